@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// A queue between one producer and one consumer thread. The producer blocks while the queue is
+// full so that a fast producer (e.g. a demuxer) can not use up all memory.
+template <typename T> class BoundedQueue
+{
+public:
+  BoundedQueue(const std::size_t maxSize) : maxSize(maxSize) {}
+
+  // Blocks while the queue is full
+  void push(T &&item)
+  {
+    std::unique_lock lock(this->mutex);
+    this->notFull.wait(lock, [this]() { return this->items.size() < this->maxSize; });
+    this->items.push_back(std::move(item));
+    this->notEmpty.notify_one();
+  }
+
+  // Blocks until an item is available. Returns no item if the producer is finished and all items
+  // were taken.
+  std::optional<T> pop()
+  {
+    std::unique_lock lock(this->mutex);
+    this->notEmpty.wait(lock, [this]() { return !this->items.empty() || this->finished; });
+    if (this->items.empty())
+      return {};
+
+    auto item = std::move(this->items.front());
+    this->items.pop_front();
+    this->notFull.notify_one();
+    return item;
+  }
+
+  void setFinished()
+  {
+    std::unique_lock lock(this->mutex);
+    this->finished = true;
+    this->notEmpty.notify_all();
+  }
+
+private:
+  std::mutex              mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  std::deque<T>           items;
+  std::size_t             maxSize{};
+  bool                    finished{};
+};
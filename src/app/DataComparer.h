@@ -0,0 +1,136 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/Types.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+
+// The data of one input in data comparison mode. New data is appended at the end. Compared data
+// is removed from the front.
+class DataBuffer
+{
+public:
+  void append(const std::span<const std::byte> data)
+  {
+    // Move the remaining data to the front instead of growing the buffer
+    if (this->readOffset > 0 && this->readOffset >= this->data.size() / 2)
+    {
+      this->data.erase(this->data.begin(), this->data.begin() + this->readOffset);
+      this->readOffset = 0;
+    }
+    this->data.insert(this->data.end(), data.begin(), data.end());
+  }
+
+  [[nodiscard]] std::size_t      size() const { return this->data.size() - this->readOffset; }
+  [[nodiscard]] const std::byte *begin() const { return this->data.data() + this->readOffset; }
+  void                           consume(const std::size_t bytes) { this->readOffset += bytes; }
+
+  void clear()
+  {
+    this->data.clear();
+    this->readOffset = 0;
+  }
+
+private:
+  libffmpeg::ByteVector data;
+  std::size_t           readOffset{};
+};
+
+// Compare the data of two inputs byte by byte. The inputs may deliver the data in chunks of
+// different sizes (e.g. the packets of two pcm streams). Only data that could not be compared yet
+// is buffered. Once one input is finished, the remaining data of the other input can not be
+// matched anymore and is only counted.
+class DataComparer
+{
+public:
+  // Read from the input that has less data buffered next. So the buffers only hold the data of
+  // about one chunk.
+  [[nodiscard]] int getInputToReadNext() const
+  {
+    if (this->finished[0] || this->finished[1])
+      return this->finished[0] ? 1 : 0;
+    return (this->buffers[0].size() <= this->buffers[1].size()) ? 0 : 1;
+  }
+
+  void addData(const int input, const std::span<const std::byte> data)
+  {
+    if (this->finished[1 - input])
+    {
+      this->unmatchedBytes[input] += data.size();
+      return;
+    }
+
+    this->buffers[input].append(data);
+    this->compareAndDrain();
+  }
+
+  void setFinished(const int input)
+  {
+    this->finished[input] = true;
+
+    const auto other = 1 - input;
+    this->unmatchedBytes[other] += this->buffers[other].size();
+    this->buffers[other].clear();
+  }
+
+  [[nodiscard]] bool isFinished() const { return this->finished[0] && this->finished[1]; }
+
+  [[nodiscard]] uint64_t getBytesCompared() const { return this->bytesCompared; }
+  [[nodiscard]] uint64_t getBytesDiffering() const { return this->bytesDiffering; }
+  [[nodiscard]] uint64_t getUnmatchedBytes(const int input) const
+  {
+    return this->unmatchedBytes[input];
+  }
+
+private:
+  // Compare all data that is available in both buffers
+  void compareAndDrain()
+  {
+    auto &buffer1 = this->buffers[0];
+    auto &buffer2 = this->buffers[1];
+
+    const auto bytes = std::min(buffer1.size(), buffer2.size());
+    if (bytes == 0)
+      return;
+
+    const auto start = this->bytesCompared;
+    if (std::memcmp(buffer1.begin(), buffer2.begin(), bytes) != 0)
+    {
+      // Only in the rare case of a mismatch, look at the individual bytes
+      const auto firstDifference =
+          std::mismatch(buffer1.begin(), buffer1.begin() + bytes, buffer2.begin()).first -
+          buffer1.begin();
+
+      uint64_t differingBytes{};
+      for (std::size_t i = static_cast<std::size_t>(firstDifference); i < bytes; ++i)
+        if (buffer1.begin()[i] != buffer2.begin()[i])
+          ++differingBytes;
+
+      std::cout << "Error comparing data. " << differingBytes << " bytes of bytes " << start
+                << " to " << (start + bytes) << " differ. First difference at byte "
+                << (start + firstDifference) << ".\n";
+      this->bytesDiffering += differingBytes;
+    }
+
+    this->bytesCompared += bytes;
+    buffer1.consume(bytes);
+    buffer2.consume(bytes);
+  }
+
+  std::array<DataBuffer, 2> buffers;
+  std::array<bool, 2>       finished{};
+  std::array<uint64_t, 2>   unmatchedBytes{};
+  uint64_t                  bytesCompared{};
+  uint64_t                  bytesDiffering{};
+};
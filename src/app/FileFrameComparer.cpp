@@ -0,0 +1,426 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVUtil/QualityMetrics.h>
+#include <Decoder.h>
+#include <Demuxer.h>
+#include <common/Formatting.h>
+#include <libHandling/FFmpegLibrariesBuilder.h>
+
+#include "BoundedQueue.h"
+#include "Formatting.h"
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+using namespace libffmpeg;
+
+void showUsage()
+{
+  std::cout << "FileFrameComparer takes 2 input files and compares the decoded frames of one\n";
+  std::cout << "stream in each of the inputs. Both inputs are decoded in parallel. Frames are\n";
+  std::cout << "first compared by a CRC32C of the visible data. For video frames that differ,\n";
+  std::cout << "the MSE, PSNR and SSIM of each plane are calculated.\n";
+  std::cout << "Usage:\n";
+  std::cout
+      << "  FileFrameComparer <filename1>:<stream_index1> <filename2>:<stream_index2> [options]\n";
+  std::cout << "\n";
+  std::cout << "Options:\n";
+  std::cout << "  -showAllFrames    Also show the frames that match\n";
+  std::cout << "  -noSSIM           Only calculate the MSE and PSNR for frames that differ\n";
+  std::cout << "  -loglevelDebug    Set log level to debug output\n";
+  std::cout << "  -loglevelInfo     Set log level to info output\n";
+  std::cout << "  -loglevelWarning  Set log level to warning output\n";
+  std::cout << "  -libPath          Set a search path for the ffmpeg libraries\n";
+}
+
+struct CompareFile
+{
+  std::string filename;
+  int         streamIndex{};
+};
+
+struct Settings
+{
+  CompareFile           file1{};
+  CompareFile           file2{};
+  bool                  showFrames{};
+  bool                  calculateSSIM{true};
+  std::filesystem::path libraryPath{};
+  libffmpeg::LogLevel   logLevel{libffmpeg::LogLevel::Error};
+};
+
+// The decoder threads stop when this many frames are waiting for the comparison.
+constexpr std::size_t MAX_QUEUED_FRAMES = 16;
+
+using FrameQueue = BoundedQueue<avutil::AVFrameWrapper>;
+
+std::optional<CompareFile> parseFileNameAndStreamIndex(const std::string &variable)
+{
+  const auto columnPos = variable.rfind(":");
+  if (columnPos >= variable.size())
+    return {};
+
+  CompareFile file;
+
+  file.filename = variable.substr(0, columnPos);
+  if (!std::filesystem::exists(file.filename))
+  {
+    std::cout << "Given file " << file.filename << " not found.";
+    return {};
+  }
+
+  try
+  {
+    file.streamIndex = std::stoi(variable.substr(columnPos + 1));
+  }
+  catch (const std::exception &)
+  {
+    return {};
+  }
+
+  return file;
+}
+
+std::optional<Settings> parseCommandLineArguments(int argc, char const *argv[])
+{
+  Settings settings;
+
+  if (argc < 3)
+  {
+    std::cout << "Not enough arguments. Two files must be given.\n";
+    return {};
+  }
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const auto argument = std::string(argv[i]);
+
+    if (1 == i || 2 == i)
+    {
+      if (const auto file = parseFileNameAndStreamIndex(argument))
+      {
+        if (i == 1)
+          settings.file1 = *file;
+        else
+          settings.file2 = *file;
+      }
+      else
+        return {};
+    }
+    if (argument == "-showAllFrames")
+      settings.showFrames = true;
+    if (argument == "-noSSIM")
+      settings.calculateSSIM = false;
+    if (argument == "-loglevelDebug")
+      settings.logLevel = libffmpeg::LogLevel::Debug;
+    if (argument == "-loglevelInfo")
+      settings.logLevel = libffmpeg::LogLevel::Info;
+    if (argument == "-loglevelWarning")
+      settings.logLevel = libffmpeg::LogLevel::Warning;
+    if (argument == "-libPath")
+    {
+      i++;
+      if (i < argc)
+      {
+        const auto nextArgument = std::string(argv[i]);
+        const auto path         = std::filesystem::path(nextArgument);
+        const auto fileStatus   = std::filesystem::status(path);
+        if (fileStatus.type() == std::filesystem::file_type::not_found)
+          std::cout << "The given library path " << nextArgument
+                    << " could not be found. Ignoring the given path.";
+        else
+          settings.libraryPath = path;
+      }
+      else
+      {
+        std::cout << "Missing argument for parameter -libPath";
+        return {};
+      }
+    }
+  }
+  return settings;
+}
+
+void loggingFunction(const LogLevel logLevel, const std::string &message)
+{
+  static std::map<LogLevel, std::string> LogLevelToName = {{LogLevel::Debug, "Debug"},
+                                                           {LogLevel::Info, "Info"},
+                                                           {LogLevel::Warning, "Warning"},
+                                                           {LogLevel::Error, "Error"}};
+
+  std::cout << "[" << LogLevelToName.at(logLevel) << "]" << message << "\n";
+}
+
+Demuxer openInput(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                  const CompareFile                &file)
+{
+  Demuxer demuxer(ffmpegLibraries);
+  if (!demuxer.openFile(file.filename))
+    throw std::runtime_error("Error when opening input file : " + file.filename + "\n ");
+
+  const auto numberOfStreams = demuxer.getFormatContext()->getNumberStreams();
+  if (file.streamIndex < 0 || file.streamIndex >= numberOfStreams)
+    throw std::runtime_error("Given stream index " + std::to_string(file.streamIndex) +
+                             " not found in file " + file.filename);
+
+  std::cout << "Successfully opened file " + file.filename + ".\n";
+  return demuxer;
+}
+
+void checkStreams(Demuxer &demuxer1, Demuxer &demuxer2, const Settings &settings)
+{
+  const auto stream1 = demuxer1.getFormatContext()->getStream(settings.file1.streamIndex);
+  const auto stream2 = demuxer2.getFormatContext()->getStream(settings.file2.streamIndex);
+
+  const auto codecType1 = stream1.getCodecType();
+  const auto codecType2 = stream2.getCodecType();
+  if (codecType1 != codecType2)
+    throw std::runtime_error("Stream types of streams to compare do not match. Type 1 " +
+                             avutil::mediaTypeMapper.getName(codecType1) + " and type 2 " +
+                             avutil::mediaTypeMapper.getName(codecType2));
+  if (codecType1 != avutil::MediaType::Video && codecType1 != avutil::MediaType::Audio)
+    throw std::runtime_error("Only video and audio streams can be compared.");
+}
+
+// Demux and decode the stream and push all decoded frames into the queue
+bool decodeStream(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                  Demuxer                          &demuxer,
+                  const int                         streamIndex,
+                  FrameQueue                       &queue)
+{
+  Decoder decoder(ffmpegLibraries);
+  if (!decoder.openForDecoding(demuxer.getFormatContext()->getStream(streamIndex)))
+    return false;
+
+  const auto pullFramesFromDecoder = [&decoder, &queue]()
+  {
+    while (auto frame = decoder.decodeNextFrame())
+      queue.push(std::move(*frame));
+  };
+
+  while (auto packet = demuxer.getNextPacket())
+  {
+    if (packet->getStreamIndex() != streamIndex)
+      continue;
+
+    auto result = decoder.sendPacket(*packet);
+    if (decoder.getDecoderState() == Decoder::State::RetrieveFrames)
+      pullFramesFromDecoder();
+    if (result == Decoder::SendPacketResult::NotSentPullFramesFirst)
+      result = decoder.sendPacket(*packet);
+    if (result == Decoder::SendPacketResult::Error)
+      return false;
+  }
+
+  // E.g. the memory budget is exhausted. This is not the end of the stream.
+  if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+    return false;
+
+  decoder.setFlushing();
+  pullFramesFromDecoder();
+  return true;
+}
+
+bool isSameFormat(const avutil::AVFrameWrapper &frame1,
+                  const avutil::AVFrameWrapper &frame2,
+                  const avutil::MediaType       type)
+{
+  if (type == avutil::MediaType::Audio)
+    return frame1.getSampleFormat() == frame2.getSampleFormat() &&
+           frame1.getNumberOfChannels() == frame2.getNumberOfChannels() &&
+           frame1.getNumberOfSamples() == frame2.getNumberOfSamples();
+  return frame1.getSize() == frame2.getSize() &&
+         frame1.getPixelFormatDescriptor() == frame2.getPixelFormatDescriptor();
+}
+
+std::string to_string(const avutil::PlaneMetrics &metrics)
+{
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(4) << "Plane " << metrics.plane << ": MSE "
+         << metrics.mse << " PSNR " << metrics.psnr;
+  if (metrics.ssim)
+    stream << " SSIM " << *metrics.ssim;
+  return stream.str();
+}
+
+struct Statistics
+{
+  std::size_t                       framesCompared{};
+  std::size_t                       framesMatched{};
+  std::optional<std::size_t>        firstDivergentFrame{};
+  avutil::QualityMetricsAccumulator metricsOfDivergentFrames{};
+};
+
+void compareFrames(const avutil::AVFrameWrapper &frame1,
+                   const avutil::AVFrameWrapper &frame2,
+                   const avutil::MediaType       type,
+                   const Settings               &settings,
+                   Statistics                   &statistics)
+{
+  const auto frameIndex = statistics.framesCompared++;
+  const auto ptsString  = [](const avutil::AVFrameWrapper &frame)
+  {
+    const auto pts = frame.getPTS();
+    return pts ? std::to_string(*pts) : std::string("-");
+  };
+
+  if (isSameFormat(frame1, frame2, type) &&
+      frame1.calculateCRC32C() == frame2.calculateCRC32C())
+  {
+    ++statistics.framesMatched;
+    if (settings.showFrames)
+      std::cout << "Match for frame " << frameIndex << ". PTS " << ptsString(frame1) << ".\n";
+    return;
+  }
+
+  if (!statistics.firstDivergentFrame)
+    statistics.firstDivergentFrame = frameIndex;
+
+  std::cout << "Frame " << frameIndex << " differs. PTS " << ptsString(frame1) << " vs "
+            << ptsString(frame2) << ".\n";
+
+  if (type == avutil::MediaType::Audio)
+  {
+    if (!isSameFormat(frame1, frame2, type))
+      std::cout << "  Sample format, number of channels or number of samples differ.\n";
+    return;
+  }
+
+  const auto metrics = avutil::calculateQualityMetrics(
+      frame1, frame2, {.calculateSSIM = settings.calculateSSIM, .numberOfThreads = 0});
+  if (!metrics)
+  {
+    std::cout << "  Metrics not available. Size " << to_string(frame1.getSize()) << " vs "
+              << to_string(frame2.getSize()) << ", pixel format "
+              << frame1.getPixelFormatDescriptor().name << " vs "
+              << frame2.getPixelFormatDescriptor().name << ".\n";
+    return;
+  }
+
+  for (const auto &planeMetrics : metrics->planes)
+    std::cout << "  " << to_string(planeMetrics) << "\n";
+  statistics.metricsOfDivergentFrames.add(*metrics);
+}
+
+void printStatistics(const Statistics &statistics,
+                     const std::size_t remainingFrames1,
+                     const std::size_t remainingFrames2)
+{
+  std::cout << "\nCompared " << statistics.framesCompared << " frames. "
+            << statistics.framesMatched << " frames match.\n";
+  if (statistics.firstDivergentFrame)
+    std::cout << "First divergent frame: " << *statistics.firstDivergentFrame << "\n";
+  if (remainingFrames1 > 0)
+    std::cout << "Input 1 has " << remainingFrames1 << " more frames than input 2.\n";
+  if (remainingFrames2 > 0)
+    std::cout << "Input 2 has " << remainingFrames2 << " more frames than input 1.\n";
+
+  const auto &accumulator = statistics.metricsOfDivergentFrames;
+  if (accumulator.getNumberOfFrames() > 0)
+  {
+    std::cout << "Average metrics of the " << accumulator.getNumberOfFrames()
+              << " divergent frames:\n";
+    for (const auto &plane : accumulator.getPlaneMetrics())
+    {
+      std::cout << std::fixed << std::setprecision(4) << "  Plane " << plane.plane << ": MSE "
+                << plane.averageMSE << " PSNR " << plane.psnr;
+      if (plane.averageSSIM)
+        std::cout << " SSIM " << *plane.averageSSIM << " (min " << *plane.minimumSSIM << ")";
+      std::cout << "\n";
+    }
+  }
+}
+
+int main(int argc, char const *argv[])
+{
+  const auto settings = parseCommandLineArguments(argc, argv);
+  if (!settings)
+  {
+    showUsage();
+    return 1;
+  }
+
+  auto builder = FFmpegLibrariesBuilder();
+  if (!settings->libraryPath.empty())
+    builder.withAdditionalSearchPaths({settings->libraryPath});
+  const auto loadingResult =
+      builder.withLoggingFunction(&loggingFunction, settings->logLevel).tryLoadingOfLibraries();
+
+  if (!loadingResult.ffmpegLibraries)
+  {
+    std::cout << "Error when loading libraries\n";
+    return 1;
+  }
+  std::cout << "Successfully loaded ffmpeg libraries.\n";
+
+  auto demuxer1 = openInput(loadingResult.ffmpegLibraries, settings->file1);
+  auto demuxer2 = openInput(loadingResult.ffmpegLibraries, settings->file2);
+  checkStreams(demuxer1, demuxer2, *settings);
+
+  const auto mediaType =
+      demuxer1.getFormatContext()->getStream(settings->file1.streamIndex).getCodecType();
+
+  std::array<FrameQueue, 2> queues = {FrameQueue(MAX_QUEUED_FRAMES),
+                                      FrameQueue(MAX_QUEUED_FRAMES)};
+  std::array<bool, 2>       decodingSuccessful{};
+
+  const auto decodeInput = [&](const int input, Demuxer &demuxer, const CompareFile &file)
+  {
+    decodingSuccessful.at(input) =
+        decodeStream(loadingResult.ffmpegLibraries, demuxer, file.streamIndex, queues.at(input));
+    queues.at(input).setFinished();
+  };
+
+  std::thread thread1(decodeInput, 0, std::ref(demuxer1), std::cref(settings->file1));
+  std::thread thread2(decodeInput, 1, std::ref(demuxer2), std::cref(settings->file2));
+
+  Statistics  statistics;
+  std::size_t remainingFrames1{};
+  std::size_t remainingFrames2{};
+  while (true)
+  {
+    auto frame1 = queues[0].pop();
+    auto frame2 = queues[1].pop();
+
+    if (!frame1 || !frame2)
+    {
+      // Drain the other queue so that its decoder can finish
+      remainingFrames1 = frame1 ? 1 : 0;
+      remainingFrames2 = frame2 ? 1 : 0;
+      while (queues[0].pop())
+        ++remainingFrames1;
+      while (queues[1].pop())
+        ++remainingFrames2;
+
+      // The first frame that only one input has is where the inputs diverge
+      if ((remainingFrames1 > 0 || remainingFrames2 > 0) && !statistics.firstDivergentFrame)
+        statistics.firstDivergentFrame = statistics.framesCompared;
+
+      thread1.join();
+      thread2.join();
+      printStatistics(statistics, remainingFrames1, remainingFrames2);
+      break;
+    }
+
+    compareFrames(*frame1, *frame2, mediaType, *settings, statistics);
+  }
+
+  for (int input = 0; input < 2; ++input)
+    if (!decodingSuccessful.at(input))
+      std::cout << "Error decoding input " << (input + 1) << ".\n";
+
+  const auto allFramesMatch = !statistics.firstDivergentFrame && remainingFrames1 == 0 &&
+                              remainingFrames2 == 0 && decodingSuccessful[0] &&
+                              decodingSuccessful[1];
+  return allFramesMatch ? 0 : 2;
+}
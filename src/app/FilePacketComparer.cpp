@@ -8,29 +8,38 @@
 #include <common/Formatting.h>
 #include <libHandling/FFmpegLibrariesBuilder.h>
 
+#include "BoundedQueue.h"
+#include "DataComparer.h"
 #include "Formatting.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
-#include <queue>
 #include <sstream>
+#include <thread>
 
 using namespace libffmpeg;
-using PacketQueue = std::queue<avcodec::AVPacketWrapper>;
-using DataQueue   = std::deque<std::byte>;
+
+// The demuxer threads stop when this many packets of the compared stream are waiting.
+constexpr std::size_t MAX_QUEUED_PACKETS = 64;
+
+using PacketQueue = BoundedQueue<avcodec::AVPacketWrapper>;
 
 void showUsage()
 {
   std::cout << "FilePacketComparer takes 2 input files and compares the packets of one\n";
   std::cout << "stream in each of the inputs. Packets are checked for data identity.\n";
+  std::cout << "Both inputs are demuxed in parallel using constant memory.\n";
   std::cout << "Usage:\n";
   std::cout
       << "  FilePacketComparer <filename1>:<stream_index1> <filename2>:<stream_index2> [options]\n";
   std::cout << "\n";
   std::cout << "Options:\n";
+  std::cout << "  -showAllPackets   Also show the packets that match\n";
   std::cout << "  -loglevelDebug    Set log level to debug output\n";
   std::cout << "  -loglevelInfo     Set log level to info output\n";
   std::cout << "  -loglevelWarning  Set log level to warning output\n";
@@ -144,87 +153,116 @@ ComparisonMode checkStreamsAndGetComparMode(Demuxer  &demuxer1,
   return ComparisonMode::Packets;
 }
 
-bool compareData(const ByteVector &data1, const ByteVector &data2)
+struct Statistics
 {
-  return std::ranges::equal(data1, data2);
-}
+  std::size_t packetsCompared{};
+  std::size_t packetsMatched{};
+};
 
-void compareQueuePacketsAndDrain(PacketQueue &queue1, PacketQueue &queue2)
+void comparePackets(const avcodec::AVPacketWrapper &packet1,
+                    const avcodec::AVPacketWrapper &packet2,
+                    const Settings                 &settings,
+                    Statistics                     &statistics)
 {
-  while (!queue1.empty() && !queue2.empty())
-  {
-    auto packet1 = std::move(queue1.front());
-    auto packet2 = std::move(queue2.front());
-
-    queue1.pop();
-    queue2.pop();
+  const auto packetCount = statistics.packetsCompared++;
 
-    static int packetCount = -1;
-    ++packetCount;
+  bool match = true;
 
-    bool match = true;
-
-    if (packet1.getDuration() != packet2.getDuration())
-    {
-      std::cout << "Error comparing packet " << packetCount << ". Duration unequal ("
-                << packet1.getDuration() << " vs " << packet2.getDuration() << ").\n";
-      match = false;
-    }
+  if (packet1.getDuration() != packet2.getDuration())
+  {
+    std::cout << "Error comparing packet " << packetCount << ". Duration unequal ("
+              << packet1.getDuration() << " vs " << packet2.getDuration() << ").\n";
+    match = false;
+  }
 
-    if (packet1.getDataSize() != packet2.getDataSize())
-    {
-      std::cout << "Error comparing packet " << packetCount << ". Data size unequal ("
-                << packet1.getDataSize() << " vs " << packet2.getDataSize() << ").\n";
-      match = false;
-    }
-    else if (!compareData(packet1.getData(), packet2.getData()))
-    {
-      std::cout << "Error comparing packet " << packetCount << ". Data unequal.\n";
-      match = false;
-    }
+  const auto data1 = packet1.getDataView();
+  const auto data2 = packet2.getDataView();
+  if (data1.size() != data2.size())
+  {
+    std::cout << "Error comparing packet " << packetCount << ". Data size unequal ("
+              << data1.size() << " vs " << data2.size() << ").\n";
+    match = false;
+  }
+  else if (!data1.empty() && std::memcmp(data1.data(), data2.data(), data1.size()) != 0)
+  {
+    std::cout << "Error comparing packet " << packetCount << ". Data unequal.\n";
+    match = false;
+  }
 
-    if (match)
+  if (match)
+  {
+    ++statistics.packetsMatched;
+    if (settings.showPackets)
       std::cout << "Match for packet " << packetCount << ". Duration " << packet1.getDuration()
                 << ".\n";
   }
 }
 
-void compareDataQueueAndDrain(DataQueue &queue1, DataQueue &queue2)
+// Push all packets of the stream into the queue. Returns false if demuxing stopped before the end
+// of the file.
+bool demuxStream(Demuxer &demuxer, const int streamIndex, PacketQueue &queue)
 {
-  int  bytesMatched = 0;
-  bool matched      = true;
+  while (auto packet = demuxer.getNextPacket())
+    if (packet->getStreamIndex() == streamIndex)
+      queue.push(std::move(*packet));
+  queue.setFinished();
+  return demuxer.getDemuxerState() == Demuxer::State::EndOfFile;
+}
 
-  while (!queue1.empty() && !queue2.empty())
+void comparePacketQueues(std::array<PacketQueue, 2> &queues,
+                         const Settings             &settings,
+                         Statistics                 &statistics)
+{
+  while (true)
   {
-    const auto byte1 = queue1.front();
-    const auto byte2 = queue2.front();
-
-    queue1.pop_front();
-    queue2.pop_front();
+    auto packet1 = queues[0].pop();
+    auto packet2 = queues[1].pop();
 
-    static int byteCounter = -1;
-    ++byteCounter;
-    ++bytesMatched;
-
-    if (byte1 != byte2)
+    if (!packet1 || !packet2)
     {
-      std::cout << "Error comparing data. Byte " << byteCounter << " differs.\n";
-      matched = false;
+      std::size_t remainingPackets1 = packet1 ? 1 : 0;
+      std::size_t remainingPackets2 = packet2 ? 1 : 0;
+      while (queues[0].pop())
+        ++remainingPackets1;
+      while (queues[1].pop())
+        ++remainingPackets2;
+
+      if (remainingPackets1 > 0)
+        std::cout << "Input 1 has " << remainingPackets1 << " packets that were not matched.\n";
+      if (remainingPackets2 > 0)
+        std::cout << "Input 2 has " << remainingPackets2 << " packets that were not matched.\n";
+      break;
     }
+
+    comparePackets(*packet1, *packet2, settings, statistics);
   }
 
-  if (bytesMatched > 0)
-    std::cout << (matched ? "Successfully matched " : "Failed to match ") << bytesMatched
-              << " bytes.\n";
+  std::cout << "Compared " << statistics.packetsCompared << " packets. "
+            << statistics.packetsMatched << " packets match.\n";
 }
 
-template <typename T> void logQueueState(const std::string &queueName, const T &queue)
+void compareDataOfQueues(std::array<PacketQueue, 2> &queues)
 {
-  if (!queue.empty())
+  DataComparer comparer;
+  while (!comparer.isFinished())
   {
-    std::cout << "Queue " << queueName << " is not empty. " << queue.size()
-              << " items not matched.";
+    const auto input = comparer.getInputToReadNext();
+    if (auto packet = queues[input].pop())
+      comparer.addData(input, packet->getDataView());
+    else
+      comparer.setFinished(input);
   }
+
+  std::cout << (comparer.getBytesDiffering() == 0 ? "Successfully matched " : "Failed to match ")
+            << comparer.getBytesCompared() << " bytes.";
+  if (comparer.getBytesDiffering() > 0)
+    std::cout << " " << comparer.getBytesDiffering() << " bytes differ.";
+  std::cout << "\n";
+
+  for (int input = 0; input < 2; ++input)
+    if (comparer.getUnmatchedBytes(input) > 0)
+      std::cout << "Input " << (input + 1) << " has " << comparer.getUnmatchedBytes(input)
+                << " bytes that were not matched.\n";
 }
 
 std::optional<Settings> parseCommandLineArguments(int argc, char const *argv[])
@@ -331,53 +369,34 @@ int main(int argc, char const *argv[])
   const auto compareMode = checkStreamsAndGetComparMode(
       demuxer1, demuxer2, settings->file1.streamIndex, settings->file2.streamIndex);
 
-  std::array<PacketQueue, 2> packetQueue;
-  std::array<DataQueue, 2>   dataQueue;
-
-  auto addPacketToQueue = [&packetQueue, &dataQueue, compareMode](avcodec::AVPacketWrapper &&packet,
-                                                                  const int streamIndex,
-                                                                  const int queueIndex)
-  {
-    const auto packetStreamIndex = packet.getStreamIndex();
-    if (packetStreamIndex != streamIndex)
-      return;
-    if (compareMode == ComparisonMode::Packets)
-      packetQueue[queueIndex].push(std::move(packet));
-    else
-    {
-      const auto data = packet.getData();
-      dataQueue[queueIndex].insert(dataQueue[queueIndex].end(), data.begin(), data.end());
-    }
-  };
-
-  while (true)
-  {
-    auto packet1 = demuxer1.getNextPacket();
-    auto packet2 = demuxer2.getNextPacket();
+  std::array<PacketQueue, 2> queues = {PacketQueue(MAX_QUEUED_PACKETS),
+                                       PacketQueue(MAX_QUEUED_PACKETS)};
 
-    if (!packet1 && !packet2)
-      break;
+  std::array<bool, 2> demuxingSuccessful{};
 
-    if (packet1)
-      addPacketToQueue(std::move(*packet1), settings->file1.streamIndex, 0);
-    if (packet2)
-      addPacketToQueue(std::move(*packet2), settings->file2.streamIndex, 1);
+  const auto demuxInput = [&](const int input, Demuxer &demuxer, const int streamIndex)
+  { demuxingSuccessful.at(input) = demuxStream(demuxer, streamIndex, queues.at(input)); };
 
-    if (compareMode == ComparisonMode::Packets)
-      compareQueuePacketsAndDrain(packetQueue[0], packetQueue[1]);
-    else
-      compareDataQueueAndDrain(dataQueue[0], dataQueue[1]);
-  }
+  std::thread thread1(demuxInput, 0, std::ref(demuxer1), settings->file1.streamIndex);
+  std::thread thread2(demuxInput, 1, std::ref(demuxer2), settings->file2.streamIndex);
 
+  Statistics statistics;
   if (compareMode == ComparisonMode::Packets)
-  {
-    logQueueState("1", packetQueue[0]);
-    logQueueState("2", packetQueue[1]);
-  }
+    comparePacketQueues(queues, *settings, statistics);
   else
+    compareDataOfQueues(queues);
+
+  thread1.join();
+  thread2.join();
+
+  for (int input = 0; input < 2; ++input)
   {
-    logQueueState("1", dataQueue[0]);
-    logQueueState("2", dataQueue[1]);
+    if (!demuxingSuccessful.at(input))
+    {
+      std::cout << "Error: Demuxing of input " << (input + 1)
+                << " stopped before the end of the file. The comparison is incomplete.\n";
+      return 1;
+    }
   }
 
   return 0;
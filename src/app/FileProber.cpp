@@ -4,16 +4,27 @@
  * For a copy, see <https://opensource.org/licenses/MIT>.
  */
 
+#include <Analysis/PacketAnalyzer.h>
+#include <BitstreamFilter.h>
+#include <Bitstream/NalParser.h>
+#include <Decoder.h>
 #include <Demuxer.h>
+#include <Parser.h>
+#include <Probing/BatchProber.h>
+#include <common/CpuFeatures.h>
 #include <common/Formatting.h>
 #include <libHandling/FFmpegLibrariesBuilder.h>
 
 #include "Formatting.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 
 using namespace libffmpeg;
@@ -22,9 +33,30 @@ void showUsage()
 {
   std::cout << "FileProber usage:\n";
   std::cout << "  FileProber <filename> [options]\n";
+  std::cout << "  FileProber -batch <directory or file list> [options]\n";
+  std::cout << "\n";
+  std::cout << "In batch mode, all files in the directory (recursively) or all files listed\n";
+  std::cout << "in the given file (one per line) are probed in parallel. For each file one\n";
+  std::cout << "line of JSON is written.\n";
   std::cout << "\n";
   std::cout << "Options:\n";
   std::cout << "  -showAllPackets   Print all parsed packets\n";
+  std::cout << "  -showIndex        Print the index entries of the streams (no packets are read)\n";
+  std::cout << "  -analyze          Print the bitrate, GOP structure and timestamp issues of the\n";
+  std::cout << "                    streams. Only packet headers are used.\n";
+  std::cout << "  -nalUnits         Parse the NAL units of all H.264 and HEVC streams and print\n";
+  std::cout << "                    the picture types. Use -showAllPackets to print each packet.\n";
+  std::cout << "  -benchmarkNal     Measure the NAL parsing throughput (packets per second) of\n";
+  std::cout << "                    all start code search implementations\n";
+  std::cout << "  -annexB           Convert length prefixed NAL units to Annex B with the\n";
+  std::cout << "                    mp4toannexb bitstream filter before parsing them\n";
+  std::cout << "  -stream <index>   Only analyze the given stream (can be given multiple times)\n";
+  std::cout << "  -raw <codec>      Read the file as an elementary stream of the given codec\n";
+  std::cout << "                    (e.g. h264 or hevc) without avformat and decode all frames\n";
+  std::cout << "  -threads <n>      Batch mode: Number of threads (default: all cores)\n";
+  std::cout << "  -cache <file>     Batch mode: Skip files with unchanged size and\n";
+  std::cout << "                    modification time using the given cache file.\n";
+  std::cout << "  -output <file>    Batch mode: Write the JSON lines to the file\n";
   std::cout << "  -loglevelDebug    Set log level to debug output\n";
   std::cout << "  -loglevelInfo     Set log level to info output\n";
   std::cout << "  -loglevelWarning  Set log level to warning output\n";
@@ -35,6 +67,17 @@ struct Settings
 {
   std::string           filename{};
   bool                  showPackets{};
+  bool                  showIndex{};
+  bool                  analyze{};
+  bool                  parseNalUnits{};
+  bool                  benchmarkNal{};
+  bool                  annexB{};
+  std::string           rawCodec{};
+  std::vector<int>      streamIndices{};
+  std::filesystem::path batchPath{};
+  unsigned              numberOfThreads{};
+  std::filesystem::path cachePath{};
+  std::filesystem::path outputPath{};
   std::filesystem::path libraryPath{};
   libffmpeg::LogLevel   logLevel{libffmpeg::LogLevel::Error};
 };
@@ -62,6 +105,42 @@ std::optional<Settings> parseCommandLineArguments(int argc, char const *argv[])
   {
     const auto argument = std::string(argv[i]);
 
+    if (argument == "-batch" || argument == "-threads" || argument == "-cache" ||
+        argument == "-output" || argument == "-stream" || argument == "-raw")
+    {
+      i++;
+      if (i >= argc)
+      {
+        std::cout << "Missing argument for parameter " << argument;
+        return {};
+      }
+      const auto nextArgument = std::string(argv[i]);
+      if (argument == "-batch")
+      {
+        if (!checkIfFileExists(nextArgument))
+          return {};
+        settings.batchPath = nextArgument;
+      }
+      try
+      {
+        if (argument == "-threads")
+          settings.numberOfThreads = static_cast<unsigned>(std::stoul(nextArgument));
+        if (argument == "-stream")
+          settings.streamIndices.push_back(std::stoi(nextArgument));
+      }
+      catch (const std::exception &)
+      {
+        std::cout << "Invalid value " << nextArgument << " for parameter " << argument;
+        return {};
+      }
+      if (argument == "-cache")
+        settings.cachePath = nextArgument;
+      if (argument == "-output")
+        settings.outputPath = nextArgument;
+      if (argument == "-raw")
+        settings.rawCodec = nextArgument;
+      continue;
+    }
     if (1 == i)
     {
       if (checkIfFileExists(argument))
@@ -71,6 +150,16 @@ std::optional<Settings> parseCommandLineArguments(int argc, char const *argv[])
     }
     if (argument == "-showAllPackets")
       settings.showPackets = true;
+    if (argument == "-showIndex")
+      settings.showIndex = true;
+    if (argument == "-analyze")
+      settings.analyze = true;
+    if (argument == "-nalUnits")
+      settings.parseNalUnits = true;
+    if (argument == "-benchmarkNal")
+      settings.benchmarkNal = true;
+    if (argument == "-annexB")
+      settings.annexB = true;
     if (argument == "-loglevelDebug")
       settings.logLevel = libffmpeg::LogLevel::Debug;
     if (argument == "-loglevelInfo")
@@ -98,6 +187,12 @@ std::optional<Settings> parseCommandLineArguments(int argc, char const *argv[])
       }
     }
   }
+
+  if (settings.filename.empty() && settings.batchPath.empty())
+  {
+    std::cout << "Either a file name or -batch must be given";
+    return {};
+  }
   return settings;
 }
 
@@ -108,7 +203,406 @@ void loggingFunction(const LogLevel logLevel, const std::string &message)
                                                            {LogLevel::Warning, "Warning"},
                                                            {LogLevel::Error, "Error"}};
 
-  std::cout << "[" << LogLevelToName.at(logLevel) << "]" << message << "\n";
+  // Log to stderr so that the JSON output of the batch mode is not interrupted
+  std::cerr << "[" << LogLevelToName.at(logLevel) << "]" << message << "\n";
+}
+
+void printIndexEntries(const avformat::AVFormatContextWrapper *formatContext)
+{
+  std::cout << "  Index entries:\n";
+  for (const auto &stream : formatContext->getStreams())
+  {
+    const auto entries = stream.getIndexEntries();
+    const auto numberOfKeyframes =
+        std::count_if(entries.begin(),
+                      entries.end(),
+                      [](const avformat::IndexEntry &entry) { return entry.keyframe; });
+
+    std::cout << "    Stream " << stream.getIndex() << " : " << entries.size() << " entries, "
+              << numberOfKeyframes << " keyframes\n";
+    for (const auto &entry : entries)
+      std::cout << "      Pos " << entry.position << " TS " << entry.timestamp << " size "
+                << entry.size << (entry.keyframe ? " [Keyframe]" : "") << "\n";
+  }
+}
+
+void printStreamAnalysis(const analysis::StreamAnalysis &analysis)
+{
+  const auto gopLengths =
+      std::accumulate(analysis.gopLengths.begin(), analysis.gopLengths.end(), uint64_t(0));
+  const auto averageGOPLength =
+      analysis.gopLengths.empty()
+          ? 0.0
+          : static_cast<double>(gopLengths) / static_cast<double>(analysis.gopLengths.size());
+  const auto averageKeyframeInterval =
+      analysis.keyframeIntervals.empty()
+          ? 0.0
+          : std::accumulate(
+                analysis.keyframeIntervals.begin(), analysis.keyframeIntervals.end(), 0.0) /
+                static_cast<double>(analysis.keyframeIntervals.size());
+
+  std::cout << "    Stream " << analysis.streamIndex << " : \n";
+  std::cout << "      Packets             : " << analysis.numberOfPackets << "\n";
+  std::cout << "      Bytes               : " << analysis.numberOfBytes << "\n";
+  std::cout << "      Average bitrate     : " << analysis.averageBitrate << " bit/s\n";
+  std::cout << "      Keyframes           : " << analysis.numberOfKeyframes << "\n";
+  std::cout << "      GOPs                : " << analysis.gopLengths.size() << " (average "
+            << averageGOPLength << " packets, " << averageKeyframeInterval << " s)\n";
+  std::cout << "      Leading packets     : " << analysis.numberOfLeadingPackets << "\n";
+  std::cout << "      Corrupt packets     : " << analysis.numberOfCorruptPackets << "\n";
+  std::cout << "      Discard packets     : " << analysis.numberOfDiscardPackets << "\n";
+  std::cout << "      Without DTS / PTS   : " << analysis.numberOfPacketsWithoutDTS << " / "
+            << analysis.numberOfPacketsWithoutPTS << "\n";
+  std::cout << "      Non monotonic DTS   : " << analysis.numberOfNonMonotonicDTS << "\n";
+  std::cout << "      PTS before DTS      : " << analysis.numberOfPTSBeforeDTS << "\n";
+  std::cout << "      Max PTS delay       : " << analysis.maxPTSDelay << "\n";
+  std::cout << "      DTS gaps            : " << analysis.numberOfGaps << "\n";
+  for (const auto &gap : analysis.gaps)
+    std::cout << "        Packet " << gap.packetIndex << " DTS " << gap.dts << " gap " << gap.gap
+              << "\n";
+  std::cout << "      Bitrate per window  :\n";
+  for (const auto &window : analysis.bitrateWindows)
+    std::cout << "        " << window.startTime << " s: " << window.bitrate << " bit/s ("
+              << window.numberOfPackets << " packets)\n";
+}
+
+struct NalStream
+{
+  int                                   streamIndex{};
+  bitstream::NalParser                  parser;
+  std::optional<BitstreamFilter>        filter{};
+  ByteVector                            extradata{};
+  std::vector<avcodec::AVPacketWrapper> packets{};
+  std::map<std::string, int>            pictureTypeCounts{};
+  int                                   numberOfKeyframes{};
+  int                                   numberOfFailedPackets{};
+};
+
+void benchmarkNalParsing(const std::vector<NalStream> &streams)
+{
+  using Implementation = bitstream::NalParserSettings::Implementation;
+
+  constexpr int NUMBER_OF_RUNS = 10;
+
+  std::cout << "  NAL parsing benchmark:\n";
+  for (const auto &[implementation, name] :
+       {std::pair{Implementation::Scalar, "Scalar"}, std::pair{Implementation::AVX2, "AVX2"}})
+  {
+    std::size_t numberOfPackets{};
+    std::size_t numberOfBytes{};
+    std::size_t numberOfNalUnits{};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < NUMBER_OF_RUNS; ++run)
+    {
+      for (const auto &stream : streams)
+      {
+        bitstream::NalParser parser(stream.parser.getCodec(), {implementation});
+        parser.parseExtradata(stream.extradata);
+
+        bitstream::PacketNalUnits result;
+        for (const auto &packet : stream.packets)
+        {
+          parser.parsePacket(packet, result);
+          numberOfNalUnits += result.nalUnits.size();
+          numberOfBytes += static_cast<std::size_t>(packet.getDataSize());
+          ++numberOfPackets;
+        }
+      }
+    }
+    const auto seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "    " << name << ": " << numberOfPackets << " packets (" << numberOfNalUnits
+              << " NAL units) in " << seconds << " s: "
+              << static_cast<double>(numberOfPackets) / seconds << " packets/s, "
+              << static_cast<double>(numberOfBytes) / seconds / 1000000.0 << " MB/s\n";
+  }
+  if (!getCpuFeatures().avx2)
+    std::cout << "    AVX2 is not supported by the CPU. The scalar implementation was used.\n";
+}
+
+void parseNalPacket(NalStream                 &stream,
+                    avcodec::AVPacketWrapper &&packet,
+                    const Settings            &settings,
+                    int                       &packetIndex)
+{
+  bitstream::PacketNalUnits result;
+  if (!stream.parser.parsePacket(packet, result))
+    ++stream.numberOfFailedPackets;
+  if (result.keyframe)
+    ++stream.numberOfKeyframes;
+  const auto pictureType =
+      result.pictureType ? bitstream::sliceTypeMapper.getName(*result.pictureType) : "None";
+  ++stream.pictureTypeCounts[pictureType];
+
+  if (settings.showPackets)
+  {
+    std::cout << "  Packet " << packetIndex << ": StreamIndex " << stream.streamIndex << " "
+              << pictureType << (result.keyframe ? " [Keyframe]" : "") << " NAL units";
+    for (const auto &nalUnit : result.nalUnits)
+    {
+      std::cout << " " << nalUnit.type;
+      if (nalUnit.slice && nalUnit.slice->picOrderCntLsb)
+        std::cout << "(POC LSB " << *nalUnit.slice->picOrderCntLsb << ")";
+    }
+    std::cout << "\n";
+  }
+  if (settings.benchmarkNal)
+    stream.packets.push_back(std::move(packet));
+  packetIndex++;
+}
+
+bool openAnnexBFilter(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                      const avformat::AVStreamWrapper  &stream,
+                      NalStream                        &nalStream)
+{
+  const auto codec = nalStream.parser.getCodec();
+  const auto filterName =
+      (codec == bitstream::Codec::H264) ? "h264_mp4toannexb" : "hevc_mp4toannexb";
+
+  BitstreamFilter filter(ffmpegLibraries);
+  if (!filter.open(filterName, stream))
+    return false;
+
+  // The filter converts the extradata to Annex B as well
+  nalStream.parser = bitstream::NalParser(codec);
+  if (const auto outputParameters = filter.getOutputCodecParameters())
+    nalStream.extradata = outputParameters->getExtradata();
+  nalStream.parser.parseExtradata(nalStream.extradata);
+  nalStream.filter = std::move(filter);
+  return true;
+}
+
+int parseNalUnits(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                  Demuxer                          &demuxer,
+                  const Settings                   &settings)
+{
+  std::vector<NalStream>     streams;
+  std::map<int, std::size_t> streamIndexToNalStream;
+  for (auto &stream : demuxer.getFormatContext()->getStreams())
+  {
+    const auto descriptor = stream.getCodecDescriptor();
+    const auto codec =
+        descriptor ? bitstream::codecFromName(descriptor->codecName) : std::nullopt;
+    const auto selected =
+        settings.streamIndices.empty() ||
+        std::find(settings.streamIndices.begin(),
+                  settings.streamIndices.end(),
+                  stream.getIndex()) != settings.streamIndices.end();
+    if (!codec || !selected)
+    {
+      stream.setDiscard(avcodec::Discard::All);
+      continue;
+    }
+
+    NalStream nalStream{stream.getIndex(), bitstream::NalParser(*codec)};
+    nalStream.extradata = stream.getExtradata();
+    if (!nalStream.parser.parseExtradata(nalStream.extradata))
+      std::cout << "  Error parsing the extradata of stream " << stream.getIndex() << "\n";
+    if (settings.annexB && nalStream.parser.getNalLengthSize() > 0 &&
+        !openAnnexBFilter(ffmpegLibraries, stream, nalStream))
+      std::cout << "  Error opening the Annex B filter for stream " << stream.getIndex() << "\n";
+
+    streamIndexToNalStream[stream.getIndex()] = streams.size();
+    streams.push_back(std::move(nalStream));
+  }
+
+  if (streams.empty())
+  {
+    std::cout << "  No H.264 or HEVC stream found\n";
+    return 1;
+  }
+
+  int                                   packetIndex = 0;
+  std::vector<avcodec::AVPacketWrapper> filteredPackets;
+  while (auto packet = demuxer.getNextPacket())
+  {
+    const auto nalStreamIt = streamIndexToNalStream.find(packet->getStreamIndex());
+    if (nalStreamIt == streamIndexToNalStream.end())
+      continue;
+    auto &stream = streams.at(nalStreamIt->second);
+
+    if (!stream.filter)
+    {
+      parseNalPacket(stream, std::move(*packet), settings, packetIndex);
+      continue;
+    }
+
+    filteredPackets.clear();
+    if (!stream.filter->filterPacket(std::move(*packet), filteredPackets))
+      ++stream.numberOfFailedPackets;
+    for (auto &filteredPacket : filteredPackets)
+      parseNalPacket(stream, std::move(filteredPacket), settings, packetIndex);
+  }
+
+  if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+  {
+    std::cout << "  Error: Demuxing stopped before the end of the file\n";
+    return 1;
+  }
+
+  for (auto &stream : streams)
+  {
+    if (!stream.filter)
+      continue;
+    stream.filter->sendEndOfStream();
+    while (auto filteredPacket = stream.filter->receivePacket())
+      parseNalPacket(stream, std::move(*filteredPacket), settings, packetIndex);
+  }
+
+  std::cout << "  NAL units:\n";
+  for (const auto &stream : streams)
+  {
+    std::cout << "    Stream " << stream.streamIndex << " : \n";
+    for (const auto &[id, sps] : stream.parser.getSPSs())
+      std::cout << "      SPS " << id << "           : profile " << sps.profile << " level "
+                << sps.level << " size " << sps.size.width << "x" << sps.size.height
+                << " chroma format " << sps.chromaFormat << " bit depth " << sps.bitDepthLuma
+                << "\n";
+    std::cout << "      Keyframes       : " << stream.numberOfKeyframes << "\n";
+    std::cout << "      Picture types   : " << to_string(stream.pictureTypeCounts) << "\n";
+    std::cout << "      Failed packets  : " << stream.numberOfFailedPackets << "\n";
+  }
+
+  if (settings.benchmarkNal)
+    benchmarkNalParsing(streams);
+  return 0;
+}
+
+int decodeElementaryStream(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                           const Settings                   &settings)
+{
+  Parser parser(ffmpegLibraries);
+  if (!parser.open(settings.rawCodec))
+  {
+    std::cout << "Error opening parser for codec " << settings.rawCodec << "\n";
+    return 1;
+  }
+
+  Decoder decoder(ffmpegLibraries);
+  if (!decoder.openForDecoding(parser.getCodecID()))
+  {
+    std::cout << "Error opening decoder for codec " << settings.rawCodec << "\n";
+    return 1;
+  }
+
+  std::ifstream file(settings.filename, std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cout << "Error opening input file " << settings.filename << "\n";
+    return 1;
+  }
+
+  int                                 numberOfPackets   = 0;
+  int                                 numberOfKeyframes = 0;
+  std::size_t                         numberOfFrames    = 0;
+  std::vector<avutil::AVFrameWrapper> frames;
+
+  const auto decodePackets = [&](std::vector<avcodec::AVPacketWrapper> &packets)
+  {
+    for (const auto &packet : packets)
+    {
+      ++numberOfPackets;
+      if (packet.getFlags().keyframe)
+        ++numberOfKeyframes;
+      if (settings.showPackets)
+        std::cout << "  Packet " << numberOfPackets - 1 << ": dataSize " << packet.getDataSize()
+                  << (packet.getFlags().keyframe ? " [Keyframe]" : "") << "\n";
+
+      auto result = decoder.sendPacket(packet);
+      if (result == Decoder::SendPacketResult::NotSentPullFramesFirst)
+      {
+        numberOfFrames += decoder.decodeAvailableFrames(frames);
+        result = decoder.sendPacket(packet);
+      }
+      if (result != Decoder::SendPacketResult::Ok)
+        return false;
+      numberOfFrames += decoder.decodeAvailableFrames(frames);
+    }
+    packets.clear();
+    return true;
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+
+  ByteVector                            buffer(64 * 1024);
+  std::vector<avcodec::AVPacketWrapper> packets;
+  std::size_t                           numberOfBytes = 0;
+  while (file)
+  {
+    file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    const auto bytesRead = static_cast<std::size_t>(file.gcount());
+    numberOfBytes += bytesRead;
+    if (!parser.parse(std::span(buffer).first(bytesRead), packets) || !decodePackets(packets))
+    {
+      std::cout << "Error parsing or decoding the elementary stream\n";
+      return 1;
+    }
+  }
+  if (!parser.flush(packets) || !decodePackets(packets))
+  {
+    std::cout << "Error parsing or decoding the elementary stream\n";
+    return 1;
+  }
+
+  decoder.setFlushing();
+  numberOfFrames += decoder.decodeAvailableFrames(frames);
+
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+  std::cout << "Elementary stream " << settings.filename << " (" << settings.rawCodec << "):\n";
+  std::cout << "  Bytes:     " << numberOfBytes << "\n";
+  std::cout << "  Packets:   " << numberOfPackets << "\n";
+  std::cout << "  Keyframes: " << numberOfKeyframes << "\n";
+  std::cout << "  Frames:    " << numberOfFrames << "\n";
+  std::cout << "  Time:      " << std::fixed << std::setprecision(3) << seconds.count() << " s\n";
+  return 0;
+}
+
+int runBatch(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const Settings &settings)
+{
+  const auto files = probing::collectFiles(settings.batchPath);
+  std::cerr << "Probing " << files.size() << " files.\n";
+
+  std::ofstream outputFile;
+  if (!settings.outputPath.empty())
+  {
+    outputFile.open(settings.outputPath, std::ios::trunc);
+    if (!outputFile.is_open())
+    {
+      std::cerr << "Error opening output file " << settings.outputPath << "\n";
+      return 1;
+    }
+  }
+  auto &output = settings.outputPath.empty() ? std::cout : outputFile;
+
+  std::optional<probing::ProbeCache> cache;
+  if (!settings.cachePath.empty())
+  {
+    cache.emplace();
+    if (!cache->load(settings.cachePath))
+      std::cerr << "No valid cache found at " << settings.cachePath << ". Probing all files.\n";
+  }
+
+  probing::BatchProber prober(ffmpegLibraries, {settings.numberOfThreads});
+  const auto           statistics =
+      prober.probeFiles(files,
+                        cache ? &(*cache) : nullptr,
+                        [&output](const probing::ProbeResult &result)
+                        { output << result.json << "\n"; });
+
+  if (cache)
+  {
+    cache->removeUnusedEntries();
+    if (!cache->save(settings.cachePath))
+      std::cerr << "Error writing cache file " << settings.cachePath << "\n";
+  }
+
+  std::cerr << "Probed " << statistics.numberOfProbedFiles << " files. "
+            << statistics.numberOfCachedFiles << " files unchanged. "
+            << statistics.numberOfFailedFiles << " files failed.\n";
+  return 0;
 }
 
 int main(int argc, char const *argv[])
@@ -129,6 +623,10 @@ int main(int argc, char const *argv[])
     std::cout << "Error when loading libraries\n";
     return 1;
   }
+  else if (!settings->batchPath.empty())
+    return runBatch(loadingResult.ffmpegLibraries, *settings);
+  else if (!settings->rawCodec.empty())
+    return decodeElementaryStream(loadingResult.ffmpegLibraries, *settings);
   else
   {
     std::cout << "Successfully loaded ffmpeg libraries.\n";
@@ -155,6 +653,28 @@ int main(int argc, char const *argv[])
   std::cout << "\nFile info:\n";
   printInputFormat(formatContext, inputFormat);
 
+  if (settings->showIndex)
+    printIndexEntries(formatContext);
+
+  if (settings->parseNalUnits || settings->benchmarkNal)
+    return parseNalUnits(loadingResult.ffmpegLibraries, demuxer, *settings);
+
+  if (settings->analyze)
+  {
+    analysis::PacketAnalyzerSettings analyzerSettings;
+    analyzerSettings.streamIndices = settings->streamIndices;
+
+    std::cout << "  Stream analysis:\n";
+    for (const auto &streamAnalysis : analysis::analyzeStreams(demuxer, analyzerSettings))
+      printStreamAnalysis(streamAnalysis);
+    if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+    {
+      std::cout << "  Error: Demuxing stopped before the end of the file\n";
+      return 1;
+    }
+    return 0;
+  }
+
   struct StreamCounters
   {
     int                    packetCount{0};
@@ -201,6 +721,12 @@ int main(int argc, char const *argv[])
     packetIndex++;
   }
 
+  if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+  {
+    std::cout << "  Error: Demuxing stopped before the end of the file\n";
+    return 1;
+  }
+
   std::cout << "  Stream counts:\n";
   for (const auto [streamIndex, counters] : streamPacketCounters)
   {
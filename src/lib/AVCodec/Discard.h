@@ -0,0 +1,36 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/EnumMapper.h>
+
+namespace libffmpeg::avcodec
+{
+
+// Which frames to discard. This corresponds to the AVDiscard values in FFmpeg.
+enum class Discard
+{
+  None,
+  Default,
+  NonReference,
+  Bidirectional,
+  NonIntra,
+  NonKey,
+  All
+};
+
+// The names are the names of the constants of the FFmpeg options (e.g. skip_frame).
+const EnumMapper<Discard>
+    DiscardMapper({{Discard::None, "none", "Discard nothing"},
+                   {Discard::Default, "default", "Discard useless packets like 0 size packets"},
+                   {Discard::NonReference, "noref", "Discard all non reference frames"},
+                   {Discard::Bidirectional, "bidir", "Discard all bidirectional frames"},
+                   {Discard::NonIntra, "nointra", "Discard all non intra frames"},
+                   {Discard::NonKey, "nokey", "Discard all frames except keyframes"},
+                   {Discard::All, "all", "Discard all frames"}});
+
+} // namespace libffmpeg::avcodec
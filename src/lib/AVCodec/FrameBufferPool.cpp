@@ -0,0 +1,238 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "FrameBufferPool.h"
+
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace libffmpeg::avcodec
+{
+
+struct FrameBufferPool::Buffer
+{
+  uint8_t    *data{};
+  std::size_t size{};
+  std::size_t allocatedSize{};
+  bool        memoryMapped{};
+
+  // Only set while the buffer is handed out. This keeps the pool state alive until all buffers
+  // came back.
+  std::shared_ptr<PoolState> pool{};
+};
+
+struct FrameBufferPool::PoolState
+{
+  ~PoolState();
+
+  Settings           settings{};
+  mutable std::mutex mutex;
+  Statistics         statistics{};
+  bool               poolDestroyed{};
+
+  std::map<std::size_t, std::vector<Buffer *>> freeBuffersPerSize;
+};
+
+namespace
+{
+
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+std::size_t roundUpToMultiple(const std::size_t value, const std::size_t multiple)
+{
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+FrameBufferPool::Buffer *allocateBuffer(const std::size_t size, const bool useHugePages)
+{
+  auto buffer  = new FrameBufferPool::Buffer;
+  buffer->size = size;
+
+#if defined(__linux__)
+  if (useHugePages)
+  {
+    const auto mappedSize = roundUpToMultiple(size, HUGE_PAGE_SIZE);
+
+    auto memory = mmap(nullptr,
+                       mappedSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                       -1,
+                       0);
+    if (memory == MAP_FAILED)
+    {
+      // No explicit huge pages reserved in the system. Fall back to transparent huge pages.
+      memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (memory != MAP_FAILED)
+        madvise(memory, mappedSize, MADV_HUGEPAGE);
+    }
+
+    if (memory != MAP_FAILED)
+    {
+      buffer->data          = static_cast<uint8_t *>(memory);
+      buffer->allocatedSize = mappedSize;
+      buffer->memoryMapped  = true;
+      return buffer;
+    }
+  }
+#else
+  (void)useHugePages;
+#endif
+
+  buffer->data = static_cast<uint8_t *>(::operator new(
+      size, std::align_val_t(FrameBufferPool::BUFFER_ALIGNMENT), std::nothrow));
+  if (buffer->data == nullptr)
+  {
+    delete buffer;
+    return nullptr;
+  }
+
+  buffer->allocatedSize = size;
+  return buffer;
+}
+
+void freeBuffer(FrameBufferPool::Buffer *buffer)
+{
+#if defined(__linux__)
+  if (buffer->memoryMapped)
+    munmap(buffer->data, buffer->allocatedSize);
+  else
+#endif
+    ::operator delete(buffer->data, std::align_val_t(FrameBufferPool::BUFFER_ALIGNMENT));
+
+  delete buffer;
+}
+
+} // namespace
+
+FrameBufferPool::PoolState::~PoolState()
+{
+  for (auto &[size, buffers] : this->freeBuffersPerSize)
+    for (auto buffer : buffers)
+      freeBuffer(buffer);
+}
+
+FrameBufferPool::FrameBufferPool() : FrameBufferPool(Settings())
+{
+}
+
+FrameBufferPool::FrameBufferPool(const Settings settings)
+{
+  this->state           = std::make_shared<PoolState>();
+  this->state->settings = settings;
+}
+
+FrameBufferPool::~FrameBufferPool()
+{
+  std::scoped_lock lock(this->state->mutex);
+
+  // Buffers that are still in use are freed once they are released.
+  this->state->poolDestroyed = true;
+  for (auto &[size, buffers] : this->state->freeBuffersPerSize)
+  {
+    for (auto buffer : buffers)
+    {
+      this->state->statistics.allocatedBytes -= buffer->allocatedSize;
+      freeBuffer(buffer);
+    }
+  }
+  this->state->freeBuffersPerSize.clear();
+}
+
+FrameBufferPool::Buffer *FrameBufferPool::acquireBuffer(const std::size_t size)
+{
+  if (size == 0)
+    return nullptr;
+
+  Buffer *buffer{};
+  {
+    std::scoped_lock lock(this->state->mutex);
+
+    auto &freeBuffers = this->state->freeBuffersPerSize[size];
+    if (!freeBuffers.empty())
+    {
+      buffer = freeBuffers.back();
+      freeBuffers.pop_back();
+      ++this->state->statistics.poolHits;
+    }
+  }
+
+  if (buffer == nullptr)
+  {
+    buffer = allocateBuffer(size, this->state->settings.useHugePages);
+    if (buffer == nullptr)
+      return nullptr;
+
+    std::scoped_lock lock(this->state->mutex);
+    auto            &statistics = this->state->statistics;
+    ++statistics.poolMisses;
+    statistics.allocatedBytes += buffer->allocatedSize;
+    statistics.peakAllocatedBytes =
+        std::max(statistics.peakAllocatedBytes, statistics.allocatedBytes);
+  }
+
+  std::scoped_lock lock(this->state->mutex);
+  auto            &statistics = this->state->statistics;
+  statistics.bytesInUse += buffer->size;
+  statistics.peakBytesInUse = std::max(statistics.peakBytesInUse, statistics.bytesInUse);
+  ++statistics.buffersInUse;
+
+  buffer->pool = this->state;
+  return buffer;
+}
+
+void FrameBufferPool::releaseBuffer(Buffer *buffer)
+{
+  if (buffer == nullptr || !buffer->pool)
+    return;
+
+  // Keep the state alive until we are done here. The pool object itself may already be gone.
+  const auto state = std::move(buffer->pool);
+
+  std::scoped_lock lock(state->mutex);
+  auto            &statistics = state->statistics;
+  statistics.bytesInUse -= buffer->size;
+  --statistics.buffersInUse;
+
+  auto &freeBuffers = state->freeBuffersPerSize[buffer->size];
+  if (!state->poolDestroyed && freeBuffers.size() < state->settings.maxFreeBuffersPerSize)
+  {
+    freeBuffers.push_back(buffer);
+    return;
+  }
+
+  statistics.allocatedBytes -= buffer->allocatedSize;
+  freeBuffer(buffer);
+}
+
+uint8_t *FrameBufferPool::getData(const Buffer *buffer)
+{
+  return buffer ? buffer->data : nullptr;
+}
+
+std::size_t FrameBufferPool::getSize(const Buffer *buffer)
+{
+  return buffer ? buffer->size : 0;
+}
+
+FrameBufferPool::Statistics FrameBufferPool::getStatistics() const
+{
+  std::scoped_lock lock(this->state->mutex);
+  return this->state->statistics;
+}
+
+FrameBufferPool::Settings FrameBufferPool::getSettings() const
+{
+  return this->state->settings;
+}
+
+} // namespace libffmpeg::avcodec
@@ -0,0 +1,72 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace libffmpeg::avcodec
+{
+
+/* A pool of aligned memory blocks that the decoder can use for the decoded frames (see
+ * AVCodecContextWrapper::setFrameBufferPool). Blocks that are released are kept per size so that
+ * the next frame with the same resolution / pixel format reuses the memory instead of going
+ * through the allocator again. Buffers may outlive the pool object. The memory is only given
+ * back to the system once the pool and all buffers that were handed out are destroyed.
+ */
+class FrameBufferPool
+{
+public:
+  static constexpr std::size_t BUFFER_ALIGNMENT = 64;
+
+  struct Settings
+  {
+    // Try to back the buffers with huge pages (MAP_HUGETLB with a fallback to transparent huge
+    // pages). Only supported on Linux. On other platforms this is ignored.
+    bool        useHugePages{};
+    std::size_t maxFreeBuffersPerSize{16};
+  };
+
+  struct Statistics
+  {
+    uint64_t    poolHits{};
+    uint64_t    poolMisses{};
+    std::size_t allocatedBytes{};
+    std::size_t peakAllocatedBytes{};
+    std::size_t bytesInUse{};
+    std::size_t peakBytesInUse{};
+    std::size_t buffersInUse{};
+  };
+
+  struct Buffer;
+
+  FrameBufferPool();
+  FrameBufferPool(const Settings settings);
+  FrameBufferPool(const FrameBufferPool &)            = delete;
+  FrameBufferPool &operator=(const FrameBufferPool &) = delete;
+  ~FrameBufferPool();
+
+  // Get a buffer of at least the given size. Returns nullptr if allocation failed.
+  [[nodiscard]] Buffer *acquireBuffer(const std::size_t size);
+
+  // Give a buffer back to the pool it was acquired from. Thread safe.
+  static void releaseBuffer(Buffer *buffer);
+
+  [[nodiscard]] static uint8_t    *getData(const Buffer *buffer);
+  [[nodiscard]] static std::size_t getSize(const Buffer *buffer);
+
+  [[nodiscard]] Statistics getStatistics() const;
+  [[nodiscard]] Settings   getSettings() const;
+
+  struct PoolState;
+
+private:
+  std::shared_ptr<PoolState> state;
+};
+
+} // namespace libffmpeg::avcodec
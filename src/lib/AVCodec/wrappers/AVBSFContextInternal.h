@@ -0,0 +1,57 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/InternalTypes.h>
+
+namespace libffmpeg::internal::avcodec
+{
+
+/* In avcodec version 56, this struct does not exist yet (there was only the old
+ * av_bitstream_filter API). This is a dummy class that is just here so that we can use the
+ * generic CAST_AVCODEC_GET_MEMBER and CAST_AVCODEC_SET_MEMBER macros. In reality, we will never
+ * do the cast to this struct.
+ */
+struct AVBSFContext_56
+{
+  AVCodecParameters *par_in{};
+  AVCodecParameters *par_out{};
+  AVRational         time_base_in{};
+  AVRational         time_base_out{};
+};
+
+struct AVBSFContext_57
+{
+  const AVClass           *av_class{};
+  const AVBitStreamFilter *filter{};
+  void                    *internal{};
+  void                    *priv_data{};
+  AVCodecParameters       *par_in{};
+  AVCodecParameters       *par_out{};
+  AVRational               time_base_in{};
+  AVRational               time_base_out{};
+};
+
+using AVBSFContext_58 = AVBSFContext_57;
+
+// The internal pointer was removed
+struct AVBSFContext_59
+{
+  const AVClass           *av_class{};
+  const AVBitStreamFilter *filter{};
+  void                    *priv_data{};
+  AVCodecParameters       *par_in{};
+  AVCodecParameters       *par_out{};
+  AVRational               time_base_in{};
+  AVRational               time_base_out{};
+};
+
+using AVBSFContext_60 = AVBSFContext_59;
+using AVBSFContext_61 = AVBSFContext_59;
+using AVBSFContext_62 = AVBSFContext_59;
+
+} // namespace libffmpeg::internal::avcodec
@@ -184,6 +184,29 @@ std::vector<ChannelLayout> maskArrayToChannelLayouts(const uint64_t *masks)
   return layouts;
 }
 
+std::optional<uint64_t> channelLayoutToBitMask(const ChannelLayout &layout)
+{
+  constexpr auto MAX_CHANNELS = 64;
+
+  uint64_t mask{};
+  for (const auto &channelInfo : layout)
+  {
+    if (!channelInfo.channel || channelInfo.ambisonicIndex)
+      return {};
+
+    int bitPosition = 0;
+    while (bitPosition < MAX_CHANNELS &&
+           avChannelToChannel(static_cast<AVChannel>(bitPosition)) != channelInfo.channel)
+      ++bitPosition;
+
+    if (bitPosition == MAX_CHANNELS)
+      return {};
+    mask |= (uint64_t(1) << bitPosition);
+  }
+
+  return mask;
+}
+
 ChannelLayout avChannelLayoutToChannelLayout(const AVChannelLayout &avLayout)
 {
   if (avLayout.order == AVChannelOrder::AV_CHANNEL_ORDER_UNSPEC)
@@ -89,6 +89,10 @@ using libffmpeg::avcodec::ChannelLayout;
 ChannelLayout bitMaskToChannelLayout(const uint64_t mask, const bool isAmbisonic = false);
 std::vector<ChannelLayout> maskArrayToChannelLayouts(const uint64_t *masks);
 
+// The inverse of bitMaskToChannelLayout. Returns nothing if one of the channels can not be
+// represented in a bit mask (e.g. unknown or ambisonic channels).
+std::optional<uint64_t> channelLayoutToBitMask(const ChannelLayout &layout);
+
 ChannelLayout              avChannelLayoutToChannelLayout(const AVChannelLayout &avLayout);
 std::vector<ChannelLayout> avChannelLayoutListToChannelLayouts(const AVChannelLayout *layoutList);
 
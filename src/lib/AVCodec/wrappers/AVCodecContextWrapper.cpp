@@ -11,7 +11,11 @@
 #include <common/InternalTypes.h>
 
 #include "AVCodecContextWrapperInternal.h"
+#include "AVCodecWrapper.h"
 #include "CastCodecClasses.h"
+#include "FrameBufferAllocator.h"
+
+#include <algorithm>
 
 namespace libffmpeg::avcodec
 {
@@ -31,10 +35,12 @@ using libffmpeg::internal::avcodec::AVCodecContext_60;
 using libffmpeg::internal::avcodec::AVCodecContext_61;
 using libffmpeg::internal::avcodec::AVCodecContext_62;
 
-namespace internal
+namespace
 {
 
-} // namespace internal
+constexpr auto AV_CODEC_CAP_DR1 = (1 << 1);
+
+} // namespace
 
 AVCodecContextWrapper::AVCodecContextWrapper(AVCodecContext                   *codecContext,
                                              std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
@@ -59,6 +65,10 @@ AVCodecContextWrapper::operator=(AVCodecContextWrapper &&codecContextWrapper) no
   this->codecContext               = codecContextWrapper.codecContext;
   this->codecContextOwnership      = codecContextWrapper.codecContextOwnership;
   codecContextWrapper.codecContext = nullptr;
+  this->skipSettings               = codecContextWrapper.skipSettings;
+  this->lowres                     = codecContextWrapper.lowres;
+  this->frameBufferPool            = std::move(codecContextWrapper.frameBufferPool);
+  this->frameBufferAllocator       = std::move(codecContextWrapper.frameBufferAllocator);
   this->ffmpegLibraries            = std::move(codecContextWrapper.ffmpegLibraries);
   return *this;
 }
@@ -66,6 +76,9 @@ AVCodecContextWrapper::operator=(AVCodecContextWrapper &&codecContextWrapper) no
 AVCodecContextWrapper::AVCodecContextWrapper(AVCodecContextWrapper &&codecContextWrapper) noexcept
     : codecContext(codecContextWrapper.codecContext),
       codecContextOwnership(codecContextWrapper.codecContextOwnership),
+      skipSettings(codecContextWrapper.skipSettings), lowres(codecContextWrapper.lowres),
+      frameBufferPool(std::move(codecContextWrapper.frameBufferPool)),
+      frameBufferAllocator(std::move(codecContextWrapper.frameBufferAllocator)),
       ffmpegLibraries(std::move(codecContextWrapper.ffmpegLibraries))
 {
 }
@@ -95,12 +108,8 @@ bool AVCodecContextWrapper::openContextForDecoding(
   if (ret < 0)
     return false;
 
-  AVDictionary *dictionary = nullptr;
-  ret = ffmpegLibraries->avcodec.avcodec_open2(this->codecContext, decoderCodec, &dictionary);
-  if (ret < 0)
-    return false;
-
-  return true;
+  this->installFrameBufferAllocator(decoderCodec);
+  return this->openCodec(decoderCodec);
 }
 
 bool AVCodecContextWrapper::openContextForDecoding()
@@ -112,13 +121,108 @@ bool AVCodecContextWrapper::openContextForDecoding()
   if (decoderCodec == nullptr)
     return false;
 
-  AVDictionary *dictionary = nullptr;
-  const auto    ret =
-      ffmpegLibraries->avcodec.avcodec_open2(this->codecContext, decoderCodec, &dictionary);
-  if (ret < 0)
+  this->installFrameBufferAllocator(decoderCodec);
+  return this->openCodec(decoderCodec);
+}
+
+bool AVCodecContextWrapper::openContextForDecoding(const libffmpeg::internal::AVCodecID codecID)
+{
+  const auto decoderCodec = ffmpegLibraries->avcodec.avcodec_find_decoder(codecID);
+  if (decoderCodec == nullptr)
+    return false;
+
+  this->codecContext = ffmpegLibraries->avcodec.avcodec_alloc_context3(decoderCodec);
+  if (this->codecContext == nullptr)
     return false;
 
-  return true;
+  this->codecContextOwnership = true;
+
+  this->installFrameBufferAllocator(decoderCodec);
+  return this->openCodec(decoderCodec);
+}
+
+void AVCodecContextWrapper::setSkipSettings(const SkipSettings skipSettings)
+{
+  this->skipSettings = skipSettings;
+}
+
+void AVCodecContextWrapper::setLowres(const int lowres)
+{
+  if (lowres < 0)
+    throw std::runtime_error("The lowres value must not be negative");
+  this->lowres = lowres;
+}
+
+bool AVCodecContextWrapper::openCodec(libffmpeg::internal::AVCodec *codec)
+{
+  // The skip values are not part of the AVCodecContext structs that we mirror. We pass them as
+  // options to avcodec_open2 instead.
+  AVDictionary *dictionary = nullptr;
+
+  const auto setOption = [this, &dictionary](const char *key, const Discard discard)
+  {
+    if (discard != Discard::Default)
+      this->ffmpegLibraries->avutil.av_dict_set(
+          &dictionary, key, DiscardMapper.getName(discard).c_str(), 0);
+  };
+  setOption("skip_frame", this->skipSettings.skipFrame);
+  setOption("skip_loop_filter", this->skipSettings.skipLoopFilter);
+  setOption("skip_idct", this->skipSettings.skipIDCT);
+
+  if (this->lowres > 0)
+  {
+    const int maxLowres = AVCodecWrapper(codec, this->ffmpegLibraries).getMaxLowres();
+    const int lowres    = std::min(this->lowres, maxLowres);
+    if (lowres < this->lowres)
+      this->ffmpegLibraries->log(LogLevel::Info,
+                                 "Decoder only supports lowres up to " + std::to_string(maxLowres));
+    if (lowres > 0)
+      this->ffmpegLibraries->avutil.av_dict_set(
+          &dictionary, "lowres", std::to_string(lowres).c_str(), 0);
+  }
+
+  const auto ret =
+      this->ffmpegLibraries->avcodec.avcodec_open2(this->codecContext, codec, &dictionary);
+
+  // All options that were consumed are removed from the dictionary
+  if (dictionary != nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Warning, "Not all decoder options could be applied");
+    this->ffmpegLibraries->avutil.av_dict_free(&dictionary);
+  }
+
+  return ret >= 0;
+}
+
+void AVCodecContextWrapper::setFrameBufferPool(std::shared_ptr<FrameBufferPool> pool)
+{
+  this->frameBufferPool = pool;
+}
+
+void AVCodecContextWrapper::installFrameBufferAllocator(libffmpeg::internal::AVCodec *codec)
+{
+  if (!this->frameBufferPool)
+    return;
+
+  const auto codecWrapper = AVCodecWrapper(codec, this->ffmpegLibraries);
+  if ((codecWrapper.getCapabilities() & AV_CODEC_CAP_DR1) == 0)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Info, "Decoder does not support custom frame buffers. Not using the pool.");
+    return;
+  }
+
+  if (!FrameBufferAllocator::isSupported(this->codecContext, this->ffmpegLibraries))
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Warning,
+        "Custom frame buffers are not supported with the loaded FFmpeg version. Not using the pool.");
+    return;
+  }
+
+  this->frameBufferAllocator =
+      std::make_unique<FrameBufferAllocator>(this->frameBufferPool, this->ffmpegLibraries);
+  this->frameBufferAllocator->installInCodecContext(this->codecContext);
 }
 
 ReturnCode AVCodecContextWrapper::sendPacket(const avcodec::AVPacketWrapper &packet)
@@ -135,18 +239,28 @@ ReturnCode AVCodecContextWrapper::sendFlushPacket()
   return toReturnCode(avReturnCode);
 }
 
+void AVCodecContextWrapper::flushBuffers()
+{
+  this->ffmpegLibraries->avcodec.avcodec_flush_buffers(this->codecContext);
+}
+
 AVCodecContextWrapper::DecodeResult AVCodecContextWrapper::revieveFrame()
 {
   DecodeResult result;
 
   result.frame.emplace(this->ffmpegLibraries);
-  const auto avReturnCode = this->ffmpegLibraries->avcodec.avcodec_receive_frame(
-      this->codecContext, result.frame->getFrame());
-  result.returnCode = toReturnCode(avReturnCode);
+  result.returnCode = this->revieveFrame(*result.frame);
 
   return result;
 }
 
+ReturnCode AVCodecContextWrapper::revieveFrame(avutil::AVFrameWrapper &frame)
+{
+  const auto avReturnCode =
+      this->ffmpegLibraries->avcodec.avcodec_receive_frame(this->codecContext, frame.getFrame());
+  return toReturnCode(avReturnCode);
+}
+
 AVCodecContextWrapper::DecodeResult
 AVCodecContextWrapper::decodeVideo2(const avcodec::AVPacketWrapper &packet)
 {
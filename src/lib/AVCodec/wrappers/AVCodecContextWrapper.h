@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AVCodec/Discard.h>
+#include <AVCodec/FrameBufferPool.h>
 #include <AVCodec/wrappers/AVCodecParametersWrapper.h>
 #include <AVCodec/wrappers/AVPacketWrapper.h>
 #include <AVUtil/ColorSpace.h>
@@ -18,6 +20,8 @@
 namespace libffmpeg::avcodec
 {
 
+class FrameBufferAllocator;
+
 class AVCodecContextWrapper
 {
 public:
@@ -34,15 +38,48 @@ public:
   bool openContextForDecoding(const avcodec::AVCodecParametersWrapper &codecParameters);
   bool openContextForDecoding();
 
+  // Open a decoder without codec parameters (e.g. for elementary streams that were split by a
+  // parser). All codec configuration (like the parameter sets) must then be part of the
+  // bitstream.
+  bool openContextForDecoding(const libffmpeg::internal::AVCodecID codecID);
+
+  // Use the given pool for the video frame buffers of the decoder. Must be set before the context
+  // is opened. This is only supported for FFmpeg 5 and newer. For older versions (or if the
+  // decoder does not support custom buffers) the default FFmpeg allocator is used.
+  void setFrameBufferPool(std::shared_ptr<FrameBufferPool> pool);
+
+  // Which frames the decoder skips entirely (skip_frame) and for which frames the loop filter
+  // (skip_loop_filter) and the IDCT (skip_idct) are skipped. Must be set before the context is
+  // opened.
+  struct SkipSettings
+  {
+    Discard skipFrame{Discard::Default};
+    Discard skipLoopFilter{Discard::Default};
+    Discard skipIDCT{Discard::Default};
+  };
+  void setSkipSettings(const SkipSettings skipSettings);
+
+  // Decode at a reduced resolution (1: half, 2: quarter, 3: eighth) if the decoder supports it
+  // (see AVCodecWrapper::getMaxLowres). The value is limited to what the decoder supports. Must be
+  // set before the context is opened.
+  void setLowres(const int lowres);
+
   ReturnCode sendPacket(const avcodec::AVPacketWrapper &packet);
   ReturnCode sendFlushPacket();
 
+  // Reset the internal decoder state (avcodec_flush_buffers). All buffered frames are dropped
+  // and the decoder can be used again after it was drained.
+  void flushBuffers();
+
   struct DecodeResult
   {
     std::optional<avutil::AVFrameWrapper> frame{};
     ReturnCode                            returnCode{};
   };
   DecodeResult revieveFrame();
+  // Receive the next frame into an existing frame. avcodec_receive_frame unreferences the frame
+  // first, so the same frame can be used for every call.
+  ReturnCode revieveFrame(avutil::AVFrameWrapper &frame);
 
   // This is the old FFMpeg 2 interface before pushPacket/pullFrame.
   DecodeResult decodeVideo2(const avcodec::AVPacketWrapper &packet);
@@ -65,6 +102,15 @@ private:
   libffmpeg::internal::AVCodecContext *codecContext{};
   bool                                 codecContextOwnership{};
 
+  void installFrameBufferAllocator(libffmpeg::internal::AVCodec *codec);
+  bool openCodec(libffmpeg::internal::AVCodec *codec);
+
+  SkipSettings skipSettings{};
+  int          lowres{};
+
+  std::shared_ptr<FrameBufferPool>      frameBufferPool{};
+  std::unique_ptr<FrameBufferAllocator> frameBufferAllocator{};
+
   std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
 };
 
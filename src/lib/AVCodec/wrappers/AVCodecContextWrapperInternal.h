@@ -8,6 +8,8 @@
 
 #include <common/InternalTypes.h>
 
+#include "AVChannelInternal.h"
+
 namespace libffmpeg::internal::avcodec
 {
 
@@ -382,6 +384,19 @@ struct AVCodecContext_59
   AVColorRange                  color_range{};
   AVChromaLocation              chroma_sample_location{};
   int                           slices{};
+  AVFieldOrder                  field_order{};
+  int                           sample_rate{};
+  int                           channels{}; // Deprecated
+  AVSampleFormat                sample_fmt{};
+  int                           frame_size{};
+  int                           frame_number{}; // Deprecated
+  int                           block_align{};
+  int                           cutoff{};
+  uint64_t                      channel_layout{};         // Deprecated
+  uint64_t                      request_channel_layout{}; // Deprecated
+  int                           audio_service_type{};
+  AVSampleFormat                request_sample_fmt{};
+  int (*get_buffer2)(AVCodecContext *s, AVFrame *frame, int flags){};
 
   // Actually, there is more here, but the variables above are the only we need.
 };
@@ -446,6 +461,51 @@ struct AVCodecContext_61
                           int                    type,
                           int                    height){};
   enum AVPixelFormat (*get_format)(struct AVCodecContext *s, const enum AVPixelFormat *fmt){};
+  int             max_b_frames{};
+  float           b_quant_factor{};
+  float           b_quant_offset{};
+  float           i_quant_factor{};
+  float           i_quant_offset{};
+  float           lumi_masking{};
+  float           temporal_cplx_masking{};
+  float           spatial_cplx_masking{};
+  float           p_masking{};
+  float           dark_masking{};
+  int             nsse_weight{};
+  int             me_cmp{};
+  int             me_sub_cmp{};
+  int             mb_cmp{};
+  int             ildct_cmp{};
+  int             dia_size{};
+  int             last_predictor_count{};
+  int             me_pre_cmp{};
+  int             pre_dia_size{};
+  int             me_subpel_quality{};
+  int             me_range{};
+  int             mb_decision{};
+  uint16_t       *intra_matrix{};
+  uint16_t       *inter_matrix{};
+  uint16_t       *chroma_intra_matrix{};
+  int             intra_dc_precision{};
+  int             mb_lmin{};
+  int             mb_lmax{};
+  int             bidir_refine{};
+  int             keyint_min{};
+  int             gop_size{};
+  int             mv0_threshold{};
+  int             slices{};
+  int             sample_rate{};
+  AVSampleFormat  sample_fmt{};
+  AVChannelLayout ch_layout{};
+  int             frame_size{};
+  int             block_align{};
+  int             cutoff{};
+  int             audio_service_type{};
+  AVSampleFormat  request_sample_fmt{};
+  int             initial_padding{};
+  int             trailing_padding{};
+  int             seek_preroll{};
+  int (*get_buffer2)(struct AVCodecContext *s, AVFrame *frame, int flags){};
 
   // Actually, there is more here, but the variables above are the only we need.
 };
@@ -507,6 +567,51 @@ struct AVCodecContext_62
                           int                    type,
                           int                    height){};
   enum AVPixelFormat (*get_format)(struct AVCodecContext *s, const enum AVPixelFormat *fmt){};
+  int             max_b_frames{};
+  float           b_quant_factor{};
+  float           b_quant_offset{};
+  float           i_quant_factor{};
+  float           i_quant_offset{};
+  float           lumi_masking{};
+  float           temporal_cplx_masking{};
+  float           spatial_cplx_masking{};
+  float           p_masking{};
+  float           dark_masking{};
+  int             nsse_weight{};
+  int             me_cmp{};
+  int             me_sub_cmp{};
+  int             mb_cmp{};
+  int             ildct_cmp{};
+  int             dia_size{};
+  int             last_predictor_count{};
+  int             me_pre_cmp{};
+  int             pre_dia_size{};
+  int             me_subpel_quality{};
+  int             me_range{};
+  int             mb_decision{};
+  uint16_t       *intra_matrix{};
+  uint16_t       *inter_matrix{};
+  uint16_t       *chroma_intra_matrix{};
+  int             intra_dc_precision{};
+  int             mb_lmin{};
+  int             mb_lmax{};
+  int             bidir_refine{};
+  int             keyint_min{};
+  int             gop_size{};
+  int             mv0_threshold{};
+  int             slices{};
+  int             sample_rate{};
+  AVSampleFormat  sample_fmt{};
+  AVChannelLayout ch_layout{};
+  int             frame_size{};
+  int             block_align{};
+  int             cutoff{};
+  int             audio_service_type{};
+  AVSampleFormat  request_sample_fmt{};
+  int             initial_padding{};
+  int             trailing_padding{};
+  int             seek_preroll{};
+  int (*get_buffer2)(struct AVCodecContext *s, AVFrame *frame, int flags){};
 
   // Actually, there is more here, but the variables above are the only we need.
 };
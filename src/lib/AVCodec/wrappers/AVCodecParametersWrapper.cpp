@@ -159,6 +159,52 @@ ChannelLayout AVCodecParametersWrapper::getChannelLayout() const
   throw std::runtime_error("Invalid library version");
 }
 
+int AVCodecParametersWrapper::getSampleRate() const
+{
+  RETURN_IF_VERSION_TOO_OLD({});
+
+  int sampleRate{};
+  CAST_AVCODEC_GET_MEMBER(AVCodecParameters, this->codecParameters, sampleRate, sample_rate);
+  return sampleRate;
+}
+
+int AVCodecParametersWrapper::getBlockAlign() const
+{
+  RETURN_IF_VERSION_TOO_OLD({});
+
+  int blockAlign{};
+  CAST_AVCODEC_GET_MEMBER(AVCodecParameters, this->codecParameters, blockAlign, block_align);
+  return blockAlign;
+}
+
+int AVCodecParametersWrapper::getBitsPerCodedSample() const
+{
+  RETURN_IF_VERSION_TOO_OLD({});
+
+  int bitsPerCodedSample{};
+  CAST_AVCODEC_GET_MEMBER(
+      AVCodecParameters, this->codecParameters, bitsPerCodedSample, bits_per_coded_sample);
+  return bitsPerCodedSample;
+}
+
+int AVCodecParametersWrapper::getProfile() const
+{
+  RETURN_IF_VERSION_TOO_OLD({});
+
+  int profile{};
+  CAST_AVCODEC_GET_MEMBER(AVCodecParameters, this->codecParameters, profile, profile);
+  return profile;
+}
+
+uint32_t AVCodecParametersWrapper::getCodecTag() const
+{
+  RETURN_IF_VERSION_TOO_OLD({});
+
+  uint32_t codecTag{};
+  CAST_AVCODEC_GET_MEMBER(AVCodecParameters, this->codecParameters, codecTag, codec_tag);
+  return codecTag;
+}
+
 void AVCodecParametersWrapper::setClearValues()
 {
   const auto version = this->ffmpegLibraries->getLibrariesVersion().avformat.major;
@@ -241,6 +287,11 @@ void AVCodecParametersWrapper::setAVCodecID(AVCodecID id)
   CAST_AVCODEC_SET_MEMBER(AVCodecParameters, this->codecParameters, codec_id, id);
 }
 
+void AVCodecParametersWrapper::setCodecTag(uint32_t codecTag)
+{
+  CAST_AVCODEC_SET_MEMBER(AVCodecParameters, this->codecParameters, codec_tag, codecTag);
+}
+
 void AVCodecParametersWrapper::setExtradata(const ByteVector &data)
 {
   uint8_t   *extradata{};
@@ -291,4 +342,9 @@ void AVCodecParametersWrapper::setSampleAspectRatio(int num, int den)
   CAST_AVCODEC_SET_MEMBER(AVCodecParameters, this->codecParameters, sample_aspect_ratio, ratio);
 }
 
+void AVCodecParametersWrapper::setSampleRate(int sampleRate)
+{
+  CAST_AVCODEC_SET_MEMBER(AVCodecParameters, this->codecParameters, sample_rate, sampleRate);
+}
+
 } // namespace libffmpeg::avcodec
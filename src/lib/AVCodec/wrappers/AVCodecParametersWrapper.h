@@ -32,6 +32,11 @@ public:
   [[nodiscard]] avutil::PixelFormatDescriptor  getPixelFormat() const;
   [[nodiscard]] Rational                       getSampleAspectRatio() const;
   [[nodiscard]] ChannelLayout                  getChannelLayout() const;
+  [[nodiscard]] int                            getSampleRate() const;
+  [[nodiscard]] int                            getBlockAlign() const;
+  [[nodiscard]] int                            getBitsPerCodedSample() const;
+  [[nodiscard]] int                            getProfile() const;
+  [[nodiscard]] uint32_t                       getCodecTag() const;
 
   // Set a default set of (unknown) values
   void setClearValues();
@@ -43,6 +48,11 @@ public:
   void setAVPixelFormat(avutil::PixelFormatDescriptor descriptor);
   void setProfileLevel(int profile, int level);
   void setSampleAspectRatio(int num, int den);
+  void setSampleRate(int sampleRate);
+
+  // The codec tag (fourcc) is container specific. Reset it to 0 when copying the parameters to a
+  // different container.
+  void setCodecTag(uint32_t codecTag);
 
   [[nodiscard]] libffmpeg::internal::AVCodecParameters *getCodecParameters() const
   {
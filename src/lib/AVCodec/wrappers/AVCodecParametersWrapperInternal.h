@@ -22,15 +22,19 @@ struct AVCodecParameters_56
 {
   AVMediaType  codec_type{};
   AVCodecID    codec_id{};
+  uint32_t     codec_tag{};
   uint8_t     *extradata{};
   int          extradata_size{};
   int          format{};
+  int          bits_per_coded_sample{};
   int          profile{};
   int          level{};
   int          width{};
   int          height{};
   AVRational   sample_aspect_ratio{};
   AVColorSpace color_space{};
+  int          sample_rate{};
+  int          block_align{};
 };
 
 struct AVCodecParameters_57
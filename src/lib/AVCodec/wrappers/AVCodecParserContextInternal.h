@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/InternalTypes.h>
+
+namespace libffmpeg::internal::avcodec
+{
+
+constexpr auto AV_PARSER_PTS_NB = 4;
+
+// AVCodecParserContext is part of the public API. We only mirror the members up to the position
+// of the frame which is all that we need.
+struct AVCodecParserContext_56
+{
+  void   *priv_data{};
+  void   *parser{};
+  int64_t frame_offset{};
+  int64_t cur_offset{};
+  int64_t next_frame_offset{};
+  int     pict_type{};
+  int     repeat_pict{};
+  int64_t pts{};
+  int64_t dts{};
+  int64_t last_pts{};
+  int64_t last_dts{};
+  int     fetch_timestamp{};
+  int     cur_frame_start_index{};
+  int64_t cur_frame_offset[AV_PARSER_PTS_NB]{};
+  int64_t cur_frame_pts[AV_PARSER_PTS_NB]{};
+  int64_t cur_frame_dts[AV_PARSER_PTS_NB]{};
+  int     flags{};
+  int64_t offset{};
+  int64_t cur_frame_end[AV_PARSER_PTS_NB]{};
+  int     key_frame{};
+  int64_t convergence_duration{};
+  int     dts_sync_point{};
+  int     dts_ref_dts_delta{};
+  int     pts_dts_delta{};
+  int64_t cur_frame_pos[AV_PARSER_PTS_NB]{};
+  int64_t pos{};
+};
+
+using AVCodecParserContext_57 = AVCodecParserContext_56;
+using AVCodecParserContext_58 = AVCodecParserContext_56;
+
+// The deprecated convergence_duration was removed
+struct AVCodecParserContext_59
+{
+  void   *priv_data{};
+  void   *parser{};
+  int64_t frame_offset{};
+  int64_t cur_offset{};
+  int64_t next_frame_offset{};
+  int     pict_type{};
+  int     repeat_pict{};
+  int64_t pts{};
+  int64_t dts{};
+  int64_t last_pts{};
+  int64_t last_dts{};
+  int     fetch_timestamp{};
+  int     cur_frame_start_index{};
+  int64_t cur_frame_offset[AV_PARSER_PTS_NB]{};
+  int64_t cur_frame_pts[AV_PARSER_PTS_NB]{};
+  int64_t cur_frame_dts[AV_PARSER_PTS_NB]{};
+  int     flags{};
+  int64_t offset{};
+  int64_t cur_frame_end[AV_PARSER_PTS_NB]{};
+  int     key_frame{};
+  int     dts_sync_point{};
+  int     dts_ref_dts_delta{};
+  int     pts_dts_delta{};
+  int64_t cur_frame_pos[AV_PARSER_PTS_NB]{};
+  int64_t pos{};
+};
+
+using AVCodecParserContext_60 = AVCodecParserContext_59;
+using AVCodecParserContext_61 = AVCodecParserContext_59;
+using AVCodecParserContext_62 = AVCodecParserContext_59;
+
+} // namespace libffmpeg::internal::avcodec
@@ -6,6 +6,7 @@
 
 #include "AVPacketWrapper.h"
 
+#include <common/Checksum.h>
 #include <common/Functions.h>
 #include <common/InternalTypes.h>
 
@@ -43,7 +44,7 @@ AVPacketWrapper::AVPacketWrapper(std::shared_ptr<IFFmpegLibraries> ffmpegLibrari
   this->allocateNewPacket();
 }
 
-AVPacketWrapper::AVPacketWrapper(const ByteVector                 &data,
+AVPacketWrapper::AVPacketWrapper(std::span<const std::byte>        data,
                                  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
     : ffmpegLibraries(ffmpegLibraries)
 {
@@ -53,7 +54,7 @@ AVPacketWrapper::AVPacketWrapper(const ByteVector                 &data,
 
   const auto ret = this->ffmpegLibraries->avcodec.av_new_packet(this->packet.get(),
                                                                 static_cast<int>(data.size()));
-  if (ret > 0)
+  if (ret < 0)
     throw std::runtime_error("Error calling av_new_packet");
 
   uint8_t *dataPointer{};
@@ -83,6 +84,29 @@ void AVPacketWrapper::setTimestamps(const int64_t dts, const int64_t pts)
   CAST_AVCODEC_SET_MEMBER(AVPacket, this->packet.get(), pts, pts);
 }
 
+void AVPacketWrapper::setFlags(const Flags flags)
+{
+  int flagsAsInt{};
+  if (flags.keyframe)
+    flagsAsInt |= AV_PKT_FLAG_KEY;
+  if (flags.corrupt)
+    flagsAsInt |= AV_PKT_FLAG_CORRUPT;
+  if (flags.discard)
+    flagsAsInt |= AV_PKT_FLAG_DISCARD;
+
+  CAST_AVCODEC_SET_MEMBER(AVPacket, this->packet.get(), flags, flagsAsInt);
+}
+
+void AVPacketWrapper::setStreamIndex(const int streamIndex)
+{
+  CAST_AVCODEC_SET_MEMBER(AVPacket, this->packet.get(), stream_index, streamIndex);
+}
+
+void AVPacketWrapper::setPosition(const int64_t position)
+{
+  CAST_AVCODEC_SET_MEMBER(AVPacket, this->packet.get(), pos, position);
+}
+
 int AVPacketWrapper::getStreamIndex() const
 {
   int index{};
@@ -149,6 +173,44 @@ ByteVector AVPacketWrapper::getData() const
   return copyDataFromRawArray(data, dataSize);
 }
 
+std::span<const std::byte> AVPacketWrapper::getDataView() const
+{
+  uint8_t *data{};
+  CAST_AVCODEC_GET_MEMBER(AVPacket, this->packet.get(), data, data);
+
+  int dataSize{};
+  CAST_AVCODEC_GET_MEMBER(AVPacket, this->packet.get(), dataSize, size);
+
+  if (data == nullptr || dataSize <= 0)
+    return {};
+  return {reinterpret_cast<const std::byte *>(data), static_cast<std::size_t>(dataSize)};
+}
+
+uint32_t AVPacketWrapper::calculateCRC32C() const
+{
+  return libffmpeg::calculateCRC32C(this->getDataView());
+}
+
+void AVPacketWrapper::setMemoryReservation(MemoryBudget::Reservation &&reservation)
+{
+  this->memoryReservation = std::move(reservation);
+}
+
+void AVPacketWrapper::unref()
+{
+  this->memoryReservation = {};
+  if (!this->packet)
+    return;
+
+  if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major == 56)
+  {
+    this->ffmpegLibraries->avcodec.av_free_packet(this->packet.get());
+    this->ffmpegLibraries->avcodec.av_init_packet(this->packet.get());
+  }
+  else
+    this->ffmpegLibraries->avcodec.av_packet_unref(this->packet.get());
+}
+
 void AVPacketWrapper::allocateNewPacket()
 {
   if (ffmpegLibraries->getLibrariesVersion().avcodec.major == 56)
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <common/MemoryBudget.h>
 #include <libHandling/IFFmpegLibraries.h>
 
 #include <memory>
+#include <span>
 
 namespace libffmpeg::avcodec
 {
@@ -22,13 +24,17 @@ public:
   AVPacketWrapper(AVPacketWrapper &&packet) noexcept      = default;
   AVPacketWrapper &operator=(AVPacketWrapper &&) noexcept = default;
   AVPacketWrapper(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
-  AVPacketWrapper(const ByteVector &data, std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+  AVPacketWrapper(std::span<const std::byte>        data,
+                  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
   ~AVPacketWrapper() = default;
 
   // Todo: Needs to be tested
   [[nodiscard]] std::optional<AVPacketWrapper> clone() const;
 
   void setTimestamps(const int64_t dts, const int64_t pts);
+  void setStreamIndex(const int streamIndex);
+  // The byte position of the packet in the input. Set to -1 if unknown.
+  void setPosition(const int64_t position);
 
   [[nodiscard]] libffmpeg::internal::AVPacket *getPacket() const { return this->packet.get(); }
 
@@ -39,6 +45,8 @@ public:
     bool discard{};
   };
 
+  void setFlags(const Flags flags);
+
   [[nodiscard]] int                    getStreamIndex() const;
   [[nodiscard]] std::optional<int64_t> getPTS() const;
   [[nodiscard]] int64_t                getDTS() const;
@@ -47,6 +55,18 @@ public:
   [[nodiscard]] int                    getDataSize() const;
   [[nodiscard]] ByteVector             getData() const;
 
+  // Read only access to the data without copying it. The span is valid as long as the packet
+  // exists and is not modified.
+  [[nodiscard]] std::span<const std::byte> getDataView() const;
+  [[nodiscard]] uint32_t                   calculateCRC32C() const;
+
+  // The reserved bytes are released when the packet is destroyed.
+  void setMemoryReservation(MemoryBudget::Reservation &&reservation);
+
+  // Free the data of the packet and reset all fields so that the packet can be reused
+  // (e.g. to read the next packet into it). The memory reservation is released.
+  void unref();
+
   explicit operator bool() const { return this->packet != nullptr; };
 
 private:
@@ -64,6 +84,9 @@ private:
     std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
   };
 
+  // Declared first so that it is released after the packet was freed.
+  MemoryBudget::Reservation memoryReservation{};
+
   std::unique_ptr<libffmpeg::internal::AVPacket, AVPacketDeleter> packet{nullptr,
                                                                          AVPacketDeleter()};
   std::shared_ptr<IFFmpegLibraries>                               ffmpegLibraries{};
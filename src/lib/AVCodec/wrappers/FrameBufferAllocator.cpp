@@ -0,0 +1,282 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "FrameBufferAllocator.h"
+
+#include <AVUtil/wrappers/AVFrameWrapperInternal.h>
+#include <AVUtil/wrappers/AVPixFmtDescriptorConversion.h>
+
+#include "AVCodecContextWrapperInternal.h"
+
+#include <cerrno>
+#include <cstddef>
+
+namespace libffmpeg::avcodec
+{
+
+using libffmpeg::internal::AVBufferRef;
+using libffmpeg::internal::AVCodecContext;
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVMediaType;
+using libffmpeg::internal::AVPixelFormat;
+using libffmpeg::internal::avcodec::AVCodecContext_59;
+using libffmpeg::internal::avcodec::AVCodecContext_61;
+using libffmpeg::internal::avcodec::AVCodecContext_62;
+using libffmpeg::internal::avutil::AVFrame_57;
+using libffmpeg::internal::avutil::AVFrame_59;
+using libffmpeg::internal::avutil::AVFrame_60;
+
+namespace
+{
+
+// The first members of the AVOption struct. We only need the offset.
+struct AVOptionHeader
+{
+  const char *name{};
+  const char *help{};
+  int         offset{};
+};
+
+// Extra bytes after the last plane. FFmpeg adds the same amount in the default allocator because
+// some SIMD functions read past the end of the lines.
+constexpr std::size_t BUFFER_PADDING = 16 + 64;
+
+constexpr auto AVERROR_ENOMEM = -ENOMEM;
+
+std::size_t offsetOfRequestSampleFormat(const int avcodecMajorVersion)
+{
+  if (avcodecMajorVersion == 59 || avcodecMajorVersion == 60)
+    return offsetof(AVCodecContext_59, request_sample_fmt);
+  if (avcodecMajorVersion == 61)
+    return offsetof(AVCodecContext_61, request_sample_fmt);
+  if (avcodecMajorVersion == 62)
+    return offsetof(AVCodecContext_62, request_sample_fmt);
+  return 0;
+}
+
+template <typename AVCodecContextType>
+void setGetBuffer2(AVCodecContext *codecContext,
+                   void           *opaque,
+                   int (*getBuffer2)(AVCodecContext *, AVFrame *, int))
+{
+  auto context         = reinterpret_cast<AVCodecContextType *>(codecContext);
+  context->opaque      = opaque;
+  context->get_buffer2 = getBuffer2;
+}
+
+template <typename AVFrameType> struct FrameParameters
+{
+  static void get(AVFrame *frame, int &width, int &height, int &format)
+  {
+    const auto f = reinterpret_cast<AVFrameType *>(frame);
+    width        = f->width;
+    height       = f->height;
+    format       = f->format;
+  }
+
+  static void set(AVFrame *frame, uint8_t *data[4], const int linesize[4], AVBufferRef *buffer)
+  {
+    const auto f = reinterpret_cast<AVFrameType *>(frame);
+    for (int i = 0; i < 4; ++i)
+    {
+      f->data[i]     = data[i];
+      f->linesize[i] = linesize[i];
+    }
+    f->extended_data = f->data;
+    f->buf[0]        = buffer;
+  }
+};
+
+} // namespace
+
+FrameBufferAllocator::FrameBufferAllocator(std::shared_ptr<FrameBufferPool>  pool,
+                                           std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : pool(pool), ffmpegLibraries(ffmpegLibraries)
+{
+  if (!pool)
+    throw std::runtime_error("Provided frame buffer pool must not be null");
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool FrameBufferAllocator::isSupported(AVCodecContext                          *codecContext,
+                                       const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+{
+  // Older versions do not have reference counted buffers in the AVFrame and we do not know
+  // the position of get_buffer2 in the AVCodecContext.
+  const auto version = ffmpegLibraries->getLibrariesVersion();
+  if (version.avcodec.major < 59 || version.avcodec.major > 62)
+    return false;
+  if (version.avutil.major < 57 || version.avutil.major > 60)
+    return false;
+
+  // The AVCodecContext structs only mirror the first members of the real struct. Before we write
+  // into it, check with the AVOption table that the layout matches the loaded library.
+  const auto option = reinterpret_cast<const AVOptionHeader *>(
+      ffmpegLibraries->avutil.av_opt_find(codecContext, "request_sample_fmt", nullptr, 0, 0));
+  if (option == nullptr)
+    return false;
+
+  return static_cast<std::size_t>(option->offset) ==
+         offsetOfRequestSampleFormat(version.avcodec.major);
+}
+
+void FrameBufferAllocator::installInCodecContext(AVCodecContext *codecContext)
+{
+  const auto avcodecMajorVersion = this->ffmpegLibraries->getLibrariesVersion().avcodec.major;
+  if (avcodecMajorVersion == 59 || avcodecMajorVersion == 60)
+    setGetBuffer2<AVCodecContext_59>(codecContext, this, &FrameBufferAllocator::getBuffer2);
+  else if (avcodecMajorVersion == 61)
+    setGetBuffer2<AVCodecContext_61>(codecContext, this, &FrameBufferAllocator::getBuffer2);
+  else if (avcodecMajorVersion == 62)
+    setGetBuffer2<AVCodecContext_62>(codecContext, this, &FrameBufferAllocator::getBuffer2);
+  else
+    throw std::runtime_error("Invalid library version");
+}
+
+int FrameBufferAllocator::getBuffer2(AVCodecContext *codecContext, AVFrame *frame, int flags)
+{
+  // The opaque pointer is at the same position in all supported versions of the AVCodecContext.
+  const auto allocator = static_cast<FrameBufferAllocator *>(
+      reinterpret_cast<AVCodecContext_59 *>(codecContext)->opaque);
+  return allocator->allocateFrame(codecContext, frame, flags);
+}
+
+void FrameBufferAllocator::releaseBuffer(void *opaque, uint8_t *)
+{
+  FrameBufferPool::releaseBuffer(static_cast<FrameBufferPool::Buffer *>(opaque));
+}
+
+FrameBufferAllocator::FrameLayout FrameBufferAllocator::getFrameLayout(
+    AVCodecContext *codecContext, const int width, const int height, const int format)
+{
+  const auto key = LayoutKey(width, height, format);
+
+  std::scoped_lock lock(this->layoutCacheMutex);
+  if (const auto it = this->layoutCache.find(key); it != this->layoutCache.end())
+    return it->second;
+
+  FrameLayout layout;
+
+  const auto avPixelFormat = static_cast<AVPixelFormat>(format);
+  const auto descriptor    = avutil::convertAVPixFmtDescriptor(avPixelFormat, this->ffmpegLibraries);
+  if (descriptor.flags.hwAccelerated || descriptor.flags.pallette ||
+      descriptor.flags.pseudoPallette || descriptor.numberOfComponents == 0)
+  {
+    layout.useDefaultAllocator = true;
+    this->layoutCache[key]     = layout;
+    return layout;
+  }
+
+  int alignedWidth  = width;
+  int alignedHeight = height;
+  int linesizeAlign[internal::AV_NUM_DATA_POINTERS]{};
+  this->ffmpegLibraries->avcodec.avcodec_align_dimensions2(
+      codecContext, &alignedWidth, &alignedHeight, linesizeAlign);
+
+  // Same as in the FFmpeg default allocator: Increase the width until all linesizes are aligned.
+  bool unaligned = true;
+  while (unaligned)
+  {
+    if (this->ffmpegLibraries->avutil.av_image_fill_linesizes(
+            layout.linesize, avPixelFormat, alignedWidth) < 0)
+    {
+      layout.useDefaultAllocator = true;
+      break;
+    }
+    alignedWidth += alignedWidth & ~(alignedWidth - 1);
+
+    unaligned = false;
+    for (int i = 0; i < 4; ++i)
+    {
+      const auto alignment =
+          std::max(static_cast<int>(FrameBufferPool::BUFFER_ALIGNMENT), linesizeAlign[i]);
+      if (layout.linesize[i] % alignment != 0)
+        unaligned = true;
+    }
+  }
+
+  if (!layout.useDefaultAllocator)
+  {
+    // With a null pointer, the data pointers are the offsets of the planes in the buffer.
+    uint8_t   *planes[4]{};
+    const auto size = this->ffmpegLibraries->avutil.av_image_fill_pointers(
+        planes, avPixelFormat, alignedHeight, nullptr, layout.linesize);
+    if (size <= 0)
+      layout.useDefaultAllocator = true;
+    else
+    {
+      for (int i = 0; i < 4; ++i)
+        layout.planeOffset[i] = reinterpret_cast<std::uintptr_t>(planes[i]);
+      layout.bufferSize = static_cast<std::size_t>(size) + BUFFER_PADDING;
+    }
+  }
+
+  this->layoutCache[key] = layout;
+  return layout;
+}
+
+int FrameBufferAllocator::allocateFrame(AVCodecContext *codecContext, AVFrame *frame, int flags)
+{
+  AVMediaType codecType{};
+  {
+    const auto avcodecMajorVersion = this->ffmpegLibraries->getLibrariesVersion().avcodec.major;
+    if (avcodecMajorVersion == 59 || avcodecMajorVersion == 60)
+      codecType = reinterpret_cast<AVCodecContext_59 *>(codecContext)->codec_type;
+    else if (avcodecMajorVersion == 61)
+      codecType = reinterpret_cast<AVCodecContext_61 *>(codecContext)->codec_type;
+    else
+      codecType = reinterpret_cast<AVCodecContext_62 *>(codecContext)->codec_type;
+  }
+
+  const auto avutilMajorVersion = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+
+  int width{};
+  int height{};
+  int format{};
+  if (avutilMajorVersion == 57 || avutilMajorVersion == 58)
+    FrameParameters<AVFrame_57>::get(frame, width, height, format);
+  else if (avutilMajorVersion == 59)
+    FrameParameters<AVFrame_59>::get(frame, width, height, format);
+  else
+    FrameParameters<AVFrame_60>::get(frame, width, height, format);
+
+  if (codecType != AVMediaType::AVMEDIA_TYPE_VIDEO || width <= 0 || height <= 0 || format < 0)
+    return this->ffmpegLibraries->avcodec.avcodec_default_get_buffer2(codecContext, frame, flags);
+
+  const auto layout = this->getFrameLayout(codecContext, width, height, format);
+  if (layout.useDefaultAllocator)
+    return this->ffmpegLibraries->avcodec.avcodec_default_get_buffer2(codecContext, frame, flags);
+
+  auto buffer = this->pool->acquireBuffer(layout.bufferSize);
+  if (buffer == nullptr)
+    return AVERROR_ENOMEM;
+
+  const auto bufferData = FrameBufferPool::getData(buffer);
+  auto       bufferRef  = this->ffmpegLibraries->avutil.av_buffer_create(
+      bufferData, layout.bufferSize, &FrameBufferAllocator::releaseBuffer, buffer, 0);
+  if (bufferRef == nullptr)
+  {
+    FrameBufferPool::releaseBuffer(buffer);
+    return AVERROR_ENOMEM;
+  }
+
+  uint8_t *data[4]{};
+  for (int i = 0; i < 4; ++i)
+    if (layout.linesize[i] > 0)
+      data[i] = bufferData + layout.planeOffset[i];
+
+  if (avutilMajorVersion == 57 || avutilMajorVersion == 58)
+    FrameParameters<AVFrame_57>::set(frame, data, layout.linesize, bufferRef);
+  else if (avutilMajorVersion == 59)
+    FrameParameters<AVFrame_59>::set(frame, data, layout.linesize, bufferRef);
+  else
+    FrameParameters<AVFrame_60>::set(frame, data, layout.linesize, bufferRef);
+
+  return 0;
+}
+
+} // namespace libffmpeg::avcodec
@@ -0,0 +1,70 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/FrameBufferPool.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace libffmpeg::avcodec
+{
+
+/* Implementation of the get_buffer2 callback of the AVCodecContext. All planes of a video frame
+ * are placed into one block of memory from the FrameBufferPool. For everything that we can not
+ * handle (audio, hardware or palette formats) the default FFmpeg allocator is used.
+ * The instance is set as the opaque pointer of the codec context so it must not move while the
+ * codec context is in use.
+ */
+class FrameBufferAllocator
+{
+public:
+  FrameBufferAllocator() = delete;
+  FrameBufferAllocator(std::shared_ptr<FrameBufferPool>  pool,
+                       std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+
+  // Check if the get_buffer2 callback can be used with the loaded libraries and the given context.
+  [[nodiscard]] static bool isSupported(libffmpeg::internal::AVCodecContext    *codecContext,
+                                        const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries);
+
+  void installInCodecContext(libffmpeg::internal::AVCodecContext *codecContext);
+
+  [[nodiscard]] std::shared_ptr<FrameBufferPool> getPool() const { return this->pool; }
+
+private:
+  static int  getBuffer2(libffmpeg::internal::AVCodecContext *codecContext,
+                         libffmpeg::internal::AVFrame        *frame,
+                         int                                  flags);
+  static void releaseBuffer(void *opaque, uint8_t *data);
+
+  struct FrameLayout
+  {
+    bool        useDefaultAllocator{};
+    int         linesize[4]{};
+    std::size_t planeOffset[4]{};
+    std::size_t bufferSize{};
+  };
+
+  FrameLayout getFrameLayout(libffmpeg::internal::AVCodecContext *codecContext,
+                             const int                            width,
+                             const int                            height,
+                             const int                            format);
+  int         allocateFrame(libffmpeg::internal::AVCodecContext *codecContext,
+                            libffmpeg::internal::AVFrame        *frame,
+                            int                                  flags);
+
+  using LayoutKey = std::tuple<int, int, int>;
+  std::mutex                       layoutCacheMutex;
+  std::map<LayoutKey, FrameLayout> layoutCache;
+
+  std::shared_ptr<FrameBufferPool>  pool{};
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+};
+
+} // namespace libffmpeg::avcodec
@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "OutputContexts.h"
+
+#include <algorithm>
+
+namespace libffmpeg::avformat
+{
+
+FileOutputContext::FileOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                     const Path                       &path)
+    : AVIOOutputContext(ffmpegLibraries)
+{
+  this->file.open(path, std::ios::binary | std::ios::trunc);
+  if (!this->file.is_open())
+    ffmpegLibraries->log(LogLevel::Error, "Error opening output file " + path.string());
+}
+
+bool FileOutputContext::writeData(const uint8_t *buf, int buf_size)
+{
+  this->file.write(reinterpret_cast<const char *>(buf), buf_size);
+  return this->file.good();
+}
+
+bool FileOutputContext::seek(int64_t offset)
+{
+  this->file.seekp(offset);
+  return this->file.good();
+}
+
+MemoryOutputContext::MemoryOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : AVIOOutputContext(ffmpegLibraries)
+{
+}
+
+bool MemoryOutputContext::writeData(const uint8_t *buf, int buf_size)
+{
+  if (buf_size < 0)
+    return false;
+
+  const auto size = static_cast<std::size_t>(buf_size);
+  if (this->position + size > this->data.size())
+    this->data.resize(this->position + size);
+
+  std::copy_n(reinterpret_cast<const std::byte *>(buf), size, this->data.begin() + this->position);
+  this->position += size;
+  return true;
+}
+
+bool MemoryOutputContext::seek(int64_t offset)
+{
+  if (offset < 0)
+    return false;
+
+  // Seeking beyond the end is allowed. The gap is filled with zeros when writing.
+  this->position = static_cast<std::size_t>(offset);
+  return true;
+}
+
+CallbackOutputContext::CallbackOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                             WriteCallback                     writeCallback)
+    : AVIOOutputContext(ffmpegLibraries, false), writeCallback(std::move(writeCallback))
+{
+  if (!this->writeCallback)
+    throw std::runtime_error("Provided write callback must not be empty");
+}
+
+bool CallbackOutputContext::writeData(const uint8_t *buf, int buf_size)
+{
+  if (buf_size < 0)
+    return false;
+  return this->writeCallback(
+      {reinterpret_cast<const std::byte *>(buf), static_cast<std::size_t>(buf_size)});
+}
+
+} // namespace libffmpeg::avformat
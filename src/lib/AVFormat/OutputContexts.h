@@ -0,0 +1,69 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVFormat/wrappers/AVIOContextWrapper.h>
+#include <common/Types.h>
+
+#include <fstream>
+#include <functional>
+#include <span>
+
+namespace libffmpeg::avformat
+{
+
+// Write the muxed data into a file. The file is created (or truncated) when the context is
+// created.
+class FileOutputContext : public AVIOOutputContext
+{
+public:
+  FileOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const Path &path);
+
+  [[nodiscard]] bool isFileOpen() const { return this->file.is_open(); }
+
+  bool writeData(const uint8_t *buf, int buf_size) override;
+  bool seek(int64_t offset) override;
+
+private:
+  std::ofstream file;
+};
+
+// Collect the muxed data in memory
+class MemoryOutputContext : public AVIOOutputContext
+{
+public:
+  MemoryOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+
+  // All data is only available after the trailer was written
+  [[nodiscard]] const ByteVector &getData() const { return this->data; }
+
+  bool writeData(const uint8_t *buf, int buf_size) override;
+  bool seek(int64_t offset) override;
+
+private:
+  ByteVector  data;
+  std::size_t position{};
+};
+
+// Pass the muxed data on to a callback (e.g. a network socket or a pipe). The output is not
+// seekable so muxers that have to rewrite data at the beginning of the file can not be used.
+class CallbackOutputContext : public AVIOOutputContext
+{
+public:
+  using WriteCallback = std::function<bool(std::span<const std::byte> data)>;
+
+  CallbackOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                        WriteCallback                     writeCallback);
+
+  bool writeData(const uint8_t *buf, int buf_size) override;
+  bool seek(int64_t) override { return false; }
+
+private:
+  WriteCallback writeCallback;
+};
+
+} // namespace libffmpeg::avformat
@@ -153,6 +153,11 @@ avutil::AVDictionaryWrapper AVFormatContextWrapper::getMetadata() const
 }
 
 bool AVFormatContextWrapper::getNextPacket(avcodec::AVPacketWrapper &packet)
+{
+  return this->readNextPacket(packet) == ReturnCode::Ok;
+}
+
+ReturnCode AVFormatContextWrapper::readNextPacket(avcodec::AVPacketWrapper &packet)
 {
   const auto returnCode = toReturnCode(
       this->ffmpegLibraries->avformat.av_read_frame(this->formatContext, packet.getPacket()));
@@ -164,7 +169,7 @@ bool AVFormatContextWrapper::getNextPacket(avcodec::AVPacketWrapper &packet)
                                "Error getting next packet (av_read_frame). Return code " +
                                    ReturnCodeMapper.getName(returnCode));
 
-  return returnCode == ReturnCode::Ok;
+  return returnCode;
 }
 
 bool AVFormatContextWrapper::openInputAndFindStreamInfo(
@@ -11,6 +11,7 @@
 #include <AVFormat/wrappers/AVInputFormatWrapper.h>
 #include <AVFormat/wrappers/AVStreamWrapper.h>
 #include <AVUtil/wrappers/AVDictionaryWrapper.h>
+#include <common/Error.h>
 #include <libHandling/IFFmpegLibraries.h>
 
 #include <memory>
@@ -44,6 +45,9 @@ public:
 
   bool getNextPacket(avcodec::AVPacketWrapper &packet);
 
+  // Same as getNextPacket but returns why no packet was read (e.g. EndOfFile).
+  ReturnCode readNextPacket(avcodec::AVPacketWrapper &packet);
+
 private:
   bool openInputAndFindStreamInfo(const std::optional<std::filesystem::path> path);
 
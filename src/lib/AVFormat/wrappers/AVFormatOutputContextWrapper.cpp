@@ -0,0 +1,237 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "AVFormatOutputContextWrapper.h"
+#include "AVFormatContextWrapperInternal.h"
+
+#include <common/Error.h>
+
+#include "CastFormatClasses.h"
+
+namespace libffmpeg::avformat
+{
+
+namespace
+{
+
+using libffmpeg::internal::AVFormatContext;
+using libffmpeg::internal::AVStream;
+using libffmpeg::internal::avformat::AVFormatContext_56;
+using libffmpeg::internal::avformat::AVFormatContext_57;
+using libffmpeg::internal::avformat::AVFormatContext_58;
+using libffmpeg::internal::avformat::AVFormatContext_59;
+using libffmpeg::internal::avformat::AVFormatContext_60;
+using libffmpeg::internal::avformat::AVFormatContext_61;
+using libffmpeg::internal::avformat::AVFormatContext_62;
+
+} // namespace
+
+AVFormatOutputContextWrapper::AVFormatOutputContextWrapper(
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool AVFormatOutputContextWrapper::openOutput(std::unique_ptr<avformat::AVIOOutputContext> ioOutput,
+                                              const std::string &formatName,
+                                              const std::string &fileName)
+{
+  if (this->formatContext)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error opening output. AVFormatContext is already initialized.");
+    return false;
+  }
+
+  if (!ioOutput || !(*ioOutput))
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Invalid ioOutput given.");
+    return false;
+  }
+
+  AVFormatContext *newContext{};
+  const auto       returnCode =
+      toReturnCode(this->ffmpegLibraries->avformat.avformat_alloc_output_context2(
+          &newContext,
+          nullptr,
+          formatName.empty() ? nullptr : formatName.c_str(),
+          fileName.empty() ? nullptr : fileName.c_str()));
+  if (returnCode != ReturnCode::Ok || newContext == nullptr)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error,
+        "Error allocating output context for format '" + formatName + "' and file '" + fileName +
+            "' (avformat_alloc_output_context2). Return code " +
+            ReturnCodeMapper.getName(returnCode));
+    return false;
+  }
+
+  this->formatContext = std::unique_ptr<AVFormatContext, AVFormatContextDeleter>(
+      newContext, AVFormatContextDeleter(this->ffmpegLibraries));
+  this->ioOutput = std::move(ioOutput);
+
+  CAST_AVFORMAT_SET_MEMBER(
+      AVFormatContext, this->formatContext.get(), pb, this->ioOutput->getAVIOContext());
+
+  this->headerWritten  = false;
+  this->trailerWritten = false;
+  return true;
+}
+
+AVFormatOutputContextWrapper::operator bool() const
+{
+  return !!this->formatContext;
+}
+
+std::optional<AVStreamWrapper>
+AVFormatOutputContextWrapper::addStream(const avcodec::AVCodecParametersWrapper &codecParameters,
+                                        const Rational                           timeBase)
+{
+  if (!this->formatContext || this->headerWritten)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error,
+        "Streams can only be added after opening the output and before writing the header.");
+    return {};
+  }
+
+  const auto &avcodec = this->ffmpegLibraries->avcodec;
+  if (this->ffmpegLibraries->getLibrariesVersion().avformat.major < 57 ||
+      !avcodec.avcodec_parameters_copy)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Stream copy is not supported with this avformat version.");
+    return {};
+  }
+
+  const auto newStream =
+      this->ffmpegLibraries->avformat.avformat_new_stream(this->formatContext.get(), nullptr);
+  if (newStream == nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Error adding stream (avformat_new_stream).");
+    return {};
+  }
+
+  AVStreamWrapper stream(newStream, this->ffmpegLibraries);
+  auto            streamParameters = stream.getCodecParameters();
+  if (!streamParameters)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "The new stream has no codec parameters.");
+    return {};
+  }
+
+  const auto returnCode = toReturnCode(avcodec.avcodec_parameters_copy(
+      streamParameters->getCodecParameters(), codecParameters.getCodecParameters()));
+  if (returnCode != ReturnCode::Ok)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error,
+        "Error copying codec parameters to the output stream. Return code " +
+            ReturnCodeMapper.getName(returnCode));
+    return {};
+  }
+
+  streamParameters->setCodecTag(0);
+  stream.setTimeBase(timeBase);
+  return stream;
+}
+
+int AVFormatOutputContextWrapper::getNumberStreams() const
+{
+  unsigned numberStreams{};
+  CAST_AVFORMAT_GET_MEMBER(AVFormatContext, this->formatContext.get(), numberStreams, nb_streams);
+  return static_cast<int>(numberStreams);
+}
+
+AVStreamWrapper AVFormatOutputContextWrapper::getStream(int idx) const
+{
+  if (idx < 0 || idx >= this->getNumberStreams())
+    throw std::runtime_error("Invalid stream index");
+
+  AVStream *streamPointer{};
+  CAST_AVFORMAT_GET_MEMBER(AVFormatContext, this->formatContext.get(), streamPointer, streams[idx]);
+  return {streamPointer, this->ffmpegLibraries};
+}
+
+bool AVFormatOutputContextWrapper::writeHeader()
+{
+  if (!this->formatContext || this->headerWritten)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Can not write header. Output not open or header already written.");
+    return false;
+  }
+
+  const auto returnCode = toReturnCode(
+      this->ffmpegLibraries->avformat.avformat_write_header(this->formatContext.get(), nullptr));
+  // Positive values only indicate if the streams were already initialized
+  if (returnCode != ReturnCode::Ok && toAVError(returnCode) < 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error writing header (avformat_write_header). Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+    return false;
+  }
+
+  this->headerWritten = true;
+  return true;
+}
+
+bool AVFormatOutputContextWrapper::writePacket(avcodec::AVPacketWrapper &packet)
+{
+  if (!this->headerWritten || this->trailerWritten || !packet)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error,
+        "Can not write packet. The header was not written yet or the output is finished.");
+    return false;
+  }
+
+  const auto returnCode = toReturnCode(this->ffmpegLibraries->avformat.av_interleaved_write_frame(
+      this->formatContext.get(), packet.getPacket()));
+  if (returnCode != ReturnCode::Ok)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error writing packet (av_interleaved_write_frame). Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+    return false;
+  }
+  return true;
+}
+
+bool AVFormatOutputContextWrapper::writeTrailer()
+{
+  if (!this->headerWritten || this->trailerWritten)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Can not write trailer. The header was not written yet or the "
+                               "trailer was already written.");
+    return false;
+  }
+
+  this->trailerWritten = true;
+  const auto returnCode =
+      toReturnCode(this->ffmpegLibraries->avformat.av_write_trailer(this->formatContext.get()));
+  if (returnCode != ReturnCode::Ok)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error writing trailer (av_write_trailer). Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+    return false;
+  }
+  return true;
+}
+
+void AVFormatOutputContextWrapper::AVFormatContextDeleter::operator()(
+    AVFormatContext *formatContext) const noexcept
+{
+  if (formatContext != nullptr)
+    this->ffmpegLibraries->avformat.avformat_free_context(formatContext);
+}
+
+} // namespace libffmpeg::avformat
@@ -0,0 +1,83 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVCodecParametersWrapper.h>
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <AVFormat/wrappers/AVIOContextWrapper.h>
+#include <AVFormat/wrappers/AVStreamWrapper.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <memory>
+
+namespace libffmpeg::avformat
+{
+
+// The counterpart of the AVFormatContextWrapper for writing (muxing) a container.
+class AVFormatOutputContextWrapper
+{
+public:
+  AVFormatOutputContextWrapper()                                                    = delete;
+  AVFormatOutputContextWrapper(const AVFormatOutputContextWrapper &)                = delete;
+  AVFormatOutputContextWrapper &operator=(const AVFormatOutputContextWrapper &)     = delete;
+  AVFormatOutputContextWrapper(AVFormatOutputContextWrapper &&) noexcept            = default;
+  AVFormatOutputContextWrapper &operator=(AVFormatOutputContextWrapper &&) noexcept = default;
+  AVFormatOutputContextWrapper(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+  ~AVFormatOutputContextWrapper() = default;
+
+  // Allocate the muxer for the given container format (e.g. "mp4", "matroska" or "mpegts"). If
+  // no format name is given, the format is guessed from the file name.
+  bool openOutput(std::unique_ptr<avformat::AVIOOutputContext> ioOutput,
+                  const std::string                          &formatName,
+                  const std::string                          &fileName = {});
+
+  explicit operator bool() const;
+
+  // Add a stream with a copy of the given codec parameters (stream copy). Streams must be added
+  // before the header is written. This is not supported for avformat 56.
+  std::optional<AVStreamWrapper> addStream(const avcodec::AVCodecParametersWrapper &codecParameters,
+                                           const Rational                           timeBase);
+
+  [[nodiscard]] int             getNumberStreams() const;
+  [[nodiscard]] AVStreamWrapper getStream(int idx) const;
+
+  // The muxer may change the time base of the streams. Use the time base of the output streams
+  // for the packets after writing the header.
+  bool writeHeader();
+
+  // The packet must have the index of the output stream and timestamps in the time base of the
+  // output stream. The muxer takes ownership of the packet data so the packet is empty afterwards.
+  bool writePacket(avcodec::AVPacketWrapper &packet);
+
+  // Flush all interleaved packets and finish the file. Must be called before the output is closed.
+  bool writeTrailer();
+
+private:
+  class AVFormatContextDeleter
+  {
+  public:
+    AVFormatContextDeleter() = default;
+    AVFormatContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(libffmpeg::internal::AVFormatContext *formatContext) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  // Declared first so that the format context is freed before the output it writes to.
+  std::unique_ptr<avformat::AVIOOutputContext> ioOutput{};
+
+  std::unique_ptr<libffmpeg::internal::AVFormatContext, AVFormatContextDeleter> formatContext{
+      nullptr, AVFormatContextDeleter()};
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+
+  bool headerWritten{};
+  bool trailerWritten{};
+};
+
+} // namespace libffmpeg::avformat
@@ -8,10 +8,13 @@
 
 #include <common/Error.h>
 
+#include "AVIOContextWrapperInternal.h"
+
 namespace libffmpeg::avformat
 {
 
 using internal::AVIOContext;
+using internal::avformat::AVIOContext_56;
 
 namespace
 {
@@ -48,6 +51,30 @@ int64_t seekCallback(void *opaque, int64_t offset, int whence)
   return toAVError(ReturnCode::Unknown);
 }
 
+int writePacketCallback(void *opaque, const uint8_t *buffer, int bufferSize)
+{
+  auto *io = reinterpret_cast<AVIOOutputContext *>(opaque);
+
+  if (io->writeData(buffer, bufferSize))
+    return bufferSize;
+
+  return toAVError(ReturnCode::Unknown);
+}
+
+int64_t outputSeekCallback(void *opaque, int64_t offset, int whence)
+{
+  auto *io = reinterpret_cast<AVIOOutputContext *>(opaque);
+
+  // avio_seek converts all relative seeks to absolute positions before calling this
+  if (whence != 0)
+    return toAVError(ReturnCode::Unknown);
+
+  if (io->seek(offset))
+    return offset;
+
+  return toAVError(ReturnCode::Unknown);
+}
+
 } // namespace
 
 
@@ -61,6 +88,10 @@ void AVIOInputContext::AVIOContextDeleter::operator()(AVIOContext *ioContext) co
   if (ioContext == nullptr)
     return;
 
+  // The buffer is not freed by avio_context_free. It may have been reallocated by ffmpeg, so the
+  // current pointer must be taken from the context. Its position is the same in all versions.
+  this->ffmpegLibraries->avutil.av_freep(&reinterpret_cast<AVIOContext_56 *>(ioContext)->buffer);
+
   if (this->ffmpegLibraries->getLibrariesVersion().avformat.major > 56)
     this->ffmpegLibraries->avformat.avio_context_free(&ioContext);
   else
@@ -83,6 +114,46 @@ AVIOInputContext::AVIOInputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibra
 
   auto newContext = ffmpegLibraries->avformat.avio_alloc_context(
       buffer, bufferSize, 0, this, &readPacketCallback, nullptr, &seekCallback);
+  if (newContext == nullptr)
+  {
+    ffmpegLibraries->log(LogLevel::Error, "Error allocating IO context.");
+    ffmpegLibraries->avutil.av_freep(&buffer);
+    return;
+  }
+
+  this->ioContext = std::unique_ptr<AVIOContext, AVIOContextDeleter>(
+      newContext, AVIOContextDeleter(ffmpegLibraries));
+}
+
+AVIOOutputContext::AVIOOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                     const bool                        seekable)
+    : AVIOContextWrapper()
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+
+  const size_t bufferSize = 32768;
+  auto buffer = static_cast<unsigned char *>(ffmpegLibraries->avutil.av_mallocz(bufferSize));
+  if (buffer == nullptr)
+  {
+    ffmpegLibraries->log(LogLevel::Error, "Error allocating buffer for IO context.");
+    return;
+  }
+
+  auto newContext = ffmpegLibraries->avformat.avio_alloc_context(buffer,
+                                                                 bufferSize,
+                                                                 1,
+                                                                 this,
+                                                                 nullptr,
+                                                                 &writePacketCallback,
+                                                                 seekable ? &outputSeekCallback
+                                                                          : nullptr);
+  if (newContext == nullptr)
+  {
+    ffmpegLibraries->log(LogLevel::Error, "Error allocating IO context.");
+    ffmpegLibraries->avutil.av_freep(&buffer);
+    return;
+  }
 
   this->ioContext = std::unique_ptr<AVIOContext, AVIOContextDeleter>(
       newContext, AVIOContextDeleter(ffmpegLibraries));
@@ -52,4 +52,16 @@ public:
   virtual bool                             seek(int64_t offset)                 = 0;
 };
 
+class AVIOOutputContext : public AVIOContextWrapper
+{
+public:
+  // If the output is not seekable, muxers that have to update data that was already written (e.g.
+  // the index of mp4 files) can not be used.
+  AVIOOutputContext(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const bool seekable = true);
+  virtual ~AVIOOutputContext() = default;
+
+  virtual bool writeData(const uint8_t *buf, int buf_size) = 0;
+  virtual bool seek(int64_t offset)                         = 0;
+};
+
 } // namespace libffmpeg::avformat
@@ -0,0 +1,30 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/InternalTypes.h>
+
+namespace libffmpeg::internal::avformat
+{
+
+// AVIOContext is part of AVFormat. Only the first members are declared here. They are the same
+// in all supported versions.
+struct AVIOContext_56
+{
+  const AVClass *av_class{};
+  unsigned char *buffer{};
+  int            buffer_size{};
+};
+
+using AVIOContext_57 = AVIOContext_56;
+using AVIOContext_58 = AVIOContext_56;
+using AVIOContext_59 = AVIOContext_56;
+using AVIOContext_60 = AVIOContext_56;
+using AVIOContext_61 = AVIOContext_56;
+using AVIOContext_62 = AVIOContext_56;
+
+} // namespace libffmpeg::internal::avformat
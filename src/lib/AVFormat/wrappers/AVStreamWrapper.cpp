@@ -12,6 +12,8 @@
 #include "AVStreamWrapperInternal.h"
 #include "CastFormatClasses.h"
 
+#include <map>
+
 namespace libffmpeg::avformat
 {
 
@@ -21,6 +23,8 @@ namespace
 using libffmpeg::internal::AVCodecContext;
 using libffmpeg::internal::AVCodecID;
 using libffmpeg::internal::AVCodecParameters;
+using libffmpeg::internal::AVDiscard;
+using libffmpeg::internal::AVIndexEntry;
 using libffmpeg::internal::AVRational;
 using libffmpeg::internal::AVStream;
 using libffmpeg::internal::AVStreamParseType;
@@ -32,6 +36,27 @@ using libffmpeg::internal::avformat::AVStream_60;
 using libffmpeg::internal::avformat::AVStream_61;
 using libffmpeg::internal::avformat::AVStream_62;
 
+const std::map<avcodec::Discard, AVDiscard> DISCARD_TO_AVDISCARD = {
+    {avcodec::Discard::None, internal::AVDISCARD_NONE},
+    {avcodec::Discard::Default, internal::AVDISCARD_DEFAULT},
+    {avcodec::Discard::NonReference, internal::AVDISCARD_NONREF},
+    {avcodec::Discard::Bidirectional, internal::AVDISCARD_BIDIR},
+    {avcodec::Discard::NonIntra, internal::AVDISCARD_NONINTRA},
+    {avcodec::Discard::NonKey, internal::AVDISCARD_NONKEY},
+    {avcodec::Discard::All, internal::AVDISCARD_ALL}};
+
+IndexEntry toIndexEntry(const AVIndexEntry &entry)
+{
+  IndexEntry indexEntry;
+  indexEntry.position    = entry.pos;
+  indexEntry.timestamp   = entry.timestamp;
+  indexEntry.size        = entry.size;
+  indexEntry.minDistance = entry.min_distance;
+  indexEntry.keyframe    = (entry.flags & internal::AVINDEX_KEYFRAME) != 0;
+  indexEntry.discard     = (entry.flags & internal::AVINDEX_DISCARD_FRAME) != 0;
+  return indexEntry;
+}
+
 } // namespace
 
 AVStreamWrapper::AVStreamWrapper(AVStream                         *stream,
@@ -139,6 +164,68 @@ ByteVector AVStreamWrapper::getExtradata() const
   return {};
 }
 
+avcodec::Discard AVStreamWrapper::getDiscard() const
+{
+  AVDiscard discard{};
+  CAST_AVFORMAT_GET_MEMBER(AVStream, this->stream, discard, discard);
+
+  for (const auto &[value, avDiscard] : DISCARD_TO_AVDISCARD)
+    if (avDiscard == discard)
+      return value;
+  return avcodec::Discard::Default;
+}
+
+void AVStreamWrapper::setDiscard(const avcodec::Discard discard)
+{
+  const auto avDiscard = DISCARD_TO_AVDISCARD.at(discard);
+  CAST_AVFORMAT_SET_MEMBER(AVStream, this->stream, discard, avDiscard);
+}
+
+void AVStreamWrapper::setTimeBase(const Rational timeBase)
+{
+  const auto avTimeBase = toAVRational(timeBase);
+  CAST_AVFORMAT_SET_MEMBER(AVStream, this->stream, time_base, avTimeBase);
+}
+
+int AVStreamWrapper::getNumberOfIndexEntries() const
+{
+  const auto &avformat = this->ffmpegLibraries->avformat;
+  if (avformat.avformat_index_get_entries_count)
+    return avformat.avformat_index_get_entries_count(this->stream);
+
+  // Before the API functions, the index was a (not officially public) member of the stream
+  if (this->ffmpegLibraries->getLibrariesVersion().avformat.major == 57)
+    return reinterpret_cast<AVStream_57 *>(this->stream)->nb_index_entries;
+
+  return 0;
+}
+
+std::vector<IndexEntry> AVStreamWrapper::getIndexEntries() const
+{
+  const auto numberOfEntries = this->getNumberOfIndexEntries();
+  if (numberOfEntries <= 0)
+    return {};
+
+  std::vector<IndexEntry> entries;
+  entries.reserve(static_cast<std::size_t>(numberOfEntries));
+
+  const auto &avformat = this->ffmpegLibraries->avformat;
+  if (avformat.avformat_index_get_entry)
+  {
+    for (int i = 0; i < numberOfEntries; ++i)
+      if (const auto entry = avformat.avformat_index_get_entry(this->stream, i))
+        entries.push_back(toIndexEntry(*entry));
+  }
+  // Without the API function, only avformat 57 can have entries (see getNumberOfIndexEntries)
+  else if (const auto p = reinterpret_cast<AVStream_57 *>(this->stream); p->index_entries)
+  {
+    for (int i = 0; i < numberOfEntries; ++i)
+      entries.push_back(toIndexEntry(p->index_entries[i]));
+  }
+
+  return entries;
+}
+
 std::optional<avcodec::CodecDescriptor> AVStreamWrapper::getCodecDescriptor() const
 {
   const auto codecID = this->getCodecID();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AVCodec/Discard.h>
 #include <AVCodec/wrappers/AVCodecContextWrapper.h>
 #include <AVCodec/wrappers/AVCodecDescriptorConversion.h>
 #include <AVCodec/wrappers/AVCodecParametersWrapper.h>
@@ -14,10 +15,28 @@
 #include <libHandling/IFFmpegLibraries.h>
 
 #include <memory>
+#include <vector>
 
 namespace libffmpeg::avformat
 {
 
+// An entry of the index that the demuxer built for the stream (e.g. from the sample table of an
+// MP4 file or the cues of an MKV file).
+struct IndexEntry
+{
+  // Byte position of the packet in the file
+  int64_t position{};
+  // Timestamp in the time base of the stream
+  int64_t timestamp{};
+  int     size{};
+  // The minimum distance between this and the previous keyframe in the time base of the stream
+  int     minDistance{};
+  bool    keyframe{};
+  bool    discard{};
+
+  bool operator==(const IndexEntry &other) const = default;
+};
+
 class AVStreamWrapper
 {
 public:
@@ -36,6 +55,20 @@ public:
   [[nodiscard]] avutil::ColorSpace             getColorspace() const;
   [[nodiscard]] avutil::PixelFormatDescriptor  getPixelFormat() const;
   [[nodiscard]] ByteVector                     getExtradata() const;
+  [[nodiscard]] avcodec::Discard               getDiscard() const;
+
+  // Discard::All stops the demuxer from returning (and for most formats reading) the packets of
+  // the stream.
+  void setDiscard(avcodec::Discard discard);
+
+  // For output streams. The muxer may change the time base when writing the header.
+  void setTimeBase(const Rational timeBase);
+
+  // The index is available directly after opening the file for most containers with a sample
+  // table. No packets have to be read. The index is not accessible for avformat 56 and for
+  // avformat 58 before FFmpeg 4.4. In this case, no entries are returned.
+  [[nodiscard]] int                     getNumberOfIndexEntries() const;
+  [[nodiscard]] std::vector<IndexEntry> getIndexEntries() const;
 
   [[nodiscard]] std::optional<avcodec::CodecDescriptor>          getCodecDescriptor() const;
   [[nodiscard]] std::optional<avcodec::AVCodecParametersWrapper> getCodecParameters() const;
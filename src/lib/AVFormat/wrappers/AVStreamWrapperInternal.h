@@ -12,7 +12,6 @@
 namespace libffmpeg::internal::avformat
 {
 
-class AVIndexEntry;
 class AVStreamInternal;
 
 // AVStream is part of AVFormat
@@ -0,0 +1,441 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "QualityMetrics.h"
+
+#include "QualityMetricsKernels.h"
+
+#include <common/CpuFeatures.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace libffmpeg::avutil
+{
+
+namespace
+{
+
+using qualitymetrics::BlockRow;
+using qualitymetrics::BlockSums;
+using qualitymetrics::Layout;
+
+// Bands should not be too small. Otherwise starting the threads takes longer than the calculation.
+constexpr int MIN_ROWS_PER_BAND = 32;
+
+constexpr int SSIM_BLOCK_SIZE         = 4;
+constexpr int SSIM_SAMPLES_PER_WINDOW = 64;
+constexpr int MAX_SUPPORTED_BIT_DEPTH = 16;
+
+struct PlaneLayout
+{
+  int    plane{};
+  Layout layout{};
+  int    numberOfComponents{};
+  // The number of samples in one row / the number of rows that are visible
+  int samplesPerRow{};
+  int numberOfRows{};
+};
+
+int shiftAndRoundUp(const int value, const int shift)
+{
+  return -((-value) >> shift);
+}
+
+std::optional<std::vector<PlaneLayout>>
+analyzePixelFormat(const PixelFormatDescriptor &pixelFormat, const Size size)
+{
+  const auto &flags = pixelFormat.flags;
+  if (flags.pallette || flags.bitwisePacked || flags.hwAccelerated || flags.bigEndian ||
+      flags.floatValues || flags.bayerPattern)
+    return {};
+  if (pixelFormat.numberOfComponents <= 0 || pixelFormat.componentDescriptors.empty())
+    return {};
+
+  std::vector<PlaneLayout> planes;
+  for (std::size_t component = 0; component < pixelFormat.componentDescriptors.size();
+       ++component)
+  {
+    const auto &descriptor = pixelFormat.componentDescriptors.at(component);
+    if (descriptor.plane < 0 || descriptor.plane >= 4 || descriptor.depth <= 0 ||
+        descriptor.depth > MAX_SUPPORTED_BIT_DEPTH)
+      return {};
+
+    Layout layout;
+    layout.bytesPerSample = (descriptor.depth + descriptor.shift > 8) ? 2 : 1;
+    layout.sampleShift    = descriptor.shift;
+    layout.depth          = descriptor.depth;
+    if (descriptor.depth + descriptor.shift > 16 || descriptor.step <= 0 ||
+        descriptor.step % layout.bytesPerSample != 0)
+      return {};
+
+    // The chroma components of YUV formats may be subsampled
+    const auto isSubsampled = !flags.rgb && (component == 1 || component == 2);
+    const auto widthShift   = isSubsampled ? pixelFormat.shiftLumaToChroma.widthShift : 0;
+    const auto heightShift  = isSubsampled ? pixelFormat.shiftLumaToChroma.heightShift : 0;
+    const auto samplesPerRow =
+        shiftAndRoundUp(size.width, widthShift) * (descriptor.step / layout.bytesPerSample);
+    const auto numberOfRows = shiftAndRoundUp(size.height, heightShift);
+
+    auto plane = std::find_if(planes.begin(),
+                              planes.end(),
+                              [&descriptor](const PlaneLayout &planeLayout)
+                              { return planeLayout.plane == descriptor.plane; });
+    if (plane == planes.end())
+    {
+      PlaneLayout planeLayout;
+      planeLayout.plane  = descriptor.plane;
+      planeLayout.layout = layout;
+      planes.push_back(planeLayout);
+      plane = planes.end() - 1;
+    }
+    else if (plane->layout.bytesPerSample != layout.bytesPerSample ||
+             plane->layout.sampleShift != layout.sampleShift ||
+             plane->layout.depth != layout.depth)
+      return {};
+
+    ++plane->numberOfComponents;
+    plane->samplesPerRow = std::max(plane->samplesPerRow, samplesPerRow);
+    plane->numberOfRows  = std::max(plane->numberOfRows, numberOfRows);
+  }
+
+  std::sort(planes.begin(),
+            planes.end(),
+            [](const PlaneLayout &a, const PlaneLayout &b) { return a.plane < b.plane; });
+  return planes;
+}
+
+using SumOfSquaredErrorsFunction = uint64_t (*)(const std::byte *,
+                                                const std::byte *,
+                                                int,
+                                                const Layout &);
+using BlockSumsFunction          = void (*)(const BlockRow &, const Layout &, BlockSums *);
+
+struct Kernels
+{
+  SumOfSquaredErrorsFunction sumOfSquaredErrors{};
+  BlockSumsFunction          calculateBlockSums{};
+};
+
+uint64_t sumOfSquaredErrorsScalar(const std::byte *row1,
+                                  const std::byte *row2,
+                                  const int        numberOfSamples,
+                                  const Layout    &layout)
+{
+  return qualitymetrics::sumOfSquaredErrorsScalar(row1, row2, numberOfSamples, layout, 0);
+}
+
+void calculateBlockSumsScalar(const BlockRow &row, const Layout &layout, BlockSums *sums)
+{
+  qualitymetrics::calculateBlockSumsScalar(row, layout, sums, 0);
+}
+
+Kernels selectKernels(const QualityMetricsSettings::Implementation implementation)
+{
+  using Implementation = QualityMetricsSettings::Implementation;
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  if ((implementation == Implementation::Auto || implementation == Implementation::AVX2) &&
+      getCpuFeatures().avx2)
+    return {qualitymetrics::sumOfSquaredErrorsAVX2, qualitymetrics::calculateBlockSumsAVX2};
+#endif
+
+  return {sumOfSquaredErrorsScalar, calculateBlockSumsScalar};
+}
+
+unsigned getNumberOfThreads(const QualityMetricsSettings &settings, const int height)
+{
+  auto numberOfThreads = settings.numberOfThreads;
+  if (numberOfThreads == 0)
+    numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  const auto maxBands = static_cast<unsigned>(std::max(1, height / MIN_ROWS_PER_BAND));
+  return std::min(numberOfThreads, maxBands);
+}
+
+// Split the rows into bands and call function(band, startRow, endRow) for each band in parallel.
+// The results are summed up.
+template <typename Function>
+auto sumOverBands(const int numberOfRows, const unsigned numberOfThreads, Function function)
+{
+  using Result = decltype(function(0, 0));
+
+  if (numberOfThreads <= 1)
+    return function(0, numberOfRows);
+
+  const auto rowsPerBand = (numberOfRows + static_cast<int>(numberOfThreads) - 1) /
+                           static_cast<int>(numberOfThreads);
+
+  std::vector<Result>      results(numberOfThreads);
+  std::vector<std::thread> threads;
+  for (unsigned band = 1; band < numberOfThreads; ++band)
+  {
+    const auto startRow = static_cast<int>(band) * rowsPerBand;
+    const auto endRow   = std::min(numberOfRows, startRow + rowsPerBand);
+    if (startRow < endRow)
+      threads.emplace_back([&results, &function, band, startRow, endRow]()
+                           { results.at(band) = function(startRow, endRow); });
+  }
+  results.at(0) = function(0, std::min(numberOfRows, rowsPerBand));
+
+  for (auto &thread : threads)
+    thread.join();
+
+  Result sum{};
+  for (const auto result : results)
+    sum += result;
+  return sum;
+}
+
+double calculatePSNR(const double mse, const int maxValue)
+{
+  if (mse == 0.0)
+    return std::numeric_limits<double>::infinity();
+  return 10.0 * std::log10(static_cast<double>(maxValue) * maxValue / mse);
+}
+
+const std::byte *getRow(const ImagePlanes &image, const int plane, const int row)
+{
+  return image.data.at(plane) + static_cast<std::ptrdiff_t>(row) * image.linesize.at(plane);
+}
+
+double calculateWindowSSIM(const BlockSums &sums, const int maxValue)
+{
+  const auto c1 = std::pow(0.01 * maxValue, 2);
+  const auto c2 = std::pow(0.03 * maxValue, 2);
+
+  constexpr auto count = static_cast<double>(SSIM_SAMPLES_PER_WINDOW);
+
+  const auto mean1      = static_cast<double>(sums.sum1) / count;
+  const auto mean2      = static_cast<double>(sums.sum2) / count;
+  const auto variance1  = static_cast<double>(sums.sumOfSquares1) / count - mean1 * mean1;
+  const auto variance2  = static_cast<double>(sums.sumOfSquares2) / count - mean2 * mean2;
+  const auto covariance = static_cast<double>(sums.sumOfProducts) / count - mean1 * mean2;
+
+  return (2.0 * mean1 * mean2 + c1) * (2.0 * covariance + c2) /
+         ((mean1 * mean1 + mean2 * mean2 + c1) * (variance1 + variance2 + c2));
+}
+
+BlockSums addBlockSums(const BlockSums &a, const BlockSums &b)
+{
+  return {a.sum1 + b.sum1,
+          a.sum2 + b.sum2,
+          a.sumOfSquares1 + b.sumOfSquares1,
+          a.sumOfSquares2 + b.sumOfSquares2,
+          a.sumOfProducts + b.sumOfProducts};
+}
+
+std::optional<double> calculateSSIM(const ImagePlanes            &image1,
+                                    const ImagePlanes            &image2,
+                                    const PlaneLayout            &planeLayout,
+                                    const Kernels                &kernels,
+                                    const QualityMetricsSettings &settings)
+{
+  const auto blocksPerRow      = planeLayout.samplesPerRow / SSIM_BLOCK_SIZE;
+  const auto numberOfBlockRows = planeLayout.numberOfRows / SSIM_BLOCK_SIZE;
+  if (planeLayout.numberOfComponents != 1 || blocksPerRow < 2 || numberOfBlockRows < 2)
+    return {};
+
+  const auto plane              = planeLayout.plane;
+  const auto maxValue           = (1 << planeLayout.layout.depth) - 1;
+  const auto numberOfWindowRows = numberOfBlockRows - 1;
+
+  const auto calculateBlockRow = [&](const int blockRow, std::vector<BlockSums> &sums)
+  {
+    BlockRow row;
+    row.data1          = getRow(image1, plane, blockRow * SSIM_BLOCK_SIZE);
+    row.linesize1      = image1.linesize.at(plane);
+    row.data2          = getRow(image2, plane, blockRow * SSIM_BLOCK_SIZE);
+    row.linesize2      = image2.linesize.at(plane);
+    row.numberOfBlocks = blocksPerRow;
+    kernels.calculateBlockSums(row, planeLayout.layout, sums.data());
+  };
+
+  // Each window of 8x8 samples consists of 2x2 blocks. Windows overlap by one block.
+  const auto sumOfWindowSSIM = [&](const int startWindowRow, const int endWindowRow)
+  {
+    std::vector<BlockSums> top(static_cast<std::size_t>(blocksPerRow));
+    std::vector<BlockSums> bottom(static_cast<std::size_t>(blocksPerRow));
+    calculateBlockRow(startWindowRow, top);
+
+    double sum{};
+    for (int windowRow = startWindowRow; windowRow < endWindowRow; ++windowRow)
+    {
+      calculateBlockRow(windowRow + 1, bottom);
+      for (std::size_t x = 0; x + 1 < top.size(); ++x)
+      {
+        const auto windowSums = addBlockSums(addBlockSums(top[x], top[x + 1]),
+                                             addBlockSums(bottom[x], bottom[x + 1]));
+        sum += calculateWindowSSIM(windowSums, maxValue);
+      }
+      std::swap(top, bottom);
+    }
+    return sum;
+  };
+
+  const auto sum = sumOverBands(numberOfWindowRows,
+                                getNumberOfThreads(settings, numberOfWindowRows),
+                                sumOfWindowSSIM);
+  return sum / (static_cast<double>(numberOfWindowRows) * (blocksPerRow - 1));
+}
+
+PlaneMetrics calculatePlaneMetrics(const ImagePlanes            &image1,
+                                   const ImagePlanes            &image2,
+                                   const PlaneLayout            &planeLayout,
+                                   const Kernels                &kernels,
+                                   const QualityMetricsSettings &settings)
+{
+  const auto plane = planeLayout.plane;
+
+  const auto sumOfSquaredErrors = [&](const int startRow, const int endRow)
+  {
+    uint64_t sum{};
+    for (int y = startRow; y < endRow; ++y)
+      sum += kernels.sumOfSquaredErrors(getRow(image1, plane, y),
+                                        getRow(image2, plane, y),
+                                        planeLayout.samplesPerRow,
+                                        planeLayout.layout);
+    return sum;
+  };
+
+  const auto sum = sumOverBands(planeLayout.numberOfRows,
+                                getNumberOfThreads(settings, planeLayout.numberOfRows),
+                                sumOfSquaredErrors);
+
+  PlaneMetrics metrics;
+  metrics.plane    = plane;
+  metrics.maxValue = (1 << planeLayout.layout.depth) - 1;
+  metrics.mse      = static_cast<double>(sum) /
+                (static_cast<double>(planeLayout.samplesPerRow) * planeLayout.numberOfRows);
+  metrics.psnr = calculatePSNR(metrics.mse, metrics.maxValue);
+  if (settings.calculateSSIM)
+    metrics.ssim = calculateSSIM(image1, image2, planeLayout, kernels, settings);
+  return metrics;
+}
+
+ImagePlanes getImagePlanes(const AVFrameWrapper &frame)
+{
+  ImagePlanes image;
+  image.pixelFormat = frame.getPixelFormatDescriptor();
+  image.size        = frame.getSize();
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    const auto framePlane    = frame.getPlane(plane);
+    image.data.at(plane)     = framePlane.data;
+    image.linesize.at(plane) = framePlane.linesize;
+  }
+  return image;
+}
+
+} // namespace
+
+bool isQualityMetricsSupported(const PixelFormatDescriptor &pixelFormat)
+{
+  return analyzePixelFormat(pixelFormat, {1, 1}).has_value();
+}
+
+std::optional<FrameMetrics> calculateQualityMetrics(const ImagePlanes            &image1,
+                                                    const ImagePlanes            &image2,
+                                                    const QualityMetricsSettings &settings)
+{
+  if (image1.size != image2.size || image1.pixelFormat != image2.pixelFormat)
+    return {};
+  if (image1.size.width <= 0 || image1.size.height <= 0)
+    return {};
+
+  const auto planes = analyzePixelFormat(image1.pixelFormat, image1.size);
+  if (!planes)
+    return {};
+
+  for (const auto &planeLayout : *planes)
+    if (image1.data.at(planeLayout.plane) == nullptr ||
+        image2.data.at(planeLayout.plane) == nullptr)
+      return {};
+
+  const auto kernels = selectKernels(settings.implementation);
+
+  FrameMetrics metrics;
+  for (const auto &planeLayout : *planes)
+    metrics.planes.push_back(calculatePlaneMetrics(image1, image2, planeLayout, kernels, settings));
+  return metrics;
+}
+
+std::optional<FrameMetrics> calculateQualityMetrics(const AVFrameWrapper         &frame1,
+                                                    const AVFrameWrapper         &frame2,
+                                                    const QualityMetricsSettings &settings)
+{
+  return calculateQualityMetrics(getImagePlanes(frame1), getImagePlanes(frame2), settings);
+}
+
+bool QualityMetricsAccumulator::add(const FrameMetrics &frameMetrics)
+{
+  if (this->numberOfFrames == 0)
+  {
+    this->planeSums.clear();
+    for (const auto &planeMetrics : frameMetrics.planes)
+    {
+      PlaneSums sums;
+      sums.plane    = planeMetrics.plane;
+      sums.maxValue = planeMetrics.maxValue;
+      this->planeSums.push_back(sums);
+    }
+  }
+
+  if (frameMetrics.planes.size() != this->planeSums.size())
+    return false;
+  for (std::size_t i = 0; i < this->planeSums.size(); ++i)
+    if (frameMetrics.planes[i].plane != this->planeSums[i].plane ||
+        frameMetrics.planes[i].maxValue != this->planeSums[i].maxValue)
+      return false;
+
+  for (std::size_t i = 0; i < this->planeSums.size(); ++i)
+  {
+    const auto &planeMetrics = frameMetrics.planes[i];
+    auto       &sums         = this->planeSums[i];
+    sums.sumOfMSE += planeMetrics.mse;
+    if (planeMetrics.ssim)
+    {
+      sums.sumOfSSIM += *planeMetrics.ssim;
+      ++sums.framesWithSSIM;
+      sums.minimumSSIM =
+          std::min(sums.minimumSSIM.value_or(*planeMetrics.ssim), *planeMetrics.ssim);
+    }
+  }
+  ++this->numberOfFrames;
+  return true;
+}
+
+std::size_t QualityMetricsAccumulator::getNumberOfFrames() const
+{
+  return this->numberOfFrames;
+}
+
+std::vector<QualityMetricsAccumulator::AggregatePlaneMetrics>
+QualityMetricsAccumulator::getPlaneMetrics() const
+{
+  std::vector<AggregatePlaneMetrics> planeMetrics;
+  if (this->numberOfFrames == 0)
+    return planeMetrics;
+
+  for (const auto &sums : this->planeSums)
+  {
+    AggregatePlaneMetrics metrics;
+    metrics.plane      = sums.plane;
+    metrics.averageMSE = sums.sumOfMSE / static_cast<double>(this->numberOfFrames);
+    metrics.psnr       = calculatePSNR(metrics.averageMSE, sums.maxValue);
+    if (sums.framesWithSSIM > 0)
+    {
+      metrics.averageSSIM = sums.sumOfSSIM / static_cast<double>(sums.framesWithSSIM);
+      metrics.minimumSSIM = sums.minimumSSIM;
+    }
+    planeMetrics.push_back(metrics);
+  }
+  return planeMetrics;
+}
+
+} // namespace libffmpeg::avutil
@@ -0,0 +1,124 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <AVUtil/wrappers/AVPixFmtDescriptorConversion.h>
+#include <common/Types.h>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace libffmpeg::avutil
+{
+
+/* Objective quality metrics (MSE, PSNR and SSIM) between two images of the same size and pixel
+ * format. The metrics are calculated per plane directly on the plane memory. Samples with 8 to 16
+ * bits (little endian) are supported. All samples of a plane within the visible width are
+ * compared, so for planes with interleaved components (e.g. nv12 chroma or packed RGB) the
+ * metrics combine all components of the plane.
+ *
+ * SSIM is calculated on 8x8 windows with a step of 4 samples (like x264 and FFmpeg) without
+ * gaussian weighting. It is only calculated for planes that contain one component and are at
+ * least 8x8 samples big.
+ *
+ * The sums use integer math with AVX2 kernels that are selected at runtime. All kernels give
+ * identical results to the scalar kernels.
+ */
+
+struct QualityMetricsSettings
+{
+  enum class Implementation
+  {
+    Auto,
+    Scalar,
+    AVX2
+  };
+
+  bool calculateSSIM{true};
+  // Each plane is split into bands of rows that are processed in parallel. 0 means one thread
+  // per hardware thread. Small planes are not split.
+  unsigned numberOfThreads{1};
+  // Auto selects the best implementation that is supported by the CPU. Selecting an
+  // implementation that is not supported falls back to Scalar.
+  Implementation implementation{Implementation::Auto};
+};
+
+// The planes of an image in memory
+struct ImagePlanes
+{
+  PixelFormatDescriptor            pixelFormat{};
+  Size                             size{};
+  std::array<const std::byte *, 4> data{};
+  std::array<int, 4>               linesize{};
+};
+
+struct PlaneMetrics
+{
+  int                   plane{};
+  int                   maxValue{};
+  double                mse{};
+  // Infinite if the planes are identical
+  double                psnr{};
+  std::optional<double> ssim{};
+};
+
+struct FrameMetrics
+{
+  std::vector<PlaneMetrics> planes;
+};
+
+[[nodiscard]] bool isQualityMetricsSupported(const PixelFormatDescriptor &pixelFormat);
+
+// Returns no value if the images differ in size or pixel format or the format is not supported.
+[[nodiscard]] std::optional<FrameMetrics>
+calculateQualityMetrics(const ImagePlanes            &image1,
+                        const ImagePlanes            &image2,
+                        const QualityMetricsSettings &settings = {});
+
+[[nodiscard]] std::optional<FrameMetrics>
+calculateQualityMetrics(const AVFrameWrapper         &frame1,
+                        const AVFrameWrapper         &frame2,
+                        const QualityMetricsSettings &settings = {});
+
+// Aggregates the metrics of multiple frames (e.g. a whole sequence). The PSNR is calculated from
+// the average MSE (not the average of the per frame PSNR values).
+class QualityMetricsAccumulator
+{
+public:
+  struct AggregatePlaneMetrics
+  {
+    int                   plane{};
+    double                averageMSE{};
+    double                psnr{};
+    std::optional<double> averageSSIM{};
+    std::optional<double> minimumSSIM{};
+  };
+
+  // Returns false if the frame has different planes than the previous frames.
+  bool add(const FrameMetrics &frameMetrics);
+
+  [[nodiscard]] std::size_t                        getNumberOfFrames() const;
+  [[nodiscard]] std::vector<AggregatePlaneMetrics> getPlaneMetrics() const;
+
+private:
+  struct PlaneSums
+  {
+    int                   plane{};
+    int                   maxValue{};
+    double                sumOfMSE{};
+    double                sumOfSSIM{};
+    std::size_t           framesWithSSIM{};
+    std::optional<double> minimumSSIM{};
+  };
+
+  std::size_t            numberOfFrames{};
+  std::vector<PlaneSums> planeSums;
+};
+
+} // namespace libffmpeg::avutil
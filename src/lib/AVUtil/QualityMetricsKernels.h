@@ -0,0 +1,74 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* The kernels of the quality metrics. These are internal to the library. Like the RGB conversion
+ * kernels, the SIMD kernels are compiled with the instruction set enabled and must only be called
+ * if getCpuFeatures reports support. All kernels give identical results to the scalar kernels.
+ */
+
+namespace libffmpeg::avutil::qualitymetrics
+{
+
+// How the samples of one row are stored
+struct Layout
+{
+  // 1 for 8 bit formats, 2 (little endian) for higher bit depths
+  int bytesPerSample{1};
+  // Right shift of the sample value (e.g. 6 for p010 where the value is stored in the MSBs)
+  int sampleShift{};
+  // The number of bits of the sample values
+  int depth{8};
+};
+
+// The sums over one block of 4x4 samples of the two images
+struct BlockSums
+{
+  int64_t sum1{};
+  int64_t sum2{};
+  int64_t sumOfSquares1{};
+  int64_t sumOfSquares2{};
+  int64_t sumOfProducts{};
+};
+
+// A row of 4x4 blocks. The pointers point to the first of the 4 rows of samples.
+struct BlockRow
+{
+  const std::byte *data1{};
+  int              linesize1{};
+  const std::byte *data2{};
+  int              linesize2{};
+  int              numberOfBlocks{};
+};
+
+// The sum of the squared differences of the samples [startIndex, numberOfSamples) of two rows.
+uint64_t sumOfSquaredErrorsScalar(const std::byte *row1,
+                                  const std::byte *row2,
+                                  int              numberOfSamples,
+                                  const Layout    &layout,
+                                  int              startIndex);
+
+// Calculate the sums of the blocks [startBlock, row.numberOfBlocks) of the row.
+void calculateBlockSumsScalar(const BlockRow &row,
+                              const Layout   &layout,
+                              BlockSums      *sums,
+                              int             startBlock);
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+uint64_t sumOfSquaredErrorsAVX2(const std::byte *row1,
+                                const std::byte *row2,
+                                int              numberOfSamples,
+                                const Layout    &layout);
+void     calculateBlockSumsAVX2(const BlockRow &row, const Layout &layout, BlockSums *sums);
+#endif
+
+} // namespace libffmpeg::avutil::qualitymetrics
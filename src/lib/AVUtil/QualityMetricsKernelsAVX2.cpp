@@ -0,0 +1,191 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "QualityMetricsKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <immintrin.h>
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("avx2")
+
+namespace libffmpeg::avutil::qualitymetrics
+{
+
+namespace
+{
+
+// For 8 bit samples, the squares are summed up in 32 bit lanes. Each iteration adds at most
+// 2 * 255^2 to a lane so the lanes are widened to 64 bit after this many iterations.
+constexpr int MAX_ITERATIONS_32BIT = 8192;
+
+// The block sums are calculated in 32 bit lanes. 16 squared samples fit for up to 12 bits.
+constexpr int MAX_DEPTH_32BIT_BLOCK_SUMS = 12;
+
+uint64_t horizontalSum64(const __m256i value)
+{
+  const auto sum = _mm_add_epi64(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) +
+         static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+}
+
+__m256i widenAndAdd(const __m256i sum64, const __m256i sum32)
+{
+  const auto lower = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(sum32));
+  const auto upper = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(sum32, 1));
+  return _mm256_add_epi64(sum64, _mm256_add_epi64(lower, upper));
+}
+
+uint64_t sumOfSquaredErrors8Bit(const std::byte *row1,
+                                const std::byte *row2,
+                                const int        numberOfSamples,
+                                const Layout    &layout,
+                                int             &x)
+{
+  const auto shift = _mm_cvtsi32_si128(layout.sampleShift);
+
+  auto sum64 = _mm256_setzero_si256();
+  while (x + 16 <= numberOfSamples)
+  {
+    auto sum32 = _mm256_setzero_si256();
+    for (int iteration = 0; iteration < MAX_ITERATIONS_32BIT && x + 16 <= numberOfSamples;
+         ++iteration, x += 16)
+    {
+      const auto a = _mm256_srl_epi16(
+          _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x))),
+          shift);
+      const auto b = _mm256_srl_epi16(
+          _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row2 + x))),
+          shift);
+      const auto difference = _mm256_sub_epi16(a, b);
+      sum32 = _mm256_add_epi32(sum32, _mm256_madd_epi16(difference, difference));
+    }
+    sum64 = widenAndAdd(sum64, sum32);
+  }
+  return horizontalSum64(sum64);
+}
+
+uint64_t sumOfSquaredErrors16Bit(const std::byte *row1,
+                                 const std::byte *row2,
+                                 const int        numberOfSamples,
+                                 const Layout    &layout,
+                                 int             &x)
+{
+  const auto shift = _mm_cvtsi32_si128(layout.sampleShift);
+
+  // The squares of 16 bit differences do not fit into 32 bit. Multiply the even and odd lanes
+  // separately into 64 bit products.
+  auto sum64 = _mm256_setzero_si256();
+  for (; x + 8 <= numberOfSamples; x += 8)
+  {
+    const auto a = _mm256_srl_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 2))),
+        shift);
+    const auto b = _mm256_srl_epi32(
+        _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row2 + x * 2))),
+        shift);
+    const auto difference = _mm256_sub_epi32(a, b);
+    const auto odd        = _mm256_srli_epi64(difference, 32);
+    sum64 = _mm256_add_epi64(sum64, _mm256_mul_epi32(difference, difference));
+    sum64 = _mm256_add_epi64(sum64, _mm256_mul_epi32(odd, odd));
+  }
+  return horizontalSum64(sum64);
+}
+
+// Load 8 samples and widen them to 32 bit
+__m256i load8(const std::byte *data, const int index, const Layout &layout, const __m128i shift)
+{
+  if (layout.bytesPerSample == 1)
+  {
+    const auto samples = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + index));
+    return _mm256_srl_epi32(_mm256_cvtepu8_epi32(samples), shift);
+  }
+  const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index * 2));
+  return _mm256_srl_epi32(_mm256_cvtepu16_epi32(samples), shift);
+}
+
+} // namespace
+
+uint64_t sumOfSquaredErrorsAVX2(const std::byte *row1,
+                                const std::byte *row2,
+                                const int        numberOfSamples,
+                                const Layout    &layout)
+{
+  int        x   = 0;
+  const auto sum = (layout.bytesPerSample == 1)
+                       ? sumOfSquaredErrors8Bit(row1, row2, numberOfSamples, layout, x)
+                       : sumOfSquaredErrors16Bit(row1, row2, numberOfSamples, layout, x);
+  return sum + sumOfSquaredErrorsScalar(row1, row2, numberOfSamples, layout, x);
+}
+
+void calculateBlockSumsAVX2(const BlockRow &row, const Layout &layout, BlockSums *sums)
+{
+  if (layout.depth > MAX_DEPTH_32BIT_BLOCK_SUMS)
+  {
+    calculateBlockSumsScalar(row, layout, sums, 0);
+    return;
+  }
+
+  const auto shift = _mm_cvtsi32_si128(layout.sampleShift);
+
+  // Two blocks (8 samples) per iteration. Lanes 0-3 belong to the first and 4-7 to the second
+  // block.
+  int block = 0;
+  for (; block + 2 <= row.numberOfBlocks; block += 2)
+  {
+    auto sum1          = _mm256_setzero_si256();
+    auto sum2          = _mm256_setzero_si256();
+    auto sumOfSquares1 = _mm256_setzero_si256();
+    auto sumOfSquares2 = _mm256_setzero_si256();
+    auto sumOfProducts = _mm256_setzero_si256();
+    for (int y = 0; y < 4; ++y)
+    {
+      const auto a = load8(row.data1 + static_cast<std::ptrdiff_t>(y) * row.linesize1,
+                           block * 4,
+                           layout,
+                           shift);
+      const auto b = load8(row.data2 + static_cast<std::ptrdiff_t>(y) * row.linesize2,
+                           block * 4,
+                           layout,
+                           shift);
+      sum1          = _mm256_add_epi32(sum1, a);
+      sum2          = _mm256_add_epi32(sum2, b);
+      sumOfSquares1 = _mm256_add_epi32(sumOfSquares1, _mm256_mullo_epi32(a, a));
+      sumOfSquares2 = _mm256_add_epi32(sumOfSquares2, _mm256_mullo_epi32(b, b));
+      sumOfProducts = _mm256_add_epi32(sumOfProducts, _mm256_mullo_epi32(a, b));
+    }
+
+    // [sum1, sum2, sumOfSquares1, sumOfSquares2] of the first block in the lower and of the
+    // second block in the upper half
+    const auto combinedSums = _mm256_hadd_epi32(_mm256_hadd_epi32(sum1, sum2),
+                                                _mm256_hadd_epi32(sumOfSquares1, sumOfSquares2));
+    const auto productsPairs = _mm256_hadd_epi32(sumOfProducts, sumOfProducts);
+    const auto products      = _mm256_hadd_epi32(productsPairs, productsPairs);
+
+    alignas(32) int32_t sumValues[8];
+    alignas(32) int32_t productValues[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(sumValues), combinedSums);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(productValues), products);
+
+    for (int i = 0; i < 2; ++i)
+    {
+      auto &blockSums         = sums[block + i];
+      blockSums.sum1          = sumValues[i * 4];
+      blockSums.sum2          = sumValues[i * 4 + 1];
+      blockSums.sumOfSquares1 = sumValues[i * 4 + 2];
+      blockSums.sumOfSquares2 = sumValues[i * 4 + 3];
+      blockSums.sumOfProducts = productValues[i * 4];
+    }
+  }
+
+  calculateBlockSumsScalar(row, layout, sums, block);
+}
+
+} // namespace libffmpeg::avutil::qualitymetrics
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
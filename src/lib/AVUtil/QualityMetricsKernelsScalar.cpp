@@ -0,0 +1,69 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "QualityMetricsKernels.h"
+
+namespace libffmpeg::avutil::qualitymetrics
+{
+
+namespace
+{
+
+int64_t loadSample(const std::byte *data, const int index, const Layout &layout)
+{
+  if (layout.bytesPerSample == 1)
+    return static_cast<int64_t>(data[index]) >> layout.sampleShift;
+
+  const auto bytes = data + index * 2;
+  const auto value = static_cast<int64_t>(bytes[0]) | (static_cast<int64_t>(bytes[1]) << 8);
+  return value >> layout.sampleShift;
+}
+
+} // namespace
+
+uint64_t sumOfSquaredErrorsScalar(const std::byte *row1,
+                                  const std::byte *row2,
+                                  const int        numberOfSamples,
+                                  const Layout    &layout,
+                                  const int        startIndex)
+{
+  uint64_t sum{};
+  for (int i = startIndex; i < numberOfSamples; ++i)
+  {
+    const auto difference = loadSample(row1, i, layout) - loadSample(row2, i, layout);
+    sum += static_cast<uint64_t>(difference * difference);
+  }
+  return sum;
+}
+
+void calculateBlockSumsScalar(const BlockRow &row,
+                              const Layout   &layout,
+                              BlockSums      *sums,
+                              const int       startBlock)
+{
+  for (int block = startBlock; block < row.numberOfBlocks; ++block)
+  {
+    BlockSums blockSums;
+    for (int y = 0; y < 4; ++y)
+    {
+      const auto line1 = row.data1 + static_cast<std::ptrdiff_t>(y) * row.linesize1;
+      const auto line2 = row.data2 + static_cast<std::ptrdiff_t>(y) * row.linesize2;
+      for (int x = block * 4; x < block * 4 + 4; ++x)
+      {
+        const auto a = loadSample(line1, x, layout);
+        const auto b = loadSample(line2, x, layout);
+        blockSums.sum1 += a;
+        blockSums.sum2 += b;
+        blockSums.sumOfSquares1 += a * a;
+        blockSums.sumOfSquares2 += b * b;
+        blockSums.sumOfProducts += a * b;
+      }
+    }
+    sums[block] = blockSums;
+  }
+}
+
+} // namespace libffmpeg::avutil::qualitymetrics
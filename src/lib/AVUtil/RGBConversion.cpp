@@ -0,0 +1,297 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "RGBConversion.h"
+
+#include "RGBConversionKernels.h"
+
+#include <common/CpuFeatures.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace libffmpeg::avutil
+{
+
+namespace
+{
+
+using rgbconversion::Coefficients;
+using rgbconversion::Layout;
+using rgbconversion::Row;
+
+// Bands should not be too small. Otherwise starting the threads takes longer than the conversion.
+constexpr int MIN_ROWS_PER_BAND = 32;
+
+struct PlaneLayout
+{
+  Layout layout{};
+  int    heightShift{};
+  int    depth{};
+
+  std::array<int, 3> plane{};
+  std::array<int, 3> offset{};
+};
+
+std::optional<PlaneLayout> analyzePixelFormat(const PixelFormatDescriptor &pixelFormat)
+{
+  const auto &flags = pixelFormat.flags;
+  if (flags.rgb || flags.pallette || flags.pseudoPallette || flags.bitwisePacked ||
+      flags.hwAccelerated || flags.bigEndian || flags.floatValues || flags.bayerPattern)
+    return {};
+  if (pixelFormat.numberOfComponents < 3 || pixelFormat.componentDescriptors.size() < 3)
+    return {};
+
+  const auto &shift = pixelFormat.shiftLumaToChroma;
+  if (shift.widthShift < 0 || shift.widthShift > 1 || shift.heightShift < 0 ||
+      shift.heightShift > 1)
+    return {};
+
+  const auto &luma = pixelFormat.componentDescriptors.at(0);
+  const auto &cb   = pixelFormat.componentDescriptors.at(1);
+  const auto &cr   = pixelFormat.componentDescriptors.at(2);
+
+  if (luma.depth < 8 || luma.depth > 12 || cb.depth != luma.depth || cr.depth != luma.depth)
+    return {};
+  if (cb.shift != luma.shift || cr.shift != luma.shift)
+    return {};
+
+  PlaneLayout planeLayout;
+  planeLayout.depth       = luma.depth;
+  planeLayout.heightShift = shift.heightShift;
+
+  auto &layout            = planeLayout.layout;
+  layout.bytesPerSample   = (luma.depth + luma.shift > 8) ? 2 : 1;
+  layout.sampleShift      = luma.shift;
+  layout.chromaWidthShift = shift.widthShift;
+
+  if (luma.step != layout.bytesPerSample || luma.offset != 0 || luma.plane == cb.plane ||
+      luma.plane == cr.plane)
+    return {};
+
+  const auto interleavedChroma = (cb.plane == cr.plane);
+  layout.chromaStep            = interleavedChroma ? 2 : 1;
+  if (cb.step != layout.bytesPerSample * layout.chromaStep || cr.step != cb.step)
+    return {};
+  if (interleavedChroma && std::abs(cb.offset - cr.offset) != layout.bytesPerSample)
+    return {};
+  if (!interleavedChroma && (cb.offset != 0 || cr.offset != 0))
+    return {};
+
+  planeLayout.plane  = {luma.plane, cb.plane, cr.plane};
+  planeLayout.offset = {0, cb.offset, cr.offset};
+  return planeLayout;
+}
+
+struct MatrixCoefficients
+{
+  double kr{};
+  double kb{};
+};
+
+std::optional<MatrixCoefficients> getMatrixCoefficients(const ColorSpace colorSpace)
+{
+  switch (colorSpace)
+  {
+  case ColorSpace::UNSPECIFIED:
+  case ColorSpace::BT470BG:
+  case ColorSpace::SMPTE170M:
+    return MatrixCoefficients({0.299, 0.114});
+  case ColorSpace::BT709:
+    return MatrixCoefficients({0.2126, 0.0722});
+  case ColorSpace::FCC:
+    return MatrixCoefficients({0.30, 0.11});
+  case ColorSpace::SMPTE240M:
+    return MatrixCoefficients({0.212, 0.087});
+  case ColorSpace::BT2020_NCL:
+  case ColorSpace::BT2020_CL:
+    return MatrixCoefficients({0.2627, 0.0593});
+  default:
+    return {};
+  }
+}
+
+Coefficients calculateCoefficients(const MatrixCoefficients matrix,
+                                   const int                depth,
+                                   const bool               fullRange)
+{
+  const auto toFixedPoint = [](const double value)
+  { return static_cast<int32_t>(std::lround(value * (1 << rgbconversion::COEFFICIENT_BITS))); };
+
+  const auto bitDepthShift = depth - 8;
+  const auto kg            = 1.0 - matrix.kr - matrix.kb;
+  const auto lumaScale     = fullRange ? 1.0 : 255.0 / 219.0;
+  const auto chromaScale   = fullRange ? 1.0 : 255.0 / 224.0;
+
+  Coefficients c;
+  c.yOffset      = fullRange ? 0 : (16 << bitDepthShift);
+  c.yScale       = toFixedPoint(lumaScale);
+  c.chromaOffset = 128 << bitDepthShift;
+  c.vToR         = toFixedPoint(2.0 * (1.0 - matrix.kr) * chromaScale);
+  c.uToG         = -toFixedPoint(2.0 * matrix.kb * (1.0 - matrix.kb) / kg * chromaScale);
+  c.vToG         = -toFixedPoint(2.0 * matrix.kr * (1.0 - matrix.kr) / kg * chromaScale);
+  c.uToB         = toFixedPoint(2.0 * (1.0 - matrix.kb) * chromaScale);
+  c.outputShift  = rgbconversion::COEFFICIENT_BITS + bitDepthShift;
+  c.rounding     = 1 << (c.outputShift - 1);
+  return c;
+}
+
+using RowFunction = void (*)(const Row &, const Layout &, const Coefficients &);
+
+void convertRowScalar(const Row &row, const Layout &layout, const Coefficients &c)
+{
+  rgbconversion::convertRowScalar(row, layout, c, 0);
+}
+
+RowFunction selectRowFunction(const RGBConversionSettings::Implementation implementation)
+{
+  using Implementation = RGBConversionSettings::Implementation;
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  const auto cpuFeatures = getCpuFeatures();
+  if ((implementation == Implementation::Auto || implementation == Implementation::AVX2) &&
+      cpuFeatures.avx2)
+    return rgbconversion::convertRowAVX2;
+  if ((implementation == Implementation::Auto || implementation == Implementation::SSE41) &&
+      cpuFeatures.sse41)
+    return rgbconversion::convertRowSSE41;
+#endif
+
+  return convertRowScalar;
+}
+
+unsigned getNumberOfThreads(const RGBConversionSettings &settings, const int height)
+{
+  auto numberOfThreads = settings.numberOfThreads;
+  if (numberOfThreads == 0)
+    numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  const auto maxBands = static_cast<unsigned>(std::max(1, height / MIN_ROWS_PER_BAND));
+  return std::min(numberOfThreads, maxBands);
+}
+
+} // namespace
+
+bool isRGBConversionSupported(const PixelFormatDescriptor &pixelFormat)
+{
+  return analyzePixelFormat(pixelFormat).has_value();
+}
+
+bool convertToRGB(const YUVImage             &image,
+                  const ColorSpace            colorSpace,
+                  std::byte                  *output,
+                  const int                   outputLinesize,
+                  const RGBConversionSettings settings)
+{
+  const auto planeLayout = analyzePixelFormat(image.pixelFormat);
+  const auto matrix      = getMatrixCoefficients(colorSpace);
+  if (!planeLayout || !matrix || output == nullptr)
+    return false;
+
+  const auto size = image.size;
+  if (size.width <= 0 || size.height <= 0)
+    return false;
+
+  auto layout = planeLayout->layout;
+  layout.rgba = (settings.format == RGBFormat::RGBA);
+
+  const auto bytesPerPixel = layout.rgba ? 4 : 3;
+  if (outputLinesize < size.width * bytesPerPixel)
+    return false;
+
+  for (const auto plane : planeLayout->plane)
+    if (image.data.at(plane) == nullptr)
+      return false;
+
+  const auto coefficients = calculateCoefficients(*matrix, planeLayout->depth, settings.fullRange);
+  const auto rowFunction  = selectRowFunction(settings.implementation);
+
+  const auto convertRows = [&](const int startRow, const int endRow)
+  {
+    for (int y = startRow; y < endRow; ++y)
+    {
+      const auto chromaY = y >> planeLayout->heightShift;
+
+      const auto planeRow = [&](const int component, const int row)
+      {
+        const auto plane = planeLayout->plane.at(component);
+        return image.data.at(plane) + static_cast<std::ptrdiff_t>(row) * image.linesize.at(plane) +
+               planeLayout->offset.at(component);
+      };
+
+      Row rowToConvert;
+      rowToConvert.y      = planeRow(0, y);
+      rowToConvert.u      = planeRow(1, chromaY);
+      rowToConvert.v      = planeRow(2, chromaY);
+      rowToConvert.output = output + static_cast<std::ptrdiff_t>(y) * outputLinesize;
+      rowToConvert.width  = size.width;
+      rowFunction(rowToConvert, layout, coefficients);
+    }
+  };
+
+  const auto numberOfThreads = getNumberOfThreads(settings, size.height);
+  if (numberOfThreads == 1)
+  {
+    convertRows(0, size.height);
+    return true;
+  }
+
+  const auto rowsPerBand = (size.height + static_cast<int>(numberOfThreads) - 1) /
+                           static_cast<int>(numberOfThreads);
+
+  std::vector<std::thread> threads;
+  for (unsigned band = 1; band < numberOfThreads; ++band)
+  {
+    const auto startRow = static_cast<int>(band) * rowsPerBand;
+    const auto endRow   = std::min(size.height, startRow + rowsPerBand);
+    if (startRow < endRow)
+      threads.emplace_back(convertRows, startRow, endRow);
+  }
+  convertRows(0, std::min(size.height, rowsPerBand));
+
+  for (auto &thread : threads)
+    thread.join();
+
+  return true;
+}
+
+bool convertToRGB(const AVFrameWrapper       &frame,
+                  const ColorSpace            colorSpace,
+                  std::byte                  *output,
+                  const int                   outputLinesize,
+                  const RGBConversionSettings settings)
+{
+  YUVImage image;
+  image.pixelFormat = frame.getPixelFormatDescriptor();
+  image.size        = frame.getSize();
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    const auto framePlane    = frame.getPlane(plane);
+    image.data.at(plane)     = framePlane.data;
+    image.linesize.at(plane) = framePlane.linesize;
+  }
+
+  return convertToRGB(image, colorSpace, output, outputLinesize, settings);
+}
+
+ByteVector convertToRGB(const AVFrameWrapper       &frame,
+                        const ColorSpace            colorSpace,
+                        const RGBConversionSettings settings)
+{
+  const auto size          = frame.getSize();
+  const auto bytesPerPixel = (settings.format == RGBFormat::RGBA) ? 4 : 3;
+  if (size.width <= 0 || size.height <= 0)
+    return {};
+
+  ByteVector output(static_cast<std::size_t>(size.width) * size.height * bytesPerPixel);
+  if (!convertToRGB(frame, colorSpace, output.data(), size.width * bytesPerPixel, settings))
+    return {};
+  return output;
+}
+
+} // namespace libffmpeg::avutil
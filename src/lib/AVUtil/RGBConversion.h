@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/ColorSpace.h>
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <AVUtil/wrappers/AVPixFmtDescriptorConversion.h>
+#include <common/Types.h>
+
+#include <array>
+
+namespace libffmpeg::avutil
+{
+
+/* Conversion of YUV frames to packed RGB. Supported are planar YUV with 4:2:0, 4:2:2 or 4:4:4
+ * subsampling and semi planar formats with interleaved chroma (nv12 / p010) with 8 to 12 bits
+ * (little endian). Chroma is upsampled by repeating samples (nearest neighbour).
+ *
+ * The conversion uses integer math with kernels for SSE4.1 and AVX2 which are selected at
+ * runtime. All kernels produce identical results to the scalar kernel.
+ */
+
+enum class RGBFormat
+{
+  RGB24, // 3 bytes per pixel: R, G, B
+  RGBA   // 4 bytes per pixel: R, G, B, A (alpha is 255)
+};
+
+struct RGBConversionSettings
+{
+  enum class Implementation
+  {
+    Auto,
+    Scalar,
+    SSE41,
+    AVX2
+  };
+
+  RGBFormat format{RGBFormat::RGBA};
+  // Full range (0-255) instead of limited range (16-235) input
+  bool fullRange{};
+  // The image is split into bands of rows that are converted in parallel. 0 means one thread per
+  // hardware thread. Small images are not split.
+  unsigned numberOfThreads{1};
+  // Auto selects the best implementation that is supported by the CPU. Selecting an
+  // implementation that is not supported falls back to Scalar.
+  Implementation implementation{Implementation::Auto};
+};
+
+// The planes of an image in memory
+struct YUVImage
+{
+  PixelFormatDescriptor            pixelFormat{};
+  Size                             size{};
+  std::array<const std::byte *, 4> data{};
+  std::array<int, 4>               linesize{};
+};
+
+[[nodiscard]] bool isRGBConversionSupported(const PixelFormatDescriptor &pixelFormat);
+
+// Write the RGB image to output. Each line of the output is outputLinesize bytes long. Returns
+// false if the pixel format is not supported. The color space selects the matrix (BT.601, BT.709,
+// BT.2020, SMPTE 240M or FCC). If it is unspecified, BT.601 is used.
+bool convertToRGB(const YUVImage             &image,
+                  const ColorSpace            colorSpace,
+                  std::byte                  *output,
+                  const int                   outputLinesize,
+                  const RGBConversionSettings settings = {});
+
+bool convertToRGB(const AVFrameWrapper       &frame,
+                  const ColorSpace            colorSpace,
+                  std::byte                  *output,
+                  const int                   outputLinesize,
+                  const RGBConversionSettings settings = {});
+
+// Convert into a new buffer without padding. Returns an empty vector if the conversion failed.
+[[nodiscard]] ByteVector convertToRGB(const AVFrameWrapper       &frame,
+                                      const ColorSpace            colorSpace,
+                                      const RGBConversionSettings settings = {});
+
+} // namespace libffmpeg::avutil
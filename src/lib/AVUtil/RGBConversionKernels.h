@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* The row kernels of the YUV to RGB conversion. These are internal to the library. The SIMD
+ * kernels are compiled with the corresponding instruction set enabled (see
+ * LIBFFMPEG_BEGIN_KERNEL_TARGET) so the files must not define any inline functions or templates
+ * that could also be used from other files (ODR). Only call them if getCpuFeatures reports support.
+ */
+
+namespace libffmpeg::avutil::rgbconversion
+{
+
+// Fixed point coefficients with COEFFICIENT_BITS fractional bits. All kernels use the same 32 bit
+// integer arithmetic so they give bit identical results:
+//   y = (Y - yOffset) * yScale
+//   R = (y + (V - chromaOffset) * vToR + rounding) >> outputShift
+//   G = (y + (U - chromaOffset) * uToG + (V - chromaOffset) * vToG + rounding) >> outputShift
+//   B = (y + (U - chromaOffset) * uToB + rounding) >> outputShift
+// The results are clipped to 0..255.
+constexpr int COEFFICIENT_BITS = 16;
+
+struct Coefficients
+{
+  int32_t yOffset{};
+  int32_t yScale{};
+  int32_t chromaOffset{};
+  int32_t vToR{};
+  int32_t uToG{};
+  int32_t vToG{};
+  int32_t uToB{};
+  int32_t outputShift{};
+  int32_t rounding{};
+};
+
+// How the samples of one row are stored
+struct Layout
+{
+  // 1 for 8 bit formats, 2 (little endian) for higher bit depths
+  int bytesPerSample{1};
+  // Right shift of the sample value (e.g. 6 for p010 where the value is stored in the MSBs)
+  int sampleShift{};
+  // 1 if there is one chroma sample for two luma samples horizontally
+  int chromaWidthShift{};
+  // Number of samples between two horizontally neighbouring chroma values. 1 for planar chroma,
+  // 2 for interleaved chroma (nv12).
+  int chromaStep{1};
+  // Output 4 bytes per pixel (RGBA with alpha 255) instead of 3 bytes (RGB)
+  bool rgba{};
+};
+
+struct Row
+{
+  const std::byte *y{};
+  const std::byte *u{};
+  const std::byte *v{};
+  std::byte       *output{};
+  int              width{};
+};
+
+// Convert the pixels [startX, row.width) of the row.
+void convertRowScalar(const Row &row, const Layout &layout, const Coefficients &c, int startX);
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+void convertRowSSE41(const Row &row, const Layout &layout, const Coefficients &c);
+void convertRowAVX2(const Row &row, const Layout &layout, const Coefficients &c);
+#endif
+
+} // namespace libffmpeg::avutil::rgbconversion
@@ -0,0 +1,139 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "RGBConversionKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <cstring>
+#include <immintrin.h>
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("avx2")
+
+namespace libffmpeg::avutil::rgbconversion
+{
+
+namespace
+{
+
+// Load 8 samples and widen them to 32 bit
+__m256i load8(const std::byte *data, const int index, const Layout &layout, const __m128i shift)
+{
+  if (layout.bytesPerSample == 1)
+  {
+    const auto samples = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + index));
+    return _mm256_srl_epi32(_mm256_cvtepu8_epi32(samples), shift);
+  }
+  const auto samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index * 2));
+  return _mm256_srl_epi32(_mm256_cvtepu16_epi32(samples), shift);
+}
+
+// Load 4 samples into the lower half and widen them to 32 bit
+__m256i load4(const std::byte *data, const int index, const Layout &layout, const __m128i shift)
+{
+  if (layout.bytesPerSample == 1)
+  {
+    int32_t samples;
+    std::memcpy(&samples, data + index, 4);
+    return _mm256_srl_epi32(_mm256_cvtepu8_epi32(_mm_cvtsi32_si128(samples)), shift);
+  }
+  const auto samples = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + index * 2));
+  return _mm256_srl_epi32(_mm256_cvtepu16_epi32(samples), shift);
+}
+
+// Load the chroma samples for 8 luma samples
+__m256i loadChroma8(const std::byte *data, const int x, const Layout &layout, const __m128i shift)
+{
+  if (layout.chromaWidthShift == 0)
+    return load8(data, x, layout, shift);
+
+  if (layout.chromaStep == 1)
+  {
+    // [c0 c1 c2 c3 - - - -] -> [c0 c0 c1 c1 c2 c2 c3 c3]
+    const auto samples = load4(data, x >> 1, layout, shift);
+    return _mm256_permutevar8x32_epi32(samples, _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+  }
+
+  // [c0 - c1 - c2 - c3 -] -> [c0 c0 c1 c1 c2 c2 c3 c3]
+  const auto samples = load8(data, (x >> 1) * 2, layout, shift);
+  return _mm256_permutevar8x32_epi32(samples, _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6));
+}
+
+__m256i clipToByte(const __m256i value)
+{
+  return _mm256_min_epi32(_mm256_max_epi32(value, _mm256_setzero_si256()),
+                          _mm256_set1_epi32(255));
+}
+
+} // namespace
+
+void convertRowAVX2(const Row &row, const Layout &layout, const Coefficients &c)
+{
+  if (layout.chromaWidthShift > 1 || (layout.chromaWidthShift == 0 && layout.chromaStep != 1))
+  {
+    convertRowScalar(row, layout, c, 0);
+    return;
+  }
+
+  const auto sampleShift  = _mm_cvtsi32_si128(layout.sampleShift);
+  const auto outputShift  = _mm_cvtsi32_si128(c.outputShift);
+  const auto yOffset      = _mm256_set1_epi32(c.yOffset);
+  const auto yScale       = _mm256_set1_epi32(c.yScale);
+  const auto chromaOffset = _mm256_set1_epi32(c.chromaOffset);
+  const auto vToR         = _mm256_set1_epi32(c.vToR);
+  const auto uToG         = _mm256_set1_epi32(c.uToG);
+  const auto vToG         = _mm256_set1_epi32(c.vToG);
+  const auto uToB         = _mm256_set1_epi32(c.uToB);
+  const auto rounding     = _mm256_set1_epi32(c.rounding);
+  const auto alpha        = _mm256_set1_epi32(static_cast<int32_t>(0xff000000u));
+  const auto dropAlpha    = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+
+  // Stop early so that no load / store (RGB stores 2x16 bytes for 24 bytes of output) exceeds
+  // the row. The rest is done by the scalar kernel.
+  int x = 0;
+  for (; x + 16 <= row.width; x += 8)
+  {
+    const auto ySamples = load8(row.y, x, layout, sampleShift);
+    const auto uSamples = loadChroma8(row.u, x, layout, sampleShift);
+    const auto vSamples = loadChroma8(row.v, x, layout, sampleShift);
+
+    const auto y = _mm256_add_epi32(
+        _mm256_mullo_epi32(_mm256_sub_epi32(ySamples, yOffset), yScale), rounding);
+    const auto u = _mm256_sub_epi32(uSamples, chromaOffset);
+    const auto v = _mm256_sub_epi32(vSamples, chromaOffset);
+
+    const auto r = _mm256_add_epi32(y, _mm256_mullo_epi32(v, vToR));
+    const auto g = _mm256_add_epi32(_mm256_add_epi32(y, _mm256_mullo_epi32(u, uToG)),
+                                    _mm256_mullo_epi32(v, vToG));
+    const auto b = _mm256_add_epi32(y, _mm256_mullo_epi32(u, uToB));
+
+    const auto pixels = _mm256_or_si256(
+        _mm256_or_si256(clipToByte(_mm256_sra_epi32(r, outputShift)),
+                        _mm256_slli_epi32(clipToByte(_mm256_sra_epi32(g, outputShift)), 8)),
+        _mm256_or_si256(_mm256_slli_epi32(clipToByte(_mm256_sra_epi32(b, outputShift)), 16),
+                        alpha));
+
+    if (layout.rgba)
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(row.output + x * 4), pixels);
+    else
+    {
+      const auto rgb = _mm256_shuffle_epi8(pixels, dropAlpha);
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(row.output + x * 3),
+                       _mm256_castsi256_si128(rgb));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(row.output + x * 3 + 12),
+                       _mm256_extracti128_si256(rgb, 1));
+    }
+  }
+
+  convertRowScalar(row, layout, c, x);
+}
+
+} // namespace libffmpeg::avutil::rgbconversion
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
@@ -0,0 +1,114 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "RGBConversionKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <cstring>
+#include <immintrin.h>
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("sse4.1")
+
+namespace libffmpeg::avutil::rgbconversion
+{
+
+namespace
+{
+
+// Load 4 samples and widen them to 32 bit
+__m128i load4(const std::byte *data, const int index, const Layout &layout, const __m128i shift)
+{
+  if (layout.bytesPerSample == 1)
+  {
+    int32_t samples;
+    std::memcpy(&samples, data + index, 4);
+    return _mm_srl_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(samples)), shift);
+  }
+  const auto samples = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data + index * 2));
+  return _mm_srl_epi32(_mm_cvtepu16_epi32(samples), shift);
+}
+
+// Load the chroma samples for 4 luma samples
+__m128i loadChroma4(const std::byte *data, const int x, const Layout &layout, const __m128i shift)
+{
+  if (layout.chromaWidthShift == 0)
+    return load4(data, x, layout, shift);
+
+  const auto samples = load4(data, (x >> 1) * layout.chromaStep, layout, shift);
+  // Planar: [c0 c1 c2 c3] -> [c0 c0 c1 c1]. Interleaved: [c0 x c1 x] -> [c0 c0 c1 c1]
+  if (layout.chromaStep == 1)
+    return _mm_shuffle_epi32(samples, _MM_SHUFFLE(1, 1, 0, 0));
+  return _mm_shuffle_epi32(samples, _MM_SHUFFLE(2, 2, 0, 0));
+}
+
+__m128i clipToByte(const __m128i value)
+{
+  return _mm_min_epi32(_mm_max_epi32(value, _mm_setzero_si128()), _mm_set1_epi32(255));
+}
+
+} // namespace
+
+void convertRowSSE41(const Row &row, const Layout &layout, const Coefficients &c)
+{
+  if (layout.chromaWidthShift > 1 || (layout.chromaWidthShift == 0 && layout.chromaStep != 1))
+  {
+    convertRowScalar(row, layout, c, 0);
+    return;
+  }
+
+  const auto sampleShift  = _mm_cvtsi32_si128(layout.sampleShift);
+  const auto outputShift  = _mm_cvtsi32_si128(c.outputShift);
+  const auto yOffset      = _mm_set1_epi32(c.yOffset);
+  const auto yScale       = _mm_set1_epi32(c.yScale);
+  const auto chromaOffset = _mm_set1_epi32(c.chromaOffset);
+  const auto vToR         = _mm_set1_epi32(c.vToR);
+  const auto uToG         = _mm_set1_epi32(c.uToG);
+  const auto vToG         = _mm_set1_epi32(c.vToG);
+  const auto uToB         = _mm_set1_epi32(c.uToB);
+  const auto rounding     = _mm_set1_epi32(c.rounding);
+  const auto alpha        = _mm_set1_epi32(static_cast<int32_t>(0xff000000u));
+  const auto dropAlpha    = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+  // Stop early so that no load / store (RGB stores 16 bytes for 12 bytes of output) exceeds the
+  // row. The rest is done by the scalar kernel.
+  int x = 0;
+  for (; x + 8 <= row.width; x += 4)
+  {
+    const auto ySamples = load4(row.y, x, layout, sampleShift);
+    const auto uSamples = loadChroma4(row.u, x, layout, sampleShift);
+    const auto vSamples = loadChroma4(row.v, x, layout, sampleShift);
+
+    const auto y =
+        _mm_add_epi32(_mm_mullo_epi32(_mm_sub_epi32(ySamples, yOffset), yScale), rounding);
+    const auto u = _mm_sub_epi32(uSamples, chromaOffset);
+    const auto v = _mm_sub_epi32(vSamples, chromaOffset);
+
+    const auto r = _mm_sra_epi32(_mm_add_epi32(y, _mm_mullo_epi32(v, vToR)), outputShift);
+    const auto g = _mm_sra_epi32(
+        _mm_add_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, uToG)), _mm_mullo_epi32(v, vToG)),
+        outputShift);
+    const auto b = _mm_sra_epi32(_mm_add_epi32(y, _mm_mullo_epi32(u, uToB)), outputShift);
+
+    const auto pixels =
+        _mm_or_si128(_mm_or_si128(clipToByte(r), _mm_slli_epi32(clipToByte(g), 8)),
+                     _mm_or_si128(_mm_slli_epi32(clipToByte(b), 16), alpha));
+
+    if (layout.rgba)
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(row.output + x * 4), pixels);
+    else
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(row.output + x * 3),
+                       _mm_shuffle_epi8(pixels, dropAlpha));
+  }
+
+  convertRowScalar(row, layout, c, x);
+}
+
+} // namespace libffmpeg::avutil::rgbconversion
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
@@ -0,0 +1,55 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "RGBConversionKernels.h"
+
+#include <algorithm>
+
+namespace libffmpeg::avutil::rgbconversion
+{
+
+namespace
+{
+
+int32_t loadSample(const std::byte *data, const int index, const Layout &layout)
+{
+  if (layout.bytesPerSample == 1)
+    return static_cast<int32_t>(data[index]) >> layout.sampleShift;
+
+  const auto bytes = data + index * 2;
+  const auto value = static_cast<int32_t>(bytes[0]) | (static_cast<int32_t>(bytes[1]) << 8);
+  return value >> layout.sampleShift;
+}
+
+std::byte clipToByte(const int32_t value)
+{
+  return static_cast<std::byte>(std::clamp(value, 0, 255));
+}
+
+} // namespace
+
+void convertRowScalar(const Row &row, const Layout &layout, const Coefficients &c, const int startX)
+{
+  const auto bytesPerPixel = layout.rgba ? 4 : 3;
+
+  for (int x = startX; x < row.width; ++x)
+  {
+    const auto chromaIndex = (x >> layout.chromaWidthShift) * layout.chromaStep;
+
+    const auto y = (loadSample(row.y, x, layout) - c.yOffset) * c.yScale;
+    const auto u = loadSample(row.u, chromaIndex, layout) - c.chromaOffset;
+    const auto v = loadSample(row.v, chromaIndex, layout) - c.chromaOffset;
+
+    auto output = row.output + x * bytesPerPixel;
+    output[0]   = clipToByte((y + v * c.vToR + c.rounding) >> c.outputShift);
+    output[1]   = clipToByte((y + u * c.uToG + v * c.vToG + c.rounding) >> c.outputShift);
+    output[2]   = clipToByte((y + u * c.uToB + c.rounding) >> c.outputShift);
+    if (layout.rgba)
+      output[3] = std::byte(255);
+  }
+}
+
+} // namespace libffmpeg::avutil::rgbconversion
@@ -0,0 +1,55 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "SampleFormat.h"
+
+namespace libffmpeg::avutil
+{
+
+using libffmpeg::internal::AVSampleFormat;
+
+int getBytesPerSample(const AVSampleFormat sampleFormat)
+{
+  switch (sampleFormat)
+  {
+  case AVSampleFormat::AV_SAMPLE_FMT_U8:
+  case AVSampleFormat::AV_SAMPLE_FMT_U8P:
+    return 1;
+  case AVSampleFormat::AV_SAMPLE_FMT_S16:
+  case AVSampleFormat::AV_SAMPLE_FMT_S16P:
+    return 2;
+  case AVSampleFormat::AV_SAMPLE_FMT_S32:
+  case AVSampleFormat::AV_SAMPLE_FMT_S32P:
+  case AVSampleFormat::AV_SAMPLE_FMT_FLT:
+  case AVSampleFormat::AV_SAMPLE_FMT_FLTP:
+    return 4;
+  case AVSampleFormat::AV_SAMPLE_FMT_DBL:
+  case AVSampleFormat::AV_SAMPLE_FMT_DBLP:
+  case AVSampleFormat::AV_SAMPLE_FMT_S64:
+  case AVSampleFormat::AV_SAMPLE_FMT_S64P:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+bool isPlanar(const AVSampleFormat sampleFormat)
+{
+  switch (sampleFormat)
+  {
+  case AVSampleFormat::AV_SAMPLE_FMT_U8P:
+  case AVSampleFormat::AV_SAMPLE_FMT_S16P:
+  case AVSampleFormat::AV_SAMPLE_FMT_S32P:
+  case AVSampleFormat::AV_SAMPLE_FMT_FLTP:
+  case AVSampleFormat::AV_SAMPLE_FMT_DBLP:
+  case AVSampleFormat::AV_SAMPLE_FMT_S64P:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace libffmpeg::avutil
@@ -0,0 +1,21 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/InternalTypes.h>
+
+namespace libffmpeg::avutil
+{
+
+// The size of one sample of one channel in bytes. 0 for unknown formats.
+int getBytesPerSample(const libffmpeg::internal::AVSampleFormat sampleFormat);
+
+// Planar formats store the samples of each channel in a separate plane. Non planar (packed)
+// formats interleave the samples of all channels in one plane.
+bool isPlanar(const libffmpeg::internal::AVSampleFormat sampleFormat);
+
+} // namespace libffmpeg::avutil
@@ -22,27 +22,68 @@ AVDictionaryWrapper::AVDictionaryWrapper(AVDictionary *                    dicti
     throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
 }
 
-DictionaryMap AVDictionaryWrapper::toMap() const
+AVDictionaryWrapper::Iterator::Iterator(const AVDictionaryWrapper *dictionaryWrapper)
+    : dictionaryWrapper(dictionaryWrapper)
 {
-  if (this->dictionary == nullptr)
-    return {};
+  if (this->dictionaryWrapper != nullptr && this->dictionaryWrapper->dictionary != nullptr)
+    this->fetchNextEntry();
+}
 
-  DictionaryMap map;
+AVDictionaryWrapper::Iterator &AVDictionaryWrapper::Iterator::operator++()
+{
+  if (this->avEntry != nullptr)
+    this->fetchNextEntry();
+  return *this;
+}
 
-  AVDictionaryEntry *entry{};
-  while (true)
+AVDictionaryWrapper::Iterator AVDictionaryWrapper::Iterator::operator++(int)
+{
+  auto previous = *this;
+  ++(*this);
+  return previous;
+}
+
+void AVDictionaryWrapper::Iterator::fetchNextEntry()
+{
+  // An empty key together with AV_DICT_IGNORE_SUFFIX matches every entry in the dictionary.
+  this->avEntry = this->dictionaryWrapper->ffmpegLibraries->avutil.av_dict_get(
+      this->dictionaryWrapper->dictionary, "", this->avEntry, AV_DICT_IGNORE_SUFFIX);
+
+  if (this->avEntry == nullptr)
   {
-    entry = this->ffmpegLibraries->avutil.av_dict_get(
-        this->dictionary, "", entry, AV_DICT_IGNORE_SUFFIX);
-    if (entry == nullptr)
-      break;
+    this->currentEntry = {};
+    return;
+  }
 
-    const auto key   = std::string(entry->key);
-    const auto value = std::string(entry->value);
+  this->currentEntry.key   = this->avEntry->key ? std::string_view(this->avEntry->key) : "";
+  this->currentEntry.value = this->avEntry->value ? std::string_view(this->avEntry->value) : "";
+}
+
+std::optional<std::string_view> AVDictionaryWrapper::get(const char *key) const
+{
+  if (this->dictionary == nullptr || key == nullptr)
+    return {};
+
+  const auto entry = this->ffmpegLibraries->avutil.av_dict_get(this->dictionary, key, nullptr, 0);
+  if (entry == nullptr || entry->value == nullptr)
+    return {};
+
+  return std::string_view(entry->value);
+}
+
+std::optional<std::string_view> AVDictionaryWrapper::get(const std::string &key) const
+{
+  return this->get(key.c_str());
+}
+
+DictionaryMap AVDictionaryWrapper::toMap() const
+{
+  DictionaryMap map;
+  for (const auto &[key, value] : *this)
+  {
     if (!key.empty() || value.empty())
-      map[key] = value;
+      map[std::string(key)] = std::string(value);
   }
-
   return map;
 }
 
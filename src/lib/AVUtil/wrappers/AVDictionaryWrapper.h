@@ -8,7 +8,9 @@
 
 #include <libHandling/IFFmpegLibraries.h>
 
+#include <iterator>
 #include <map>
+#include <string_view>
 
 namespace libffmpeg::avutil
 {
@@ -25,6 +27,50 @@ public:
   explicit                    operator bool() const { return this->dictionary != nullptr; }
   [[nodiscard]] AVDictionary *getDictionary() const { return this->dictionary; }
 
+  // The key and value point directly into the AVDictionaryEntry. They are only valid as long as
+  // the dictionary is not modified or freed.
+  struct Entry
+  {
+    std::string_view key{};
+    std::string_view value{};
+  };
+
+  // Iterates over the entries of the dictionary without copying the keys or values.
+  class Iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Entry;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Entry *;
+    using reference         = const Entry &;
+
+    Iterator() = default;
+    Iterator(const AVDictionaryWrapper *dictionaryWrapper);
+
+    reference operator*() const { return this->currentEntry; }
+    pointer   operator->() const { return &this->currentEntry; }
+    Iterator &operator++();
+    Iterator  operator++(int);
+
+    bool operator==(const Iterator &other) const { return this->avEntry == other.avEntry; }
+    bool operator!=(const Iterator &other) const { return this->avEntry != other.avEntry; }
+
+  private:
+    void fetchNextEntry();
+
+    const AVDictionaryWrapper         *dictionaryWrapper{};
+    const internal::AVDictionaryEntry *avEntry{};
+    Entry                              currentEntry{};
+  };
+
+  [[nodiscard]] Iterator begin() const { return Iterator(this); }
+  [[nodiscard]] Iterator end() const { return {}; }
+
+  // Look up the value of the given key (case insensitive like in FFmpeg) without allocating.
+  [[nodiscard]] std::optional<std::string_view> get(const char *key) const;
+  [[nodiscard]] std::optional<std::string_view> get(const std::string &key) const;
+
   [[nodiscard]] DictionaryMap toMap() const;
 
 private:
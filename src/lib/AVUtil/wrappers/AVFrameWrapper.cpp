@@ -9,9 +9,12 @@
 #include "AVFrameWrapperInternal.h"
 #include "CastUtilClasses.h"
 
+#include <AVCodec/wrappers/AVChannelInternal.h>
+#include <common/Checksum.h>
 #include <common/Functions.h>
 #include <common/InternalTypes.h>
 
+#include <cstdlib>
 #include <stdexcept>
 
 namespace libffmpeg::avutil
@@ -24,6 +27,9 @@ using libffmpeg::internal::AVDictionary;
 using libffmpeg::internal::AVFrame;
 using libffmpeg::internal::AVPictureType;
 using libffmpeg::internal::AVRational;
+using libffmpeg::internal::AVSampleFormat;
+using libffmpeg::internal::avcodec::AVChannelLayout;
+using libffmpeg::internal::avcodec::AVChannelOrder;
 
 ByteVector copyFrameDataFromRawArray(const uint8_t *inputData, Size size, const int linesize)
 {
@@ -43,6 +49,19 @@ ByteVector copyFrameDataFromRawArray(const uint8_t *inputData, Size size, const
   return data;
 }
 
+// Before FFmpeg 7, the channels are a bit mask in native order. A mask of 0 means that only the
+// number of channels is known.
+avcodec::ChannelLayout channelMaskToChannelLayout(const uint64_t mask, const int numberOfChannels)
+{
+  if (mask != 0)
+    return internal::avcodec::bitMaskToChannelLayout(mask);
+
+  AVChannelLayout unspecifiedLayout;
+  unspecifiedLayout.order       = AVChannelOrder::AV_CHANNEL_ORDER_UNSPEC;
+  unspecifiedLayout.nb_channels = numberOfChannels;
+  return internal::avcodec::avChannelLayoutToChannelLayout(unspecifiedLayout);
+}
+
 } // namespace
 
 AVFrameWrapper::AVFrameWrapper(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
@@ -60,17 +79,53 @@ AVFrameWrapper::AVFrameWrapper(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries
 }
 
 AVFrameWrapper::AVFrameWrapper(AVFrameWrapper &&other) noexcept
-    : frame(std::move(other.frame)), ffmpegLibraries(std::move(other.ffmpegLibraries))
+    : memoryReservation(std::move(other.memoryReservation)), frame(std::move(other.frame)),
+      ffmpegLibraries(std::move(other.ffmpegLibraries))
 {
 }
 
 AVFrameWrapper &AVFrameWrapper::operator=(AVFrameWrapper &&other) noexcept
 {
-  this->frame           = std::move(other.frame);
-  this->ffmpegLibraries = std::move(other.ffmpegLibraries);
+  this->frame             = std::move(other.frame);
+  this->memoryReservation = std::move(other.memoryReservation);
+  this->ffmpegLibraries   = std::move(other.ffmpegLibraries);
   return *this;
 }
 
+std::span<const std::byte> AVFrameWrapper::Plane::getLine(const int y) const
+{
+  if (this->data == nullptr || y < 0 || y >= this->size.height)
+    return {};
+  const auto lineLength = static_cast<std::size_t>(std::abs(this->linesize));
+  return {this->data + static_cast<std::ptrdiff_t>(y) * this->linesize, lineLength};
+}
+
+AVFrameWrapper::Plane AVFrameWrapper::getPlane(const int component) const
+{
+  if (component < 0 || component >= internal::AV_NUM_DATA_POINTERS)
+    return {};
+
+  uint8_t *dataPointer{};
+  CAST_AVUTIL_GET_MEMBER(AVFrame, this->frame.get(), dataPointer, data[component]);
+  if (dataPointer == nullptr)
+    return {};
+
+  Plane plane;
+  plane.data     = reinterpret_cast<const std::byte *>(dataPointer);
+  plane.linesize = this->getLineSize(component);
+  plane.size =
+      getSizeOfFrameComponent(component, this->getSize(), this->getPixelFormatDescriptor());
+  return plane;
+}
+
+AVFrameWrapper AVFrameWrapper::createReference() const
+{
+  AVFrameWrapper reference(this->ffmpegLibraries);
+  if (this->ffmpegLibraries->avutil.av_frame_ref(reference.getFrame(), this->frame.get()) < 0)
+    throw std::runtime_error("Error creating a reference to the AVFrame");
+  return reference;
+}
+
 ByteVector AVFrameWrapper::getData(const int component) const
 {
   if (component < 0 || component > internal::AV_NUM_DATA_POINTERS)
@@ -110,6 +165,178 @@ Size AVFrameWrapper::getSize() const
   return {width, height};
 }
 
+std::size_t AVFrameWrapper::getDataSizeInBytes() const
+{
+  const auto size = this->getSize();
+
+  std::size_t dataSize{};
+  if (size.height <= 0)
+  {
+    // Audio frames. Every plane (one per channel for planar formats) has the size of linesize[0].
+    const auto linesize = static_cast<std::size_t>(std::abs(this->getLineSize(0)));
+    for (int plane = 0; plane < internal::AV_NUM_DATA_POINTERS; ++plane)
+    {
+      uint8_t *dataPointer{};
+      CAST_AVUTIL_GET_MEMBER(AVFrame, this->frame.get(), dataPointer, data[plane]);
+      if (dataPointer != nullptr)
+        dataSize += linesize;
+    }
+    return dataSize;
+  }
+
+  const auto heightShift = this->getPixelFormatDescriptor().shiftLumaToChroma.heightShift;
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    const auto linesize = static_cast<std::size_t>(std::abs(this->getLineSize(plane)));
+    // Plane 1 and 2 are the (subsampled) chroma planes. Rounding up like FFmpeg does.
+    const auto lines = (plane == 1 || plane == 2) ? -((-size.height) >> heightShift) : size.height;
+    dataSize += linesize * static_cast<std::size_t>(lines);
+  }
+  return dataSize;
+}
+
+uint32_t AVFrameWrapper::calculateCRC32C() const
+{
+  CRC32C crc;
+
+  const auto size = this->getSize();
+  if (size.height <= 0)
+  {
+    for (int plane = 0; plane < this->getNumberOfAudioPlanes(); ++plane)
+      crc.update(this->getAudioPlane(plane));
+    return crc.getValue();
+  }
+
+  const auto pixelFormat = this->getPixelFormatDescriptor();
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    const auto framePlane  = this->getPlane(plane);
+    const auto visibleSize = getVisiblePlaneSize(plane, size, pixelFormat);
+    if (framePlane.data == nullptr || visibleSize.width <= 0)
+      continue;
+
+    for (int y = 0; y < visibleSize.height; ++y)
+      crc.update({framePlane.data + static_cast<std::ptrdiff_t>(y) * framePlane.linesize,
+                  static_cast<std::size_t>(visibleSize.width)});
+  }
+  return crc.getValue();
+}
+
+AVSampleFormat AVFrameWrapper::getSampleFormat() const
+{
+  int format{};
+  CAST_AVUTIL_GET_MEMBER(AVFrame, this->frame.get(), format, format);
+  return static_cast<AVSampleFormat>(format);
+}
+
+int AVFrameWrapper::getSampleRate() const
+{
+  const auto version = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+
+  if (version == 54 || version == 55 || version == 56)
+    return this->ffmpegLibraries->avutil.av_frame_get_sample_rate(this->frame.get());
+  if (version == 57 || version == 58)
+    return reinterpret_cast<internal::avutil::AVFrame_57 *>(this->frame.get())->sample_rate;
+  if (version == 59)
+    return reinterpret_cast<internal::avutil::AVFrame_59 *>(this->frame.get())->sample_rate;
+  if (version == 60)
+    return reinterpret_cast<internal::avutil::AVFrame_60 *>(this->frame.get())->sample_rate;
+
+  throw std::runtime_error("Invalid library version");
+}
+
+int AVFrameWrapper::getNumberOfSamples() const
+{
+  int numberOfSamples{};
+  CAST_AVUTIL_GET_MEMBER(AVFrame, this->frame.get(), numberOfSamples, nb_samples);
+  return numberOfSamples;
+}
+
+int AVFrameWrapper::getNumberOfChannels() const
+{
+  const auto version = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+
+  if (version == 54 || version == 55 || version == 56)
+    return this->ffmpegLibraries->avutil.av_frame_get_channels(this->frame.get());
+  if (version == 57 || version == 58)
+    return reinterpret_cast<internal::avutil::AVFrame_57 *>(this->frame.get())->channels;
+  if (version == 59)
+  {
+    const auto p = reinterpret_cast<internal::avutil::AVFrame_59 *>(this->frame.get());
+    return p->ch_layout.nb_channels;
+  }
+  if (version == 60)
+  {
+    const auto p = reinterpret_cast<internal::avutil::AVFrame_60 *>(this->frame.get());
+    return p->ch_layout.nb_channels;
+  }
+
+  throw std::runtime_error("Invalid library version");
+}
+
+avcodec::ChannelLayout AVFrameWrapper::getChannelLayout() const
+{
+  const auto version = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+
+  if (version == 54 || version == 55 || version == 56)
+  {
+    const auto mask = this->ffmpegLibraries->avutil.av_frame_get_channel_layout(this->frame.get());
+    return channelMaskToChannelLayout(static_cast<uint64_t>(mask), this->getNumberOfChannels());
+  }
+  if (version == 57 || version == 58)
+  {
+    const auto p = reinterpret_cast<internal::avutil::AVFrame_57 *>(this->frame.get());
+    return channelMaskToChannelLayout(p->channel_layout, p->channels);
+  }
+  if (version == 59)
+  {
+    const auto p = reinterpret_cast<internal::avutil::AVFrame_59 *>(this->frame.get());
+    return internal::avcodec::avChannelLayoutToChannelLayout(p->ch_layout);
+  }
+  if (version == 60)
+  {
+    const auto p = reinterpret_cast<internal::avutil::AVFrame_60 *>(this->frame.get());
+    return internal::avcodec::avChannelLayoutToChannelLayout(p->ch_layout);
+  }
+
+  throw std::runtime_error("Invalid library version");
+}
+
+int AVFrameWrapper::getNumberOfAudioPlanes() const
+{
+  if (isPlanar(this->getSampleFormat()))
+    return this->getNumberOfChannels();
+  return 1;
+}
+
+std::span<const std::byte> AVFrameWrapper::getAudioPlane(const int plane) const
+{
+  if (plane < 0 || plane >= this->getNumberOfAudioPlanes())
+    return {};
+
+  // Frames with more channels than data pointers only have all planes in extended_data
+  uint8_t **extendedData{};
+  CAST_AVUTIL_GET_MEMBER(AVFrame, this->frame.get(), extendedData, extended_data);
+  if (extendedData == nullptr || extendedData[plane] == nullptr)
+    return {};
+
+  const auto format          = this->getSampleFormat();
+  auto       samplesPerPlane = this->getNumberOfSamples();
+  if (!isPlanar(format))
+    samplesPerPlane *= this->getNumberOfChannels();
+  if (samplesPerPlane <= 0)
+    return {};
+
+  const auto bytesPerSample = static_cast<std::size_t>(getBytesPerSample(format));
+  const auto bytesPerPlane  = static_cast<std::size_t>(samplesPerPlane) * bytesPerSample;
+  return {reinterpret_cast<const std::byte *>(extendedData[plane]), bytesPerPlane};
+}
+
+void AVFrameWrapper::setMemoryReservation(MemoryBudget::Reservation &&reservation)
+{
+  this->memoryReservation = std::move(reservation);
+}
+
 std::optional<int64_t> AVFrameWrapper::getPTS() const
 {
   int64_t pts{};
@@ -6,13 +6,17 @@
 
 #pragma once
 
+#include <AVCodec/Channel.h>
 #include <AVUtil/PictureType.h>
+#include <AVUtil/SampleFormat.h>
 #include <AVUtil/wrappers/AVDictionaryWrapper.h>
 #include <AVUtil/wrappers/AVPixFmtDescriptorConversion.h>
+#include <common/MemoryBudget.h>
 #include <common/Types.h>
 #include <libHandling/IFFmpegLibraries.h>
 
 #include <memory>
+#include <span>
 
 namespace libffmpeg::avutil
 {
@@ -31,6 +35,22 @@ public:
 
   [[nodiscard]] libffmpeg::internal::AVFrame *getFrame() const { return this->frame.get(); }
 
+  // Read only access to the data of one plane without copying it. The pointer is valid as long as
+  // this frame (or another reference to the same buffers) exists.
+  struct Plane
+  {
+    const std::byte *data{};
+    int              linesize{};
+    Size             size{};
+
+    [[nodiscard]] std::span<const std::byte> getLine(const int y) const;
+  };
+  [[nodiscard]] Plane getPlane(int component) const;
+
+  // Create a new frame that references the same data buffers (av_frame_ref). No data is copied.
+  // The buffers are freed when the last frame that references them is freed.
+  [[nodiscard]] AVFrameWrapper createReference() const;
+
   [[nodiscard]] ByteVector                         getData(int component) const;
   [[nodiscard]] int                                getLineSize(int component) const;
   [[nodiscard]] Size                               getSize() const;
@@ -41,6 +61,44 @@ public:
   [[nodiscard]] PixelFormatDescriptor              getPixelFormatDescriptor() const;
   [[nodiscard]] Rational                           getSampleAspectRatio() const;
 
+  // Audio frames
+  [[nodiscard]] internal::AVSampleFormat getSampleFormat() const;
+  [[nodiscard]] int                      getSampleRate() const;
+  [[nodiscard]] int                      getNumberOfSamples() const;
+  [[nodiscard]] int                      getNumberOfChannels() const;
+  [[nodiscard]] avcodec::ChannelLayout   getChannelLayout() const;
+
+  // Planar formats have one plane per channel. Packed formats have one plane with the interleaved
+  // samples of all channels.
+  [[nodiscard]] int getNumberOfAudioPlanes() const;
+
+  // Read only access to the samples of one audio plane without copying them. The span is valid as
+  // long as this frame (or another reference to the same buffers) exists.
+  [[nodiscard]] std::span<const std::byte> getAudioPlane(int plane) const;
+
+  // The samples of one audio plane as the given type (e.g. float for AV_SAMPLE_FMT_FLTP). Returns
+  // an empty span if the size of the type does not match the sample format.
+  template <typename SampleType>
+  [[nodiscard]] std::span<const SampleType> getAudioSamples(const int plane) const
+  {
+    if (sizeof(SampleType) != static_cast<std::size_t>(getBytesPerSample(this->getSampleFormat())))
+      return {};
+    const auto data = this->getAudioPlane(plane);
+    return {reinterpret_cast<const SampleType *>(data.data()), data.size() / sizeof(SampleType)};
+  }
+
+  // The number of bytes of all planes of the frame (linesize times the number of lines).
+  [[nodiscard]] std::size_t getDataSizeInBytes() const;
+
+  // CRC32C of the data of the frame without copying it. For video frames only the visible bytes
+  // of each line are included (not the padding up to the linesize), so frames with identical
+  // pictures have the same checksum independent of the memory layout. For audio frames, the
+  // samples of all planes are included.
+  [[nodiscard]] uint32_t calculateCRC32C() const;
+
+  // The reserved bytes are released when the frame is destroyed.
+  void setMemoryReservation(MemoryBudget::Reservation &&reservation);
+
   explicit operator bool() const { return this->frame != nullptr; }
 
 private:
@@ -56,6 +114,9 @@ private:
     std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
   };
 
+  // Declared first so that it is released after the frame was freed.
+  MemoryBudget::Reservation memoryReservation{};
+
   std::unique_ptr<libffmpeg::internal::AVFrame, AVFrameDeleter> frame{nullptr, AVFrameDeleter()};
   std::shared_ptr<IFFmpegLibraries>                             ffmpegLibraries{};
 };
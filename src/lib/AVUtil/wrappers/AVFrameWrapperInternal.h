@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AVCodec/wrappers/AVChannelInternal.h>
 #include <common/InternalTypes.h>
 
 namespace libffmpeg::internal::avutil
@@ -94,6 +95,8 @@ struct AVFrame_57
   int64_t                       pkt_pos;
   int64_t                       pkt_duration;
   AVDictionary                 *metadata;
+  int                           decode_error_flags;
+  int                           channels; // Deprecated
 
   // Actually, there is more here, but the variables above are the only we need.
 };
@@ -136,6 +139,16 @@ struct AVFrame_59
   int64_t                       best_effort_timestamp;
   int64_t                       pkt_pos; // Deprecated
   AVDictionary                 *metadata;
+  int                           decode_error_flags;
+  int                           pkt_size; // Deprecated
+  AVBufferRef                  *hw_frames_ctx;
+  AVBufferRef                  *opaque_ref;
+  size_t                        crop_top;
+  size_t                        crop_bottom;
+  size_t                        crop_left;
+  size_t                        crop_right;
+  AVBufferRef                  *private_ref;
+  avcodec::AVChannelLayout      ch_layout;
 
   // Actually, there is more here, but the variables above are the only we need.
 };
@@ -170,6 +183,15 @@ struct AVFrame_60
   AVChromaLocation              chroma_location;
   int64_t                       best_effort_timestamp;
   AVDictionary                 *metadata;
+  int                           decode_error_flags;
+  AVBufferRef                  *hw_frames_ctx;
+  AVBufferRef                  *opaque_ref;
+  size_t                        crop_top;
+  size_t                        crop_bottom;
+  size_t                        crop_left;
+  size_t                        crop_right;
+  AVBufferRef                  *private_ref;
+  avcodec::AVChannelLayout      ch_layout;
 
   // Actually, there is more here, but the variables above are the only we need.
 };
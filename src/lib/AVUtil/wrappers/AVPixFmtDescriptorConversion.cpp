@@ -9,6 +9,7 @@
 #include "AVPixFmtDescriptorConversionInternal.h"
 #include "CastUtilClasses.h"
 
+#include <algorithm>
 #include <utility>
 
 using namespace std::rel_ops;
@@ -146,6 +147,22 @@ convertAVPixFmtDescriptor(const internal::AVPixelFormat            avPixelFormat
   return format;
 }
 
+std::optional<internal::AVPixelFormat>
+findAVPixelFormatByName(const std::string                       &name,
+                        const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+{
+  auto descriptor = ffmpegLibraries->avutil.av_pix_fmt_desc_next(nullptr);
+  while (descriptor != nullptr)
+  {
+    // The name is the first member of the descriptor in all versions
+    const auto p = reinterpret_cast<const internal::avutil::AVPixFmtDescriptor_54 *>(descriptor);
+    if (p->name != nullptr && name == p->name)
+      return ffmpegLibraries->avutil.av_pix_fmt_desc_get_id(descriptor);
+    descriptor = ffmpegLibraries->avutil.av_pix_fmt_desc_next(descriptor);
+  }
+  return {};
+}
+
 Size getSizeOfFrameComponent(const int                    component,
                              const Size                   frameSize,
                              const PixelFormatDescriptor &pixelFormatDescriptor)
@@ -159,4 +176,35 @@ Size getSizeOfFrameComponent(const int                    component,
   return {width, height};
 }
 
+Size getVisiblePlaneSize(const int                    plane,
+                         const Size                   frameSize,
+                         const PixelFormatDescriptor &pixelFormatDescriptor)
+{
+  const auto &shift = pixelFormatDescriptor.shiftLumaToChroma;
+  const auto &flags = pixelFormatDescriptor.flags;
+
+  Size planeSize;
+  for (std::size_t component = 0; component < pixelFormatDescriptor.componentDescriptors.size();
+       ++component)
+  {
+    const auto &descriptor = pixelFormatDescriptor.componentDescriptors.at(component);
+    if (descriptor.plane != plane)
+      continue;
+
+    // Only the chroma components of YUV formats are subsampled. Partially covered chroma samples
+    // at the right and bottom border are part of the picture.
+    const auto isSubsampled = !flags.rgb && (component == 1 || component == 2);
+    const auto width        = -((-frameSize.width) >> (isSubsampled ? shift.widthShift : 0));
+    const auto height       = -((-frameSize.height) >> (isSubsampled ? shift.heightShift : 0));
+
+    // For bitwise packed formats, the step is given in bits
+    const auto bytesPerLine =
+        flags.bitwisePacked ? (width * descriptor.step + 7) / 8 : width * descriptor.step;
+
+    planeSize.width  = std::max(planeSize.width, bytesPerLine);
+    planeSize.height = std::max(planeSize.height, height);
+  }
+  return planeSize;
+}
+
 } // namespace libffmpeg::avutil
@@ -10,6 +10,7 @@
 #include <libHandling/IFFmpegLibraries.h>
 
 #include <memory>
+#include <optional>
 
 namespace libffmpeg::avutil
 {
@@ -76,8 +77,21 @@ PixelFormatDescriptor
 convertAVPixFmtDescriptor(const internal::AVPixelFormat            avPixelFormat,
                           const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries);
 
+// Search the list of all pixel formats of the loaded library for the format with the given name
+// (e.g. "yuv420p" or "rgb24").
+std::optional<internal::AVPixelFormat>
+findAVPixelFormatByName(const std::string                       &name,
+                        const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries);
+
 Size getSizeOfFrameComponent(const int                    component,
                              const Size                   frameSize,
                              const PixelFormatDescriptor &pixelFormatDescriptor);
 
+// The number of bytes of each line of the plane that belong to the picture (width) and the number
+// of lines (height). The padding at the end of each line (up to the linesize) is not included.
+// Returns an empty size if the plane is not used by the pixel format.
+Size getVisiblePlaneSize(const int                    plane,
+                         const Size                   frameSize,
+                         const PixelFormatDescriptor &pixelFormatDescriptor);
+
 } // namespace libffmpeg::avutil
@@ -0,0 +1,28 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "SharedFrame.h"
+
+#include <stdexcept>
+
+namespace libffmpeg::avutil
+{
+
+SharedFrame::SharedFrame(AVFrameWrapper &&frame)
+{
+  if (!frame)
+    throw std::runtime_error("Can not share an empty frame");
+  this->frame = std::make_shared<const AVFrameWrapper>(std::move(frame));
+}
+
+AVFrameWrapper SharedFrame::createReference() const
+{
+  if (!this->frame)
+    throw std::runtime_error("Can not create a reference to an empty shared frame");
+  return this->frame->createReference();
+}
+
+} // namespace libffmpeg::avutil
@@ -0,0 +1,43 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+
+#include <memory>
+
+namespace libffmpeg::avutil
+{
+
+/* A copyable, read only handle to a decoded frame. Copying the handle only increments a
+ * reference counter so one frame can be passed to multiple consumers (also on different threads)
+ * without copying the data. Only const access to the frame is possible.
+ *
+ * Consumers that need their own AVFrame (e.g. to pass it to an encoder) can create one with
+ * createReference. This references the same data buffers (av_frame_ref).
+ */
+class SharedFrame
+{
+public:
+  SharedFrame() = default;
+  explicit SharedFrame(AVFrameWrapper &&frame);
+
+  explicit operator bool() const { return this->frame && *this->frame; }
+
+  [[nodiscard]] const AVFrameWrapper &operator*() const { return *this->frame; }
+  [[nodiscard]] const AVFrameWrapper *operator->() const { return this->frame.get(); }
+
+  [[nodiscard]] AVFrameWrapper createReference() const;
+
+  // The number of handles that share this frame
+  [[nodiscard]] long getUseCount() const { return this->frame.use_count(); }
+
+private:
+  std::shared_ptr<const AVFrameWrapper> frame{};
+};
+
+} // namespace libffmpeg::avutil
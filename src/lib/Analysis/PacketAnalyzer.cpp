@@ -0,0 +1,246 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "PacketAnalyzer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libffmpeg::analysis
+{
+
+namespace
+{
+
+constexpr std::size_t PACKETS_PER_BATCH = 64;
+
+} // namespace
+
+PacketInfo PacketInfo::fromPacket(const avcodec::AVPacketWrapper &packet)
+{
+  PacketInfo info;
+  info.streamIndex = packet.getStreamIndex();
+  if (const auto dts = packet.getDTS(); dts != internal::AV_NOPTS_VALUE)
+    info.dts = dts;
+  info.pts      = packet.getPTS();
+  info.duration = packet.getDuration();
+  info.dataSize = packet.getDataSize();
+
+  const auto flags = packet.getFlags();
+  info.keyframe    = flags.keyframe;
+  info.corrupt     = flags.corrupt;
+  info.discard     = flags.discard;
+  return info;
+}
+
+PacketAnalyzer::PacketAnalyzer(const PacketAnalyzerSettings &settings) : settings(settings)
+{
+  if (this->settings.bitrateWindowSeconds <= 0.0)
+    this->settings.bitrateWindowSeconds = 1.0;
+}
+
+void PacketAnalyzer::addStream(const int streamIndex, const Rational timeBase)
+{
+  auto &state                = this->streams[streamIndex];
+  state.analysis.streamIndex = streamIndex;
+  state.analysis.timeBase    = timeBase;
+}
+
+void PacketAnalyzer::addPacket(const PacketInfo &packet)
+{
+  const auto it = this->streams.find(packet.streamIndex);
+  if (it == this->streams.end())
+    return;
+
+  auto &state    = it->second;
+  auto &analysis = state.analysis;
+
+  ++analysis.numberOfPackets;
+  analysis.numberOfBytes += static_cast<uint64_t>(std::max(packet.dataSize, 0));
+  if (packet.keyframe)
+    ++analysis.numberOfKeyframes;
+  if (packet.corrupt)
+    ++analysis.numberOfCorruptPackets;
+  if (packet.discard)
+    ++analysis.numberOfDiscardPackets;
+
+  this->checkTimestamps(state, packet);
+  this->addToBitrateWindow(state, packet);
+  this->updateGOP(state, packet);
+}
+
+void PacketAnalyzer::addPacket(const avcodec::AVPacketWrapper &packet)
+{
+  this->addPacket(PacketInfo::fromPacket(packet));
+}
+
+std::vector<StreamAnalysis> PacketAnalyzer::finish()
+{
+  std::vector<StreamAnalysis> results;
+  for (auto &[streamIndex, state] : this->streams)
+  {
+    this->finishBitrateWindow(state);
+    if (state.inGOP)
+      state.analysis.gopLengths.push_back(state.packetsInCurrentGOP);
+    state.inGOP = false;
+
+    auto &analysis = state.analysis;
+    if (analysis.firstDTS && analysis.lastDTS)
+    {
+      const auto duration =
+          this->toSeconds(state, *analysis.lastDTS - *analysis.firstDTS + state.previousDuration);
+      if (duration > 0.0)
+        analysis.averageBitrate = static_cast<double>(analysis.numberOfBytes) * 8.0 / duration;
+    }
+
+    results.push_back(std::move(analysis));
+  }
+  this->streams.clear();
+  return results;
+}
+
+void PacketAnalyzer::addToBitrateWindow(StreamState &state, const PacketInfo &packet)
+{
+  // Packets without DTS (or with a DTS before the first one) are counted in the current window
+  if (packet.dts && state.analysis.firstDTS)
+  {
+    const auto time   = this->toSeconds(state, *packet.dts - *state.analysis.firstDTS);
+    const auto window =
+        static_cast<int64_t>(std::floor(time / this->settings.bitrateWindowSeconds));
+    if (!state.currentWindow || window > *state.currentWindow)
+    {
+      this->finishBitrateWindow(state);
+      state.currentWindow = window;
+    }
+  }
+  if (!state.currentWindow)
+    state.currentWindow = 0;
+
+  state.currentWindowValues.bytes += static_cast<uint64_t>(std::max(packet.dataSize, 0));
+  ++state.currentWindowValues.numberOfPackets;
+}
+
+void PacketAnalyzer::finishBitrateWindow(StreamState &state)
+{
+  if (!state.currentWindow)
+    return;
+
+  const auto windowLength = this->settings.bitrateWindowSeconds;
+
+  auto &window     = state.currentWindowValues;
+  window.startTime = static_cast<double>(*state.currentWindow) * windowLength;
+  window.bitrate   = static_cast<double>(window.bytes) * 8.0 / windowLength;
+  state.analysis.bitrateWindows.push_back(window);
+
+  state.currentWindow.reset();
+  state.currentWindowValues = {};
+}
+
+void PacketAnalyzer::updateGOP(StreamState &state, const PacketInfo &packet)
+{
+  if (!packet.keyframe)
+  {
+    if (state.inGOP)
+      ++state.packetsInCurrentGOP;
+    else
+      ++state.analysis.numberOfLeadingPackets;
+    return;
+  }
+
+  if (state.inGOP)
+  {
+    state.analysis.gopLengths.push_back(state.packetsInCurrentGOP);
+    if (state.lastKeyframeDTS && packet.dts)
+      state.analysis.keyframeIntervals.push_back(
+          this->toSeconds(state, *packet.dts - *state.lastKeyframeDTS));
+  }
+
+  state.inGOP               = true;
+  state.packetsInCurrentGOP = 1;
+  state.lastKeyframeDTS     = packet.dts;
+}
+
+void PacketAnalyzer::checkTimestamps(StreamState &state, const PacketInfo &packet)
+{
+  auto &analysis = state.analysis;
+
+  if (!packet.pts)
+    ++analysis.numberOfPacketsWithoutPTS;
+  if (!packet.dts)
+  {
+    ++analysis.numberOfPacketsWithoutDTS;
+    return;
+  }
+
+  if (packet.pts)
+  {
+    if (*packet.pts < *packet.dts)
+      ++analysis.numberOfPTSBeforeDTS;
+    else
+      analysis.maxPTSDelay = std::max(analysis.maxPTSDelay, *packet.pts - *packet.dts);
+  }
+
+  if (!analysis.firstDTS)
+    analysis.firstDTS = packet.dts;
+  analysis.lastDTS = packet.dts;
+
+  if (state.previousDTS)
+  {
+    if (*packet.dts <= *state.previousDTS)
+      ++analysis.numberOfNonMonotonicDTS;
+
+    // Without a duration, the expected DTS is not known
+    if (state.previousDuration > 0)
+    {
+      const auto gap = *packet.dts - *state.previousDTS - state.previousDuration;
+      if (gap != 0)
+      {
+        if (analysis.gaps.size() < this->settings.maxListedGaps)
+          analysis.gaps.push_back({analysis.numberOfPackets - 1, *packet.dts, gap});
+        ++analysis.numberOfGaps;
+      }
+    }
+  }
+
+  state.previousDTS      = packet.dts;
+  state.previousDuration = packet.duration;
+}
+
+double PacketAnalyzer::toSeconds(const StreamState &state, const int64_t value) const
+{
+  const auto timeBase = state.analysis.timeBase;
+  if (timeBase.denominator == 0)
+    return 0.0;
+  return static_cast<double>(value) * timeBase.numerator / timeBase.denominator;
+}
+
+std::vector<StreamAnalysis> analyzeStreams(Demuxer                      &demuxer,
+                                           const PacketAnalyzerSettings &settings)
+{
+  PacketAnalyzer analyzer(settings);
+  for (auto &stream : demuxer.getFormatContext()->getStreams())
+  {
+    const auto streamIndex = stream.getIndex();
+    const auto isSelected =
+        settings.streamIndices.empty() ||
+        std::find(settings.streamIndices.begin(), settings.streamIndices.end(), streamIndex) !=
+            settings.streamIndices.end();
+
+    if (isSelected)
+      analyzer.addStream(streamIndex, stream.getTimeBase());
+    else
+      stream.setDiscard(avcodec::Discard::All);
+  }
+
+  std::vector<avcodec::AVPacketWrapper> packets;
+  while (demuxer.getNextPackets(packets, PACKETS_PER_BATCH) > 0)
+    for (const auto &packet : packets)
+      analyzer.addPacket(packet);
+
+  return analyzer.finish();
+}
+
+} // namespace libffmpeg::analysis
@@ -0,0 +1,152 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <Demuxer.h>
+#include <common/Types.h>
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+/* Analyze the bitrate, GOP structure and timestamps of the streams of a file in a single pass.
+ * Only the packet properties (size, timestamps, duration and flags) are used. The packet data is
+ * never read and nothing is decoded.
+ */
+
+namespace libffmpeg::analysis
+{
+
+struct PacketAnalyzerSettings
+{
+  // The streams to analyze. Empty means all streams. When analyzing a file, the other streams
+  // are discarded in the demuxer.
+  std::vector<int> streamIndices{};
+  // The length of the windows for the bitrate in seconds
+  double bitrateWindowSeconds{1.0};
+  // At most this many timestamp gaps are listed per stream. All gaps are counted.
+  std::size_t maxListedGaps{100};
+};
+
+// The packet properties that are used for the analysis
+struct PacketInfo
+{
+  int                    streamIndex{};
+  std::optional<int64_t> dts{};
+  std::optional<int64_t> pts{};
+  int64_t                duration{};
+  int                    dataSize{};
+  bool                   keyframe{};
+  bool                   corrupt{};
+  bool                   discard{};
+
+  static PacketInfo fromPacket(const avcodec::AVPacketWrapper &packet);
+};
+
+struct BitrateWindow
+{
+  // Start of the window in seconds relative to the first DTS of the stream
+  double      startTime{};
+  uint64_t    bytes{};
+  std::size_t numberOfPackets{};
+  // Bits per second
+  double bitrate{};
+};
+
+// A DTS increase that does not match the duration of the previous packet
+struct TimestampGap
+{
+  uint64_t packetIndex{};
+  int64_t  dts{};
+  // DTS increase minus the duration of the previous packet in time base units. Negative values
+  // are overlaps.
+  int64_t gap{};
+};
+
+struct StreamAnalysis
+{
+  int      streamIndex{};
+  Rational timeBase{};
+
+  uint64_t numberOfPackets{};
+  uint64_t numberOfBytes{};
+  uint64_t numberOfKeyframes{};
+  uint64_t numberOfCorruptPackets{};
+  uint64_t numberOfDiscardPackets{};
+  uint64_t numberOfPacketsWithoutDTS{};
+  uint64_t numberOfPacketsWithoutPTS{};
+  // Packets with a DTS that is not larger than the DTS of the previous packet
+  uint64_t numberOfNonMonotonicDTS{};
+  // Packets with a PTS smaller than the DTS
+  uint64_t numberOfPTSBeforeDTS{};
+
+  std::optional<int64_t> firstDTS{};
+  std::optional<int64_t> lastDTS{};
+  // The largest difference between PTS and DTS (the reordering delay) in time base units
+  int64_t maxPTSDelay{};
+
+  double averageBitrate{};
+  // Windows without packets are not listed
+  std::vector<BitrateWindow> bitrateWindows{};
+
+  // The number of packets before the first keyframe (not part of any GOP)
+  uint64_t numberOfLeadingPackets{};
+  // The number of packets of each GOP, starting with the first keyframe
+  std::vector<uint64_t> gopLengths{};
+  // The DTS distance between consecutive keyframes in seconds
+  std::vector<double> keyframeIntervals{};
+
+  uint64_t                  numberOfGaps{};
+  std::vector<TimestampGap> gaps{};
+};
+
+class PacketAnalyzer
+{
+public:
+  PacketAnalyzer(const PacketAnalyzerSettings &settings = {});
+
+  // Packets of streams that were not added are ignored
+  void addStream(int streamIndex, Rational timeBase);
+  void addPacket(const PacketInfo &packet);
+  void addPacket(const avcodec::AVPacketWrapper &packet);
+
+  // Finish the last bitrate window and GOP of each stream and return the results
+  [[nodiscard]] std::vector<StreamAnalysis> finish();
+
+private:
+  struct StreamState
+  {
+    StreamAnalysis         analysis{};
+    std::optional<int64_t> previousDTS{};
+    int64_t                previousDuration{};
+    std::optional<int64_t> currentWindow{};
+    BitrateWindow          currentWindowValues{};
+    bool                   inGOP{};
+    std::optional<int64_t> lastKeyframeDTS{};
+    uint64_t               packetsInCurrentGOP{};
+  };
+
+  void addToBitrateWindow(StreamState &state, const PacketInfo &packet);
+  void finishBitrateWindow(StreamState &state);
+  void updateGOP(StreamState &state, const PacketInfo &packet);
+  void checkTimestamps(StreamState &state, const PacketInfo &packet);
+
+  [[nodiscard]] double toSeconds(const StreamState &state, int64_t value) const;
+
+  PacketAnalyzerSettings     settings{};
+  std::map<int, StreamState> streams;
+};
+
+// Read all remaining packets from the opened demuxer and analyze the selected streams. Reading
+// stops early if the memory budget is exhausted. Check Demuxer::getDemuxerState afterwards to
+// make sure that the whole file was analyzed.
+std::vector<StreamAnalysis> analyzeStreams(Demuxer                      &demuxer,
+                                           const PacketAnalyzerSettings &settings);
+
+} // namespace libffmpeg::analysis
@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "BitReader.h"
+
+namespace libffmpeg::bitstream
+{
+
+namespace
+{
+
+// Exp-Golomb codes with more leading zeros can not be represented in 32 bits
+constexpr unsigned MAX_LEADING_ZERO_BITS = 31;
+
+} // namespace
+
+void convertToRBSP(const std::span<const std::byte> nalUnit,
+                   ByteVector                      &rbsp,
+                   const std::size_t                maxSize)
+{
+  rbsp.clear();
+
+  unsigned numberOfZeros{};
+  for (const auto byte : nalUnit)
+  {
+    if (rbsp.size() >= maxSize)
+      break;
+
+    if (numberOfZeros >= 2 && byte == std::byte(0x03))
+    {
+      numberOfZeros = 0;
+      continue;
+    }
+
+    numberOfZeros = (byte == std::byte(0)) ? numberOfZeros + 1 : 0;
+    rbsp.push_back(byte);
+  }
+}
+
+BitReader::BitReader(const std::span<const std::byte> data) : data(data)
+{
+}
+
+uint32_t BitReader::readBits(const unsigned numberOfBits)
+{
+  uint32_t value{};
+  for (unsigned i = 0; i < numberOfBits; ++i)
+  {
+    const auto byteIndex = this->bitPosition / 8;
+    if (byteIndex >= this->data.size())
+    {
+      this->error = true;
+      return 0;
+    }
+
+    const auto bit = (std::to_integer<unsigned>(this->data[byteIndex]) >>
+                      (7 - this->bitPosition % 8)) &
+                     1;
+    value = (value << 1) | bit;
+    ++this->bitPosition;
+  }
+  return value;
+}
+
+bool BitReader::readFlag()
+{
+  return this->readBits(1) == 1;
+}
+
+uint32_t BitReader::readUEV()
+{
+  unsigned leadingZeroBits{};
+  while (!this->readFlag())
+  {
+    if (this->error || ++leadingZeroBits > MAX_LEADING_ZERO_BITS)
+    {
+      this->error = true;
+      return 0;
+    }
+  }
+
+  if (leadingZeroBits == 0)
+    return 0;
+  return (uint32_t(1) << leadingZeroBits) - 1 + this->readBits(leadingZeroBits);
+}
+
+int32_t BitReader::readSEV()
+{
+  const auto value = this->readUEV();
+  if (value % 2 == 1)
+    return static_cast<int32_t>((value + 1) / 2);
+  return -static_cast<int32_t>(value / 2);
+}
+
+void BitReader::skipBits(const std::size_t numberOfBits)
+{
+  this->bitPosition += numberOfBits;
+  if (this->bitPosition > this->data.size() * 8)
+  {
+    this->bitPosition = this->data.size() * 8;
+    this->error       = true;
+  }
+}
+
+} // namespace libffmpeg::bitstream
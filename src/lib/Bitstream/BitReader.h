@@ -0,0 +1,47 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/Types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace libffmpeg::bitstream
+{
+
+// Remove the emulation prevention bytes (0x03 after two zero bytes) from the NAL unit payload.
+// At most maxSize bytes of the result are written. The output vector is reused.
+void convertToRBSP(std::span<const std::byte> nalUnit, ByteVector &rbsp, std::size_t maxSize);
+
+/* Read bits (MSB first) and Exp-Golomb codes from a buffer. Reading beyond the end of the buffer
+ * returns zeros and sets the error flag instead of throwing. So the fields can be read in one go
+ * and the error is only checked at the end.
+ */
+class BitReader
+{
+public:
+  BitReader(std::span<const std::byte> data);
+
+  uint32_t readBits(unsigned numberOfBits);
+  bool     readFlag();
+  // Unsigned and signed Exp-Golomb codes (ue(v) and se(v))
+  uint32_t readUEV();
+  int32_t  readSEV();
+  void     skipBits(std::size_t numberOfBits);
+
+  [[nodiscard]] bool        hasError() const { return this->error; }
+  [[nodiscard]] std::size_t getBitPosition() const { return this->bitPosition; }
+
+private:
+  std::span<const std::byte> data{};
+  std::size_t                bitPosition{};
+  bool                       error{};
+};
+
+} // namespace libffmpeg::bitstream
@@ -0,0 +1,679 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "NalParser.h"
+
+#include "BitReader.h"
+#include "StartCodeKernels.h"
+
+#include <algorithm>
+#include <array>
+
+namespace libffmpeg::bitstream
+{
+
+namespace
+{
+
+// Only the start of the slice header is parsed. This is plenty for the parsed fields.
+constexpr std::size_t MAX_SLICE_HEADER_BYTES = 128;
+
+namespace h264
+{
+
+constexpr int NAL_SLICE = 1;
+constexpr int NAL_IDR   = 5;
+constexpr int NAL_SPS   = 7;
+constexpr int NAL_PPS   = 8;
+
+constexpr std::size_t NAL_HEADER_SIZE = 1;
+
+bool hasChromaFormatInSPS(const int profile)
+{
+  constexpr std::array<int, 13> profiles = {
+      100, 110, 122, 244, 44, 83, 86, 118, 128, 138, 139, 134, 135};
+  return std::find(profiles.begin(), profiles.end(), profile) != profiles.end();
+}
+
+void skipScalingList(BitReader &reader, const int size)
+{
+  int lastScale = 8;
+  int nextScale = 8;
+  for (int i = 0; i < size; ++i)
+  {
+    if (nextScale != 0)
+      nextScale = (lastScale + reader.readSEV() + 256) % 256;
+    if (nextScale != 0)
+      lastScale = nextScale;
+  }
+}
+
+SliceType toSliceType(const uint32_t sliceType)
+{
+  constexpr std::array<SliceType, 5> types = {
+      SliceType::P, SliceType::B, SliceType::I, SliceType::SP, SliceType::SI};
+  return types.at(sliceType % 5);
+}
+
+} // namespace h264
+
+namespace hevc
+{
+
+constexpr int NAL_BLA_W_LP          = 16;
+constexpr int NAL_IDR_W_RADL        = 19;
+constexpr int NAL_IDR_N_LP          = 20;
+constexpr int NAL_RESERVED_IRAP_23  = 23;
+constexpr int NAL_RESERVED_VCL_N14  = 14;
+constexpr int NAL_SPS               = 33;
+constexpr int NAL_PPS               = 34;
+constexpr int LAST_VCL_NAL_UNIT     = 31;
+constexpr int MAX_NUMBER_SUB_LAYERS = 8;
+
+constexpr std::size_t NAL_HEADER_SIZE = 2;
+
+bool isIRAP(const int type)
+{
+  return type >= NAL_BLA_W_LP && type <= NAL_RESERVED_IRAP_23;
+}
+
+void skipProfileTierLevel(BitReader &reader, const unsigned maxSubLayersMinus1, int &level)
+{
+  // General profile space, tier, profile idc, compatibility flags and constraint flags
+  reader.skipBits(2 + 1 + 5 + 32 + 4 + 43 + 1);
+  level = static_cast<int>(reader.readBits(8));
+
+  std::array<bool, MAX_NUMBER_SUB_LAYERS> subLayerProfilePresent{};
+  std::array<bool, MAX_NUMBER_SUB_LAYERS> subLayerLevelPresent{};
+  for (unsigned i = 0; i < maxSubLayersMinus1; ++i)
+  {
+    subLayerProfilePresent.at(i) = reader.readFlag();
+    subLayerLevelPresent.at(i)   = reader.readFlag();
+  }
+  if (maxSubLayersMinus1 > 0)
+    reader.skipBits(2 * (MAX_NUMBER_SUB_LAYERS - maxSubLayersMinus1));
+
+  for (unsigned i = 0; i < maxSubLayersMinus1; ++i)
+  {
+    if (subLayerProfilePresent.at(i))
+      reader.skipBits(88);
+    if (subLayerLevelPresent.at(i))
+      reader.skipBits(8);
+  }
+}
+
+SliceType toSliceType(const uint32_t sliceType)
+{
+  if (sliceType == 0)
+    return SliceType::B;
+  if (sliceType == 1)
+    return SliceType::P;
+  return SliceType::I;
+}
+
+unsigned ceilLog2(const int value)
+{
+  unsigned bits{};
+  while ((1 << bits) < value)
+    ++bits;
+  return bits;
+}
+
+} // namespace hevc
+
+std::size_t readBigEndian(const std::span<const std::byte> data, const std::size_t numberOfBytes)
+{
+  std::size_t value{};
+  for (std::size_t i = 0; i < numberOfBytes; ++i)
+    value = (value << 8) | std::to_integer<std::size_t>(data[i]);
+  return value;
+}
+
+bool startsWithStartCode(const std::span<const std::byte> data)
+{
+  const auto threeByte = data.size() >= 3 && data[0] == std::byte(0) && data[1] == std::byte(0) &&
+                         data[2] == std::byte(1);
+  const auto fourByte  = data.size() >= 4 && data[0] == std::byte(0) && data[1] == std::byte(0) &&
+                        data[2] == std::byte(0) && data[3] == std::byte(1);
+  return threeByte || fourByte;
+}
+
+int getSliceTypePriority(const SliceType sliceType)
+{
+  if (sliceType == SliceType::B)
+    return 2;
+  if (sliceType == SliceType::P || sliceType == SliceType::SP)
+    return 1;
+  return 0;
+}
+
+} // namespace
+
+std::optional<Codec> codecFromName(const std::string &codecName)
+{
+  if (codecName == "h264")
+    return Codec::H264;
+  if (codecName == "hevc")
+    return Codec::HEVC;
+  return {};
+}
+
+NalParser::NalParser(const Codec codec, const NalParserSettings &settings) : codec(codec)
+{
+  this->findStartCode = &kernels::findStartCodeScalar;
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  using Implementation = NalParserSettings::Implementation;
+  if ((settings.implementation == Implementation::Auto ||
+       settings.implementation == Implementation::AVX2) &&
+      getCpuFeatures().avx2)
+    this->findStartCode = &kernels::findStartCodeAVX2;
+#else
+  (void)settings;
+#endif
+}
+
+bool NalParser::parseExtradata(const std::span<const std::byte> extradata)
+{
+  this->nalLengthSize = 0;
+  if (extradata.empty())
+    return true;
+
+  if (startsWithStartCode(extradata))
+  {
+    PacketNalUnits nalUnits;
+    return this->parseAnnexB(extradata, nalUnits);
+  }
+
+  // The configuration version of avcC and hvcC
+  if (extradata[0] != std::byte(1))
+    return false;
+
+  if (this->codec == Codec::H264)
+    return this->parseAVCC(extradata);
+  return this->parseHVCC(extradata);
+}
+
+bool NalParser::parsePacket(const std::span<const std::byte> data, PacketNalUnits &result)
+{
+  result.nalUnits.clear();
+  result.keyframe  = false;
+  result.reference = false;
+  result.pictureType.reset();
+
+  const auto success = (this->nalLengthSize > 0) ? this->parseLengthPrefixed(data, result)
+                                                 : this->parseAnnexB(data, result);
+
+  for (const auto &nalUnit : result.nalUnits)
+  {
+    if (!nalUnit.slice)
+      continue;
+
+    result.keyframe |= nalUnit.keyframe;
+    result.reference |= nalUnit.reference;
+    if (const auto sliceType = nalUnit.slice->sliceType)
+      if (!result.pictureType ||
+          getSliceTypePriority(*sliceType) > getSliceTypePriority(*result.pictureType))
+        result.pictureType = sliceType;
+  }
+
+  return success;
+}
+
+bool NalParser::parsePacket(const avcodec::AVPacketWrapper &packet, PacketNalUnits &result)
+{
+  return this->parsePacket(packet.getDataView(), result);
+}
+
+bool NalParser::parseAnnexB(const std::span<const std::byte> data, PacketNalUnits &result)
+{
+  const auto bytes = reinterpret_cast<const uint8_t *>(data.data());
+
+  auto startCode = this->findStartCode(bytes, data.size(), 0);
+  while (startCode < data.size())
+  {
+    const auto nalStart = startCode + 3;
+    startCode           = this->findStartCode(bytes, data.size(), nalStart);
+
+    // Remove the trailing zero bytes (e.g. the first byte of a 4 byte start code)
+    auto nalEnd = startCode;
+    while (nalEnd > nalStart && bytes[nalEnd - 1] == 0)
+      --nalEnd;
+
+    if (nalEnd > nalStart)
+      this->addNalUnit(data, nalStart, nalEnd - nalStart, result);
+  }
+
+  return true;
+}
+
+bool NalParser::parseLengthPrefixed(const std::span<const std::byte> data, PacketNalUnits &result)
+{
+  std::size_t position{};
+  while (position + this->nalLengthSize <= data.size())
+  {
+    const auto nalSize = readBigEndian(data.subspan(position), this->nalLengthSize);
+    position += this->nalLengthSize;
+    if (nalSize > data.size() - position)
+      return false;
+
+    if (nalSize > 0)
+      this->addNalUnit(data, position, nalSize, result);
+    position += nalSize;
+  }
+
+  return position == data.size();
+}
+
+bool NalParser::parseAVCC(const std::span<const std::byte> extradata)
+{
+  // Configuration version, profile, profile compatibility, level, length size minus one
+  if (extradata.size() < 6)
+    return false;
+
+  this->nalLengthSize = (std::to_integer<std::size_t>(extradata[4]) & 0x03) + 1;
+
+  std::size_t position = 5;
+  for (const auto countMask : {0x1f, 0xff})
+  {
+    if (position >= extradata.size())
+      return false;
+    const auto numberOfNalUnits = std::to_integer<int>(extradata[position]) & countMask;
+    ++position;
+
+    for (int i = 0; i < numberOfNalUnits; ++i)
+    {
+      if (position + 2 > extradata.size())
+        return false;
+      const auto nalSize = readBigEndian(extradata.subspan(position), 2);
+      position += 2;
+      if (nalSize > extradata.size() - position)
+        return false;
+
+      NalUnit nalUnit;
+      this->parseNalUnit(extradata.subspan(position, nalSize), nalUnit);
+      position += nalSize;
+    }
+  }
+
+  return true;
+}
+
+bool NalParser::parseHVCC(const std::span<const std::byte> extradata)
+{
+  constexpr std::size_t HVCC_HEADER_SIZE = 23;
+  if (extradata.size() < HVCC_HEADER_SIZE)
+    return false;
+
+  this->nalLengthSize = (std::to_integer<std::size_t>(extradata[21]) & 0x03) + 1;
+
+  const auto  numberOfArrays = std::to_integer<int>(extradata[22]);
+  std::size_t position       = HVCC_HEADER_SIZE;
+  for (int array = 0; array < numberOfArrays; ++array)
+  {
+    // NAL unit type and number of NAL units
+    if (position + 3 > extradata.size())
+      return false;
+    const auto numberOfNalUnits = readBigEndian(extradata.subspan(position + 1), 2);
+    position += 3;
+
+    for (std::size_t i = 0; i < numberOfNalUnits; ++i)
+    {
+      if (position + 2 > extradata.size())
+        return false;
+      const auto nalSize = readBigEndian(extradata.subspan(position), 2);
+      position += 2;
+      if (nalSize > extradata.size() - position)
+        return false;
+
+      NalUnit nalUnit;
+      this->parseNalUnit(extradata.subspan(position, nalSize), nalUnit);
+      position += nalSize;
+    }
+  }
+
+  return true;
+}
+
+void NalParser::addNalUnit(const std::span<const std::byte> data,
+                           const std::size_t                offset,
+                           const std::size_t                size,
+                           PacketNalUnits                  &result)
+{
+  auto &nalUnit  = result.nalUnits.emplace_back();
+  nalUnit.offset = offset;
+  nalUnit.size   = size;
+  this->parseNalUnit(data.subspan(offset, size), nalUnit);
+}
+
+void NalParser::parseNalUnit(const std::span<const std::byte> data, NalUnit &nalUnit)
+{
+  const auto headerSize =
+      (this->codec == Codec::H264) ? h264::NAL_HEADER_SIZE : hevc::NAL_HEADER_SIZE;
+  if (data.size() <= headerSize)
+    return;
+
+  const auto firstByte = std::to_integer<int>(data[0]);
+  const auto payload   = data.subspan(headerSize);
+  const auto slicePart = std::min(payload.size(), MAX_SLICE_HEADER_BYTES);
+
+  if (this->codec == Codec::H264)
+  {
+    nalUnit.type      = firstByte & 0x1f;
+    nalUnit.reference = ((firstByte >> 5) & 0x03) != 0;
+    nalUnit.keyframe  = nalUnit.type == h264::NAL_IDR;
+
+    if (nalUnit.type == h264::NAL_SPS || nalUnit.type == h264::NAL_PPS)
+    {
+      convertToRBSP(payload, this->rbspBuffer, payload.size());
+      if (nalUnit.type == h264::NAL_SPS)
+        this->parseSPSH264(this->rbspBuffer);
+      else
+        this->parsePPSH264(this->rbspBuffer);
+    }
+    else if (nalUnit.type == h264::NAL_SLICE || nalUnit.type == h264::NAL_IDR)
+    {
+      convertToRBSP(payload, this->rbspBuffer, slicePart);
+      this->parseSliceH264(this->rbspBuffer, nalUnit);
+    }
+  }
+  else
+  {
+    const auto secondByte = std::to_integer<int>(data[1]);
+    nalUnit.type          = (firstByte >> 1) & 0x3f;
+    nalUnit.temporalID    = (secondByte & 0x07) - 1;
+    nalUnit.keyframe      = hevc::isIRAP(nalUnit.type);
+    // The even types up to 14 are sub-layer non-reference pictures
+    nalUnit.reference = !(nalUnit.type <= hevc::NAL_RESERVED_VCL_N14 && nalUnit.type % 2 == 0);
+
+    if (nalUnit.type == hevc::NAL_SPS || nalUnit.type == hevc::NAL_PPS)
+    {
+      convertToRBSP(payload, this->rbspBuffer, payload.size());
+      if (nalUnit.type == hevc::NAL_SPS)
+        this->parseSPSHEVC(this->rbspBuffer);
+      else
+        this->parsePPSHEVC(this->rbspBuffer);
+    }
+    else if (nalUnit.type <= hevc::LAST_VCL_NAL_UNIT)
+    {
+      convertToRBSP(payload, this->rbspBuffer, slicePart);
+      this->parseSliceHEVC(this->rbspBuffer, nalUnit);
+    }
+    else
+      nalUnit.reference = false;
+  }
+}
+
+void NalParser::parseSPSH264(const std::span<const std::byte> rbsp)
+{
+  BitReader            reader(rbsp);
+  SequenceParameterSet sps;
+
+  sps.profile = static_cast<int>(reader.readBits(8));
+  reader.skipBits(8);
+  sps.level = static_cast<int>(reader.readBits(8));
+  sps.id    = static_cast<int>(reader.readUEV());
+
+  if (h264::hasChromaFormatInSPS(sps.profile))
+  {
+    sps.chromaFormat = static_cast<int>(reader.readUEV());
+    if (sps.chromaFormat == 3)
+      sps.separateColourPlane = reader.readFlag();
+    sps.bitDepthLuma   = static_cast<int>(reader.readUEV()) + 8;
+    sps.bitDepthChroma = static_cast<int>(reader.readUEV()) + 8;
+    reader.skipBits(1);
+    if (reader.readFlag())
+    {
+      const auto numberOfLists = (sps.chromaFormat != 3) ? 8 : 12;
+      for (int i = 0; i < numberOfLists && !reader.hasError(); ++i)
+        if (reader.readFlag())
+          h264::skipScalingList(reader, (i < 6) ? 16 : 64);
+    }
+  }
+
+  sps.log2MaxFrameNum = static_cast<int>(reader.readUEV()) + 4;
+  sps.picOrderCntType = static_cast<int>(reader.readUEV());
+  if (sps.picOrderCntType == 0)
+    sps.log2MaxPicOrderCntLsb = static_cast<int>(reader.readUEV()) + 4;
+  else if (sps.picOrderCntType == 1)
+  {
+    reader.skipBits(1);
+    reader.readSEV();
+    reader.readSEV();
+    const auto numberOfRefFramesInCycle = reader.readUEV();
+    for (uint32_t i = 0; i < numberOfRefFramesInCycle && !reader.hasError(); ++i)
+      reader.readSEV();
+  }
+
+  sps.maxNumberOfReferenceFrames = static_cast<int>(reader.readUEV());
+  reader.skipBits(1);
+  const auto widthInMbs       = static_cast<int>(reader.readUEV()) + 1;
+  const auto heightInMapUnits = static_cast<int>(reader.readUEV()) + 1;
+  sps.frameMbsOnly            = reader.readFlag();
+  if (!sps.frameMbsOnly)
+    reader.skipBits(1);
+  reader.skipBits(1);
+
+  const auto frameHeightFactor = sps.frameMbsOnly ? 1 : 2;
+  sps.size.width               = widthInMbs * 16;
+  sps.size.height              = heightInMapUnits * 16 * frameHeightFactor;
+
+  if (reader.readFlag())
+  {
+    const auto chromaArrayType = sps.separateColourPlane ? 0 : sps.chromaFormat;
+    const auto cropUnitX       = (chromaArrayType == 1 || chromaArrayType == 2) ? 2 : 1;
+    const auto cropUnitY       = ((chromaArrayType == 1) ? 2 : 1) * frameHeightFactor;
+
+    const auto left   = static_cast<int>(reader.readUEV());
+    const auto right  = static_cast<int>(reader.readUEV());
+    const auto top    = static_cast<int>(reader.readUEV());
+    const auto bottom = static_cast<int>(reader.readUEV());
+    sps.size.width -= cropUnitX * (left + right);
+    sps.size.height -= cropUnitY * (top + bottom);
+  }
+
+  if (!reader.hasError())
+    this->spsMap[sps.id] = sps;
+}
+
+void NalParser::parsePPSH264(const std::span<const std::byte> rbsp)
+{
+  BitReader           reader(rbsp);
+  PictureParameterSet pps;
+
+  pps.id                                = static_cast<int>(reader.readUEV());
+  pps.spsID                             = static_cast<int>(reader.readUEV());
+  pps.entropyCodingMode                 = reader.readFlag();
+  pps.bottomFieldPicOrderInFramePresent = reader.readFlag();
+
+  if (!reader.hasError())
+    this->ppsMap[pps.id] = pps;
+}
+
+void NalParser::parseSliceH264(const std::span<const std::byte> rbsp, NalUnit &nalUnit)
+{
+  BitReader   reader(rbsp);
+  SliceHeader slice;
+
+  slice.firstSliceInPicture = reader.readUEV() == 0;
+  slice.sliceType           = h264::toSliceType(reader.readUEV());
+  slice.ppsID               = static_cast<int>(reader.readUEV());
+  if (reader.hasError())
+    return;
+
+  const auto pps = this->ppsMap.find(slice.ppsID);
+  if (pps == this->ppsMap.end())
+  {
+    nalUnit.slice = slice;
+    return;
+  }
+  const auto sps = this->spsMap.find(pps->second.spsID);
+  if (sps == this->spsMap.end())
+  {
+    nalUnit.slice = slice;
+    return;
+  }
+
+  if (sps->second.separateColourPlane)
+    reader.skipBits(2);
+  const auto frameNum = static_cast<int>(reader.readBits(sps->second.log2MaxFrameNum));
+  if (!sps->second.frameMbsOnly)
+  {
+    slice.fieldPic = reader.readFlag();
+    if (slice.fieldPic)
+      slice.bottomField = reader.readFlag();
+  }
+  if (nalUnit.type == h264::NAL_IDR)
+    slice.idrPicID = static_cast<int>(reader.readUEV());
+  if (sps->second.picOrderCntType == 0)
+    slice.picOrderCntLsb = static_cast<int>(reader.readBits(sps->second.log2MaxPicOrderCntLsb));
+
+  if (reader.hasError())
+  {
+    slice.fieldPic    = false;
+    slice.bottomField = false;
+    slice.idrPicID.reset();
+    slice.picOrderCntLsb.reset();
+  }
+  else
+    slice.frameNum = frameNum;
+
+  nalUnit.slice = slice;
+}
+
+void NalParser::parseSPSHEVC(const std::span<const std::byte> rbsp)
+{
+  BitReader            reader(rbsp);
+  SequenceParameterSet sps;
+
+  reader.skipBits(4);
+  const auto maxSubLayersMinus1 = reader.readBits(3);
+  reader.skipBits(1);
+  if (maxSubLayersMinus1 >= hevc::MAX_NUMBER_SUB_LAYERS)
+    return;
+  hevc::skipProfileTierLevel(reader, maxSubLayersMinus1, sps.level);
+  // The general profile idc is in the first byte after the VPS ID byte
+  if (rbsp.size() > 1)
+    sps.profile = std::to_integer<int>(rbsp[1]) & 0x1f;
+
+  sps.id           = static_cast<int>(reader.readUEV());
+  sps.chromaFormat = static_cast<int>(reader.readUEV());
+  if (sps.chromaFormat == 3)
+    sps.separateColourPlane = reader.readFlag();
+  const auto width  = static_cast<int>(reader.readUEV());
+  const auto height = static_cast<int>(reader.readUEV());
+  sps.size          = {width, height};
+
+  if (reader.readFlag())
+  {
+    const auto chromaArrayType = sps.separateColourPlane ? 0 : sps.chromaFormat;
+    const auto subWidth        = (chromaArrayType == 1 || chromaArrayType == 2) ? 2 : 1;
+    const auto subHeight       = (chromaArrayType == 1) ? 2 : 1;
+
+    const auto left   = static_cast<int>(reader.readUEV());
+    const auto right  = static_cast<int>(reader.readUEV());
+    const auto top    = static_cast<int>(reader.readUEV());
+    const auto bottom = static_cast<int>(reader.readUEV());
+    sps.size.width -= subWidth * (left + right);
+    sps.size.height -= subHeight * (top + bottom);
+  }
+
+  sps.bitDepthLuma          = static_cast<int>(reader.readUEV()) + 8;
+  sps.bitDepthChroma        = static_cast<int>(reader.readUEV()) + 8;
+  sps.log2MaxPicOrderCntLsb = static_cast<int>(reader.readUEV()) + 4;
+
+  const auto subLayerOrderingInfoPresent = reader.readFlag();
+  for (auto i = subLayerOrderingInfoPresent ? 0u : maxSubLayersMinus1; i <= maxSubLayersMinus1;
+       ++i)
+  {
+    reader.readUEV();
+    reader.readUEV();
+    reader.readUEV();
+  }
+
+  const auto log2MinCodingBlockSize = static_cast<int>(reader.readUEV()) + 3;
+  const auto log2CtbSize            = log2MinCodingBlockSize + static_cast<int>(reader.readUEV());
+  if (reader.hasError() || log2CtbSize > 6)
+    return;
+
+  const auto ctbSize      = 1 << log2CtbSize;
+  const auto widthInCtbs  = (width + ctbSize - 1) / ctbSize;
+  const auto heightInCtbs = (height + ctbSize - 1) / ctbSize;
+  sps.picSizeInCtbs       = widthInCtbs * heightInCtbs;
+
+  this->spsMap[sps.id] = sps;
+}
+
+void NalParser::parsePPSHEVC(const std::span<const std::byte> rbsp)
+{
+  BitReader           reader(rbsp);
+  PictureParameterSet pps;
+
+  pps.id                            = static_cast<int>(reader.readUEV());
+  pps.spsID                         = static_cast<int>(reader.readUEV());
+  pps.dependentSliceSegmentsEnabled = reader.readFlag();
+  pps.outputFlagPresent             = reader.readFlag();
+  pps.numberOfExtraSliceHeaderBits  = static_cast<int>(reader.readBits(3));
+
+  if (!reader.hasError())
+    this->ppsMap[pps.id] = pps;
+}
+
+void NalParser::parseSliceHEVC(const std::span<const std::byte> rbsp, NalUnit &nalUnit)
+{
+  BitReader   reader(rbsp);
+  SliceHeader slice;
+
+  slice.firstSliceInPicture = reader.readFlag();
+  if (hevc::isIRAP(nalUnit.type))
+    reader.skipBits(1);
+  slice.ppsID = static_cast<int>(reader.readUEV());
+  if (reader.hasError())
+    return;
+
+  const auto pps = this->ppsMap.find(slice.ppsID);
+  if (pps == this->ppsMap.end())
+  {
+    nalUnit.slice = slice;
+    return;
+  }
+  const auto sps = this->spsMap.find(pps->second.spsID);
+  if (sps == this->spsMap.end())
+  {
+    nalUnit.slice = slice;
+    return;
+  }
+
+  if (!slice.firstSliceInPicture)
+  {
+    if (pps->second.dependentSliceSegmentsEnabled)
+      slice.dependentSliceSegment = reader.readFlag();
+    reader.skipBits(hevc::ceilLog2(sps->second.picSizeInCtbs));
+  }
+
+  if (!slice.dependentSliceSegment)
+  {
+    reader.skipBits(static_cast<std::size_t>(pps->second.numberOfExtraSliceHeaderBits));
+    const auto sliceType = hevc::toSliceType(reader.readUEV());
+    if (pps->second.outputFlagPresent)
+      reader.skipBits(1);
+    if (sps->second.separateColourPlane)
+      reader.skipBits(2);
+
+    std::optional<int> picOrderCntLsb;
+    if (nalUnit.type != hevc::NAL_IDR_W_RADL && nalUnit.type != hevc::NAL_IDR_N_LP)
+      picOrderCntLsb = static_cast<int>(reader.readBits(sps->second.log2MaxPicOrderCntLsb));
+
+    if (!reader.hasError())
+    {
+      slice.sliceType      = sliceType;
+      slice.picOrderCntLsb = picOrderCntLsb;
+    }
+  }
+
+  nalUnit.slice = slice;
+}
+
+} // namespace libffmpeg::bitstream
@@ -0,0 +1,205 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <common/EnumMapper.h>
+#include <common/Types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/* A lightweight parser for the NAL unit headers of H.264 and HEVC bitstreams. Only the fields that
+ * are needed to type the pictures without decoding are parsed: The NAL unit types, the basics of
+ * the parameter sets and the start of the slice headers (slice type, frame number and POC LSB).
+ *
+ * The parameter sets are taken from the extradata (avcC / hvcC or Annex B) and from the packets.
+ * The packet data is either length prefixed (if the extradata is avcC / hvcC) or Annex B.
+ */
+
+namespace libffmpeg::bitstream
+{
+
+enum class Codec
+{
+  H264,
+  HEVC
+};
+
+// The codec for the name of the codec descriptor (see AVStreamWrapper::getCodecDescriptor)
+std::optional<Codec> codecFromName(const std::string &codecName);
+
+enum class SliceType
+{
+  P,
+  B,
+  I,
+  SP,
+  SI
+};
+
+const EnumMapper<SliceType> sliceTypeMapper({{SliceType::P, "P"},
+                                             {SliceType::B, "B"},
+                                             {SliceType::I, "I"},
+                                             {SliceType::SP, "SP"},
+                                             {SliceType::SI, "SI"}});
+
+struct SequenceParameterSet
+{
+  int  id{};
+  int  profile{};
+  int  level{};
+  int  chromaFormat{1};
+  bool separateColourPlane{};
+  int  bitDepthLuma{8};
+  int  bitDepthChroma{8};
+  // The size after applying the cropping / conformance window
+  Size size{};
+  int  log2MaxPicOrderCntLsb{};
+
+  // H.264 only
+  int  log2MaxFrameNum{};
+  int  picOrderCntType{};
+  int  maxNumberOfReferenceFrames{};
+  bool frameMbsOnly{true};
+
+  // HEVC only
+  int picSizeInCtbs{};
+};
+
+struct PictureParameterSet
+{
+  int id{};
+  int spsID{};
+
+  // H.264 only
+  bool entropyCodingMode{};
+  bool bottomFieldPicOrderInFramePresent{};
+
+  // HEVC only
+  bool dependentSliceSegmentsEnabled{};
+  bool outputFlagPresent{};
+  int  numberOfExtraSliceHeaderBits{};
+};
+
+// The start of the slice header. Fields that could not be parsed (e.g. because the parameter
+// sets are missing) have no value.
+struct SliceHeader
+{
+  bool                     firstSliceInPicture{};
+  int                      ppsID{};
+  std::optional<SliceType> sliceType{};
+  std::optional<int>       picOrderCntLsb{};
+
+  // H.264 only
+  std::optional<int> frameNum{};
+  std::optional<int> idrPicID{};
+  bool               fieldPic{};
+  bool               bottomField{};
+
+  // HEVC only. Dependent slice segments take over the values of the previous slice segment.
+  bool dependentSliceSegment{};
+};
+
+struct NalUnit
+{
+  int type{};
+  // Position and size (including the NAL unit header) in the packet data
+  std::size_t offset{};
+  std::size_t size{};
+  // H.264: nal_ref_idc is not 0. HEVC: Not a sub-layer non-reference picture.
+  bool reference{};
+  // IDR (H.264) or IRAP (HEVC) picture
+  bool keyframe{};
+  // HEVC only
+  int temporalID{};
+
+  std::optional<SliceHeader> slice{};
+};
+
+struct PacketNalUnits
+{
+  std::vector<NalUnit> nalUnits{};
+
+  // Combined over all slices of the packet
+  bool keyframe{};
+  bool reference{};
+  // B if any slice is a B slice, P if any slice is a P slice (or SP) and I otherwise
+  std::optional<SliceType> pictureType{};
+};
+
+struct NalParserSettings
+{
+  enum class Implementation
+  {
+    Auto,
+    Scalar,
+    AVX2
+  };
+
+  // Auto selects the best implementation of the start code search that is supported by the CPU.
+  // Selecting an implementation that is not supported falls back to Scalar.
+  Implementation implementation{Implementation::Auto};
+};
+
+class NalParser
+{
+public:
+  NalParser(Codec codec, const NalParserSettings &settings = {});
+
+  // Detect the packet format (length prefixed or Annex B) and parse the contained parameter sets.
+  // Empty extradata means Annex B. Returns false if the extradata could not be parsed.
+  bool parseExtradata(std::span<const std::byte> extradata);
+
+  // The result is reused. Returns false if the packet could not be split into NAL units (e.g.
+  // invalid length prefixes). All NAL units until the error are still returned.
+  bool parsePacket(std::span<const std::byte> data, PacketNalUnits &result);
+  bool parsePacket(const avcodec::AVPacketWrapper &packet, PacketNalUnits &result);
+
+  [[nodiscard]] Codec       getCodec() const { return this->codec; }
+  // The size of the length prefix of each NAL unit. 0 for Annex B.
+  [[nodiscard]] std::size_t getNalLengthSize() const { return this->nalLengthSize; }
+
+  [[nodiscard]] const std::map<int, SequenceParameterSet> &getSPSs() const { return this->spsMap; }
+  [[nodiscard]] const std::map<int, PictureParameterSet>  &getPPSs() const { return this->ppsMap; }
+
+private:
+  using FindStartCodeFunction = std::size_t (*)(const uint8_t *, std::size_t, std::size_t);
+
+  bool parseAnnexB(std::span<const std::byte> data, PacketNalUnits &result);
+  bool parseLengthPrefixed(std::span<const std::byte> data, PacketNalUnits &result);
+  bool parseAVCC(std::span<const std::byte> extradata);
+  bool parseHVCC(std::span<const std::byte> extradata);
+
+  void addNalUnit(std::span<const std::byte> data,
+                  std::size_t                offset,
+                  std::size_t                size,
+                  PacketNalUnits            &result);
+  void parseNalUnit(std::span<const std::byte> data, NalUnit &nalUnit);
+
+  void parseSPSH264(std::span<const std::byte> rbsp);
+  void parsePPSH264(std::span<const std::byte> rbsp);
+  void parseSliceH264(std::span<const std::byte> rbsp, NalUnit &nalUnit);
+  void parseSPSHEVC(std::span<const std::byte> rbsp);
+  void parsePPSHEVC(std::span<const std::byte> rbsp);
+  void parseSliceHEVC(std::span<const std::byte> rbsp, NalUnit &nalUnit);
+
+  Codec                 codec{};
+  FindStartCodeFunction findStartCode{};
+  std::size_t           nalLengthSize{};
+
+  std::map<int, SequenceParameterSet> spsMap;
+  std::map<int, PictureParameterSet>  ppsMap;
+  ByteVector                          rbspBuffer;
+};
+
+} // namespace libffmpeg::bitstream
@@ -0,0 +1,30 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* The Annex B start code (00 00 01) search kernels. These are internal to the library. The AVX2
+ * kernel is compiled with the instruction set enabled (see LIBFFMPEG_BEGIN_KERNEL_TARGET) and
+ * must only be called if getCpuFeatures reports support. Both kernels give identical results.
+ */
+
+namespace libffmpeg::bitstream::kernels
+{
+
+// The position of the first start code (the first zero byte of 00 00 01) at or after start.
+// Returns size if there is no further start code.
+std::size_t findStartCodeScalar(const uint8_t *data, std::size_t size, std::size_t start);
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+std::size_t findStartCodeAVX2(const uint8_t *data, std::size_t size, std::size_t start);
+#endif
+
+} // namespace libffmpeg::bitstream::kernels
@@ -0,0 +1,65 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "StartCodeKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("avx2")
+
+namespace libffmpeg::bitstream::kernels
+{
+
+namespace
+{
+
+unsigned countTrailingZeros(const uint32_t value)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, value);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+} // namespace
+
+std::size_t findStartCodeAVX2(const uint8_t *data, const std::size_t size, std::size_t start)
+{
+  const auto zero = _mm256_setzero_si256();
+  const auto one  = _mm256_set1_epi8(1);
+
+  // Compare 32 candidate positions at once. Each candidate needs the two following bytes.
+  for (; start + 34 <= size; start += 32)
+  {
+    const auto first  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + start));
+    const auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + start + 1));
+    const auto third  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + start + 2));
+
+    const auto match = _mm256_and_si256(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, zero), _mm256_cmpeq_epi8(second, zero)),
+        _mm256_cmpeq_epi8(third, one));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+    if (mask != 0)
+      return start + countTrailingZeros(mask);
+  }
+
+  return findStartCodeScalar(data, size, start);
+}
+
+} // namespace libffmpeg::bitstream::kernels
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
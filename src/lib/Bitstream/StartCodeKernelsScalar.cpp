@@ -0,0 +1,27 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "StartCodeKernels.h"
+
+namespace libffmpeg::bitstream::kernels
+{
+
+std::size_t findStartCodeScalar(const uint8_t *data, const std::size_t size, std::size_t start)
+{
+  while (start + 3 <= size)
+  {
+    // If the third byte is larger than 1, none of the three positions can start a start code
+    if (data[start + 2] > 1)
+      start += 3;
+    else if (data[start + 2] == 1 && data[start + 1] == 0 && data[start] == 0)
+      return start;
+    else
+      ++start;
+  }
+  return size;
+}
+
+} // namespace libffmpeg::bitstream::kernels
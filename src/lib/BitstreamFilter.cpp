@@ -0,0 +1,224 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "BitstreamFilter.h"
+
+#include <AVCodec/wrappers/AVBSFContextInternal.h>
+#include <AVCodec/wrappers/CastCodecClasses.h>
+#include <common/Functions.h>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using libffmpeg::internal::AVBSFContext;
+using libffmpeg::internal::AVCodecParameters;
+using libffmpeg::internal::AVRational;
+using libffmpeg::internal::avcodec::AVBSFContext_56;
+using libffmpeg::internal::avcodec::AVBSFContext_57;
+using libffmpeg::internal::avcodec::AVBSFContext_58;
+using libffmpeg::internal::avcodec::AVBSFContext_59;
+using libffmpeg::internal::avcodec::AVBSFContext_60;
+using libffmpeg::internal::avcodec::AVBSFContext_61;
+using libffmpeg::internal::avcodec::AVBSFContext_62;
+
+} // namespace
+
+BitstreamFilter::BitstreamFilter(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool BitstreamFilter::open(const std::string &filterName, const avformat::AVStreamWrapper &stream)
+{
+  const auto codecParameters = stream.getCodecParameters();
+  if (!codecParameters)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Opening bitstream filter " + filterName +
+                                   " failed. The stream has no codec parameters.");
+    return false;
+  }
+  return this->open(filterName, *codecParameters, stream.getTimeBase());
+}
+
+bool BitstreamFilter::open(const std::string                       &filterName,
+                           const avcodec::AVCodecParametersWrapper &codecParameters,
+                           const Rational                           timeBase)
+{
+  if (this->context)
+    throw std::runtime_error("Bitstream filter was already opened.");
+
+  const auto &avcodec = this->ffmpegLibraries->avcodec;
+  if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major < 57 ||
+      !avcodec.av_bsf_get_by_name)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Bitstream filters are not supported with this avcodec version.");
+    return false;
+  }
+
+  const auto filter = avcodec.av_bsf_get_by_name(filterName.c_str());
+  if (filter == nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Bitstream filter " + filterName + " not found.");
+    return false;
+  }
+
+  AVBSFContext *newContext{};
+  auto          returnCode = toReturnCode(avcodec.av_bsf_alloc(filter, &newContext));
+  if (returnCode != ReturnCode::Ok || newContext == nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error allocating bitstream filter (av_bsf_alloc). Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+    return false;
+  }
+  this->context = std::unique_ptr<AVBSFContext, AVBSFContextDeleter>(
+      newContext, AVBSFContextDeleter(this->ffmpegLibraries));
+
+  AVCodecParameters *parametersIn{};
+  CAST_AVCODEC_GET_MEMBER(AVBSFContext, this->context.get(), parametersIn, par_in);
+  returnCode = toReturnCode(
+      avcodec.avcodec_parameters_copy(parametersIn, codecParameters.getCodecParameters()));
+  if (returnCode != ReturnCode::Ok)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error,
+        "Error copying codec parameters into the bitstream filter. Return code " +
+            ReturnCodeMapper.getName(returnCode));
+    this->context.reset();
+    return false;
+  }
+
+  const auto timeBaseIn = toAVRational(timeBase);
+  CAST_AVCODEC_SET_MEMBER(AVBSFContext, this->context.get(), time_base_in, timeBaseIn);
+
+  returnCode = toReturnCode(avcodec.av_bsf_init(this->context.get()));
+  if (returnCode != ReturnCode::Ok)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error initializing bitstream filter " + filterName +
+                                   " (av_bsf_init). Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+    this->context.reset();
+    return false;
+  }
+
+  this->ffmpegLibraries->log(LogLevel::Info, "Opened bitstream filter " + filterName);
+  this->endOfStream = false;
+  return true;
+}
+
+ReturnCode BitstreamFilter::sendPacket(avcodec::AVPacketWrapper &packet)
+{
+  if (!this->context || !packet)
+  {
+    this->ffmpegLibraries->log(
+        LogLevel::Error, "Can not send packet. The filter is not open or the packet is null.");
+    return ReturnCode::Unknown;
+  }
+
+  const auto returnCode = toReturnCode(
+      this->ffmpegLibraries->avcodec.av_bsf_send_packet(this->context.get(), packet.getPacket()));
+  if (returnCode != ReturnCode::Ok && returnCode != ReturnCode::TryAgain)
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error sending packet to bitstream filter. Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+  return returnCode;
+}
+
+ReturnCode BitstreamFilter::sendEndOfStream()
+{
+  if (!this->context)
+    return ReturnCode::Unknown;
+
+  this->ffmpegLibraries->log(LogLevel::Debug, "Sending end of stream to bitstream filter.");
+  return toReturnCode(
+      this->ffmpegLibraries->avcodec.av_bsf_send_packet(this->context.get(), nullptr));
+}
+
+std::optional<avcodec::AVPacketWrapper> BitstreamFilter::receivePacket()
+{
+  if (!this->context || this->endOfStream)
+    return {};
+
+  avcodec::AVPacketWrapper packet(this->ffmpegLibraries);
+
+  const auto returnCode = toReturnCode(this->ffmpegLibraries->avcodec.av_bsf_receive_packet(
+      this->context.get(), packet.getPacket()));
+  if (returnCode == ReturnCode::Ok)
+    return packet;
+
+  if (returnCode == ReturnCode::EndOfFile)
+    this->endOfStream = true;
+  else if (returnCode != ReturnCode::TryAgain)
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error receiving packet from bitstream filter. Return code " +
+                                   ReturnCodeMapper.getName(returnCode));
+  return {};
+}
+
+bool BitstreamFilter::filterPacket(avcodec::AVPacketWrapper              &&packet,
+                                   std::vector<avcodec::AVPacketWrapper> &filteredPackets)
+{
+  auto returnCode = this->sendPacket(packet);
+  if (returnCode == ReturnCode::TryAgain)
+  {
+    while (auto filteredPacket = this->receivePacket())
+      filteredPackets.push_back(std::move(*filteredPacket));
+    returnCode = this->sendPacket(packet);
+  }
+  if (returnCode != ReturnCode::Ok)
+    return false;
+
+  while (auto filteredPacket = this->receivePacket())
+    filteredPackets.push_back(std::move(*filteredPacket));
+  return true;
+}
+
+void BitstreamFilter::flush()
+{
+  if (!this->context)
+    return;
+
+  this->ffmpegLibraries->avcodec.av_bsf_flush(this->context.get());
+  this->endOfStream = false;
+}
+
+std::optional<avcodec::AVCodecParametersWrapper> BitstreamFilter::getOutputCodecParameters() const
+{
+  if (!this->context)
+    return {};
+
+  AVCodecParameters *parametersOut{};
+  CAST_AVCODEC_GET_MEMBER(AVBSFContext, this->context.get(), parametersOut, par_out);
+  if (parametersOut == nullptr)
+    return {};
+  return avcodec::AVCodecParametersWrapper(parametersOut, this->ffmpegLibraries);
+}
+
+Rational BitstreamFilter::getOutputTimeBase() const
+{
+  if (!this->context)
+    return {};
+
+  AVRational timeBaseOut{};
+  CAST_AVCODEC_GET_MEMBER(AVBSFContext, this->context.get(), timeBaseOut, time_base_out);
+  return fromAVRational(timeBaseOut);
+}
+
+void BitstreamFilter::AVBSFContextDeleter::operator()(AVBSFContext *context) const noexcept
+{
+  if (context != nullptr)
+    this->ffmpegLibraries->avcodec.av_bsf_free(&context);
+}
+
+} // namespace libffmpeg
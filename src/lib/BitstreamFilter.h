@@ -0,0 +1,90 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVCodecParametersWrapper.h>
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <AVFormat/wrappers/AVStreamWrapper.h>
+#include <common/Error.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace libffmpeg
+{
+
+/* A bitstream filter of FFmpeg (av_bsf API, e.g. h264_mp4toannexb or hevc_mp4toannexb) that is
+ * applied to the packets of one stream. It can directly be chained after the demuxer:
+ *
+ *   filter.open("h264_mp4toannexb", stream);
+ *   while (auto packet = demuxer.getNextPacket())
+ *     if (packet->getStreamIndex() == stream.getIndex())
+ *       filter.filterPacket(std::move(*packet), filteredPackets);
+ *
+ * The data reference of the sent packets is moved into the filter, so the data is not copied
+ * unless the filter has to modify it. The filters are only available with avcodec >= 57.
+ */
+class BitstreamFilter
+{
+public:
+  BitstreamFilter(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+
+  // Open the filter with the codec parameters and the time base of the input packets.
+  bool open(const std::string &filterName, const avformat::AVStreamWrapper &stream);
+  bool open(const std::string                       &filterName,
+            const avcodec::AVCodecParametersWrapper &codecParameters,
+            const Rational                           timeBase);
+
+  explicit operator bool() const { return this->context != nullptr; }
+
+  // On success, the data reference of the packet is moved into the filter and the packet is empty
+  // afterwards. With TryAgain the packet is unchanged. The available output packets must be
+  // received before sending it again. Use sendEndOfStream to flush the filter.
+  ReturnCode sendPacket(avcodec::AVPacketWrapper &packet);
+  ReturnCode sendEndOfStream();
+
+  // Returns no packet if the filter needs more input or all packets were received after
+  // sendEndOfStream (see hasReachedEndOfStream).
+  std::optional<avcodec::AVPacketWrapper> receivePacket();
+
+  // Send the packet and append all available output packets to the vector. Returns false if
+  // sending failed.
+  bool filterPacket(avcodec::AVPacketWrapper              &&packet,
+                    std::vector<avcodec::AVPacketWrapper> &filteredPackets);
+
+  // Drop all buffered packets (e.g. after seeking) and reset the end of stream state.
+  void flush();
+
+  [[nodiscard]] bool hasReachedEndOfStream() const { return this->endOfStream; }
+
+  // The codec parameters of the output packets (e.g. the extradata changes from avcC to Annex B)
+  [[nodiscard]] std::optional<avcodec::AVCodecParametersWrapper> getOutputCodecParameters() const;
+  [[nodiscard]] Rational                                         getOutputTimeBase() const;
+
+private:
+  class AVBSFContextDeleter
+  {
+  public:
+    AVBSFContextDeleter() = default;
+    AVBSFContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(libffmpeg::internal::AVBSFContext *context) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  std::unique_ptr<libffmpeg::internal::AVBSFContext, AVBSFContextDeleter> context{
+      nullptr, AVBSFContextDeleter()};
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  bool                              endOfStream{};
+};
+
+} // namespace libffmpeg
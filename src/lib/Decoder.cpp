@@ -6,6 +6,7 @@
 
 #include "Decoder.h"
 
+#include <AVCodec/wrappers/AVCodecWrapper.h>
 #include <common/Error.h>
 #include <common/Formatting.h>
 
@@ -17,6 +18,7 @@ Decoder::Decoder(std::shared_ptr<IFFmpegLibraries> libraries)
   if (!libraries)
     throw std::runtime_error("Given libraries pointer is null");
   this->ffmpegLibraries = libraries;
+  this->memoryBudget    = libraries->getMemoryBudget();
 }
 
 Decoder::operator bool() const
@@ -24,7 +26,49 @@ Decoder::operator bool() const
   return this->decoderState != State::Error && this->decoderState != State::EndOfBitstream;
 };
 
-bool Decoder::openForDecoding(const avformat::AVStreamWrapper &stream)
+void Decoder::setFrameBufferPool(std::shared_ptr<avcodec::FrameBufferPool> pool)
+{
+  if (this->decoderState != State::NotOpened)
+    throw std::runtime_error("The frame buffer pool must be set before opening the decoder.");
+  this->frameBufferPool = pool;
+}
+
+void Decoder::setMemoryBudget(std::shared_ptr<MemoryBudget> budget)
+{
+  if (!budget)
+    throw std::runtime_error("Given memory budget pointer is null");
+  this->memoryBudget = budget;
+}
+
+void Decoder::setDecodeMode(const DecodeMode decodeMode)
+{
+  auto skipSettings = avcodec::AVCodecContextWrapper::SkipSettings();
+  if (decodeMode == DecodeMode::SkipNonReference)
+    skipSettings.skipFrame = avcodec::Discard::NonReference;
+  else if (decodeMode == DecodeMode::IntraOnly)
+    skipSettings.skipFrame = avcodec::Discard::NonIntra;
+  else if (decodeMode == DecodeMode::KeyframesOnly)
+    skipSettings.skipFrame = avcodec::Discard::NonKey;
+
+  this->setSkipSettings(skipSettings);
+}
+
+void Decoder::setSkipSettings(const avcodec::AVCodecContextWrapper::SkipSettings skipSettings)
+{
+  if (this->decoderState != State::NotOpened)
+    throw std::runtime_error("The skip settings must be set before opening the decoder.");
+  this->skipSettings = skipSettings;
+}
+
+int Decoder::getMaxLowres(const avformat::AVStreamWrapper &stream) const
+{
+  const auto codec = this->ffmpegLibraries->avcodec.avcodec_find_decoder(stream.getCodecID());
+  if (codec == nullptr)
+    return 0;
+  return avcodec::AVCodecWrapper(codec, this->ffmpegLibraries).getMaxLowres();
+}
+
+bool Decoder::openForDecoding(const avformat::AVStreamWrapper &stream, const int lowres)
 {
   if (this->decoderState != State::NotOpened)
     throw std::runtime_error("Decoder was already opened.");
@@ -32,22 +76,50 @@ bool Decoder::openForDecoding(const avformat::AVStreamWrapper &stream)
   bool openContextSuccessfull = false;
   if (auto codecParameters = stream.getCodecParameters())
   {
-    this->decoderContext   = avcodec::AVCodecContextWrapper(this->ffmpegLibraries);
+    this->decoderContext = avcodec::AVCodecContextWrapper(this->ffmpegLibraries);
+    this->decoderContext->setFrameBufferPool(this->frameBufferPool);
+    this->decoderContext->setSkipSettings(this->skipSettings);
+    this->decoderContext->setLowres(lowres);
     openContextSuccessfull = this->decoderContext->openContextForDecoding(*codecParameters);
   }
   else
   {
     this->decoderContext = stream.getCodecContext();
     if (this->decoderContext)
+    {
+      this->decoderContext->setFrameBufferPool(this->frameBufferPool);
+      this->decoderContext->setSkipSettings(this->skipSettings);
+      this->decoderContext->setLowres(lowres);
       openContextSuccessfull = this->decoderContext->openContextForDecoding();
+    }
     else
       openContextSuccessfull = false;
   }
 
+  return this->finishOpening(openContextSuccessfull);
+}
+
+bool Decoder::openForDecoding(const internal::AVCodecID codecID, const int lowres)
+{
+  if (this->decoderState != State::NotOpened)
+    throw std::runtime_error("Decoder was already opened.");
+
+  this->decoderContext = avcodec::AVCodecContextWrapper(this->ffmpegLibraries);
+  this->decoderContext->setFrameBufferPool(this->frameBufferPool);
+  this->decoderContext->setSkipSettings(this->skipSettings);
+  this->decoderContext->setLowres(lowres);
+  return this->finishOpening(this->decoderContext->openContextForDecoding(codecID));
+}
+
+bool Decoder::finishOpening(const bool openContextSuccessfull)
+{
   if (openContextSuccessfull)
     this->ffmpegLibraries->log(LogLevel::Info, "Opening of decoder successfull");
   else
+  {
     this->ffmpegLibraries->log(LogLevel::Error, "Opening of deoder failed.");
+    this->decoderContext.reset();
+  }
 
   this->decoderState = openContextSuccessfull ? State::NeedsMoreData : State::Error;
   return openContextSuccessfull;
@@ -118,7 +190,9 @@ void Decoder::setFlushing()
     throw std::runtime_error("Flushing was already set. Can not be set multiple times.");
 
   auto returnCode = ReturnCode::Ok;
-  if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major > 56)
+  if (!this->decoderContext)
+    returnCode = ReturnCode::Unknown;
+  else if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major > 56)
     returnCode = this->decoderContext->sendFlushPacket();
 
   this->ffmpegLibraries->log(LogLevel::Debug, "Setting decoder to flushing.");
@@ -126,11 +200,31 @@ void Decoder::setFlushing()
   this->decoderState = (returnCode == ReturnCode::Ok) ? State::RetrieveFrames : State::Error;
 }
 
+bool Decoder::reset()
+{
+  if (this->decoderState == State::NotOpened || !this->decoderContext)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Can not reset decoder that was not opened.");
+    return false;
+  }
+
+  this->decoderContext->flushBuffers();
+
+  this->ffmpegLibraries->log(LogLevel::Debug, "Decoder reset. Switching to state NeedsMoreData.");
+  this->pendingDecodedFrame.reset();
+  this->flushing     = false;
+  this->decoderState = State::NeedsMoreData;
+  return true;
+}
+
 std::optional<avutil::AVFrameWrapper> Decoder::decodeNextFrame()
 {
   if (this->decoderState != State::RetrieveFrames)
     return {};
 
+  if (!this->waitForMemoryBudget())
+    return {};
+
   if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major == 56)
   {
     if (this->flushing)
@@ -139,7 +233,10 @@ std::optional<avutil::AVFrameWrapper> Decoder::decodeNextFrame()
 
       auto decodeResult = this->decoderContext->decodeVideo2(emptyFlushPacket);
       if (decodeResult.frame)
+      {
+        this->accountFrameInMemoryBudget(decodeResult.frame);
         return std::move(decodeResult.frame);
+      }
       this->decoderState = State::EndOfBitstream;
       return {};
     }
@@ -149,6 +246,7 @@ std::optional<avutil::AVFrameWrapper> Decoder::decodeNextFrame()
     {
       auto frame = std::move(this->pendingDecodedFrame);
       this->pendingDecodedFrame.reset();
+      this->accountFrameInMemoryBudget(frame);
       return frame;
     }
   }
@@ -157,17 +255,90 @@ std::optional<avutil::AVFrameWrapper> Decoder::decodeNextFrame()
     auto [frame, returnCode] = this->decoderContext->revieveFrame();
 
     if (returnCode == ReturnCode::Ok)
+    {
+      this->accountFrameInMemoryBudget(frame);
       return std::move(frame);
+    }
 
-    if (returnCode == ReturnCode::TryAgain)
-      this->decoderState = this->flushing ? State::EndOfBitstream : State::NeedsMoreData;
-    else if (returnCode == ReturnCode::EndOfFile)
-      this->decoderState = State::EndOfBitstream;
-    else
-      this->decoderState = State::Error;
+    this->updateStateAfterReceivingFrame(returnCode);
   }
 
   return {};
 }
 
+std::size_t Decoder::decodeAvailableFrames(std::vector<avutil::AVFrameWrapper> &frames)
+{
+  if (this->ffmpegLibraries->getLibrariesVersion().avcodec.major == 56)
+  {
+    // The old interface returns at most one frame per packet. There is nothing to batch.
+    frames.clear();
+    while (auto frame = this->decodeNextFrame())
+      frames.push_back(std::move(*frame));
+    return frames.size();
+  }
+
+  if (this->decoderState != State::RetrieveFrames || !this->waitForMemoryBudget())
+  {
+    frames.clear();
+    return 0;
+  }
+
+  std::size_t numberOfFrames{};
+  while (true)
+  {
+    if (numberOfFrames == frames.size() && !this->spareFrame)
+      this->spareFrame.emplace(this->ffmpegLibraries);
+    auto &frame = (numberOfFrames == frames.size()) ? *this->spareFrame : frames[numberOfFrames];
+    if (!frame)
+      frame = avutil::AVFrameWrapper(this->ffmpegLibraries);
+    frame.setMemoryReservation({});
+
+    const auto returnCode = this->decoderContext->revieveFrame(frame);
+    if (returnCode != ReturnCode::Ok)
+    {
+      this->updateStateAfterReceivingFrame(returnCode);
+      break;
+    }
+
+    frame.setMemoryReservation(this->memoryBudget->reserve(frame.getDataSizeInBytes()));
+    if (numberOfFrames == frames.size())
+    {
+      frames.push_back(std::move(*this->spareFrame));
+      this->spareFrame.reset();
+    }
+    ++numberOfFrames;
+  }
+  frames.erase(frames.begin() + static_cast<std::ptrdiff_t>(numberOfFrames), frames.end());
+
+  this->ffmpegLibraries->log(LogLevel::Debug,
+                             "Got batch of " + std::to_string(numberOfFrames) + " frames");
+  return numberOfFrames;
+}
+
+void Decoder::updateStateAfterReceivingFrame(const ReturnCode returnCode)
+{
+  if (returnCode == ReturnCode::TryAgain)
+    this->decoderState = this->flushing ? State::EndOfBitstream : State::NeedsMoreData;
+  else if (returnCode == ReturnCode::EndOfFile)
+    this->decoderState = State::EndOfBitstream;
+  else
+    this->decoderState = State::Error;
+}
+
+bool Decoder::waitForMemoryBudget()
+{
+  if (this->memoryBudget->waitForCapacity())
+    return true;
+
+  this->ffmpegLibraries->log(LogLevel::Warning,
+                             "Memory budget exhausted. Not retrieving a new frame.");
+  return false;
+}
+
+void Decoder::accountFrameInMemoryBudget(std::optional<avutil::AVFrameWrapper> &frame)
+{
+  if (frame)
+    frame->setMemoryReservation(this->memoryBudget->reserve(frame->getDataSizeInBytes()));
+}
+
 } // namespace libffmpeg
@@ -12,6 +12,8 @@
 #include <AVUtil/wrappers/AVFrameWrapper.h>
 #include <libHandling/IFFmpegLibraries.h>
 
+#include <vector>
+
 namespace libffmpeg
 {
 
@@ -22,7 +24,41 @@ public:
 
   explicit operator bool() const;
 
-  bool openForDecoding(const avformat::AVStreamWrapper &stream);
+  // Optionally set a pool that is used for the frame buffers. Must be called before opening.
+  void setFrameBufferPool(std::shared_ptr<avcodec::FrameBufferPool> pool);
+
+  // Account the decoded frames in the given budget (e.g. one budget per pipeline) instead of the
+  // budget of the library instance. The budget should have the library budget as parent.
+  void setMemoryBudget(std::shared_ptr<MemoryBudget> budget);
+  [[nodiscard]] std::shared_ptr<MemoryBudget> getMemoryBudget() const { return this->memoryBudget; }
+
+  enum class DecodeMode
+  {
+    AllFrames,
+    // Skip all frames that are not used as a reference by other frames
+    SkipNonReference,
+    // Only decode intra frames
+    IntraOnly,
+    // Only decode keyframes. Combine with Demuxer::setKeyframesOnly so that the other packets
+    // are not even read.
+    KeyframesOnly
+  };
+
+  // Must be called before opening. For more control use setSkipSettings.
+  void setDecodeMode(const DecodeMode decodeMode);
+  void setSkipSettings(const avcodec::AVCodecContextWrapper::SkipSettings skipSettings);
+
+  // With a lowres value > 0, the frames are decoded at a reduced resolution (1: half, 2: quarter,
+  // 3: eighth) if the decoder supports it. Use getMaxLowres to check this.
+  bool openForDecoding(const avformat::AVStreamWrapper &stream, const int lowres = 0);
+
+  // Open the decoder for packets that do not come from a demuxer (e.g. from a Parser). There are
+  // no codec parameters so the codec configuration must be part of the bitstream.
+  bool openForDecoding(const internal::AVCodecID codecID, const int lowres = 0);
+
+  // The maximum lowres value that the decoder for the given stream supports. 0 if the decoder
+  // does not support decoding at a lower resolution.
+  [[nodiscard]] int getMaxLowres(const avformat::AVStreamWrapper &stream) const;
 
   enum class State
   {
@@ -41,18 +77,45 @@ public:
     Error
   };
 
-  SendPacketResult                      sendPacket(const avcodec::AVPacketWrapper &packet);
-  void                                  setFlushing();
+  SendPacketResult sendPacket(const avcodec::AVPacketWrapper &packet);
+  void             setFlushing();
+
+  // Drop all buffered data and go back to NeedsMoreData without reopening the codec (e.g. after
+  // a seek or to decode the next clip with the same codec parameters). This also works after
+  // flushing / EndOfBitstream. Returns false if the decoder was not opened successfully.
+  bool reset();
+
+  // If the memory budget is exhausted (and the policy is Fail or the timeout expired) no frame is
+  // returned but the state stays RetrieveFrames. Release frames and try again.
   std::optional<avutil::AVFrameWrapper> decodeNextFrame();
 
+  // Retrieve all frames that are currently available (until the decoder needs more data or
+  // reached the end of the bitstream) into the given vector. The frames of the previous call in
+  // the vector are reused, so pass the same vector for every call to avoid reallocating frames.
+  // The memory budget is only checked once per call. Returns the number of frames.
+  std::size_t decodeAvailableFrames(std::vector<avutil::AVFrameWrapper> &frames);
+
 private:
+  bool               finishOpening(const bool openContextSuccessfull);
+  [[nodiscard]] bool waitForMemoryBudget();
+  void               accountFrameInMemoryBudget(std::optional<avutil::AVFrameWrapper> &frame);
+  void               updateStateAfterReceivingFrame(const ReturnCode returnCode);
+
   std::shared_ptr<IFFmpegLibraries>             ffmpegLibraries;
   std::optional<avcodec::AVCodecContextWrapper> decoderContext{};
+  std::shared_ptr<avcodec::FrameBufferPool>     frameBufferPool{};
+  std::shared_ptr<MemoryBudget>                 memoryBudget{};
+
+  avcodec::AVCodecContextWrapper::SkipSettings skipSettings{};
 
   // For the old (FFmpeg 2) interface, we store the frame that is returned
   // in sendPacket from avcodec_decode_video2.
   std::optional<avutil::AVFrameWrapper> pendingDecodedFrame;
 
+  // decodeAvailableFrames always ends with a failed receive call. The frame that was used for
+  // it is kept for the next call.
+  std::optional<avutil::AVFrameWrapper> spareFrame;
+
   State decoderState{State::NotOpened};
   bool  flushing{};
 };
@@ -0,0 +1,190 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "DecoderPool.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+// A decoder can only be reused for a stream if it was opened with the same codec parameters.
+struct DecoderKey
+{
+  internal::AVCodecID      codecID{};
+  uint32_t                 codecTag{};
+  int                      profile{};
+  int                      width{};
+  int                      height{};
+  std::string              pixelFormat{};
+  int                      sampleRate{};
+  std::vector<std::string> channelLayout{};
+  int                      blockAlign{};
+  int                      bitsPerCodedSample{};
+  ByteVector               extradata{};
+
+  bool operator<(const DecoderKey &other) const
+  {
+    return std::tie(this->codecID,
+                    this->codecTag,
+                    this->profile,
+                    this->width,
+                    this->height,
+                    this->pixelFormat,
+                    this->sampleRate,
+                    this->channelLayout,
+                    this->blockAlign,
+                    this->bitsPerCodedSample,
+                    this->extradata) < std::tie(other.codecID,
+                                                other.codecTag,
+                                                other.profile,
+                                                other.width,
+                                                other.height,
+                                                other.pixelFormat,
+                                                other.sampleRate,
+                                                other.channelLayout,
+                                                other.blockAlign,
+                                                other.bitsPerCodedSample,
+                                                other.extradata);
+  }
+};
+
+DecoderKey getKeyForStream(const avcodec::AVCodecParametersWrapper &codecParameters)
+{
+  std::vector<std::string> channelLayout;
+  for (const auto &channelInfo : codecParameters.getChannelLayout())
+    channelLayout.push_back(channelInfo.name);
+
+  const auto size = codecParameters.getSize();
+  return DecoderKey{codecParameters.getCodecID(),
+                    codecParameters.getCodecTag(),
+                    codecParameters.getProfile(),
+                    size.width,
+                    size.height,
+                    codecParameters.getPixelFormat().name,
+                    codecParameters.getSampleRate(),
+                    channelLayout,
+                    codecParameters.getBlockAlign(),
+                    codecParameters.getBitsPerCodedSample(),
+                    codecParameters.getExtradata()};
+}
+
+} // namespace
+
+struct DecoderPool::PoolState
+{
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  Settings                          settings{};
+
+  std::mutex                                                  mutex;
+  std::map<DecoderKey, std::vector<std::unique_ptr<Decoder>>> idleDecoders;
+  Statistics                                                  statistics{};
+
+  void returnDecoder(const DecoderKey &key, std::unique_ptr<Decoder> decoder)
+  {
+    if (!decoder->reset())
+      return;
+
+    // The previous user may have set its own budget. Frames of the next user must not be
+    // accounted in it.
+    decoder->setMemoryBudget(this->ffmpegLibraries->getMemoryBudget());
+
+    std::scoped_lock lock(this->mutex);
+    auto            &decoders = this->idleDecoders[key];
+    if (decoders.size() < this->settings.maxIdleDecodersPerKey)
+      decoders.push_back(std::move(decoder));
+  }
+};
+
+DecoderPool::DecoderPool(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : DecoderPool(ffmpegLibraries, Settings())
+{
+}
+
+DecoderPool::DecoderPool(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                         const Settings                    settings)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+
+  this->state                  = std::make_shared<PoolState>();
+  this->state->ffmpegLibraries = ffmpegLibraries;
+  this->state->settings        = settings;
+}
+
+std::shared_ptr<Decoder> DecoderPool::getDecoder(const avformat::AVStreamWrapper &stream)
+{
+  const auto codecParameters = stream.getCodecParameters();
+  if (!codecParameters)
+  {
+    auto decoder = std::make_shared<Decoder>(this->state->ffmpegLibraries);
+    if (!decoder->openForDecoding(stream, this->state->settings.lowres))
+      return {};
+    return decoder;
+  }
+
+  const auto key = getKeyForStream(*codecParameters);
+
+  std::unique_ptr<Decoder> decoder;
+  {
+    std::scoped_lock lock(this->state->mutex);
+    auto             it = this->state->idleDecoders.find(key);
+    if (it != this->state->idleDecoders.end() && !it->second.empty())
+    {
+      decoder = std::move(it->second.back());
+      it->second.pop_back();
+      ++this->state->statistics.reusedDecoders;
+    }
+  }
+
+  if (!decoder)
+  {
+    decoder = std::make_unique<Decoder>(this->state->ffmpegLibraries);
+    if (!decoder->openForDecoding(stream, this->state->settings.lowres))
+      return {};
+
+    std::scoped_lock lock(this->state->mutex);
+    ++this->state->statistics.openedDecoders;
+  }
+
+  // The deleter only holds a weak reference so that the decoders can outlive the pool
+  std::weak_ptr<PoolState> weakState = this->state;
+  return std::shared_ptr<Decoder>(decoder.release(),
+                                  [weakState, key](Decoder *decoderToReturn)
+                                  {
+                                    std::unique_ptr<Decoder> decoder(decoderToReturn);
+                                    if (auto state = weakState.lock())
+                                      state->returnDecoder(key, std::move(decoder));
+                                  });
+}
+
+DecoderPool::Statistics DecoderPool::getStatistics() const
+{
+  std::scoped_lock lock(this->state->mutex);
+
+  auto statistics         = this->state->statistics;
+  statistics.idleDecoders = 0;
+  for (const auto &[key, decoders] : this->state->idleDecoders)
+    statistics.idleDecoders += decoders.size();
+  return statistics;
+}
+
+void DecoderPool::clear()
+{
+  std::map<DecoderKey, std::vector<std::unique_ptr<Decoder>>> decodersToClose;
+  {
+    std::scoped_lock lock(this->state->mutex);
+    std::swap(decodersToClose, this->state->idleDecoders);
+  }
+}
+
+} // namespace libffmpeg
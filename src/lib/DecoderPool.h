@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include "Decoder.h"
+
+#include <AVFormat/wrappers/AVStreamWrapper.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <memory>
+
+namespace libffmpeg
+{
+
+/* A pool of opened decoders. Opening a decoder (finding the codec, allocating the context,
+ * avcodec_open2, starting the codec threads) is expensive compared to decoding a short clip. When
+ * a decoder that was handed out by the pool is released, it is reset (Decoder::reset), its memory
+ * budget is set back to the budget of the libraries and it is kept in the pool. The next request
+ * for a stream with the same codec parameters (codec, size, pixel format and extradata) gets this
+ * warm decoder instead of a newly opened one.
+ *
+ * The pool can be used from multiple threads. Decoders that were handed out may outlive the pool.
+ */
+class DecoderPool
+{
+public:
+  struct Settings
+  {
+    // How many idle decoders are kept for one set of codec parameters
+    std::size_t maxIdleDecodersPerKey{4};
+    // The lowres value that all decoders of the pool are opened with
+    int lowres{};
+  };
+
+  struct Statistics
+  {
+    std::size_t openedDecoders{};
+    std::size_t reusedDecoders{};
+    std::size_t idleDecoders{};
+  };
+
+  DecoderPool() = delete;
+  DecoderPool(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+  DecoderPool(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const Settings settings);
+
+  // Get a decoder for the given stream in state NeedsMoreData. Returns nullptr if no decoder
+  // could be opened. When the last reference to the decoder is dropped, it is returned to the
+  // pool. For old FFmpeg versions (without AVCodecParameters) the codec context belongs to the
+  // stream so these decoders are not pooled.
+  [[nodiscard]] std::shared_ptr<Decoder> getDecoder(const avformat::AVStreamWrapper &stream);
+
+  [[nodiscard]] Statistics getStatistics() const;
+
+  // Close all idle decoders
+  void clear();
+
+private:
+  struct PoolState;
+  std::shared_ptr<PoolState> state{};
+};
+
+} // namespace libffmpeg
@@ -8,12 +8,18 @@
 
 #include <common/Formatting.h>
 
+#include <algorithm>
+
 namespace libffmpeg
 {
 
 namespace
 {
 
+// The number of packets that is reserved up front. The caller may request any number of packets
+// (e.g. SIZE_MAX to read all packets). Larger batches grow the vector while reading.
+constexpr std::size_t MAX_RESERVED_PACKETS = 256;
+
 std::string logPacket(const avcodec::AVPacketWrapper &packet)
 {
   std::stringstream stream;
@@ -37,11 +43,13 @@ Demuxer::Demuxer(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
     throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
 
   this->ffmpegLibraries = ffmpegLibraries;
+  this->memoryBudget    = ffmpegLibraries->getMemoryBudget();
 }
 
 Demuxer::Demuxer(Demuxer &&demuxer) noexcept
     : ffmpegLibraries(std::move(demuxer.ffmpegLibraries)),
-      formatContext(std::move(demuxer.formatContext))
+      memoryBudget(std::move(demuxer.memoryBudget)), keyframesOnly(demuxer.keyframesOnly),
+      demuxerState(demuxer.demuxerState), formatContext(std::move(demuxer.formatContext))
 {
 }
 
@@ -50,6 +58,9 @@ Demuxer &Demuxer::operator=(Demuxer &&demuxer) noexcept
   if (this != &demuxer)
   {
     this->ffmpegLibraries = std::move(demuxer.ffmpegLibraries);
+    this->memoryBudget    = std::move(demuxer.memoryBudget);
+    this->keyframesOnly   = demuxer.keyframesOnly;
+    this->demuxerState    = demuxer.demuxerState;
     this->formatContext   = std::move(demuxer.formatContext);
   }
   return *this;
@@ -57,24 +68,109 @@ Demuxer &Demuxer::operator=(Demuxer &&demuxer) noexcept
 
 bool Demuxer::openFile(const Path &path)
 {
-  return this->formatContext.openFile(path);
+  const auto success = this->formatContext.openFile(path);
+  this->demuxerState = success ? State::Reading : State::Error;
+  return success;
 }
 
 bool Demuxer::openInput(std::unique_ptr<avformat::AVIOInputContext> ioInput)
 {
-  return this->formatContext.openInput(std::move(ioInput));
+  const auto success = this->formatContext.openInput(std::move(ioInput));
+  this->demuxerState = success ? State::Reading : State::Error;
+  return success;
+}
+
+void Demuxer::setMemoryBudget(std::shared_ptr<MemoryBudget> budget)
+{
+  if (!budget)
+    throw std::runtime_error("Provided memory budget pointer must not be null");
+  this->memoryBudget = budget;
 }
 
 std::optional<avcodec::AVPacketWrapper> Demuxer::getNextPacket()
 {
-  avcodec::AVPacketWrapper packet(this->ffmpegLibraries);
-  if (!this->formatContext.getNextPacket(packet))
+  if (!this->memoryBudget->waitForCapacity())
+  {
+    this->ffmpegLibraries->log(LogLevel::Warning,
+                               "Memory budget exhausted. Not reading a new packet.");
+    this->demuxerState = State::MemoryBudgetExhausted;
+    return {};
+  }
+
+  auto packet = this->readNextPacket();
+  if (!packet)
   {
     this->ffmpegLibraries->log(LogLevel::Debug, "Got empty packet");
     return {};
   }
-  this->ffmpegLibraries->log(LogLevel::Debug, "Got Packet with " + logPacket(packet));
+  this->ffmpegLibraries->log(LogLevel::Debug, "Got Packet with " + logPacket(*packet));
   return packet;
 }
 
+std::size_t Demuxer::getNextPackets(std::vector<avcodec::AVPacketWrapper> &packets,
+                                    const std::size_t                      maxNumberOfPackets)
+{
+  if (!this->memoryBudget->waitForCapacity())
+  {
+    this->ffmpegLibraries->log(LogLevel::Warning,
+                               "Memory budget exhausted. Not reading a new batch of packets.");
+    this->demuxerState = State::MemoryBudgetExhausted;
+    packets.clear();
+    return 0;
+  }
+
+  packets.reserve(std::min(maxNumberOfPackets, MAX_RESERVED_PACKETS));
+
+  std::size_t numberOfPackets{};
+  while (numberOfPackets < maxNumberOfPackets)
+  {
+    if (numberOfPackets == packets.size())
+      packets.emplace_back(this->ffmpegLibraries);
+    else if (!packets[numberOfPackets])
+      packets[numberOfPackets] = avcodec::AVPacketWrapper(this->ffmpegLibraries);
+    else
+      packets[numberOfPackets].unref();
+
+    if (!this->readNextPacket(packets[numberOfPackets]))
+      break;
+    ++numberOfPackets;
+  }
+  packets.erase(packets.begin() + static_cast<std::ptrdiff_t>(numberOfPackets), packets.end());
+
+  this->ffmpegLibraries->log(LogLevel::Debug,
+                             "Got batch of " + std::to_string(numberOfPackets) + " packets");
+  return numberOfPackets;
+}
+
+std::optional<avcodec::AVPacketWrapper> Demuxer::readNextPacket()
+{
+  avcodec::AVPacketWrapper packet(this->ffmpegLibraries);
+  if (!this->readNextPacket(packet))
+    return {};
+  return packet;
+}
+
+bool Demuxer::readNextPacket(avcodec::AVPacketWrapper &packet)
+{
+  while (true)
+  {
+    const auto returnCode = this->formatContext.readNextPacket(packet);
+    if (returnCode != ReturnCode::Ok)
+    {
+      this->demuxerState = (returnCode == ReturnCode::EndOfFile) ? State::EndOfFile : State::Error;
+      return false;
+    }
+    if (!this->keyframesOnly || packet.getFlags().keyframe)
+      break;
+
+    this->ffmpegLibraries->log(LogLevel::Debug,
+                               "Dropping non keyframe packet with " + logPacket(packet));
+    packet.unref();
+  }
+  packet.setMemoryReservation(
+      this->memoryBudget->reserve(static_cast<std::size_t>(packet.getDataSize())));
+  this->demuxerState = State::Reading;
+  return true;
+}
+
 } // namespace libffmpeg
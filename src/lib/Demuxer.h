@@ -11,6 +11,8 @@
 #include <AVFormat/wrappers/AVIOContextWrapper.h>
 #include <libHandling/IFFmpegLibraries.h>
 
+#include <vector>
+
 namespace libffmpeg
 {
 
@@ -30,10 +32,46 @@ public:
 
   avformat::AVFormatContextWrapper *getFormatContext() { return &this->formatContext; }
 
+  // Account the packets in the given budget (e.g. one budget per pipeline) instead of the budget
+  // of the library instance. The budget should have the library budget as parent.
+  void setMemoryBudget(std::shared_ptr<MemoryBudget> budget);
+
+  // Drop all packets that are not flagged as keyframe (see AVPacketWrapper::Flags::keyframe).
+  void setKeyframesOnly(const bool keyframesOnly) { this->keyframesOnly = keyframesOnly; }
+
+  enum class State
+  {
+    NotOpened,
+    Reading,
+    EndOfFile,
+    // No packet was read because the memory budget is exhausted (and the policy is Fail or the
+    // timeout expired). This is not the end of the file. Reading can continue once packets or
+    // frames were released.
+    MemoryBudgetExhausted,
+    Error
+  };
+  // The state is updated by every read. Check it when no packet is returned.
+  [[nodiscard]] State getDemuxerState() const { return this->demuxerState; }
+
   std::optional<avcodec::AVPacketWrapper> getNextPacket();
 
+  // Read up to maxNumberOfPackets packets into the given vector. The packets of the previous
+  // batch in the vector are unreferenced and reused, so pass the same vector for every batch to
+  // avoid reallocating packets. Returns the number of packets read. Fewer packets are returned at
+  // the end of the file or on an error (see getDemuxerState).
+  // In contrast to getNextPacket, the memory budget is only checked once per batch and the
+  // packets are not logged individually.
+  std::size_t getNextPackets(std::vector<avcodec::AVPacketWrapper> &packets,
+                             const std::size_t                      maxNumberOfPackets);
+
 private:
+  std::optional<avcodec::AVPacketWrapper> readNextPacket();
+  bool                                    readNextPacket(avcodec::AVPacketWrapper &packet);
+
   std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  std::shared_ptr<MemoryBudget>     memoryBudget;
+  bool                              keyframesOnly{};
+  State                             demuxerState{State::NotOpened};
 
   avformat::AVFormatContextWrapper formatContext;
 };
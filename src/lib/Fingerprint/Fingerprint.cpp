@@ -0,0 +1,163 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Fingerprint.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace libffmpeg::fingerprint
+{
+
+namespace
+{
+
+constexpr auto HEADER = "# LibFFmpeg fingerprint version 1";
+
+std::string to_string(const FingerprintEntry &entry)
+{
+  std::ostringstream stream;
+  stream << (entry.type == FingerprintEntry::Type::Packet ? "packet" : "frame") << " "
+         << entry.streamIndex << " " << entry.index << " ";
+  if (entry.pts)
+    stream << *entry.pts;
+  else
+    stream << "-";
+  stream << " " << std::hex << std::setw(8) << std::setfill('0') << entry.crc32c;
+  return stream.str();
+}
+
+std::optional<FingerprintEntry> parseEntry(const std::string &line)
+{
+  std::istringstream stream(line);
+  std::string        type;
+  std::string        pts;
+  std::string        crc;
+
+  FingerprintEntry entry;
+  if (!(stream >> type >> entry.streamIndex >> entry.index >> pts >> crc))
+    return {};
+
+  if (type == "packet")
+    entry.type = FingerprintEntry::Type::Packet;
+  else if (type == "frame")
+    entry.type = FingerprintEntry::Type::Frame;
+  else
+    return {};
+
+  try
+  {
+    if (pts != "-")
+      entry.pts = std::stoll(pts);
+    std::size_t parsedCharacters{};
+    entry.crc32c = static_cast<uint32_t>(std::stoul(crc, &parsedCharacters, 16));
+    if (parsedCharacters != crc.size())
+      return {};
+  }
+  catch (const std::exception &)
+  {
+    return {};
+  }
+
+  return entry;
+}
+
+} // namespace
+
+bool FingerprintWriter::open(const Path &path)
+{
+  this->indexCounters.clear();
+  this->file.open(path, std::ios::trunc);
+  if (!this->file.is_open())
+    return false;
+
+  this->file << HEADER << "\n";
+  this->file << "# type, stream index, index, pts, crc32c\n";
+  return this->file.good();
+}
+
+void FingerprintWriter::addPacket(const avcodec::AVPacketWrapper &packet)
+{
+  FingerprintEntry entry;
+  entry.type        = FingerprintEntry::Type::Packet;
+  entry.streamIndex = packet.getStreamIndex();
+  entry.index       = this->getNextIndex(entry.type, entry.streamIndex);
+  entry.pts         = packet.getPTS();
+  entry.crc32c      = packet.calculateCRC32C();
+  this->add(entry);
+}
+
+void FingerprintWriter::addFrame(const int streamIndex, const avutil::AVFrameWrapper &frame)
+{
+  FingerprintEntry entry;
+  entry.type        = FingerprintEntry::Type::Frame;
+  entry.streamIndex = streamIndex;
+  entry.index       = this->getNextIndex(entry.type, entry.streamIndex);
+  entry.pts         = frame.getPTS();
+  entry.crc32c      = frame.calculateCRC32C();
+  this->add(entry);
+}
+
+void FingerprintWriter::add(const FingerprintEntry &entry)
+{
+  if (this->file.is_open())
+    this->file << to_string(entry) << "\n";
+}
+
+bool FingerprintWriter::close()
+{
+  if (!this->file.is_open())
+    return false;
+
+  this->file.flush();
+  const auto success = this->file.good();
+  this->file.close();
+  return success;
+}
+
+uint64_t FingerprintWriter::getNextIndex(const FingerprintEntry::Type type, const int streamIndex)
+{
+  return this->indexCounters[{type, streamIndex}]++;
+}
+
+bool FingerprintReader::open(const Path &path)
+{
+  this->file.close();
+  this->error = false;
+
+  this->file.open(path);
+  if (!this->file.is_open())
+    return false;
+
+  std::string header;
+  if (!std::getline(this->file, header) || header != HEADER)
+  {
+    this->file.close();
+    return false;
+  }
+  return true;
+}
+
+std::optional<FingerprintEntry> FingerprintReader::readNext()
+{
+  if (!this->file.is_open() || this->error)
+    return {};
+
+  std::string line;
+  while (std::getline(this->file, line))
+  {
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    const auto entry = parseEntry(line);
+    if (!entry)
+      this->error = true;
+    return entry;
+  }
+  return {};
+}
+
+} // namespace libffmpeg::fingerprint
@@ -0,0 +1,87 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <common/Types.h>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <utility>
+
+/* A fingerprint file contains a CRC32C checksum of each packet and / or decoded frame of a file
+ * but no data. Two fingerprint files (e.g. from decoding with different FFmpeg versions) can be
+ * compared using the reader or any text diff tool.
+ *
+ * The file is a text file with one line per entry:
+ *   <packet|frame> <stream index> <index in the stream> <pts or -> <crc32c as 8 hex digits>
+ * The first line is a header with the version. Lines starting with # are comments.
+ */
+
+namespace libffmpeg::fingerprint
+{
+
+struct FingerprintEntry
+{
+  enum class Type
+  {
+    Packet,
+    Frame
+  };
+
+  Type                   type{Type::Packet};
+  int                    streamIndex{};
+  // Counted separately for the packets and the frames of each stream
+  uint64_t               index{};
+  std::optional<int64_t> pts{};
+  uint32_t               crc32c{};
+
+  bool operator==(const FingerprintEntry &other) const = default;
+};
+
+class FingerprintWriter
+{
+public:
+  FingerprintWriter() = default;
+
+  bool               open(const Path &path);
+  [[nodiscard]] bool isOpen() const { return this->file.is_open(); }
+
+  void addPacket(const avcodec::AVPacketWrapper &packet);
+  void addFrame(int streamIndex, const avutil::AVFrameWrapper &frame);
+  // Entries with an explicit index. The index counters are not updated.
+  void add(const FingerprintEntry &entry);
+
+  bool close();
+
+private:
+  uint64_t getNextIndex(FingerprintEntry::Type type, int streamIndex);
+
+  std::ofstream                                              file;
+  std::map<std::pair<FingerprintEntry::Type, int>, uint64_t> indexCounters;
+};
+
+class FingerprintReader
+{
+public:
+  FingerprintReader() = default;
+
+  bool open(const Path &path);
+
+  // Returns no value at the end of the file or if a line could not be parsed (see hasError).
+  [[nodiscard]] std::optional<FingerprintEntry> readNext();
+  [[nodiscard]] bool                            hasError() const { return this->error; }
+
+private:
+  std::ifstream file;
+  bool          error{};
+};
+
+} // namespace libffmpeg::fingerprint
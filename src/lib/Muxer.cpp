@@ -0,0 +1,98 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Muxer.h"
+
+#include <AVFormat/OutputContexts.h>
+#include <common/Functions.h>
+
+namespace libffmpeg
+{
+
+Muxer::Muxer(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : formatContext(avformat::AVFormatOutputContextWrapper(ffmpegLibraries))
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+
+  this->ffmpegLibraries = ffmpegLibraries;
+}
+
+bool Muxer::openFile(const Path &path, const std::string &formatName)
+{
+  auto fileOutput = std::make_unique<avformat::FileOutputContext>(this->ffmpegLibraries, path);
+  if (!fileOutput->isFileOpen())
+    return false;
+
+  return this->formatContext.openOutput(std::move(fileOutput), formatName, path.string());
+}
+
+bool Muxer::openOutput(std::unique_ptr<avformat::AVIOOutputContext> ioOutput,
+                       const std::string                          &formatName)
+{
+  return this->formatContext.openOutput(std::move(ioOutput), formatName);
+}
+
+std::optional<int> Muxer::addStream(const avformat::AVStreamWrapper &inputStream)
+{
+  const auto inputStreamIndex = inputStream.getIndex();
+  if (this->streamMapping.count(inputStreamIndex) > 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "The input stream " + std::to_string(inputStreamIndex) +
+                                   " was already added.");
+    return {};
+  }
+
+  const auto codecParameters = inputStream.getCodecParameters();
+  if (!codecParameters)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "The input stream " + std::to_string(inputStreamIndex) +
+                                   " has no codec parameters.");
+    return {};
+  }
+
+  const auto inputTimeBase = inputStream.getTimeBase();
+  const auto outputStream  = this->formatContext.addStream(*codecParameters, inputTimeBase);
+  if (!outputStream)
+    return {};
+
+  const auto outputStreamIndex          = outputStream->getIndex();
+  this->streamMapping[inputStreamIndex] = {outputStreamIndex, inputTimeBase};
+  return outputStreamIndex;
+}
+
+bool Muxer::writeHeader()
+{
+  return this->formatContext.writeHeader();
+}
+
+bool Muxer::writePacket(avcodec::AVPacketWrapper &&packet)
+{
+  const auto mapping = this->streamMapping.find(packet.getStreamIndex());
+  if (mapping == this->streamMapping.end())
+    return true;
+
+  const auto [outputStreamIndex, inputTimeBase] = mapping->second;
+  const auto outputTimeBase = this->formatContext.getStream(outputStreamIndex).getTimeBase();
+
+  packet.setStreamIndex(outputStreamIndex);
+  // The position in the input file has no meaning in the output file
+  packet.setPosition(-1);
+  if (inputTimeBase != outputTimeBase)
+    this->ffmpegLibraries->avcodec.av_packet_rescale_ts(
+        packet.getPacket(), toAVRational(inputTimeBase), toAVRational(outputTimeBase));
+
+  return this->formatContext.writePacket(packet);
+}
+
+bool Muxer::finish()
+{
+  return this->formatContext.writeTrailer();
+}
+
+} // namespace libffmpeg
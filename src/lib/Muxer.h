@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <AVFormat/wrappers/AVFormatOutputContextWrapper.h>
+#include <AVFormat/wrappers/AVIOContextWrapper.h>
+#include <AVFormat/wrappers/AVStreamWrapper.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <map>
+
+namespace libffmpeg
+{
+
+// Write packets (e.g. from a Demuxer) into a new container without decoding them (stream copy).
+class Muxer
+{
+public:
+  Muxer()                                  = delete;
+  ~Muxer()                                 = default;
+  Muxer(const Muxer &)                     = delete;
+  Muxer &operator=(const Muxer &)          = delete;
+  Muxer(Muxer &&muxer) noexcept            = default;
+  Muxer &operator=(Muxer &&muxer) noexcept = default;
+  Muxer(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+
+  // If no format name is given, the container format is guessed from the file extension.
+  bool openFile(const Path &path, const std::string &formatName = {});
+  bool openOutput(std::unique_ptr<avformat::AVIOOutputContext> ioOutput,
+                  const std::string                          &formatName);
+
+  // Add an output stream with the codec parameters of the given input stream. Packets of this
+  // input stream (by stream index) are then written to the new output stream. Returns the index
+  // of the output stream.
+  std::optional<int> addStream(const avformat::AVStreamWrapper &inputStream);
+
+  bool writeHeader();
+
+  // The stream index and timestamps of the packet are converted from the input stream to the
+  // output stream. Packets of input streams that were not added are ignored.
+  bool writePacket(avcodec::AVPacketWrapper &&packet);
+
+  // Write the trailer. The output is complete afterwards.
+  bool finish();
+
+  avformat::AVFormatOutputContextWrapper *getFormatContext() { return &this->formatContext; }
+
+private:
+  struct StreamMapping
+  {
+    int      outputStreamIndex{};
+    Rational inputTimeBase{};
+  };
+
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  std::map<int, StreamMapping>      streamMapping;
+
+  avformat::AVFormatOutputContextWrapper formatContext;
+};
+
+} // namespace libffmpeg
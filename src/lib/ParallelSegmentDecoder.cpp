@@ -0,0 +1,399 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "ParallelSegmentDecoder.h"
+
+#include "Decoder.h"
+#include "Demuxer.h"
+
+#include <common/MemoryBudget.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+struct Segment
+{
+  std::size_t                           index{};
+  std::vector<avcodec::AVPacketWrapper> packets;
+};
+
+struct SegmentResult
+{
+  // Decoded frames that were not passed to the callback yet
+  std::deque<avutil::AVFrameWrapper> frames;
+  bool                               finished{};
+  bool                               success{};
+};
+
+// Called for every decoded frame. Returns false if decoding should be aborted.
+using FrameHandler = std::function<bool(Decoder &decoder, avutil::AVFrameWrapper &&frame)>;
+
+bool pullFramesFromDecoder(Decoder &decoder, const FrameHandler &frameHandler)
+{
+  while (auto frame = decoder.decodeNextFrame())
+    if (!frameHandler(decoder, std::move(*frame)))
+      return false;
+  return true;
+}
+
+bool decodePacket(Decoder                        &decoder,
+                  const avcodec::AVPacketWrapper &packet,
+                  const FrameHandler             &frameHandler)
+{
+  auto result = decoder.sendPacket(packet);
+  if (result == Decoder::SendPacketResult::Error)
+    return false;
+
+  if (decoder.getDecoderState() == Decoder::State::RetrieveFrames &&
+      !pullFramesFromDecoder(decoder, frameHandler))
+    return false;
+
+  if (result == Decoder::SendPacketResult::NotSentPullFramesFirst)
+  {
+    result = decoder.sendPacket(packet);
+    if (result != Decoder::SendPacketResult::Ok)
+      return false;
+  }
+  return true;
+}
+
+bool flushDecoder(Decoder &decoder, const FrameHandler &frameHandler)
+{
+  decoder.setFlushing();
+  if (!pullFramesFromDecoder(decoder, frameHandler))
+    return false;
+
+  return decoder.getDecoderState() == Decoder::State::EndOfBitstream;
+}
+
+bool decodeSegment(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries,
+                   const avformat::AVStreamWrapper         &stream,
+                   const Segment                           &segment,
+                   std::shared_ptr<MemoryBudget>            memoryBudget,
+                   const FrameHandler                      &frameHandler)
+{
+  Decoder decoder(ffmpegLibraries);
+  decoder.setMemoryBudget(memoryBudget);
+  if (!decoder.openForDecoding(stream))
+    return false;
+
+  for (const auto &packet : segment.packets)
+    if (!decodePacket(decoder, packet, frameHandler))
+      return false;
+
+  return flushDecoder(decoder, frameHandler);
+}
+
+// Decode all packets of the stream with one decoder on the calling thread
+bool decodeStream(const std::shared_ptr<IFFmpegLibraries>     &ffmpegLibraries,
+                  Demuxer                                     &demuxer,
+                  const avformat::AVStreamWrapper             &stream,
+                  const int                                    streamIndex,
+                  const ParallelSegmentDecoder::FrameCallback &frameCallback)
+{
+  Decoder decoder(ffmpegLibraries);
+  if (!decoder.openForDecoding(stream))
+    return false;
+
+  const FrameHandler frameHandler = [&frameCallback](Decoder &, avutil::AVFrameWrapper &&frame)
+  {
+    frameCallback(std::move(frame));
+    return true;
+  };
+
+  while (auto packet = demuxer.getNextPacket())
+  {
+    if (packet->getStreamIndex() != streamIndex)
+      continue;
+    if (!decodePacket(decoder, *packet, frameHandler))
+      return false;
+  }
+  if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+  {
+    ffmpegLibraries->log(LogLevel::Error, "Demuxing stopped before the end of the file");
+    return false;
+  }
+
+  return flushDecoder(decoder, frameHandler);
+}
+
+} // namespace
+
+ParallelSegmentDecoder::ParallelSegmentDecoder(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : ParallelSegmentDecoder(ffmpegLibraries, Settings())
+{
+}
+
+ParallelSegmentDecoder::ParallelSegmentDecoder(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                               const Settings                    settings)
+    : ffmpegLibraries(ffmpegLibraries), settings(settings)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool ParallelSegmentDecoder::decodeFile(const Path          &path,
+                                        const int            streamIndex,
+                                        const FrameCallback &frameCallback)
+{
+  Demuxer demuxer(this->ffmpegLibraries);
+  if (!demuxer.openFile(path))
+    return false;
+
+  if (streamIndex < 0 || streamIndex >= demuxer.getFormatContext()->getNumberStreams())
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Invalid stream index " + std::to_string(streamIndex));
+    return false;
+  }
+  const auto stream = demuxer.getFormatContext()->getStream(streamIndex);
+
+  // Without codec parameters (avformat 56) every decoder would use the codec context of the
+  // stream. It can not be used by multiple decoders at the same time.
+  if (!stream.getCodecParameters())
+  {
+    this->ffmpegLibraries->log(LogLevel::Info,
+                               "The stream has no codec parameters. Decoding with one thread.");
+    return decodeStream(this->ffmpegLibraries, demuxer, stream, streamIndex, frameCallback);
+  }
+
+  auto numberOfThreads = this->settings.numberOfThreads;
+  if (numberOfThreads == 0)
+    numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  auto maxSegmentsInFlight = this->settings.maxSegmentsInFlight;
+  if (maxSegmentsInFlight == 0)
+    maxSegmentsInFlight = 2 * numberOfThreads;
+  auto maxBufferedFrames = this->settings.maxBufferedFrames;
+  if (maxBufferedFrames == 0)
+    maxBufferedFrames = 8 * numberOfThreads;
+
+  // The frames of the segment that is output next are passed on while it is decoded. Frames of
+  // all other segments are decoded ahead and are limited by maxBufferedFrames instead of the
+  // memory budget. Otherwise these frames could use up the budget and block the decoder of the
+  // segment that the output is waiting for.
+  const auto outputMemoryBudget    = this->ffmpegLibraries->getMemoryBudget();
+  const auto lookaheadMemoryBudget = std::make_shared<MemoryBudget>();
+
+  std::mutex                           mutex;
+  std::condition_variable              segmentAvailable;
+  std::condition_variable              resultAvailable;
+  std::condition_variable              outputProgress;
+  std::deque<Segment>                  segmentQueue;
+  std::map<std::size_t, SegmentResult> results;
+  std::size_t                          nextSegmentToOutput{};
+  std::size_t                          numberOfBufferedFrames{};
+  bool                                 allSegmentsQueued{};
+  bool                                 aborted{};
+
+  const auto addFrameOfSegment =
+      [&](const std::size_t segmentIndex, Decoder &decoder, avutil::AVFrameWrapper &&frame)
+  {
+    std::unique_lock lock(mutex);
+    results[segmentIndex].frames.push_back(std::move(frame));
+    ++numberOfBufferedFrames;
+    resultAvailable.notify_all();
+
+    outputProgress.wait(lock,
+                        [&]()
+                        {
+                          return aborted || segmentIndex == nextSegmentToOutput ||
+                                 numberOfBufferedFrames < maxBufferedFrames;
+                        });
+    if (segmentIndex == nextSegmentToOutput && outputMemoryBudget)
+      decoder.setMemoryBudget(outputMemoryBudget);
+    return !aborted;
+  };
+
+  const auto worker = [&]()
+  {
+    while (true)
+    {
+      Segment segment;
+      bool    isNextToOutput{};
+      {
+        std::unique_lock lock(mutex);
+        segmentAvailable.wait(
+            lock, [&]() { return !segmentQueue.empty() || allSegmentsQueued || aborted; });
+        if (segmentQueue.empty() || aborted)
+          return;
+        segment = std::move(segmentQueue.front());
+        segmentQueue.pop_front();
+        results[segment.index];
+        isNextToOutput = (segment.index == nextSegmentToOutput);
+      }
+
+      bool success{};
+      try
+      {
+        success = decodeSegment(
+            this->ffmpegLibraries,
+            stream,
+            segment,
+            (isNextToOutput && outputMemoryBudget) ? outputMemoryBudget : lookaheadMemoryBudget,
+            [&](Decoder &decoder, avutil::AVFrameWrapper &&frame)
+            { return addFrameOfSegment(segment.index, decoder, std::move(frame)); });
+      }
+      catch (const std::exception &exception)
+      {
+        this->ffmpegLibraries->log(LogLevel::Error,
+                                   "Exception while decoding segment: " +
+                                       std::string(exception.what()));
+      }
+      catch (...)
+      {
+        this->ffmpegLibraries->log(LogLevel::Error, "Unknown exception while decoding segment");
+      }
+      segment.packets.clear();
+
+      {
+        std::scoped_lock lock(mutex);
+        auto            &result = results[segment.index];
+        result.finished         = true;
+        result.success          = success;
+      }
+      resultAvailable.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto               stopWorkers = [&](const bool abort)
+  {
+    {
+      std::scoped_lock lock(mutex);
+      allSegmentsQueued = true;
+      if (abort)
+        aborted = true;
+    }
+    segmentAvailable.notify_all();
+    outputProgress.notify_all();
+    for (auto &thread : threads)
+      if (thread.joinable())
+        thread.join();
+  };
+
+  try
+  {
+    for (unsigned i = 0; i < numberOfThreads; ++i)
+      threads.emplace_back(worker);
+
+    bool        success{true};
+    std::size_t numberOfQueuedSegments{};
+
+    // Pass all available frames of the segments that are next in order to the callback. The lock
+    // is released while the callback is running.
+    const auto outputAvailableFrames = [&](std::unique_lock<std::mutex> &lock)
+    {
+      while (true)
+      {
+        const auto it = results.find(nextSegmentToOutput);
+        if (it == results.end())
+          return;
+
+        auto &result = it->second;
+        if (!result.frames.empty())
+        {
+          auto frames = std::move(result.frames);
+          result.frames.clear();
+          numberOfBufferedFrames -= frames.size();
+
+          lock.unlock();
+          outputProgress.notify_all();
+          for (auto &frame : frames)
+            frameCallback(std::move(frame));
+          lock.lock();
+          continue;
+        }
+
+        if (!result.finished)
+          return;
+
+        if (!result.success)
+        {
+          this->ffmpegLibraries->log(LogLevel::Error, "Error decoding segment");
+          success = false;
+        }
+        results.erase(it);
+        ++nextSegmentToOutput;
+        outputProgress.notify_all();
+      }
+    };
+
+    const auto queueSegment = [&](Segment &&segment)
+    {
+      std::unique_lock lock(mutex);
+      while (true)
+      {
+        outputAvailableFrames(lock);
+        if (numberOfQueuedSegments - nextSegmentToOutput < maxSegmentsInFlight)
+          break;
+        resultAvailable.wait(lock);
+      }
+      segment.index = numberOfQueuedSegments++;
+      segmentQueue.push_back(std::move(segment));
+      lock.unlock();
+      segmentAvailable.notify_one();
+    };
+
+    Segment currentSegment;
+    while (auto packet = demuxer.getNextPacket())
+    {
+      if (packet->getStreamIndex() != streamIndex)
+        continue;
+
+      if (packet->getFlags().keyframe && !currentSegment.packets.empty())
+      {
+        queueSegment(std::move(currentSegment));
+        currentSegment = {};
+      }
+      currentSegment.packets.push_back(std::move(*packet));
+    }
+    if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error, "Demuxing stopped before the end of the file");
+      success = false;
+    }
+    if (!currentSegment.packets.empty())
+      queueSegment(std::move(currentSegment));
+
+    {
+      std::unique_lock lock(mutex);
+      allSegmentsQueued = true;
+      segmentAvailable.notify_all();
+      while (true)
+      {
+        outputAvailableFrames(lock);
+        if (nextSegmentToOutput == numberOfQueuedSegments)
+          break;
+        resultAvailable.wait(lock);
+      }
+    }
+
+    stopWorkers(false);
+
+    this->ffmpegLibraries->log(LogLevel::Info,
+                               "Decoded " + std::to_string(numberOfQueuedSegments) +
+                                   " segments with " + std::to_string(numberOfThreads) +
+                                   " threads");
+    return success;
+  }
+  catch (...)
+  {
+    stopWorkers(true);
+    throw;
+  }
+}
+
+} // namespace libffmpeg
@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <common/Types.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <functional>
+
+namespace libffmpeg
+{
+
+/* Decode one stream of a file with multiple independent decoders in parallel. The packets of
+ * the stream are split into segments at keyframes. Each segment is decoded by its own Decoder
+ * on a worker thread. The frames are passed to the callback (on the calling thread) in the same
+ * order as a single Decoder would return them.
+ *
+ * This only gives correct results if the segments can be decoded independently (closed GOPs).
+ * Frames of open GOPs that reference the previous segment can not be decoded correctly.
+ *
+ * The frames of the segment that is output next are passed on while the segment is decoded and
+ * are accounted in the memory budget of the libraries. Frames of later segments that are decoded
+ * ahead are limited by maxBufferedFrames.
+ *
+ * With avformat 56 (FFmpeg 2.x) there are no codec parameters and all decoders would have to use
+ * the codec context of the stream. In this case, the stream is decoded with one decoder.
+ */
+class ParallelSegmentDecoder
+{
+public:
+  struct Settings
+  {
+    // 0 means one thread per hardware thread
+    unsigned numberOfThreads{};
+    // How many segments may be queued / decoded at the same time. Limits the number of packets
+    // that are held. 0 means two segments per thread.
+    unsigned maxSegmentsInFlight{};
+    // How many decoded frames may wait for output in total. Decoders of segments that are not next
+    // in order pause when the limit is reached. 0 means eight frames per thread.
+    unsigned maxBufferedFrames{};
+  };
+
+  ParallelSegmentDecoder() = delete;
+  ParallelSegmentDecoder(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+  ParallelSegmentDecoder(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                         const Settings                    settings);
+
+  using FrameCallback = std::function<void(avutil::AVFrameWrapper &&frame)>;
+
+  // Decode all frames of the given stream. Returns false if opening the file or a decoder failed
+  // or if there was an error (or an exception) while decoding a segment.
+  bool decodeFile(const Path &path, const int streamIndex, const FrameCallback &frameCallback);
+
+private:
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  Settings                          settings{};
+};
+
+} // namespace libffmpeg
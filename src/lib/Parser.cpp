@@ -0,0 +1,234 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Parser.h"
+
+#include <AVCodec/wrappers/AVCodecParserContextInternal.h>
+#include <AVCodec/wrappers/AVCodecWrapper.h>
+#include <AVCodec/wrappers/CastCodecClasses.h>
+#include <common/Error.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using libffmpeg::internal::AVCodecContext;
+using libffmpeg::internal::AVCodecParserContext;
+using libffmpeg::internal::avcodec::AVCodecParserContext_56;
+using libffmpeg::internal::avcodec::AVCodecParserContext_57;
+using libffmpeg::internal::avcodec::AVCodecParserContext_58;
+using libffmpeg::internal::avcodec::AVCodecParserContext_59;
+using libffmpeg::internal::avcodec::AVCodecParserContext_60;
+using libffmpeg::internal::avcodec::AVCodecParserContext_61;
+using libffmpeg::internal::avcodec::AVCodecParserContext_62;
+
+// AV_INPUT_BUFFER_PADDING_SIZE of the newest versions (older versions use less)
+constexpr std::size_t INPUT_BUFFER_PADDING_SIZE = 64;
+constexpr int         READ_SIZE                 = 64 * 1024;
+
+} // namespace
+
+Parser::Parser(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool Parser::open(const std::string &codecName)
+{
+  const auto codec = this->ffmpegLibraries->avcodec.avcodec_find_decoder_by_name(codecName.c_str());
+  if (codec == nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "No decoder with the name " + codecName + " found.");
+    return false;
+  }
+  return this->open(avcodec::AVCodecWrapper(codec, this->ffmpegLibraries).getCodecID());
+}
+
+bool Parser::open(const internal::AVCodecID codecID)
+{
+  if (this->parserContext)
+    throw std::runtime_error("Parser was already opened.");
+
+  const auto &avcodec = this->ffmpegLibraries->avcodec;
+
+  const auto codecName = std::string(avcodec.avcodec_get_name(codecID));
+  this->parserContext  = std::unique_ptr<AVCodecParserContext, AVCodecParserContextDeleter>(
+      avcodec.av_parser_init(static_cast<int>(codecID)),
+      AVCodecParserContextDeleter(this->ffmpegLibraries));
+  if (!this->parserContext)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "No parser for codec " + codecName + " found.");
+    return false;
+  }
+
+  // The parser requires a codec context. It is never opened.
+  const auto decoderCodec = avcodec.avcodec_find_decoder(codecID);
+  this->codecContext      = std::unique_ptr<AVCodecContext, AVCodecContextDeleter>(
+      avcodec.avcodec_alloc_context3(decoderCodec), AVCodecContextDeleter(this->ffmpegLibraries));
+  if (!this->codecContext)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Error allocating codec context for the parser.");
+    this->parserContext.reset();
+    return false;
+  }
+
+  this->ffmpegLibraries->log(LogLevel::Info, "Opened parser for codec " + codecName);
+  this->codecID       = codecID;
+  this->inputPosition = 0;
+  this->endOfInput    = false;
+  return true;
+}
+
+bool Parser::parse(std::span<const std::byte> data, std::vector<avcodec::AVPacketWrapper> &packets)
+{
+  if (!this->parserContext)
+    return false;
+
+  // Parsing an empty buffer would flush the parser
+  if (data.empty())
+    return true;
+
+  this->inputBuffer.resize(data.size() + INPUT_BUFFER_PADDING_SIZE);
+  std::copy(data.begin(), data.end(), this->inputBuffer.begin());
+  std::fill(this->inputBuffer.begin() + data.size(), this->inputBuffer.end(), std::byte(0));
+
+  const auto success = this->parseInputBuffer(data.size());
+  std::move(this->parsedPackets.begin(), this->parsedPackets.end(), std::back_inserter(packets));
+  this->parsedPackets.clear();
+  return success;
+}
+
+bool Parser::flush(std::vector<avcodec::AVPacketWrapper> &packets)
+{
+  if (!this->parserContext)
+    return false;
+
+  const auto success = this->parseInputBuffer(0);
+  std::move(this->parsedPackets.begin(), this->parsedPackets.end(), std::back_inserter(packets));
+  this->parsedPackets.clear();
+  return success;
+}
+
+std::optional<avcodec::AVPacketWrapper> Parser::readPacket(avformat::AVIOInputContext &input)
+{
+  if (!this->parserContext)
+    return {};
+
+  while (this->parsedPackets.empty() && !this->endOfInput)
+  {
+    this->inputBuffer.resize(READ_SIZE + INPUT_BUFFER_PADDING_SIZE);
+    const auto bytesRead =
+        input.readData(reinterpret_cast<uint8_t *>(this->inputBuffer.data()), READ_SIZE);
+
+    if (!bytesRead || *bytesRead <= 0)
+    {
+      this->endOfInput = true;
+      if (!this->parseInputBuffer(0))
+        return {};
+      break;
+    }
+
+    const auto size = static_cast<std::size_t>(*bytesRead);
+    std::fill(this->inputBuffer.begin() + size, this->inputBuffer.end(), std::byte(0));
+    if (!this->parseInputBuffer(size))
+    {
+      this->endOfInput = true;
+      return {};
+    }
+  }
+
+  if (this->parsedPackets.empty())
+    return {};
+
+  auto packet = std::move(this->parsedPackets.front());
+  this->parsedPackets.pop_front();
+  return packet;
+}
+
+bool Parser::parseInputBuffer(const std::size_t size)
+{
+  // With a size of 0, the parser is flushed and a null buffer must be passed.
+  auto data = size > 0 ? reinterpret_cast<const uint8_t *>(this->inputBuffer.data()) : nullptr;
+  auto remainingSize = static_cast<int>(size);
+
+  do
+  {
+    uint8_t *outputData{};
+    int      outputSize{};
+
+    const auto bytesUsed =
+        this->ffmpegLibraries->avcodec.av_parser_parse2(this->parserContext.get(),
+                                                        this->codecContext.get(),
+                                                        &outputData,
+                                                        &outputSize,
+                                                        data,
+                                                        remainingSize,
+                                                        internal::AV_NOPTS_VALUE,
+                                                        internal::AV_NOPTS_VALUE,
+                                                        this->inputPosition);
+    if (bytesUsed < 0)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error,
+                                 "Error parsing data (av_parser_parse2). Return code " +
+                                     ReturnCodeMapper.getName(toReturnCode(bytesUsed)));
+      return false;
+    }
+    if (bytesUsed == 0 && outputSize == 0 && remainingSize > 0)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error, "The parser did not consume any data.");
+      return false;
+    }
+
+    if (data != nullptr)
+      data += bytesUsed;
+    remainingSize -= bytesUsed;
+    this->inputPosition += bytesUsed;
+
+    if (outputSize > 0)
+    {
+      avcodec::AVPacketWrapper packet(
+          std::span(reinterpret_cast<const std::byte *>(outputData),
+                    static_cast<std::size_t>(outputSize)),
+          this->ffmpegLibraries);
+
+      int64_t pts{};
+      int64_t dts{};
+      int     keyFrame{};
+      CAST_AVCODEC_GET_MEMBER(AVCodecParserContext, this->parserContext.get(), pts, pts);
+      CAST_AVCODEC_GET_MEMBER(AVCodecParserContext, this->parserContext.get(), dts, dts);
+      CAST_AVCODEC_GET_MEMBER(AVCodecParserContext, this->parserContext.get(), keyFrame, key_frame);
+
+      packet.setTimestamps(dts, pts);
+      packet.setFlags({keyFrame == 1, false, false});
+      this->parsedPackets.push_back(std::move(packet));
+    }
+  } while (remainingSize > 0);
+
+  return true;
+}
+
+void Parser::AVCodecParserContextDeleter::operator()(
+    AVCodecParserContext *parserContext) const noexcept
+{
+  if (parserContext != nullptr)
+    this->ffmpegLibraries->avcodec.av_parser_close(parserContext);
+}
+
+void Parser::AVCodecContextDeleter::operator()(AVCodecContext *codecContext) const noexcept
+{
+  if (codecContext != nullptr)
+    this->ffmpegLibraries->avcodec.avcodec_free_context(&codecContext);
+}
+
+} // namespace libffmpeg
@@ -0,0 +1,94 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/wrappers/AVPacketWrapper.h>
+#include <AVFormat/wrappers/AVIOContextWrapper.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace libffmpeg
+{
+
+/* Split an elementary stream (e.g. a raw .h264 or .hevc file) into packets using the parsers of
+ * avcodec (av_parser_parse2). This does not use avformat at all so there is no probing. The
+ * packets can be sent to a Decoder that was opened with the codec ID of the parser. Raw
+ * elementary streams have no timestamps so the timestamps of the packets are usually not set.
+ */
+class Parser
+{
+public:
+  Parser(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+
+  // Open the parser for the codec with the given decoder name (e.g. "h264" or "hevc").
+  bool open(const std::string &codecName);
+  bool open(const internal::AVCodecID codecID);
+
+  explicit operator bool() const { return !!this->parserContext; }
+
+  // Parse the data and append all packets that were completed to the given vector. The data of an
+  // incomplete packet is kept in the parser and is output by a later call or when flushing.
+  bool parse(std::span<const std::byte> data, std::vector<avcodec::AVPacketWrapper> &packets);
+
+  // Output the last (incomplete) packet at the end of the stream.
+  bool flush(std::vector<avcodec::AVPacketWrapper> &packets);
+
+  // Read from the input until the next packet is complete. At the end of the input, the parser is
+  // flushed. No packet is returned once all packets were read (or on error).
+  std::optional<avcodec::AVPacketWrapper> readPacket(avformat::AVIOInputContext &input);
+
+  [[nodiscard]] internal::AVCodecID getCodecID() const { return this->codecID; }
+
+private:
+  bool parseInputBuffer(const std::size_t size);
+
+  class AVCodecParserContextDeleter
+  {
+  public:
+    AVCodecParserContextDeleter() = default;
+    AVCodecParserContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(internal::AVCodecParserContext *parserContext) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  class AVCodecContextDeleter
+  {
+  public:
+    AVCodecContextDeleter() = default;
+    AVCodecContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(internal::AVCodecContext *codecContext) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+
+  std::unique_ptr<internal::AVCodecParserContext, AVCodecParserContextDeleter> parserContext{
+      nullptr, AVCodecParserContextDeleter()};
+  std::unique_ptr<internal::AVCodecContext, AVCodecContextDeleter> codecContext{
+      nullptr, AVCodecContextDeleter()};
+
+  internal::AVCodecID codecID{internal::AV_CODEC_ID_NONE};
+
+  // The parsers may read beyond the end of the input so it is copied into this padded buffer.
+  ByteVector                           inputBuffer;
+  int64_t                              inputPosition{};
+  std::deque<avcodec::AVPacketWrapper> parsedPackets;
+  bool                                 endOfInput{};
+};
+
+} // namespace libffmpeg
@@ -0,0 +1,290 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "BatchProber.h"
+
+#include <Demuxer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace libffmpeg::probing
+{
+
+namespace
+{
+
+struct FileStatus
+{
+  uint64_t size{};
+  int64_t  modificationTime{};
+};
+
+std::optional<FileStatus> getFileStatus(const Path &path)
+{
+  std::error_code error;
+  FileStatus      status;
+  status.size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+  if (error)
+    return {};
+  // The raw value of the file time. It is only compared to values from the same platform.
+  const auto modificationTime = std::filesystem::last_write_time(path, error);
+  if (error)
+    return {};
+  status.modificationTime = static_cast<int64_t>(modificationTime.time_since_epoch().count());
+  return status;
+}
+
+std::string quote(const std::string_view string)
+{
+  return "\"" + escapeJSONString(string) + "\"";
+}
+
+std::string to_json(const Rational rational)
+{
+  return "[" + std::to_string(rational.numerator) + "," + std::to_string(rational.denominator) +
+         "]";
+}
+
+std::string streamToJSON(const avformat::AVStreamWrapper &stream)
+{
+  const auto codecType = stream.getCodecType();
+
+  std::ostringstream json;
+  json << "{\"index\":" << stream.getIndex();
+  json << ",\"type\":" << quote(avutil::mediaTypeMapper.getName(codecType));
+  if (const auto codecDescriptor = stream.getCodecDescriptor())
+    json << ",\"codec\":" << quote(codecDescriptor->codecName);
+  json << ",\"timeBase\":" << to_json(stream.getTimeBase());
+
+  if (codecType == avutil::MediaType::Video)
+  {
+    const auto size = stream.getFrameSize();
+    json << ",\"width\":" << size.width << ",\"height\":" << size.height;
+    json << ",\"pixelFormat\":" << quote(stream.getPixelFormat().name);
+    json << ",\"frameRate\":" << to_json(stream.getAverageFrameRate());
+  }
+  else if (codecType == avutil::MediaType::Audio)
+  {
+    if (const auto codecParameters = stream.getCodecParameters())
+      json << ",\"channels\":" << codecParameters->getChannelLayout().size();
+  }
+
+  json << "}";
+  return json.str();
+}
+
+} // namespace
+
+std::vector<Path> collectFiles(const Path &path)
+{
+  std::vector<Path> files;
+  std::error_code   error;
+
+  if (std::filesystem::is_directory(path, error))
+  {
+    for (auto it = std::filesystem::recursive_directory_iterator(
+             path, std::filesystem::directory_options::skip_permission_denied, error);
+         !error && it != std::filesystem::recursive_directory_iterator();
+         it.increment(error))
+    {
+      if (it->is_regular_file(error))
+        files.push_back(it->path());
+    }
+  }
+  else
+  {
+    std::ifstream file(path);
+    std::string   line;
+    while (std::getline(file, line))
+    {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (!line.empty())
+        files.push_back(line);
+    }
+  }
+
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+std::string escapeJSONString(const std::string_view string)
+{
+  std::ostringstream escaped;
+  for (const auto c : string)
+  {
+    switch (c)
+    {
+    case '"':
+      escaped << "\\\"";
+      break;
+    case '\\':
+      escaped << "\\\\";
+      break;
+    case '\b':
+      escaped << "\\b";
+      break;
+    case '\f':
+      escaped << "\\f";
+      break;
+    case '\n':
+      escaped << "\\n";
+      break;
+    case '\r':
+      escaped << "\\r";
+      break;
+    case '\t':
+      escaped << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(c) << std::dec;
+      else
+        escaped << c;
+    }
+  }
+  return escaped.str();
+}
+
+BatchProber::BatchProber(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries)
+    : BatchProber(ffmpegLibraries, {})
+{
+}
+
+BatchProber::BatchProber(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                         const Settings                    settings)
+    : ffmpegLibraries(ffmpegLibraries), settings(settings)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+BatchProbeStatistics BatchProber::probeFiles(const std::vector<Path> &files,
+                                             ProbeCache              *cache,
+                                             const ResultCallback    &resultCallback)
+{
+  auto numberOfThreads = this->settings.numberOfThreads;
+  if (numberOfThreads == 0)
+    numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  numberOfThreads = static_cast<unsigned>(
+      std::min(static_cast<std::size_t>(numberOfThreads), std::max(files.size(), std::size_t(1))));
+
+  std::atomic<std::size_t> nextFile{};
+  std::mutex               resultMutex;
+  BatchProbeStatistics     statistics;
+  statistics.numberOfFiles = files.size();
+
+  const auto worker = [&]()
+  {
+    while (true)
+    {
+      const auto fileIndex = nextFile++;
+      if (fileIndex >= files.size())
+        return;
+      const auto &path = files.at(fileIndex);
+
+      const auto  status = getFileStatus(path);
+      ProbeResult result;
+      if (status && cache != nullptr)
+      {
+        if (auto cachedResult = cache->find(path, status->size, status->modificationTime))
+        {
+          result.path      = path;
+          result.success   = true;
+          result.fromCache = true;
+          result.json      = std::move(*cachedResult);
+        }
+      }
+
+      if (!result.fromCache)
+      {
+        result = this->probeFile(path);
+        if (result.success && status && cache != nullptr)
+          cache->insert(path, status->size, status->modificationTime, result.json);
+      }
+
+      std::scoped_lock lock(resultMutex);
+      if (result.fromCache)
+        ++statistics.numberOfCachedFiles;
+      else if (result.success)
+        ++statistics.numberOfProbedFiles;
+      else
+        ++statistics.numberOfFailedFiles;
+      if (resultCallback)
+        resultCallback(result);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < numberOfThreads; ++i)
+    threads.emplace_back(worker);
+  for (auto &thread : threads)
+    thread.join();
+
+  this->ffmpegLibraries->log(LogLevel::Info,
+                             "Probed " + std::to_string(statistics.numberOfFiles) +
+                                 " files using " + std::to_string(numberOfThreads) +
+                                 " threads");
+  return statistics;
+}
+
+ProbeResult BatchProber::probeFile(const Path &path)
+{
+  ProbeResult result;
+  result.path = path;
+
+  std::ostringstream json;
+  json << "{\"path\":" << quote(path.string());
+
+  const auto status = getFileStatus(path);
+  if (!status)
+  {
+    json << ",\"error\":\"File not found\"}";
+    result.json = json.str();
+    return result;
+  }
+  json << ",\"size\":" << status->size << ",\"modificationTime\":" << status->modificationTime;
+
+  Demuxer demuxer(this->ffmpegLibraries);
+  if (!demuxer.openFile(path))
+  {
+    json << ",\"error\":\"Opening the file failed\"}";
+    result.json = json.str();
+    return result;
+  }
+
+  const auto formatContext = demuxer.getFormatContext();
+  const auto inputFormat   = formatContext->getInputFormat();
+  json << ",\"format\":" << quote(inputFormat.getName());
+  json << ",\"formatLongName\":" << quote(inputFormat.getLongName());
+  json << ",\"startTime\":" << formatContext->getStartTime();
+  json << ",\"duration\":" << formatContext->getDuration();
+
+  json << ",\"streams\":[";
+  const auto streams = formatContext->getStreams();
+  for (std::size_t i = 0; i < streams.size(); ++i)
+  {
+    if (i > 0)
+      json << ",";
+    json << streamToJSON(streams.at(i));
+  }
+  json << "]}";
+
+  result.success = true;
+  result.json    = json.str();
+  return result;
+}
+
+} // namespace libffmpeg::probing
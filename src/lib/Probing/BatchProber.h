@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <Probing/ProbeCache.h>
+#include <common/Types.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace libffmpeg::probing
+{
+
+// All regular files in the directory (recursively) or, if the path is a file, the files listed
+// in the file (one path per line). The result is sorted.
+std::vector<Path> collectFiles(const Path &path);
+
+// Escape the string so that it can be used as a JSON string (without the quotes).
+std::string escapeJSONString(std::string_view string);
+
+struct ProbeResult
+{
+  Path path{};
+  bool success{};
+  bool fromCache{};
+  // One JSON object in a single line with the format and stream information of the file or an
+  // error message.
+  std::string json{};
+};
+
+struct BatchProbeStatistics
+{
+  std::size_t numberOfFiles{};
+  std::size_t numberOfProbedFiles{};
+  std::size_t numberOfCachedFiles{};
+  std::size_t numberOfFailedFiles{};
+};
+
+/* Probe many files in parallel. Every worker thread opens each file with its own Demuxer. All
+ * demuxers share the same libraries. Only the format and stream information is read, the
+ * packets are not parsed.
+ */
+class BatchProber
+{
+public:
+  struct Settings
+  {
+    // 0 means one thread per hardware thread
+    unsigned numberOfThreads{};
+  };
+
+  BatchProber() = delete;
+  BatchProber(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries);
+  BatchProber(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const Settings settings);
+
+  // Called for every file in the order in which the files are finished. The calls are
+  // serialized but may come from any of the worker threads.
+  using ResultCallback = std::function<void(const ProbeResult &result)>;
+
+  // If a cache is given, files with unchanged size and modification time are not opened.
+  // The results of all successfully probed files are added to the cache.
+  BatchProbeStatistics probeFiles(const std::vector<Path> &files,
+                                  ProbeCache              *cache,
+                                  const ResultCallback    &resultCallback);
+
+  ProbeResult probeFile(const Path &path);
+
+private:
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  Settings                          settings{};
+};
+
+} // namespace libffmpeg::probing
@@ -0,0 +1,121 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "ProbeCache.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace libffmpeg::probing
+{
+
+namespace
+{
+
+constexpr auto HEADER = "# LibFFmpeg probe cache version 1";
+
+} // namespace
+
+bool ProbeCache::load(const Path &path)
+{
+  std::scoped_lock lock(this->mutex);
+  this->entries.clear();
+
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+
+  std::string line;
+  if (!std::getline(file, line) || line != HEADER)
+    return false;
+
+  while (true)
+  {
+    Entry       entry;
+    std::size_t pathLength{};
+    if (!(file >> entry.size >> entry.modificationTime >> pathLength))
+      break;
+
+    // The path may contain spaces so it is read with the given length
+    std::string filePath(pathLength, '\0');
+    if (file.get() != ' ' || !file.read(filePath.data(), static_cast<std::streamsize>(pathLength)))
+      break;
+    if (file.get() != ' ' || !std::getline(file, entry.result))
+      break;
+
+    this->entries[filePath] = std::move(entry);
+  }
+
+  return file.eof();
+}
+
+bool ProbeCache::save(const Path &path) const
+{
+  auto temporaryPath = path;
+  temporaryPath += ".tmp";
+
+  {
+    std::ofstream file(temporaryPath, std::ios::trunc);
+    if (!file.is_open())
+      return false;
+
+    file << HEADER << "\n";
+
+    std::scoped_lock lock(this->mutex);
+    for (const auto &[filePath, entry] : this->entries)
+      file << entry.size << " " << entry.modificationTime << " " << filePath.size() << " "
+           << filePath << " " << entry.result << "\n";
+
+    if (!file.good())
+      return false;
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  return !error;
+}
+
+std::optional<std::string>
+ProbeCache::find(const Path &file, const uint64_t size, const int64_t modificationTime)
+{
+  std::scoped_lock lock(this->mutex);
+  const auto       it = this->entries.find(file.string());
+  if (it == this->entries.end() || it->second.size != size ||
+      it->second.modificationTime != modificationTime)
+    return {};
+
+  it->second.used = true;
+  return it->second.result;
+}
+
+void ProbeCache::insert(const Path   &file,
+                        const uint64_t size,
+                        const int64_t  modificationTime,
+                        std::string    result)
+{
+  std::scoped_lock lock(this->mutex);
+  this->entries[file.string()] = {size, modificationTime, std::move(result), true};
+}
+
+void ProbeCache::removeUnusedEntries()
+{
+  std::scoped_lock lock(this->mutex);
+  for (auto it = this->entries.begin(); it != this->entries.end();)
+  {
+    if (it->second.used)
+      ++it;
+    else
+      it = this->entries.erase(it);
+  }
+}
+
+std::size_t ProbeCache::size() const
+{
+  std::scoped_lock lock(this->mutex);
+  return this->entries.size();
+}
+
+} // namespace libffmpeg::probing
@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/Types.h>
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+/* The cache contains the probe result of each file together with the size and modification time
+ * of the file when it was probed. A result is only used if the size and the modification time
+ * did not change.
+ *
+ * The cache file is a text file with one line per file:
+ *   <size> <modification time> <length of path> <path> <result>
+ * The first line is a header with the version. The result must not contain a line break.
+ */
+
+namespace libffmpeg::probing
+{
+
+class ProbeCache
+{
+public:
+  ProbeCache() = default;
+
+  // If the file can not be read, the cache is empty and false is returned.
+  bool load(const Path &path);
+  // The file is written to a temporary file first and then renamed.
+  bool save(const Path &path) const;
+
+  // All functions below are thread safe.
+
+  // Returns the cached result if size and modification time match. The entry is marked as used.
+  [[nodiscard]] std::optional<std::string>
+  find(const Path &file, uint64_t size, int64_t modificationTime);
+  void insert(const Path &file, uint64_t size, int64_t modificationTime, std::string result);
+
+  // Remove the entries that were neither found nor inserted since loading (e.g. deleted files).
+  void removeUnusedEntries();
+
+  [[nodiscard]] std::size_t size() const;
+
+private:
+  struct Entry
+  {
+    uint64_t    size{};
+    int64_t     modificationTime{};
+    std::string result{};
+    bool        used{};
+  };
+
+  mutable std::mutex                     mutex;
+  std::unordered_map<std::string, Entry> entries;
+};
+
+} // namespace libffmpeg::probing
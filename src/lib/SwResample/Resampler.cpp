@@ -0,0 +1,304 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Resampler.h"
+
+#include <AVCodec/wrappers/AVChannelInternal.h>
+#include <AVUtil/SampleFormat.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace libffmpeg::swresample
+{
+
+using libffmpeg::internal::SwrContext;
+using libffmpeg::internal::avcodec::AVChannelLayout;
+using libffmpeg::internal::avcodec::AVChannelOrder;
+
+namespace
+{
+
+// Some additional space when flushing because swr_get_delay rounds down
+constexpr int64_t FLUSH_MARGIN_SAMPLES = 32;
+
+// Swresample expects masks in native order. Layouts with other channels or in a different order
+// can not be represented as a mask.
+std::optional<uint64_t> toNativeChannelMask(const avcodec::ChannelLayout &layout)
+{
+  const auto mask = internal::avcodec::channelLayoutToBitMask(layout);
+  if (!mask)
+    return {};
+
+  const auto nativeLayout = internal::avcodec::bitMaskToChannelLayout(*mask);
+  if (!std::equal(layout.begin(),
+                  layout.end(),
+                  nativeLayout.begin(),
+                  nativeLayout.end(),
+                  [](const auto &channel, const auto &nativeChannel)
+                  { return channel.channel == nativeChannel.channel; }))
+    return {};
+
+  return mask;
+}
+
+AVChannelLayout toAVChannelLayout(const int numberOfChannels, const uint64_t mask)
+{
+  AVChannelLayout layout;
+  layout.nb_channels = numberOfChannels;
+  if (mask != 0)
+  {
+    layout.order  = AVChannelOrder::AV_CHANNEL_ORDER_NATIVE;
+    layout.u.mask = mask;
+  }
+  else
+    layout.order = AVChannelOrder::AV_CHANNEL_ORDER_UNSPEC;
+  return layout;
+}
+
+} // namespace
+
+Resampler::Resampler(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                     const ResamplerSettings          &settings)
+    : context(nullptr, SwrContextDeleter(ffmpegLibraries)), settings(settings),
+      ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+void Resampler::setSettings(const ResamplerSettings &settings)
+{
+  // The context is recreated with the next frame if the parameters changed. Samples that are
+  // still buffered in the old context are dropped.
+  this->settings = settings;
+}
+
+bool Resampler::convert(const avutil::AVFrameWrapper &frame, AudioBuffer &output)
+{
+  if (!frame)
+    return false;
+
+  const auto input = this->getInputParameters(frame);
+  if (!input)
+    return false;
+  const auto outputParameters = this->getOutputParameters(*input);
+  if (!outputParameters || !this->updateContext({*input, *outputParameters}))
+    return false;
+
+  const auto numberOfSamples = frame.getNumberOfSamples();
+  if (numberOfSamples <= 0)
+  {
+    output.numberOfSamples = 0;
+    return numberOfSamples == 0;
+  }
+
+  this->inputPointers.resize(static_cast<std::size_t>(frame.getNumberOfAudioPlanes()));
+  for (int plane = 0; plane < frame.getNumberOfAudioPlanes(); ++plane)
+  {
+    const auto data = frame.getAudioPlane(plane);
+    if (data.empty())
+      return false;
+    this->inputPointers.at(plane) = reinterpret_cast<const uint8_t *>(data.data());
+  }
+
+  // The maximum number of output samples for the buffered and the new input samples
+  const auto delay =
+      this->ffmpegLibraries->swresample.swr_get_delay(this->context.get(), input->sampleRate);
+  const auto capacity = ((delay + numberOfSamples) * outputParameters->sampleRate +
+                         input->sampleRate - 1) /
+                        input->sampleRate;
+
+  return this->runConversion(
+      this->inputPointers.data(), numberOfSamples, static_cast<int>(capacity), output);
+}
+
+bool Resampler::flush(AudioBuffer &output)
+{
+  if (!this->context)
+  {
+    output.numberOfSamples = 0;
+    return true;
+  }
+
+  const auto delay = this->ffmpegLibraries->swresample.swr_get_delay(
+      this->context.get(), this->contextParameters.output.sampleRate);
+  return this->runConversion(
+      nullptr, 0, static_cast<int>(delay + FLUSH_MARGIN_SAMPLES), output);
+}
+
+std::optional<Resampler::AudioParameters>
+Resampler::getInputParameters(const avutil::AVFrameWrapper &frame) const
+{
+  AudioParameters parameters;
+  parameters.sampleFormat     = frame.getSampleFormat();
+  parameters.sampleRate       = frame.getSampleRate();
+  parameters.numberOfChannels = frame.getNumberOfChannels();
+  parameters.channelMask      = toNativeChannelMask(frame.getChannelLayout()).value_or(0);
+
+  if (avutil::getBytesPerSample(parameters.sampleFormat) == 0 || parameters.sampleRate <= 0 ||
+      parameters.numberOfChannels <= 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Resampling not possible. The frame is not a valid audio frame.");
+    return {};
+  }
+
+  return parameters;
+}
+
+std::optional<Resampler::AudioParameters>
+Resampler::getOutputParameters(const AudioParameters &input) const
+{
+  AudioParameters parameters;
+  parameters.sampleFormat = this->settings.sampleFormat;
+  parameters.sampleRate   = this->settings.sampleRate;
+  if (parameters.sampleRate == 0)
+    parameters.sampleRate = input.sampleRate;
+
+  if (this->settings.channelLayout.empty())
+  {
+    parameters.numberOfChannels = input.numberOfChannels;
+    parameters.channelMask      = input.channelMask;
+  }
+  else
+  {
+    const auto mask = toNativeChannelMask(this->settings.channelLayout);
+    if (!mask)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error,
+                                 "Resampling not possible. The output channel layout is not "
+                                 "supported.");
+      return {};
+    }
+    parameters.numberOfChannels = static_cast<int>(this->settings.channelLayout.size());
+    parameters.channelMask      = *mask;
+  }
+
+  if (avutil::getBytesPerSample(parameters.sampleFormat) == 0 || parameters.sampleRate <= 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Resampling not possible. Invalid output format or sample rate.");
+    return {};
+  }
+
+  return parameters;
+}
+
+bool Resampler::updateContext(const ContextParameters &parameters)
+{
+  if (this->context && this->contextParameters == parameters)
+    return true;
+
+  this->context.reset();
+
+  const auto &swresample = this->ffmpegLibraries->swresample;
+  const auto &input      = parameters.input;
+  const auto &output     = parameters.output;
+
+  SwrContext *newContext{};
+  if (swresample.swr_alloc_set_opts2)
+  {
+    const auto inputLayout  = toAVChannelLayout(input.numberOfChannels, input.channelMask);
+    const auto outputLayout = toAVChannelLayout(output.numberOfChannels, output.channelMask);
+    if (swresample.swr_alloc_set_opts2(&newContext,
+                                       &outputLayout,
+                                       output.sampleFormat,
+                                       output.sampleRate,
+                                       &inputLayout,
+                                       input.sampleFormat,
+                                       input.sampleRate,
+                                       0,
+                                       nullptr) < 0)
+      newContext = nullptr;
+  }
+  else
+  {
+    // The old API has no unspecified layouts. Use the default layout for the number of channels.
+    const auto getMask = [this](const AudioParameters &audio)
+    {
+      if (audio.channelMask != 0)
+        return static_cast<int64_t>(audio.channelMask);
+      return this->ffmpegLibraries->avutil.av_get_default_channel_layout(audio.numberOfChannels);
+    };
+
+    newContext = swresample.swr_alloc_set_opts(nullptr,
+                                               getMask(output),
+                                               output.sampleFormat,
+                                               output.sampleRate,
+                                               getMask(input),
+                                               input.sampleFormat,
+                                               input.sampleRate,
+                                               0,
+                                               nullptr);
+  }
+
+  if (newContext == nullptr)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Error allocating swresample context.");
+    return false;
+  }
+
+  this->context.reset(newContext);
+  if (const auto ret = swresample.swr_init(this->context.get()); ret < 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error initializing swresample context. Return code " +
+                                   std::to_string(ret));
+    this->context.reset();
+    return false;
+  }
+
+  this->contextParameters = parameters;
+  return true;
+}
+
+bool Resampler::runConversion(const uint8_t **inputData,
+                              const int       inputSamples,
+                              const int       capacity,
+                              AudioBuffer    &output)
+{
+  const auto &parameters     = this->contextParameters.output;
+  const auto  planar         = avutil::isPlanar(parameters.sampleFormat);
+  const auto  numberOfPlanes = planar ? parameters.numberOfChannels : 1;
+  const auto  planeSize      = static_cast<std::size_t>(capacity) *
+                          avutil::getBytesPerSample(parameters.sampleFormat) *
+                          (planar ? 1 : parameters.numberOfChannels);
+
+  output.planes.resize(static_cast<std::size_t>(numberOfPlanes));
+  this->outputPointers.resize(static_cast<std::size_t>(numberOfPlanes));
+  for (int plane = 0; plane < numberOfPlanes; ++plane)
+  {
+    auto &data = output.planes.at(plane);
+    if (data.size() < planeSize)
+      data.resize(planeSize);
+    this->outputPointers.at(plane) = reinterpret_cast<uint8_t *>(data.data());
+  }
+
+  const auto numberOfSamples = this->ffmpegLibraries->swresample.swr_convert(
+      this->context.get(), this->outputPointers.data(), capacity, inputData, inputSamples);
+  if (numberOfSamples < 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error converting samples. swr_convert returned " +
+                                   std::to_string(numberOfSamples));
+    output.numberOfSamples = 0;
+    return false;
+  }
+
+  output.sampleFormat     = parameters.sampleFormat;
+  output.numberOfChannels = parameters.numberOfChannels;
+  output.numberOfSamples  = numberOfSamples;
+  return true;
+}
+
+void Resampler::SwrContextDeleter::operator()(SwrContext *context) const noexcept
+{
+  if (context != nullptr && this->ffmpegLibraries)
+    this->ffmpegLibraries->swresample.swr_free(&context);
+}
+
+} // namespace libffmpeg::swresample
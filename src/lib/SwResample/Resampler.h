@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVCodec/Channel.h>
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <common/InternalTypes.h>
+#include <common/Types.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace libffmpeg::swresample
+{
+
+struct ResamplerSettings
+{
+  // 0 keeps the sample rate of the input frames
+  int                      sampleRate{48000};
+  internal::AVSampleFormat sampleFormat{internal::AV_SAMPLE_FMT_FLT};
+  // An empty layout keeps the channel layout of the input frames.
+  avcodec::ChannelLayout channelLayout{};
+};
+
+// The converted samples. The buffer is owned by the caller and should be reused for all calls.
+// The planes only grow, so that no memory is allocated once the biggest frame was converted.
+struct AudioBuffer
+{
+  internal::AVSampleFormat sampleFormat{internal::AV_SAMPLE_FMT_NONE};
+  int                      numberOfChannels{};
+  int                      numberOfSamples{};
+  // One plane per channel for planar formats. One plane with interleaved samples otherwise.
+  // The planes can be bigger than the number of samples.
+  std::vector<ByteVector> planes{};
+};
+
+/* Conversion of decoded audio frames to a different sample rate, sample format and / or channel
+ * layout using libswresample. The conversion is streaming. Because of the resampling filter,
+ * swresample keeps some samples of each frame which are returned with the next frame. At the end
+ * of the stream, flush returns the remaining samples.
+ * The swresample context is cached and only recreated if the input parameters or the settings
+ * change.
+ */
+class Resampler
+{
+public:
+  Resampler() = delete;
+  Resampler(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+            const ResamplerSettings          &settings = {});
+
+  void                                   setSettings(const ResamplerSettings &settings);
+  [[nodiscard]] const ResamplerSettings &getSettings() const { return this->settings; }
+
+  // Convert the samples of the frame. Returns false if the conversion failed. The output can
+  // contain less (or no) samples than the input because swresample may buffer some samples.
+  bool convert(const avutil::AVFrameWrapper &frame, AudioBuffer &output);
+
+  // Get the samples that are still buffered in swresample at the end of the stream.
+  bool flush(AudioBuffer &output);
+
+private:
+  struct AudioParameters
+  {
+    internal::AVSampleFormat sampleFormat{internal::AV_SAMPLE_FMT_NONE};
+    int                      sampleRate{};
+    int                      numberOfChannels{};
+    // 0 if the channels are unspecified or can not be represented as a mask
+    uint64_t channelMask{};
+
+    bool operator==(const AudioParameters &other) const = default;
+  };
+
+  struct ContextParameters
+  {
+    AudioParameters input{};
+    AudioParameters output{};
+
+    bool operator==(const ContextParameters &other) const = default;
+  };
+
+  [[nodiscard]] std::optional<AudioParameters>
+  getInputParameters(const avutil::AVFrameWrapper &frame) const;
+  [[nodiscard]] std::optional<AudioParameters>
+       getOutputParameters(const AudioParameters &input) const;
+  bool updateContext(const ContextParameters &parameters);
+  bool runConversion(const uint8_t **inputData,
+                     int             inputSamples,
+                     int             capacity,
+                     AudioBuffer    &output);
+
+  class SwrContextDeleter
+  {
+  public:
+    SwrContextDeleter() = default;
+    SwrContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(libffmpeg::internal::SwrContext *context) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  std::unique_ptr<libffmpeg::internal::SwrContext, SwrContextDeleter> context{
+      nullptr, SwrContextDeleter()};
+  ContextParameters contextParameters{};
+
+  ResamplerSettings            settings{};
+  std::vector<const uint8_t *> inputPointers{};
+  std::vector<uint8_t *>       outputPointers{};
+
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+};
+
+} // namespace libffmpeg::swresample
@@ -0,0 +1,404 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Scaler.h"
+
+#include <AVUtil/wrappers/AVFrameWrapperInternal.h>
+#include <AVUtil/wrappers/AVPixFmtDescriptorConversion.h>
+#include <AVUtil/wrappers/CastUtilClasses.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+namespace libffmpeg::swscale
+{
+
+using libffmpeg::internal::AVBufferRef;
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVPixelFormat;
+using libffmpeg::internal::SwsContext;
+using libffmpeg::internal::avutil::AVFrame_57;
+using libffmpeg::internal::avutil::AVFrame_59;
+using libffmpeg::internal::avutil::AVFrame_60;
+
+namespace
+{
+
+// These values did not change between the swscale versions
+constexpr int SWS_FAST_BILINEAR = 1;
+constexpr int SWS_BILINEAR      = 2;
+constexpr int SWS_BICUBIC       = 4;
+constexpr int SWS_POINT         = 0x10;
+constexpr int SWS_AREA          = 0x20;
+constexpr int SWS_LANCZOS       = 0x200;
+
+int getScalingFlags(const ScalingAlgorithm algorithm)
+{
+  switch (algorithm)
+  {
+  case ScalingAlgorithm::FastBilinear:
+    return SWS_FAST_BILINEAR;
+  case ScalingAlgorithm::Bicubic:
+    return SWS_BICUBIC;
+  case ScalingAlgorithm::Point:
+    return SWS_POINT;
+  case ScalingAlgorithm::Area:
+    return SWS_AREA;
+  case ScalingAlgorithm::Lanczos:
+    return SWS_LANCZOS;
+  default:
+    return SWS_BILINEAR;
+  }
+}
+
+unsigned getNumberOfThreads(const ScalerSettings &settings)
+{
+  if (settings.numberOfSliceThreads == 0)
+    return std::max(1u, std::thread::hardware_concurrency());
+  return settings.numberOfSliceThreads;
+}
+
+// The output planes are owned by the caller. The buffer references only tell sws_scale_frame to
+// write into the given planes instead of allocating new ones. So there is nothing to free.
+void doNotFreeBuffer(void *, uint8_t *) {}
+
+template <typename AVFrameType> struct OutputFrame
+{
+  static void set(AVFrame                            *frame,
+                  const Size                          size,
+                  const AVPixelFormat                 format,
+                  const std::array<std::byte *, 4>   &data,
+                  const std::array<int, 4>           &linesize,
+                  const std::array<AVBufferRef *, 4> &buffers)
+  {
+    const auto f = reinterpret_cast<AVFrameType *>(frame);
+    f->width     = size.width;
+    f->height    = size.height;
+    f->format    = format;
+    for (int i = 0; i < 4; ++i)
+    {
+      f->data[i]     = reinterpret_cast<uint8_t *>(data[i]);
+      f->linesize[i] = linesize[i];
+    }
+    f->extended_data = f->data;
+    for (int i = 0; i < 4; ++i)
+      f->buf[i] = buffers[i];
+  }
+};
+
+} // namespace
+
+bool Scaler::ContextParameters::operator==(const ContextParameters &other) const
+{
+  return this->inputSize == other.inputSize && this->inputFormat == other.inputFormat &&
+         this->outputSize == other.outputSize && this->outputFormat == other.outputFormat &&
+         this->flags == other.flags && this->numberOfThreads == other.numberOfThreads;
+}
+
+Scaler::Scaler(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const ScalerSettings &settings)
+    : context(nullptr, SwsContextDeleter(ffmpegLibraries)), settings(settings),
+      ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+void Scaler::setSettings(const ScalerSettings &settings)
+{
+  // The context is recreated with the next frame if the parameters changed
+  this->settings = settings;
+  this->outputFormat.reset();
+}
+
+std::optional<OutputImageLayout> Scaler::getOutputLayout(const avutil::AVFrameWrapper &frame)
+{
+  const auto parameters = this->getContextParameters(frame);
+  if (!parameters)
+    return {};
+
+  OutputImageLayout layout;
+  if (this->ffmpegLibraries->avutil.av_image_fill_linesizes(
+          layout.linesize.data(), parameters->outputFormat, parameters->outputSize.width) < 0)
+    return {};
+
+  // With a null pointer, the data pointers are the offsets of the planes in the buffer.
+  uint8_t   *planes[4]{};
+  const auto size = this->ffmpegLibraries->avutil.av_image_fill_pointers(
+      planes, parameters->outputFormat, parameters->outputSize.height, nullptr,
+      layout.linesize.data());
+  if (size <= 0)
+    return {};
+
+  for (int i = 0; i < 4; ++i)
+    layout.planeOffset[i] = reinterpret_cast<std::uintptr_t>(planes[i]);
+  layout.bufferSize = static_cast<std::size_t>(size);
+  return layout;
+}
+
+bool Scaler::scale(const avutil::AVFrameWrapper     &frame,
+                   const std::array<std::byte *, 4> &outputData,
+                   const std::array<int, 4>         &outputLinesize)
+{
+  const auto parameters = this->getContextParameters(frame);
+  if (!parameters || !this->updateContext(*parameters))
+    return false;
+
+  if (parameters->numberOfThreads > 1)
+    return this->scaleThreaded(frame, outputData, outputLinesize);
+
+  std::array<const uint8_t *, 4> inputData{};
+  std::array<int, 4>             inputLinesize{};
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    CAST_AVUTIL_GET_MEMBER(AVFrame, frame.getFrame(), inputData[plane], data[plane]);
+    inputLinesize[plane] = frame.getLineSize(plane);
+  }
+
+  std::array<uint8_t *, 4> data{};
+  for (int plane = 0; plane < 4; ++plane)
+    data[plane] = reinterpret_cast<uint8_t *>(outputData[plane]);
+
+  const auto outputHeight = this->ffmpegLibraries->swscale.sws_scale(this->context.get(),
+                                                                     inputData.data(),
+                                                                     inputLinesize.data(),
+                                                                     0,
+                                                                     parameters->inputSize.height,
+                                                                     data.data(),
+                                                                     outputLinesize.data());
+  if (outputHeight != parameters->outputSize.height)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Scaling failed. sws_scale returned " +
+                                   std::to_string(outputHeight));
+    return false;
+  }
+  return true;
+}
+
+bool Scaler::scale(const avutil::AVFrameWrapper &frame, std::span<std::byte> outputBuffer)
+{
+  const auto layout = this->getOutputLayout(frame);
+  if (!layout || outputBuffer.size() < layout->bufferSize)
+    return false;
+
+  std::array<std::byte *, 4> data{};
+  for (int plane = 0; plane < 4; ++plane)
+    if (plane == 0 || layout->planeOffset[plane] > 0)
+      data[plane] = outputBuffer.data() + layout->planeOffset[plane];
+
+  return this->scale(frame, data, layout->linesize);
+}
+
+bool Scaler::isSliceThreadingActive() const
+{
+  return this->context && this->contextParameters.numberOfThreads > 1;
+}
+
+std::optional<Scaler::ContextParameters>
+Scaler::getContextParameters(const avutil::AVFrameWrapper &frame)
+{
+  if (!this->ffmpegLibraries->isSwScaleAvailable())
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Scaling not possible. Swscale is not loaded.");
+    return {};
+  }
+
+  if (!this->outputFormat)
+  {
+    this->outputFormat =
+        avutil::findAVPixelFormatByName(this->settings.outputPixelFormat, this->ffmpegLibraries);
+    if (!this->outputFormat)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error,
+                                 "Unknown output pixel format " +
+                                     this->settings.outputPixelFormat);
+      return {};
+    }
+  }
+
+  int format{};
+  CAST_AVUTIL_GET_MEMBER(AVFrame, frame.getFrame(), format, format);
+
+  ContextParameters parameters;
+  parameters.inputSize    = frame.getSize();
+  parameters.inputFormat  = static_cast<AVPixelFormat>(format);
+  parameters.outputSize   = this->settings.outputSize;
+  parameters.outputFormat = this->outputFormat.value();
+  parameters.flags        = getScalingFlags(this->settings.algorithm);
+
+  if (parameters.inputSize.width <= 0 || parameters.inputSize.height <= 0 || format < 0)
+    return {};
+  if (parameters.outputSize.width <= 0 || parameters.outputSize.height <= 0)
+    parameters.outputSize = parameters.inputSize;
+
+  const auto avutilMajorVersion = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+  if (this->ffmpegLibraries->swscale.sws_scale_frame && avutilMajorVersion >= 57)
+    parameters.numberOfThreads = getNumberOfThreads(this->settings);
+
+  return parameters;
+}
+
+bool Scaler::updateContext(const ContextParameters &parameters)
+{
+  if (this->context && this->contextParameters == parameters)
+    return true;
+
+  // A threaded context can not be reused by sws_getCachedContext. It would keep its threads.
+  if (parameters.numberOfThreads > 1 || this->contextParameters.numberOfThreads > 1)
+    this->context.reset();
+
+  if (parameters.numberOfThreads > 1)
+    this->createThreadedContext(parameters);
+  else
+  {
+    // If the parameters did not change, the given context is returned. Otherwise it is freed.
+    const auto newContext =
+        this->ffmpegLibraries->swscale.sws_getCachedContext(this->context.release(),
+                                                            parameters.inputSize.width,
+                                                            parameters.inputSize.height,
+                                                            parameters.inputFormat,
+                                                            parameters.outputSize.width,
+                                                            parameters.outputSize.height,
+                                                            parameters.outputFormat,
+                                                            parameters.flags,
+                                                            nullptr,
+                                                            nullptr,
+                                                            nullptr);
+    this->context.reset(newContext);
+  }
+
+  if (!this->context)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "Creating the swscale context failed");
+    this->contextParameters = {};
+    return false;
+  }
+
+  this->contextParameters = parameters;
+  this->ffmpegLibraries->log(
+      LogLevel::Debug,
+      "Created swscale context for " + std::to_string(parameters.inputSize.width) + "x" +
+          std::to_string(parameters.inputSize.height) + " to " +
+          std::to_string(parameters.outputSize.width) + "x" +
+          std::to_string(parameters.outputSize.height) + " with " +
+          std::to_string(parameters.numberOfThreads) + " thread(s)");
+  return true;
+}
+
+bool Scaler::createThreadedContext(const ContextParameters &parameters)
+{
+  this->context.reset(this->ffmpegLibraries->swscale.sws_alloc_context());
+  if (!this->context)
+    return false;
+
+  const auto setOption = [this](const char *name, const int64_t value) {
+    return this->ffmpegLibraries->avutil.av_opt_set_int(this->context.get(), name, value, 0) >= 0;
+  };
+
+  if (!setOption("srcw", parameters.inputSize.width) ||
+      !setOption("srch", parameters.inputSize.height) ||
+      !setOption("src_format", parameters.inputFormat) ||
+      !setOption("dstw", parameters.outputSize.width) ||
+      !setOption("dsth", parameters.outputSize.height) ||
+      !setOption("dst_format", parameters.outputFormat) ||
+      !setOption("sws_flags", parameters.flags) ||
+      !setOption("threads", parameters.numberOfThreads) ||
+      this->ffmpegLibraries->swscale.sws_init_context(this->context.get(), nullptr, nullptr) < 0)
+  {
+    this->context.reset();
+    return false;
+  }
+  return true;
+}
+
+bool Scaler::scaleThreaded(const avutil::AVFrameWrapper     &frame,
+                           const std::array<std::byte *, 4> &outputData,
+                           const std::array<int, 4>         &outputLinesize)
+{
+  const auto outputSize   = this->contextParameters.outputSize;
+  const auto outputFormat = this->contextParameters.outputFormat;
+
+  // With a null pointer, the data pointers are the offsets of the planes in one buffer. The
+  // difference to the next plane is the size of each plane.
+  std::array<int, 4> absoluteLinesize{};
+  for (int plane = 0; plane < 4; ++plane)
+    absoluteLinesize[plane] = std::abs(outputLinesize[plane]);
+  uint8_t   *planes[4]{};
+  const auto imageSize = this->ffmpegLibraries->avutil.av_image_fill_pointers(
+      planes, outputFormat, outputSize.height, nullptr, absoluteLinesize.data());
+  if (imageSize <= 0)
+    return false;
+
+  std::array<std::uintptr_t, 5> planeOffsets{};
+  for (int plane = 0; plane < 4; ++plane)
+    planeOffsets[plane] = reinterpret_cast<std::uintptr_t>(planes[plane]);
+
+  // One buffer reference per plane so that the frame references all the memory that its data
+  // pointers point to. The frame takes ownership of the references, also of the ones that were
+  // created before creating a reference failed.
+  std::array<AVBufferRef *, 4> buffers{};
+  std::size_t                  numberOfBuffers{};
+  bool                         allBuffersCreated{true};
+  for (int plane = 0; plane < 4; ++plane)
+  {
+    if (outputData[plane] == nullptr)
+      continue;
+
+    const auto nextPlaneOffset = planeOffsets[plane + 1];
+    const auto planeEnd        = (nextPlaneOffset > planeOffsets[plane])
+                                     ? nextPlaneOffset
+                                     : static_cast<std::uintptr_t>(imageSize);
+    const auto planeSize       = static_cast<std::size_t>(planeEnd - planeOffsets[plane]);
+
+    // With a negative linesize, the data pointer points to the last line in memory
+    auto data = reinterpret_cast<uint8_t *>(outputData[plane]);
+    if (outputLinesize[plane] < 0)
+      data -= planeSize - static_cast<std::size_t>(absoluteLinesize[plane]);
+
+    buffers[numberOfBuffers] = this->ffmpegLibraries->avutil.av_buffer_create(
+        data, planeSize, &doNotFreeBuffer, nullptr, 0);
+    if (buffers[numberOfBuffers] == nullptr)
+      allBuffersCreated = false;
+    else
+      ++numberOfBuffers;
+  }
+
+  avutil::AVFrameWrapper outputFrame(this->ffmpegLibraries);
+
+  const auto avutilMajorVersion = this->ffmpegLibraries->getLibrariesVersion().avutil.major;
+  if (avutilMajorVersion == 57 || avutilMajorVersion == 58)
+    OutputFrame<AVFrame_57>::set(
+        outputFrame.getFrame(), outputSize, outputFormat, outputData, outputLinesize, buffers);
+  else if (avutilMajorVersion == 59)
+    OutputFrame<AVFrame_59>::set(
+        outputFrame.getFrame(), outputSize, outputFormat, outputData, outputLinesize, buffers);
+  else
+    OutputFrame<AVFrame_60>::set(
+        outputFrame.getFrame(), outputSize, outputFormat, outputData, outputLinesize, buffers);
+
+  if (!allBuffersCreated)
+    return false;
+
+  const auto ret = this->ffmpegLibraries->swscale.sws_scale_frame(
+      this->context.get(), outputFrame.getFrame(), frame.getFrame());
+  if (ret < 0)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Scaling failed. sws_scale_frame returned " + std::to_string(ret));
+    return false;
+  }
+  return true;
+}
+
+void Scaler::SwsContextDeleter::operator()(SwsContext *context) const noexcept
+{
+  if (context != nullptr && this->ffmpegLibraries)
+    this->ffmpegLibraries->swscale.sws_freeContext(context);
+}
+
+} // namespace libffmpeg::swscale
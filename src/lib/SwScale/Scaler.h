@@ -0,0 +1,126 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <common/InternalTypes.h>
+#include <common/Types.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace libffmpeg::swscale
+{
+
+enum class ScalingAlgorithm
+{
+  FastBilinear,
+  Bilinear,
+  Bicubic,
+  Point,
+  Area,
+  Lanczos
+};
+
+struct ScalerSettings
+{
+  // An empty size (0x0) keeps the size of the input frame.
+  Size             outputSize{};
+  std::string      outputPixelFormat{"rgba"};
+  ScalingAlgorithm algorithm{ScalingAlgorithm::Bilinear};
+  // Number of threads that swscale uses to process slices of the frame in parallel. 0 means one
+  // thread per hardware thread. Slice threading is only available with FFmpeg 5 and newer. For
+  // older versions, scaling is always done in the calling thread.
+  unsigned numberOfSliceThreads{1};
+};
+
+// How the planes of the output image are placed into one contiguous buffer without padding.
+struct OutputImageLayout
+{
+  std::array<int, 4>         linesize{};
+  std::array<std::size_t, 4> planeOffset{};
+  std::size_t                bufferSize{};
+};
+
+/* Conversion of frames to a different size and / or pixel format using libswscale. The swscale
+ * context is cached and only recreated if the size or format of the input frames or the settings
+ * change. The output is written into buffers that are owned by the caller.
+ * Requires the optional swscale library (see IFFmpegLibraries::isSwScaleAvailable).
+ */
+class Scaler
+{
+public:
+  Scaler() = delete;
+  Scaler(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const ScalerSettings &settings = {});
+
+  void                                setSettings(const ScalerSettings &settings);
+  [[nodiscard]] const ScalerSettings &getSettings() const { return this->settings; }
+
+  // The layout of the output image for the given input frame when it is written into one buffer.
+  [[nodiscard]] std::optional<OutputImageLayout>
+  getOutputLayout(const avutil::AVFrameWrapper &frame);
+
+  // Scale the frame into the given planes. The caller must make sure that the planes are big
+  // enough for the output size and format. Returns false if scaling failed.
+  bool scale(const avutil::AVFrameWrapper     &frame,
+             const std::array<std::byte *, 4> &outputData,
+             const std::array<int, 4>         &outputLinesize);
+
+  // Scale the frame into one buffer using the layout from getOutputLayout.
+  bool scale(const avutil::AVFrameWrapper &frame, std::span<std::byte> outputBuffer);
+
+  // Is the current context scaling slices in parallel.
+  [[nodiscard]] bool isSliceThreadingActive() const;
+
+private:
+  struct ContextParameters
+  {
+    Size                    inputSize{};
+    internal::AVPixelFormat inputFormat{internal::AV_PIX_FMT_NONE};
+    Size                    outputSize{};
+    internal::AVPixelFormat outputFormat{internal::AV_PIX_FMT_NONE};
+    int                     flags{};
+    unsigned                numberOfThreads{1};
+
+    bool operator==(const ContextParameters &other) const;
+  };
+
+  [[nodiscard]] std::optional<ContextParameters>
+       getContextParameters(const avutil::AVFrameWrapper &frame);
+  bool updateContext(const ContextParameters &parameters);
+  bool createThreadedContext(const ContextParameters &parameters);
+  bool scaleThreaded(const avutil::AVFrameWrapper     &frame,
+                     const std::array<std::byte *, 4> &outputData,
+                     const std::array<int, 4>         &outputLinesize);
+
+  class SwsContextDeleter
+  {
+  public:
+    SwsContextDeleter() = default;
+    SwsContextDeleter(const std::shared_ptr<IFFmpegLibraries> &ffmpegLibraries)
+        : ffmpegLibraries(ffmpegLibraries) {};
+    void operator()(libffmpeg::internal::SwsContext *context) const noexcept;
+
+  private:
+    std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+  };
+
+  std::unique_ptr<libffmpeg::internal::SwsContext, SwsContextDeleter> context{
+      nullptr, SwsContextDeleter()};
+  ContextParameters contextParameters{};
+
+  ScalerSettings                         settings{};
+  std::optional<internal::AVPixelFormat> outputFormat{};
+
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+};
+
+} // namespace libffmpeg::swscale
@@ -0,0 +1,177 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "WaveformGenerator.h"
+
+#include <Decoder.h>
+#include <Demuxer.h>
+
+#include <stdexcept>
+
+namespace libffmpeg::waveform
+{
+
+using libffmpeg::internal::AVSampleFormat;
+
+WaveformGenerator::WaveformGenerator(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                     const WaveformSettings           &settings)
+    : settings(settings), writer(settings), ffmpegLibraries(ffmpegLibraries)
+{
+  if (!ffmpegLibraries)
+    throw std::runtime_error("Provided ffmpeg libraries pointer must not be null");
+}
+
+bool WaveformGenerator::generate(const Path        &inputFile,
+                                 const Path        &summaryFile,
+                                 std::optional<int> streamIndex)
+{
+  Demuxer demuxer(this->ffmpegLibraries);
+  if (!demuxer.openFile(inputFile))
+    return false;
+
+  const auto formatContext = demuxer.getFormatContext();
+  if (!streamIndex)
+  {
+    for (const auto &stream : formatContext->getStreams())
+    {
+      if (stream.getCodecType() == avutil::MediaType::Audio)
+      {
+        streamIndex = stream.getIndex();
+        break;
+      }
+    }
+  }
+  if (!streamIndex || *streamIndex < 0 || *streamIndex >= formatContext->getNumberStreams() ||
+      formatContext->getStream(*streamIndex).getCodecType() != avutil::MediaType::Audio)
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "No audio stream found for the waveform");
+    return false;
+  }
+
+  Decoder decoder(this->ffmpegLibraries);
+  if (!decoder.openForDecoding(formatContext->getStream(*streamIndex)))
+    return false;
+
+  this->writer = WaveformSummaryWriter(this->settings);
+  this->resampler.reset();
+
+  bool       success{true};
+  const auto pullFramesFromDecoder = [this, &decoder, &success, &summaryFile]()
+  {
+    while (auto frame = decoder.decodeNextFrame())
+    {
+      if (!this->writer.isOpen() &&
+          !this->writer.open(summaryFile, frame->getNumberOfChannels(), frame->getSampleRate()))
+      {
+        this->ffmpegLibraries->log(LogLevel::Error, "Error opening the waveform summary file");
+        success = false;
+      }
+      if (success && !this->addFrame(*frame))
+        success = false;
+    }
+  };
+
+  while (success)
+  {
+    auto packet = demuxer.getNextPacket();
+    if (!packet)
+    {
+      if (demuxer.getDemuxerState() != Demuxer::State::EndOfFile)
+      {
+        this->ffmpegLibraries->log(LogLevel::Error,
+                                   "Demuxing stopped before the end of the file");
+        success = false;
+      }
+      break;
+    }
+    if (packet->getStreamIndex() != *streamIndex)
+      continue;
+
+    auto result = decoder.sendPacket(*packet);
+    if (decoder.getDecoderState() == Decoder::State::RetrieveFrames)
+      pullFramesFromDecoder();
+    if (result == Decoder::SendPacketResult::NotSentPullFramesFirst)
+      result = decoder.sendPacket(*packet);
+    if (result == Decoder::SendPacketResult::Error)
+    {
+      this->ffmpegLibraries->log(LogLevel::Error, "Error decoding audio packet");
+      success = false;
+    }
+  }
+
+  decoder.setFlushing();
+  pullFramesFromDecoder();
+
+  if (!this->writer.isOpen())
+  {
+    this->ffmpegLibraries->log(LogLevel::Error, "No audio frames decoded for the waveform");
+    return false;
+  }
+
+  // Samples that are still buffered in the resampler
+  if (success && this->resampler && this->resampler->flush(this->convertedSamples))
+    success = this->addConvertedSamples();
+
+  return this->writer.finish() && success;
+}
+
+bool WaveformGenerator::addFrame(const avutil::AVFrameWrapper &frame)
+{
+  if (frame.getSampleFormat() != AVSampleFormat::AV_SAMPLE_FMT_FLTP)
+  {
+    if (!this->resampler)
+      this->resampler.emplace(
+          this->ffmpegLibraries,
+          swresample::ResamplerSettings{.sampleRate   = 0,
+                                        .sampleFormat = AVSampleFormat::AV_SAMPLE_FMT_FLTP});
+    if (!this->resampler->convert(frame, this->convertedSamples))
+      return false;
+    return this->addConvertedSamples();
+  }
+
+  // No conversion needed. Read the samples directly from the frame.
+  this->channels.resize(static_cast<std::size_t>(frame.getNumberOfChannels()));
+  for (int channel = 0; channel < frame.getNumberOfChannels(); ++channel)
+  {
+    const auto samples = frame.getAudioSamples<float>(channel);
+    if (samples.empty())
+      return false;
+    this->channels.at(channel) = samples.data();
+  }
+
+  if (!this->writer.addSamples(this->channels,
+                               static_cast<std::size_t>(frame.getNumberOfSamples())))
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error adding samples to the waveform. Did the number of channels "
+                               "change?");
+    return false;
+  }
+  return true;
+}
+
+bool WaveformGenerator::addConvertedSamples()
+{
+  const auto &converted = this->convertedSamples;
+  if (converted.numberOfSamples == 0)
+    return true;
+
+  this->channels.resize(converted.planes.size());
+  for (std::size_t channel = 0; channel < converted.planes.size(); ++channel)
+    this->channels[channel] = reinterpret_cast<const float *>(converted.planes[channel].data());
+
+  if (!this->writer.addSamples(this->channels,
+                               static_cast<std::size_t>(converted.numberOfSamples)))
+  {
+    this->ffmpegLibraries->log(LogLevel::Error,
+                               "Error adding samples to the waveform. Did the number of channels "
+                               "change?");
+    return false;
+  }
+  return true;
+}
+
+} // namespace libffmpeg::waveform
@@ -0,0 +1,52 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <AVUtil/wrappers/AVFrameWrapper.h>
+#include <SwResample/Resampler.h>
+#include <Waveform/WaveformSummary.h>
+#include <libHandling/IFFmpegLibraries.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace libffmpeg::waveform
+{
+
+/* Decodes one audio stream of a file and writes its waveform summary (see WaveformSummary.h) in
+ * one streaming pass. Frames in planar float format are read directly from the decoded frames.
+ * All other formats are converted using the Resampler (keeping the sample rate).
+ */
+class WaveformGenerator
+{
+public:
+  WaveformGenerator() = delete;
+  WaveformGenerator(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                    const WaveformSettings           &settings = {});
+
+  // Without a stream index, the first audio stream of the file is used.
+  bool generate(const Path        &inputFile,
+                const Path        &summaryFile,
+                std::optional<int> streamIndex = {});
+
+private:
+  bool addFrame(const avutil::AVFrameWrapper &frame);
+  bool addConvertedSamples();
+
+  WaveformSettings      settings{};
+  WaveformSummaryWriter writer;
+
+  // Only created if the decoded samples are not in planar float format
+  std::optional<swresample::Resampler> resampler;
+  swresample::AudioBuffer              convertedSamples{};
+  std::vector<const float *>           channels{};
+
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries{};
+};
+
+} // namespace libffmpeg::waveform
@@ -0,0 +1,37 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/CpuFeatures.h>
+
+#include <cstddef>
+
+/* The kernels that aggregate the samples of one waveform bucket. Like the RGB conversion kernels,
+ * the SIMD kernels are compiled with the instruction set enabled and must only be called if
+ * getCpuFeatures reports support.
+ */
+
+namespace libffmpeg::waveform::kernels
+{
+
+// The statistics of the samples of one channel in one bucket. The caller initializes min and max
+// (e.g. to +/- infinity) before the first call.
+struct SampleStatistics
+{
+  float  min;
+  float  max;
+  double sumOfSquares;
+};
+
+// Add count samples to the statistics
+void accumulateScalar(const float *samples, std::size_t count, SampleStatistics &statistics);
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+void accumulateAVX2(const float *samples, std::size_t count, SampleStatistics &statistics);
+#endif
+
+} // namespace libffmpeg::waveform::kernels
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "WaveformKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <immintrin.h>
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("avx2")
+
+namespace libffmpeg::waveform::kernels
+{
+
+void accumulateAVX2(const float *samples, const std::size_t count, SampleStatistics &statistics)
+{
+  std::size_t i = 0;
+
+  if (count >= 8)
+  {
+    auto minimum = _mm256_set1_ps(statistics.min);
+    auto maximum = _mm256_set1_ps(statistics.max);
+    // The squares are summed up in double precision like in the scalar kernel
+    auto sumLow  = _mm256_setzero_pd();
+    auto sumHigh = _mm256_setzero_pd();
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const auto values = _mm256_loadu_ps(samples + i);
+      minimum           = _mm256_min_ps(minimum, values);
+      maximum           = _mm256_max_ps(maximum, values);
+
+      const auto low  = _mm256_cvtps_pd(_mm256_castps256_ps128(values));
+      const auto high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+      sumLow          = _mm256_add_pd(sumLow, _mm256_mul_pd(low, low));
+      sumHigh         = _mm256_add_pd(sumHigh, _mm256_mul_pd(high, high));
+    }
+
+    alignas(32) float  minimumValues[8];
+    alignas(32) float  maximumValues[8];
+    alignas(32) double sums[4];
+    _mm256_store_ps(minimumValues, minimum);
+    _mm256_store_ps(maximumValues, maximum);
+    _mm256_store_pd(sums, _mm256_add_pd(sumLow, sumHigh));
+
+    for (int lane = 0; lane < 8; ++lane)
+    {
+      if (minimumValues[lane] < statistics.min)
+        statistics.min = minimumValues[lane];
+      if (maximumValues[lane] > statistics.max)
+        statistics.max = maximumValues[lane];
+    }
+    statistics.sumOfSquares += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  }
+
+  for (; i < count; ++i)
+  {
+    const auto sample = samples[i];
+    if (sample < statistics.min)
+      statistics.min = sample;
+    if (sample > statistics.max)
+      statistics.max = sample;
+    statistics.sumOfSquares += static_cast<double>(sample) * sample;
+  }
+}
+
+} // namespace libffmpeg::waveform::kernels
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
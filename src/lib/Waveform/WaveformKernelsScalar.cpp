@@ -0,0 +1,25 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "WaveformKernels.h"
+
+#include <algorithm>
+
+namespace libffmpeg::waveform::kernels
+{
+
+void accumulateScalar(const float *samples, const std::size_t count, SampleStatistics &statistics)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto sample = samples[i];
+    statistics.min    = std::min(statistics.min, sample);
+    statistics.max    = std::max(statistics.max, sample);
+    statistics.sumOfSquares += static_cast<double>(sample) * sample;
+  }
+}
+
+} // namespace libffmpeg::waveform::kernels
@@ -0,0 +1,368 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "WaveformSummary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace libffmpeg::waveform
+{
+
+namespace
+{
+
+using kernels::SampleStatistics;
+
+constexpr char        MAGIC[8]                  = {'L', 'F', 'F', 'W', 'A', 'V', 'E', '1'};
+constexpr std::size_t LEVEL_TABLE_OFFSET        = 32;
+constexpr std::size_t LEVEL_TABLE_ENTRY_SIZE    = 24;
+constexpr std::size_t LEVEL_ALIGNMENT           = 8;
+constexpr std::size_t LEVEL0_WRITE_BUFFER_BYTES = 1 << 20;
+
+static_assert(LEVEL_TABLE_OFFSET + WAVEFORM_MAX_LEVELS * LEVEL_TABLE_ENTRY_SIZE <=
+              WAVEFORM_HEADER_SIZE);
+
+template <typename T> void writeLittleEndian(std::byte *data, const T value)
+{
+  using Unsigned  = std::make_unsigned_t<T>;
+  const auto bits = static_cast<Unsigned>(value);
+  for (std::size_t i = 0; i < sizeof(T); ++i)
+    data[i] = std::byte((bits >> (8 * i)) & 0xff);
+}
+
+template <typename T> T readLittleEndian(const std::byte *data)
+{
+  using Unsigned = std::make_unsigned_t<T>;
+  Unsigned bits{};
+  for (std::size_t i = 0; i < sizeof(T); ++i)
+    bits |= static_cast<Unsigned>(static_cast<Unsigned>(data[i]) << (8 * i));
+  return static_cast<T>(bits);
+}
+
+void appendBucket(ByteVector &data, const WaveformBucket &bucket)
+{
+  const auto offset = data.size();
+  data.resize(offset + WAVEFORM_BUCKET_SIZE);
+  writeLittleEndian(data.data() + offset, bucket.min);
+  writeLittleEndian(data.data() + offset + 2, bucket.max);
+  writeLittleEndian(data.data() + offset + 4, bucket.rms);
+}
+
+template <typename T> T scaleAndClip(const double value)
+{
+  constexpr auto maxValue = static_cast<double>(std::numeric_limits<T>::max());
+  constexpr auto minValue = static_cast<double>(std::numeric_limits<T>::min());
+  return static_cast<T>(std::clamp(std::round(value * maxValue), minValue, maxValue));
+}
+
+WaveformBucket encodeBucket(const SampleStatistics &statistics, const uint64_t numberOfSamples)
+{
+  WaveformBucket bucket;
+  bucket.min = scaleAndClip<int16_t>(statistics.min);
+  bucket.max = scaleAndClip<int16_t>(statistics.max);
+  bucket.rms = scaleAndClip<uint16_t>(
+      std::sqrt(statistics.sumOfSquares / static_cast<double>(numberOfSamples)));
+  return bucket;
+}
+
+WaveformSettings::Implementation selectImplementation(WaveformSettings::Implementation selected)
+{
+  using Implementation = WaveformSettings::Implementation;
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  if ((selected == Implementation::Auto || selected == Implementation::AVX2) &&
+      getCpuFeatures().avx2)
+    return Implementation::AVX2;
+#endif
+
+  return Implementation::Scalar;
+}
+
+std::size_t alignOffset(const std::size_t offset)
+{
+  return (offset + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+}
+
+} // namespace
+
+WaveformSummaryWriter::WaveformSummaryWriter(const WaveformSettings &settings)
+    : settings(settings)
+{
+  this->settings.samplesPerBucket = std::max(1u, settings.samplesPerBucket);
+  this->settings.levelFactor      = std::max(2u, settings.levelFactor);
+
+  this->accumulate = kernels::accumulateScalar;
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  if (selectImplementation(settings.implementation) == WaveformSettings::Implementation::AVX2)
+    this->accumulate = kernels::accumulateAVX2;
+#endif
+}
+
+bool WaveformSummaryWriter::open(const Path &path, const int numberOfChannels, const int sampleRate)
+{
+  if (numberOfChannels <= 0 || sampleRate <= 0)
+    return false;
+
+  this->file.open(path, std::ios::binary | std::ios::trunc);
+  if (!this->file.is_open())
+    return false;
+
+  // The header is written in finish when all levels are known
+  const ByteVector emptyHeader(WAVEFORM_HEADER_SIZE);
+  this->file.write(reinterpret_cast<const char *>(emptyHeader.data()), emptyHeader.size());
+
+  this->numberOfChannels = numberOfChannels;
+  this->sampleRate       = sampleRate;
+  this->numberOfSamples  = 0;
+  this->levels.clear();
+  this->addLevel();
+  return this->file.good();
+}
+
+bool WaveformSummaryWriter::addSamples(std::span<const float *const> channels,
+                                       const std::size_t             numberOfSamples)
+{
+  if (!this->file.is_open() || channels.size() != static_cast<std::size_t>(this->numberOfChannels))
+    return false;
+
+  const auto samplesPerBucket = static_cast<uint64_t>(this->settings.samplesPerBucket);
+
+  std::size_t offset = 0;
+  while (offset < numberOfSamples)
+  {
+    auto      &level0 = this->levels.front();
+    const auto count  = static_cast<std::size_t>(std::min<uint64_t>(
+        numberOfSamples - offset, samplesPerBucket - level0.samplesInCurrentBucket));
+
+    for (std::size_t channel = 0; channel < channels.size(); ++channel)
+      this->accumulate(channels[channel] + offset, count, level0.currentBucket[channel]);
+
+    level0.samplesInCurrentBucket += count;
+    offset += count;
+    if (level0.samplesInCurrentBucket == samplesPerBucket)
+      this->finishBucket(0);
+  }
+
+  this->numberOfSamples += numberOfSamples;
+  return this->writeLevel0Buffer(false);
+}
+
+bool WaveformSummaryWriter::finish()
+{
+  if (!this->file.is_open())
+    return false;
+
+  // Flush the incomplete buckets. Stop at the first level with only one bucket.
+  for (std::size_t levelIndex = 0; levelIndex < this->levels.size(); ++levelIndex)
+  {
+    if (this->levels[levelIndex].samplesInCurrentBucket > 0)
+      this->finishBucket(levelIndex);
+    if (this->levels[levelIndex].numberOfBuckets <= 1)
+    {
+      this->levels.resize(levelIndex + 1);
+      break;
+    }
+  }
+
+  auto success = this->writeLevel0Buffer(true);
+
+  ByteVector header(WAVEFORM_HEADER_SIZE);
+  std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+  writeLittleEndian(header.data() + 8, static_cast<uint32_t>(this->numberOfChannels));
+  writeLittleEndian(header.data() + 12, static_cast<uint32_t>(this->sampleRate));
+  writeLittleEndian(header.data() + 16, static_cast<uint32_t>(this->levels.size()));
+  writeLittleEndian(header.data() + 24, this->numberOfSamples);
+
+  const auto bucketSize = WAVEFORM_BUCKET_SIZE * static_cast<std::size_t>(this->numberOfChannels);
+  auto       offset     = WAVEFORM_HEADER_SIZE;
+
+  uint64_t samplesPerBucket = this->settings.samplesPerBucket;
+  for (std::size_t levelIndex = 0; levelIndex < this->levels.size(); ++levelIndex)
+  {
+    const auto &level = this->levels[levelIndex];
+
+    // Level 0 was already written. Pad the file so that each level starts aligned.
+    if (levelIndex > 0)
+    {
+      const auto       alignedOffset = alignOffset(offset);
+      const ByteVector padding(alignedOffset - offset);
+      this->file.write(reinterpret_cast<const char *>(padding.data()), padding.size());
+      this->file.write(reinterpret_cast<const char *>(level.encodedBuckets.data()),
+                       level.encodedBuckets.size());
+      offset = alignedOffset;
+    }
+
+    const auto entry = header.data() + LEVEL_TABLE_OFFSET + levelIndex * LEVEL_TABLE_ENTRY_SIZE;
+    writeLittleEndian(entry, samplesPerBucket);
+    writeLittleEndian(entry + 8, level.numberOfBuckets);
+    writeLittleEndian(entry + 16, static_cast<uint64_t>(offset));
+
+    offset += static_cast<std::size_t>(level.numberOfBuckets) * bucketSize;
+    samplesPerBucket *= this->settings.levelFactor;
+  }
+
+  this->file.seekp(0);
+  this->file.write(reinterpret_cast<const char *>(header.data()), header.size());
+  success = success && this->file.good();
+  this->file.close();
+  this->levels.clear();
+  return success;
+}
+
+void WaveformSummaryWriter::addLevel()
+{
+  Level level;
+  level.currentBucket.resize(static_cast<std::size_t>(this->numberOfChannels));
+  this->resetCurrentBucket(level);
+  this->levels.push_back(std::move(level));
+}
+
+void WaveformSummaryWriter::resetCurrentBucket(Level &level)
+{
+  for (auto &statistics : level.currentBucket)
+  {
+    statistics.min          = std::numeric_limits<float>::infinity();
+    statistics.max          = -std::numeric_limits<float>::infinity();
+    statistics.sumOfSquares = 0.0;
+  }
+  level.samplesInCurrentBucket  = 0;
+  level.childrenInCurrentBucket = 0;
+}
+
+void WaveformSummaryWriter::finishBucket(const std::size_t levelIndex)
+{
+  {
+    auto &level = this->levels[levelIndex];
+    for (const auto &statistics : level.currentBucket)
+      appendBucket(level.encodedBuckets, encodeBucket(statistics, level.samplesInCurrentBucket));
+    ++level.numberOfBuckets;
+  }
+
+  if (levelIndex + 1 >= WAVEFORM_MAX_LEVELS)
+  {
+    this->resetCurrentBucket(this->levels[levelIndex]);
+    return;
+  }
+  if (levelIndex + 1 == this->levels.size())
+    this->addLevel();
+
+  // Combine the bucket into the current bucket of the next level
+  auto &level  = this->levels[levelIndex];
+  auto &parent = this->levels[levelIndex + 1];
+  for (std::size_t channel = 0; channel < level.currentBucket.size(); ++channel)
+  {
+    const auto &statistics       = level.currentBucket[channel];
+    auto       &parentStatistics = parent.currentBucket[channel];
+    parentStatistics.min         = std::min(parentStatistics.min, statistics.min);
+    parentStatistics.max         = std::max(parentStatistics.max, statistics.max);
+    parentStatistics.sumOfSquares += statistics.sumOfSquares;
+  }
+  parent.samplesInCurrentBucket += level.samplesInCurrentBucket;
+  ++parent.childrenInCurrentBucket;
+  this->resetCurrentBucket(level);
+
+  if (parent.childrenInCurrentBucket == this->settings.levelFactor)
+    this->finishBucket(levelIndex + 1);
+}
+
+bool WaveformSummaryWriter::writeLevel0Buffer(const bool force)
+{
+  auto &buffer = this->levels.front().encodedBuckets;
+  if (buffer.empty() || (!force && buffer.size() < LEVEL0_WRITE_BUFFER_BYTES))
+    return this->file.good();
+
+  this->file.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+  buffer.clear();
+  return this->file.good();
+}
+
+bool WaveformSummaryReader::open(const Path &path)
+{
+  this->file.close();
+  this->levels.clear();
+
+  this->file.open(path, std::ios::binary);
+  if (!this->file.is_open())
+    return false;
+
+  ByteVector header(WAVEFORM_HEADER_SIZE);
+  this->file.read(reinterpret_cast<char *>(header.data()), header.size());
+  if (!this->file.good() || std::memcmp(header.data(), MAGIC, sizeof(MAGIC)) != 0)
+    return false;
+
+  const auto numberOfLevels = readLittleEndian<uint32_t>(header.data() + 16);
+  this->numberOfChannels    = static_cast<int>(readLittleEndian<uint32_t>(header.data() + 8));
+  this->sampleRate          = static_cast<int>(readLittleEndian<uint32_t>(header.data() + 12));
+  this->numberOfSamples     = readLittleEndian<uint64_t>(header.data() + 24);
+  if (numberOfLevels > WAVEFORM_MAX_LEVELS)
+    return false;
+
+  for (std::size_t levelIndex = 0; levelIndex < numberOfLevels; ++levelIndex)
+  {
+    const auto entry = header.data() + LEVEL_TABLE_OFFSET + levelIndex * LEVEL_TABLE_ENTRY_SIZE;
+    WaveformLevel level;
+    level.samplesPerBucket = readLittleEndian<uint64_t>(entry);
+    level.numberOfBuckets  = readLittleEndian<uint64_t>(entry + 8);
+    level.fileOffset       = readLittleEndian<uint64_t>(entry + 16);
+    this->levels.push_back(level);
+  }
+
+  return true;
+}
+
+std::size_t WaveformSummaryReader::selectLevel(const uint64_t numberOfSamples,
+                                               const uint64_t maxNumberOfBuckets) const
+{
+  for (std::size_t levelIndex = 0; levelIndex < this->levels.size(); ++levelIndex)
+  {
+    const auto samplesPerBucket = this->levels[levelIndex].samplesPerBucket;
+    const auto buckets          = (numberOfSamples + samplesPerBucket - 1) / samplesPerBucket;
+    if (buckets <= maxNumberOfBuckets)
+      return levelIndex;
+  }
+  return this->levels.empty() ? 0 : this->levels.size() - 1;
+}
+
+bool WaveformSummaryReader::readBuckets(const std::size_t            level,
+                                        const uint64_t               firstBucket,
+                                        const uint64_t               numberOfBuckets,
+                                        std::vector<WaveformBucket> &buckets)
+{
+  buckets.clear();
+  if (level >= this->levels.size())
+    return false;
+
+  const auto &levelInfo = this->levels[level];
+  if (firstBucket >= levelInfo.numberOfBuckets)
+    return numberOfBuckets == 0;
+  const auto bucketsToRead = std::min(numberOfBuckets, levelInfo.numberOfBuckets - firstBucket);
+
+  const auto channels   = static_cast<std::size_t>(this->numberOfChannels);
+  const auto bucketSize = WAVEFORM_BUCKET_SIZE * channels;
+  this->readBuffer.resize(static_cast<std::size_t>(bucketsToRead) * bucketSize);
+
+  this->file.clear();
+  this->file.seekg(static_cast<std::streamoff>(levelInfo.fileOffset + firstBucket * bucketSize));
+  this->file.read(reinterpret_cast<char *>(this->readBuffer.data()), this->readBuffer.size());
+  if (!this->file.good())
+    return false;
+
+  buckets.resize(static_cast<std::size_t>(bucketsToRead) * channels);
+  for (std::size_t i = 0; i < buckets.size(); ++i)
+  {
+    const auto data = this->readBuffer.data() + i * WAVEFORM_BUCKET_SIZE;
+    buckets[i].min  = readLittleEndian<int16_t>(data);
+    buckets[i].max  = readLittleEndian<int16_t>(data + 2);
+    buckets[i].rms  = readLittleEndian<uint16_t>(data + 4);
+  }
+  return true;
+}
+
+} // namespace libffmpeg::waveform
@@ -0,0 +1,156 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <Waveform/WaveformKernels.h>
+#include <common/Types.h>
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <vector>
+
+/* A waveform summary contains the min, max and RMS values of buckets of audio samples at
+ * multiple resolutions (levels). Level 0 has the finest resolution. Each following level combines
+ * levelFactor buckets of the previous level, until one bucket covers the whole stream.
+ *
+ * The file layout is fixed so that the file can be memory mapped. All values are little endian.
+ *   Offset 0:  The header (WAVEFORM_HEADER_SIZE bytes, zero padded)
+ *     char[8]  magic "LFFWAVE1"
+ *     uint32   number of channels
+ *     uint32   sample rate
+ *     uint32   number of levels
+ *     uint32   reserved (0)
+ *     uint64   number of samples per channel
+ *     Per level (WAVEFORM_MAX_LEVELS entries): uint64 samples per bucket, uint64 number of buckets,
+ *                                              uint64 file offset of the buckets
+ *   The buckets of each level. For each bucket, one WaveformBucket per channel.
+ */
+
+namespace libffmpeg::waveform
+{
+
+constexpr std::size_t WAVEFORM_HEADER_SIZE = 1024;
+constexpr std::size_t WAVEFORM_MAX_LEVELS  = 32;
+
+struct WaveformSettings
+{
+  enum class Implementation
+  {
+    Auto,
+    Scalar,
+    AVX2
+  };
+
+  // The number of samples of one bucket of level 0
+  unsigned samplesPerBucket{256};
+  // The number of buckets of a level that are combined into one bucket of the next level
+  unsigned levelFactor{4};
+  // Auto selects the best implementation that is supported by the CPU. Selecting an
+  // implementation that is not supported falls back to Scalar.
+  Implementation implementation{Implementation::Auto};
+};
+
+// The values of one channel in one bucket. Min and max are scaled from [-1, 1] and the RMS from
+// [0, 1] to the range of the integer type. Values outside of that range are clipped.
+struct WaveformBucket
+{
+  int16_t  min{};
+  int16_t  max{};
+  uint16_t rms{};
+
+  bool operator==(const WaveformBucket &other) const = default;
+};
+
+constexpr std::size_t WAVEFORM_BUCKET_SIZE = 6;
+
+struct WaveformLevel
+{
+  uint64_t samplesPerBucket{};
+  uint64_t numberOfBuckets{};
+  uint64_t fileOffset{};
+};
+
+/* Writes the summary in one streaming pass. Level 0 is written to the file while the samples are
+ * added. Only the coarser levels (at most 1 / (levelFactor - 1) of the size of level 0) are kept
+ * in memory until finish is called.
+ */
+class WaveformSummaryWriter
+{
+public:
+  WaveformSummaryWriter(const WaveformSettings &settings = {});
+
+  bool open(const Path &path, int numberOfChannels, int sampleRate);
+  [[nodiscard]] bool isOpen() const { return this->file.is_open(); }
+
+  // Add the planar float samples. One pointer per channel with numberOfSamples samples each.
+  bool addSamples(std::span<const float *const> channels, std::size_t numberOfSamples);
+
+  // Write the remaining buckets and the header and close the file.
+  bool finish();
+
+private:
+  struct Level
+  {
+    std::vector<kernels::SampleStatistics> currentBucket{};
+    uint64_t                               samplesInCurrentBucket{};
+    unsigned                               childrenInCurrentBucket{};
+    uint64_t                               numberOfBuckets{};
+    ByteVector                             encodedBuckets{};
+  };
+
+  void addLevel();
+  void resetCurrentBucket(Level &level);
+  void finishBucket(std::size_t levelIndex);
+  bool writeLevel0Buffer(bool force);
+
+  using AccumulateFunction = void (*)(const float *, std::size_t, kernels::SampleStatistics &);
+
+  WaveformSettings   settings{};
+  AccumulateFunction accumulate{};
+
+  std::ofstream      file;
+  int                numberOfChannels{};
+  int                sampleRate{};
+  uint64_t           numberOfSamples{};
+  std::vector<Level> levels;
+};
+
+class WaveformSummaryReader
+{
+public:
+  WaveformSummaryReader() = default;
+
+  bool open(const Path &path);
+
+  [[nodiscard]] int      getNumberOfChannels() const { return this->numberOfChannels; }
+  [[nodiscard]] int      getSampleRate() const { return this->sampleRate; }
+  [[nodiscard]] uint64_t getNumberOfSamples() const { return this->numberOfSamples; }
+  [[nodiscard]] const std::vector<WaveformLevel> &getLevels() const { return this->levels; }
+
+  // The finest level that needs at most maxNumberOfBuckets buckets to cover numberOfSamples
+  // samples (e.g. the number of samples that are visible and the width in pixels).
+  [[nodiscard]] std::size_t selectLevel(uint64_t numberOfSamples,
+                                        uint64_t maxNumberOfBuckets) const;
+
+  // Read the buckets [firstBucket, firstBucket + numberOfBuckets) of the level. The vector is
+  // reused. It contains one entry per channel for each bucket.
+  bool readBuckets(std::size_t                  level,
+                   uint64_t                     firstBucket,
+                   uint64_t                     numberOfBuckets,
+                   std::vector<WaveformBucket> &buckets);
+
+private:
+  std::ifstream              file;
+  int                        numberOfChannels{};
+  int                        sampleRate{};
+  uint64_t                   numberOfSamples{};
+  std::vector<WaveformLevel> levels;
+  ByteVector                 readBuffer;
+};
+
+} // namespace libffmpeg::waveform
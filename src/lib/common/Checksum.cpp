@@ -0,0 +1,37 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "Checksum.h"
+
+#include "ChecksumKernels.h"
+
+namespace libffmpeg
+{
+
+CRC32C::CRC32C(const Implementation implementation)
+{
+  this->updateFunction = checksum::updateCRC32CScalar;
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  if ((implementation == Implementation::Auto || implementation == Implementation::SSE42) &&
+      getCpuFeatures().sse42)
+    this->updateFunction = checksum::updateCRC32CSSE42;
+#endif
+}
+
+void CRC32C::update(const std::span<const std::byte> data)
+{
+  if (!data.empty())
+    this->state = this->updateFunction(this->state, data.data(), data.size());
+}
+
+uint32_t calculateCRC32C(const std::span<const std::byte> data)
+{
+  CRC32C crc;
+  crc.update(data);
+  return crc.getValue();
+}
+
+} // namespace libffmpeg
@@ -0,0 +1,46 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace libffmpeg
+{
+
+/* CRC-32C (Castagnoli polynomial, as used by iSCSI and ext4). The SSE4.2 crc32 instruction is
+ * used if the CPU supports it. Otherwise a table based implementation is used. Both give identical
+ * results.
+ */
+class CRC32C
+{
+public:
+  enum class Implementation
+  {
+    Auto,
+    Scalar,
+    SSE42
+  };
+
+  // Selecting an implementation that is not supported falls back to Scalar.
+  CRC32C(const Implementation implementation = Implementation::Auto);
+
+  void update(std::span<const std::byte> data);
+
+  [[nodiscard]] uint32_t getValue() const { return ~this->state; }
+
+private:
+  using UpdateFunction = uint32_t (*)(uint32_t, const std::byte *, std::size_t);
+
+  UpdateFunction updateFunction{};
+  uint32_t       state{0xffffffff};
+};
+
+[[nodiscard]] uint32_t calculateCRC32C(std::span<const std::byte> data);
+
+} // namespace libffmpeg
@@ -0,0 +1,29 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/CpuFeatures.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/* The CRC32C kernels. These are internal to the library. The SSE4.2 kernel is compiled with the
+ * instruction set enabled (see LIBFFMPEG_BEGIN_KERNEL_TARGET) and must only be called if
+ * getCpuFeatures reports support. Both kernels give identical results.
+ */
+
+namespace libffmpeg::checksum
+{
+
+// Update the (inverted) CRC state with the data.
+uint32_t updateCRC32CScalar(uint32_t crc, const std::byte *data, std::size_t size);
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+uint32_t updateCRC32CSSE42(uint32_t crc, const std::byte *data, std::size_t size);
+#endif
+
+} // namespace libffmpeg::checksum
@@ -0,0 +1,41 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "ChecksumKernels.h"
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+
+#include <cstring>
+#include <nmmintrin.h>
+
+LIBFFMPEG_BEGIN_KERNEL_TARGET("sse4.2")
+
+namespace libffmpeg::checksum
+{
+
+uint32_t updateCRC32CSSE42(uint32_t crc, const std::byte *data, std::size_t size)
+{
+  uint64_t crc64 = crc;
+  while (size >= 8)
+  {
+    uint64_t value;
+    std::memcpy(&value, data, 8);
+    crc64 = _mm_crc32_u64(crc64, value);
+    data += 8;
+    size -= 8;
+  }
+
+  crc = static_cast<uint32_t>(crc64);
+  for (; size > 0; --size, ++data)
+    crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+  return crc;
+}
+
+} // namespace libffmpeg::checksum
+
+LIBFFMPEG_END_KERNEL_TARGET
+
+#endif
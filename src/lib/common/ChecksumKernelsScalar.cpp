@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "ChecksumKernels.h"
+
+#include <array>
+
+namespace libffmpeg::checksum
+{
+
+namespace
+{
+
+// The reversed Castagnoli polynomial
+constexpr uint32_t CRC32C_POLYNOMIAL = 0x82f63b78;
+
+// Slicing by 8. Table n contains the CRC of a byte followed by n zero bytes.
+constexpr std::array<std::array<uint32_t, 256>, 8> createTables()
+{
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (uint32_t i = 0; i < 256; ++i)
+  {
+    auto crc = i;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+    tables[0][i] = crc;
+  }
+  for (uint32_t i = 0; i < 256; ++i)
+    for (std::size_t table = 1; table < 8; ++table)
+      tables[table][i] = (tables[table - 1][i] >> 8) ^ tables[0][tables[table - 1][i] & 0xff];
+  return tables;
+}
+
+constexpr auto TABLES = createTables();
+
+uint32_t toUint(const std::byte byte)
+{
+  return static_cast<uint32_t>(byte);
+}
+
+} // namespace
+
+uint32_t updateCRC32CScalar(uint32_t crc, const std::byte *data, std::size_t size)
+{
+  while (size >= 8)
+  {
+    const auto low = crc ^ (toUint(data[0]) | (toUint(data[1]) << 8) | (toUint(data[2]) << 16) |
+                            (toUint(data[3]) << 24));
+    crc = TABLES[7][low & 0xff] ^ TABLES[6][(low >> 8) & 0xff] ^ TABLES[5][(low >> 16) & 0xff] ^
+          TABLES[4][low >> 24] ^ TABLES[3][toUint(data[4])] ^ TABLES[2][toUint(data[5])] ^
+          TABLES[1][toUint(data[6])] ^ TABLES[0][toUint(data[7])];
+    data += 8;
+    size -= 8;
+  }
+
+  for (; size > 0; --size, ++data)
+    crc = (crc >> 8) ^ TABLES[0][(crc ^ toUint(*data)) & 0xff];
+  return crc;
+}
+
+} // namespace libffmpeg::checksum
@@ -0,0 +1,59 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+CpuFeatures detectCpuFeatures()
+{
+  CpuFeatures features;
+
+#if defined(_MSC_VER) && defined(_M_X64)
+  int registers[4]{};
+  __cpuid(registers, 0);
+  const auto maxLeaf = registers[0];
+
+  __cpuid(registers, 1);
+  features.sse41 = (registers[2] & (1 << 19)) != 0;
+  features.sse42 = (registers[2] & (1 << 20)) != 0;
+
+  // OSXSAVE and AVX must be set and the OS must save the XMM and YMM registers
+  const auto osSavesAVXState = (registers[2] & (1 << 27)) != 0 &&
+                               (registers[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+  if (maxLeaf >= 7 && osSavesAVXState)
+  {
+    __cpuidex(registers, 7, 0);
+    features.avx2 = (registers[1] & (1 << 5)) != 0;
+  }
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+  __builtin_cpu_init();
+  features.sse41 = __builtin_cpu_supports("sse4.1");
+  features.sse42 = __builtin_cpu_supports("sse4.2");
+  features.avx2  = __builtin_cpu_supports("avx2");
+#endif
+
+  return features;
+}
+
+} // namespace
+
+CpuFeatures getCpuFeatures()
+{
+  static const auto features = detectCpuFeatures();
+  return features;
+}
+
+} // namespace libffmpeg
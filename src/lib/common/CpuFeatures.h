@@ -0,0 +1,49 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+// The SIMD kernels are only compiled for x86-64. Kernel files may include this header. It must
+// not contain any inline functions (see AVUtil/RGBConversionKernels.h).
+#if defined(__x86_64__) || defined(_M_X64)
+#define LIBFFMPEG_HAS_X86_KERNELS 1
+#endif
+
+// The kernel files are compiled without instruction set flags (like -mavx2) so that all build
+// systems (CMake and qmake) build them the same way. Instead, all functions between these macros
+// are compiled for the given instruction set. Place the begin macro after all includes so that no
+// inline functions from other headers are compiled for it. MSVC needs no flags for intrinsics.
+#define LIBFFMPEG_PRAGMA(pragma) _Pragma(#pragma)
+#if defined(__clang__)
+#define LIBFFMPEG_BEGIN_KERNEL_TARGET(instructionSet)                                              \
+  LIBFFMPEG_PRAGMA(clang attribute push(__attribute__((target(instructionSet))),                   \
+                                        apply_to = function))
+#define LIBFFMPEG_END_KERNEL_TARGET LIBFFMPEG_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+#define LIBFFMPEG_BEGIN_KERNEL_TARGET(instructionSet)                                              \
+  LIBFFMPEG_PRAGMA(GCC push_options) LIBFFMPEG_PRAGMA(GCC target(instructionSet))
+#define LIBFFMPEG_END_KERNEL_TARGET LIBFFMPEG_PRAGMA(GCC pop_options)
+#else
+#define LIBFFMPEG_BEGIN_KERNEL_TARGET(instructionSet)
+#define LIBFFMPEG_END_KERNEL_TARGET
+#endif
+
+namespace libffmpeg
+{
+
+// The instruction set extensions that the SIMD kernels of this library can use. Everything is
+// false if the library was not built for x86-64 (the kernels are not compiled in that case).
+struct CpuFeatures
+{
+  bool sse41{};
+  bool sse42{};
+  bool avx2{};
+};
+
+// Detected once on the first call. Also takes into account if the OS saves the AVX registers.
+[[nodiscard]] CpuFeatures getCpuFeatures();
+
+} // namespace libffmpeg
@@ -33,4 +33,9 @@ inline Rational fromAVRational(const internal::AVRational &avRational)
   return Rational({.numerator = avRational.num, .denominator = avRational.den});
 }
 
+inline internal::AVRational toAVRational(const Rational &rational)
+{
+  return internal::AVRational({.num = rational.numerator, .den = rational.denominator});
+}
+
 } // namespace libffmpeg
@@ -13,12 +13,15 @@ namespace libffmpeg::internal
 
 // Some opaque types so that we can handle pointers to them.
 // The implementation depends on the libraries version.
+class AVBSFContext;
+class AVBitStreamFilter;
 class AVBufferRef;
 class AVChapter;
 class AVClass;
 class AVCodec;
 class AVCodecDescriptor;
 class AVCodecInternal;
+class AVCodecParserContext;
 class AVCodecParameters;
 class AVDictionary;
 class AVFormatContext;
@@ -26,6 +29,7 @@ class AVFrame;
 class AVFrameSideData;
 class AVInputFormat;
 class AVIOContext;
+class AVOption;
 class AVOutputFormat;
 class AVPacket;
 class AVPacketSideData;
@@ -34,6 +38,9 @@ class AVProfile;
 class AVProgram;
 class AVStream;
 class AVStreamGroup;
+class SwrContext;
+class SwsContext;
+class SwsFilter;
 
 struct AVCodecContext;
 
@@ -296,4 +303,17 @@ struct AVDictionaryEntry
   char *value;
 };
 
+constexpr int AVINDEX_KEYFRAME      = 0x0001;
+constexpr int AVINDEX_DISCARD_FRAME = 0x0002;
+
+// This struct did not change between the FFmpeg versions
+struct AVIndexEntry
+{
+  int64_t pos;
+  int64_t timestamp;
+  int     flags : 2;
+  int     size : 30;
+  int     min_distance;
+};
+
 } // namespace libffmpeg::internal
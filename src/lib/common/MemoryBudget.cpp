@@ -0,0 +1,140 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "MemoryBudget.h"
+
+#include <algorithm>
+
+namespace libffmpeg
+{
+
+MemoryBudget::Reservation::Reservation(std::shared_ptr<MemoryBudget> budget,
+                                       const std::size_t             bytes)
+    : budget(budget), bytes(bytes)
+{
+}
+
+MemoryBudget::Reservation::Reservation(Reservation &&reservation) noexcept
+    : budget(std::move(reservation.budget)), bytes(reservation.bytes)
+{
+  reservation.bytes = 0;
+}
+
+MemoryBudget::Reservation &MemoryBudget::Reservation::operator=(Reservation &&reservation) noexcept
+{
+  if (this != &reservation)
+  {
+    this->release();
+    this->budget      = std::move(reservation.budget);
+    this->bytes       = reservation.bytes;
+    reservation.bytes = 0;
+  }
+  return *this;
+}
+
+MemoryBudget::Reservation::~Reservation()
+{
+  this->release();
+}
+
+void MemoryBudget::Reservation::release()
+{
+  if (this->budget)
+    this->budget->remove(this->bytes);
+  this->budget.reset();
+  this->bytes = 0;
+}
+
+MemoryBudget::MemoryBudget(const Settings settings, std::shared_ptr<MemoryBudget> parent)
+    : parent(parent), settings(settings)
+{
+}
+
+void MemoryBudget::setSettings(const Settings settings)
+{
+  {
+    std::scoped_lock lock(this->mutex);
+    this->settings = settings;
+  }
+  // The limit may have been increased
+  this->capacityAvailable.notify_all();
+}
+
+MemoryBudget::Settings MemoryBudget::getSettings() const
+{
+  std::scoped_lock lock(this->mutex);
+  return this->settings;
+}
+
+bool MemoryBudget::waitForCapacity()
+{
+  for (auto budget = this; budget != nullptr; budget = budget->parent.get())
+  {
+    if (!budget->waitForCapacityInThisBudget())
+      return false;
+  }
+  return true;
+}
+
+MemoryBudget::Reservation MemoryBudget::reserve(const std::size_t bytes)
+{
+  for (auto budget = this; budget != nullptr; budget = budget->parent.get())
+    budget->add(bytes);
+  return Reservation(this->shared_from_this(), bytes);
+}
+
+MemoryBudget::Usage MemoryBudget::getUsage() const
+{
+  std::scoped_lock lock(this->mutex);
+  return {this->currentBytes, this->peakBytes, this->settings.limitBytes};
+}
+
+bool MemoryBudget::isLimitReached() const
+{
+  std::scoped_lock lock(this->mutex);
+  return this->settings.limitBytes > 0 && this->currentBytes >= this->settings.limitBytes;
+}
+
+void MemoryBudget::add(const std::size_t bytes)
+{
+  std::scoped_lock lock(this->mutex);
+  this->currentBytes += bytes;
+  this->peakBytes = std::max(this->peakBytes, this->currentBytes);
+}
+
+void MemoryBudget::remove(const std::size_t bytes)
+{
+  for (auto budget = this; budget != nullptr; budget = budget->parent.get())
+  {
+    {
+      std::scoped_lock lock(budget->mutex);
+      budget->currentBytes -= std::min(bytes, budget->currentBytes);
+    }
+    budget->capacityAvailable.notify_all();
+  }
+}
+
+bool MemoryBudget::waitForCapacityInThisBudget()
+{
+  std::unique_lock lock(this->mutex);
+
+  const auto hasCapacity = [this]()
+  { return this->settings.limitBytes == 0 || this->currentBytes < this->settings.limitBytes; };
+
+  if (hasCapacity())
+    return true;
+  if (this->settings.policy == Policy::Fail)
+    return false;
+
+  if (this->settings.blockTimeout.count() == 0)
+  {
+    this->capacityAvailable.wait(lock, hasCapacity);
+    return true;
+  }
+  return this->capacityAvailable.wait_for(lock, this->settings.blockTimeout, hasCapacity);
+}
+
+} // namespace libffmpeg
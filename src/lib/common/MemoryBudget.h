@@ -0,0 +1,105 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace libffmpeg
+{
+
+/* Accounting of the memory that is held by frames and packets. Every library instance has one
+ * budget (see IFFmpegLibraries::getMemoryBudget). Additional budgets (e.g. one per pipeline) can
+ * be created with the library budget as parent. Bytes that are reserved in a budget are also
+ * reserved in all parents.
+ *
+ * The limit is a soft limit. Before a new frame / packet is created, the Decoder / Demuxer check
+ * that the usage is below the limit (waitForCapacity). Depending on the policy this blocks until
+ * enough memory was released or fails right away. The frame / packet is accounted after it was
+ * created so the usage can exceed the limit by one frame / packet.
+ */
+class MemoryBudget : public std::enable_shared_from_this<MemoryBudget>
+{
+public:
+  enum class Policy
+  {
+    // Block until the usage drops below the limit (or until the timeout expired)
+    Block,
+    // Fail immediately if the usage is above the limit
+    Fail
+  };
+
+  struct Settings
+  {
+    // A limit of 0 means that the usage is only tracked but not limited.
+    std::size_t               limitBytes{};
+    Policy                    policy{Policy::Block};
+    std::chrono::milliseconds blockTimeout{}; // 0 means wait forever
+  };
+
+  struct Usage
+  {
+    std::size_t currentBytes{};
+    std::size_t peakBytes{};
+    std::size_t limitBytes{};
+  };
+
+  // Releases the reserved bytes when it is destroyed.
+  class Reservation
+  {
+  public:
+    Reservation() = default;
+    Reservation(std::shared_ptr<MemoryBudget> budget, const std::size_t bytes);
+    Reservation(const Reservation &)            = delete;
+    Reservation &operator=(const Reservation &) = delete;
+    Reservation(Reservation &&reservation) noexcept;
+    Reservation &operator=(Reservation &&reservation) noexcept;
+    ~Reservation();
+
+    [[nodiscard]] std::size_t getBytes() const { return this->bytes; }
+
+  private:
+    void release();
+
+    std::shared_ptr<MemoryBudget> budget{};
+    std::size_t                   bytes{};
+  };
+
+  MemoryBudget() = default;
+  MemoryBudget(const Settings settings, std::shared_ptr<MemoryBudget> parent = {});
+
+  void                   setSettings(const Settings settings);
+  [[nodiscard]] Settings getSettings() const;
+
+  // Check that there is capacity for a new frame / packet in this budget and all parents.
+  // Returns false if the policy is Fail and the limit is reached or if the timeout expired.
+  [[nodiscard]] bool waitForCapacity();
+
+  // Account the given number of bytes in this budget and all parents. The limit is not checked.
+  [[nodiscard]] Reservation reserve(const std::size_t bytes);
+
+  [[nodiscard]] Usage getUsage() const;
+  [[nodiscard]] bool  isLimitReached() const;
+
+private:
+  void add(const std::size_t bytes);
+  void remove(const std::size_t bytes);
+  bool waitForCapacityInThisBudget();
+
+  std::shared_ptr<MemoryBudget> parent{};
+
+  mutable std::mutex      mutex;
+  std::condition_variable capacityAvailable;
+  Settings                settings{};
+  std::size_t             currentBytes{};
+  std::size_t             peakBytes{};
+};
+
+} // namespace libffmpeg
@@ -59,12 +59,14 @@ struct LibraryVersions
   Version       avcodec{};
   Version       avutil{};
   Version       swresample{};
+  Version       swscale{};
 };
 
 using VersionAVFormat   = Version;
 using VersionAVCodec    = Version;
 using VersionAVUtil     = Version;
 using VersionSwresample = Version;
+using VersionSwscale    = Version;
 
 // These FFmpeg versions are supported. The numbers indicate the major versions.
 // The versions are sorted from newest to oldest, so that we try to open the newest ones first.
@@ -73,36 +75,43 @@ constexpr auto SupportedFFmpegVersions = {
                      .avformat      = VersionAVFormat(62),
                      .avcodec       = VersionAVCodec(62),
                      .avutil        = VersionAVUtil(60),
-                     .swresample    = VersionSwresample(6)}),
+                     .swresample    = VersionSwresample(6),
+                     .swscale       = VersionSwscale(9)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_7x,
                      .avformat      = VersionAVFormat(61),
                      .avcodec       = VersionAVCodec(61),
                      .avutil        = VersionAVUtil(59),
-                     .swresample    = VersionSwresample(5)}),
+                     .swresample    = VersionSwresample(5),
+                     .swscale       = VersionSwscale(8)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_6x,
                      .avformat      = VersionAVFormat(60),
                      .avcodec       = VersionAVCodec(60),
                      .avutil        = VersionAVUtil(58),
-                     .swresample    = VersionSwresample(4)}),
+                     .swresample    = VersionSwresample(4),
+                     .swscale       = VersionSwscale(7)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_5x,
                      .avformat      = VersionAVFormat(59),
                      .avcodec       = VersionAVCodec(59),
                      .avutil        = VersionAVUtil(57),
-                     .swresample    = VersionSwresample(4)}),
+                     .swresample    = VersionSwresample(4),
+                     .swscale       = VersionSwscale(6)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_4x,
                      .avformat      = VersionAVFormat(58),
                      .avcodec       = VersionAVCodec(58),
                      .avutil        = VersionAVUtil(56),
-                     .swresample    = VersionSwresample(3)}),
+                     .swresample    = VersionSwresample(3),
+                     .swscale       = VersionSwscale(5)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_3x,
                      .avformat      = VersionAVFormat(57),
                      .avcodec       = VersionAVCodec(57),
                      .avutil        = VersionAVUtil(55),
-                     .swresample    = VersionSwresample(2)}),
+                     .swresample    = VersionSwresample(2),
+                     .swscale       = VersionSwscale(4)}),
     LibraryVersions({.ffmpegVersion = FFmpegVersion::FFmpeg_2x,
                      .avformat      = VersionAVFormat(56),
                      .avcodec       = VersionAVCodec(56),
                      .avutil        = VersionAVUtil(54),
-                     .swresample    = VersionSwresample(1)})};
+                     .swresample    = VersionSwresample(1),
+                     .swscale       = VersionSwscale(3)})};
 
 } // namespace libffmpeg
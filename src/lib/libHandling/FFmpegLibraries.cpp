@@ -127,6 +127,14 @@ bool FFmpegLibraries::tryLoadLibrariesBindFunctionsAndCheckVersions(const Path &
       !this->tryLoadBindAndCheckAVFormat(directory, versions.avformat))
     return false;
 
+  // Swscale is optional. Everything except scaling works without it.
+  if (!this->tryLoadBindAndCheckSWScale(directory, versions.swscale))
+  {
+    this->log(LogLevel::Info, "Loading of swscale failed. Scaling of frames is not available.");
+    this->libSwscale.unload();
+    this->swscale = {};
+  }
+
   this->getLibraryVersionsFromLoadedLibraries();
   this->connectAVLoggingCallback();
 
@@ -196,6 +204,21 @@ bool FFmpegLibraries::tryLoadBindAndCheckAVFormat(const Path &directory, const V
       "avformat", this->avformat.avformat_version(), version, this->loggingFunction);
 }
 
+bool FFmpegLibraries::tryLoadBindAndCheckSWScale(const Path &directory, const Version version)
+{
+  if (!this->tryLoadLibraryInPath(this->libSwscale, directory, "swscale", version))
+    return false;
+
+  if (const auto functions = internal::functions::tryBindSwScaleFunctionsFromLibrary(
+          this->libSwscale, this->loggingFunction))
+    this->swscale = functions.value();
+  else
+    return false;
+
+  return checkLibraryVersion(
+      "swscale", this->swscale.swscale_version(), version, this->loggingFunction);
+}
+
 bool FFmpegLibraries::tryLoadLibraryInPath(SharedLibraryLoader &lib,
                                            const Path          &directory,
                                            const std::string   &libName,
@@ -243,6 +266,8 @@ void FFmpegLibraries::unloadAllLibraries()
   this->libSwresample.unload();
   this->libAvcodec.unload();
   this->libAvformat.unload();
+  this->libSwscale.unload();
+  this->swscale = {};
 }
 
 std::vector<LibraryInfo> FFmpegLibraries::getLibrariesInfo() const
@@ -266,6 +291,9 @@ std::vector<LibraryInfo> FFmpegLibraries::getLibrariesInfo() const
   addLibraryInfo("AVUtil", this->libAvutil.getLibraryPath(), this->avutil.avutil_version());
   addLibraryInfo(
       "SwResample", this->libSwresample.getLibraryPath(), this->swresample.swresample_version());
+  if (this->libSwscale)
+    addLibraryInfo(
+        "SwScale", this->libSwscale.getLibraryPath(), this->swscale.swscale_version());
 
   return infoPerLIbrary;
 }
@@ -299,6 +327,9 @@ void FFmpegLibraries::getLibraryVersionsFromLoadedLibraries()
   this->libraryVersions.avformat = Version::fromFFmpegVersion(this->avformat.avformat_version());
   this->libraryVersions.swresample =
       Version::fromFFmpegVersion(this->swresample.swresample_version());
+  this->libraryVersions.swscale = this->isSwScaleAvailable()
+                                      ? Version::fromFFmpegVersion(this->swscale.swscale_version())
+                                      : Version();
 }
 
 void FFmpegLibraries::connectAVLoggingCallback()
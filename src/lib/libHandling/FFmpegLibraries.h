@@ -43,6 +43,7 @@ private:
   [[nodiscard]] bool tryLoadBindAndCheckSWResample(const Path &directory, const Version version);
   [[nodiscard]] bool tryLoadBindAndCheckAVCodec(const Path &directory, const Version version);
   [[nodiscard]] bool tryLoadBindAndCheckAVFormat(const Path &directory, const Version version);
+  [[nodiscard]] bool tryLoadBindAndCheckSWScale(const Path &directory, const Version version);
 
   [[nodiscard]] bool tryLoadLibraryInPath(SharedLibraryLoader &lib,
                                           const Path          &directory,
@@ -55,6 +56,7 @@ private:
   SharedLibraryLoader libSwresample;
   SharedLibraryLoader libAvcodec;
   SharedLibraryLoader libAvformat;
+  SharedLibraryLoader libSwscale;
 
   LibraryVersions libraryVersions{};
   void            getLibraryVersionsFromLoadedLibraries();
@@ -7,12 +7,14 @@
 #pragma once
 
 #include <common/Logging.h>
+#include <common/MemoryBudget.h>
 #include <common/Types.h>
 #include <common/Version.h>
 #include <libHandling/libraryFunctions/AVFormatFunctions.h>
 #include <libHandling/libraryFunctions/AvCodecFunctions.h>
 #include <libHandling/libraryFunctions/AvUtilFunctions.h>
 #include <libHandling/libraryFunctions/SwResampleFunctions.h>
+#include <libHandling/libraryFunctions/SwScaleFunctions.h>
 
 #include <filesystem>
 #include <string>
@@ -38,10 +40,24 @@ public:
 
   virtual void log(const LogLevel logLevel, const std::string &message) const = 0;
 
+  // Accounts the memory of all frames and packets that are created by the Decoder / Demuxer
+  // using this library instance.
+  [[nodiscard]] std::shared_ptr<MemoryBudget> getMemoryBudget() const { return this->memoryBudget; }
+
+  // The swscale library is optional. If it could not be loaded, all swscale functions are empty.
+  [[nodiscard]] bool isSwScaleAvailable() const
+  {
+    return static_cast<bool>(this->swscale.sws_scale);
+  }
+
   internal::functions::AvFormatFunctions   avformat{};
   internal::functions::AvCodecFunctions    avcodec{};
   internal::functions::AvUtilFunctions     avutil{};
   internal::functions::SwResampleFunctions swresample{};
+  internal::functions::SwScaleFunctions    swscale{};
+
+private:
+  std::shared_ptr<MemoryBudget> memoryBudget{std::make_shared<MemoryBudget>()};
 };
 
 } // namespace libffmpeg
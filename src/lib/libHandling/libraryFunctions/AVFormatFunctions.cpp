@@ -35,6 +35,16 @@ std::optional<AvFormatFunctions> tryBindAVFormatFunctionsFromLibrary(const Share
   lib.tryResolveFunction(functions.av_seek_frame, "av_seek_frame");
   lib.tryResolveFunction(functions.avio_alloc_context, "avio_alloc_context");
   lib.tryResolveFunction(functions.avio_context_free, "avio_context_free");
+  lib.tryResolveFunction(functions.avformat_alloc_output_context2,
+                         "avformat_alloc_output_context2");
+  lib.tryResolveFunction(functions.avformat_free_context, "avformat_free_context");
+  lib.tryResolveFunction(functions.avformat_new_stream, "avformat_new_stream");
+  lib.tryResolveFunction(functions.avformat_write_header, "avformat_write_header");
+  lib.tryResolveFunction(functions.av_interleaved_write_frame, "av_interleaved_write_frame");
+  lib.tryResolveFunction(functions.av_write_trailer, "av_write_trailer");
+  lib.tryResolveFunction(functions.avformat_index_get_entries_count,
+                         "avformat_index_get_entries_count");
+  lib.tryResolveFunction(functions.avformat_index_get_entry, "avformat_index_get_entry");
 
   std::vector<std::string> missingFunctions;
 
@@ -69,6 +79,29 @@ std::optional<AvFormatFunctions> tryBindAVFormatFunctionsFromLibrary(const Share
   if (version.major > 56)
     checkForMissingFunctionAndLog(
       functions.avio_context_free, "avio_context_free", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.avformat_alloc_output_context2,
+                                "avformat_alloc_output_context2",
+                                missingFunctions,
+                                log);
+  checkForMissingFunctionAndLog(
+      functions.avformat_free_context, "avformat_free_context", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.avformat_new_stream, "avformat_new_stream", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.avformat_write_header, "avformat_write_header", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_interleaved_write_frame, "av_interleaved_write_frame", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_write_trailer, "av_write_trailer", missingFunctions, log);
+  if (version.major >= 59)
+  {
+    checkForMissingFunctionAndLog(functions.avformat_index_get_entries_count,
+                                  "avformat_index_get_entries_count",
+                                  missingFunctions,
+                                  log);
+    checkForMissingFunctionAndLog(
+        functions.avformat_index_get_entry, "avformat_index_get_entry", missingFunctions, log);
+  }
 
   if (!missingFunctions.empty())
   {
@@ -41,6 +41,22 @@ struct AvFormatFunctions
                               SeekFunction        *seek)>
                                         avio_alloc_context;
   std::function<void(AVIOContext **ps)> avio_context_free;
+
+  // Muxing
+  std::function<int(AVFormatContext     **ctx,
+                    const AVOutputFormat *oformat,
+                    const char           *format_name,
+                    const char           *filename)>
+                                                                  avformat_alloc_output_context2;
+  std::function<void(AVFormatContext *s)>                         avformat_free_context;
+  std::function<AVStream *(AVFormatContext *s, const AVCodec *c)> avformat_new_stream;
+  std::function<int(AVFormatContext *s, AVDictionary **options)>  avformat_write_header;
+  std::function<int(AVFormatContext *s, AVPacket *pkt)>           av_interleaved_write_frame;
+  std::function<int(AVFormatContext *s)>                          av_write_trailer;
+
+  // Since avformat 58.78 (FFmpeg 4.4). Before, the index is only accessible in the AVStream.
+  std::function<int(const AVStream *st)>                     avformat_index_get_entries_count;
+  std::function<const AVIndexEntry *(AVStream *st, int idx)> avformat_index_get_entry;
 };
 
 std::optional<AvFormatFunctions> tryBindAVFormatFunctionsFromLibrary(const SharedLibraryLoader &lib,
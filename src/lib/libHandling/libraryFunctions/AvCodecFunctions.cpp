@@ -34,6 +34,13 @@ std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedL
   lib.tryResolveFunction(functions.avcodec_version, "avcodec_version");
   lib.tryResolveFunction(functions.avcodec_get_name, "avcodec_get_name");
   lib.tryResolveFunction(functions.avcodec_descriptor_get, "avcodec_descriptor_get");
+  lib.tryResolveFunction(functions.avcodec_align_dimensions2, "avcodec_align_dimensions2");
+  lib.tryResolveFunction(functions.avcodec_default_get_buffer2, "avcodec_default_get_buffer2");
+  lib.tryResolveFunction(functions.av_packet_rescale_ts, "av_packet_rescale_ts");
+  lib.tryResolveFunction(functions.avcodec_find_decoder_by_name, "avcodec_find_decoder_by_name");
+  lib.tryResolveFunction(functions.av_parser_init, "av_parser_init");
+  lib.tryResolveFunction(functions.av_parser_parse2, "av_parser_parse2");
+  lib.tryResolveFunction(functions.av_parser_close, "av_parser_close");
 
   checkForMissingFunctionAndLog(
       functions.avcodec_find_decoder, "avcodec_find_decoder", missingFunctions, log);
@@ -51,6 +58,21 @@ std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedL
       functions.avcodec_get_name, "avcodec_get_name", missingFunctions, log);
   checkForMissingFunctionAndLog(
       functions.avcodec_descriptor_get, "avcodec_descriptor_get", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.avcodec_align_dimensions2, "avcodec_align_dimensions2", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.avcodec_default_get_buffer2, "avcodec_default_get_buffer2", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_packet_rescale_ts, "av_packet_rescale_ts", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.avcodec_find_decoder_by_name,
+                                "avcodec_find_decoder_by_name",
+                                missingFunctions,
+                                log);
+  checkForMissingFunctionAndLog(functions.av_parser_init, "av_parser_init", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_parser_parse2, "av_parser_parse2", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_parser_close, "av_parser_close", missingFunctions, log);
 
   if (avCodecVersion.major >= 57)
   {
@@ -61,10 +83,19 @@ std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedL
     lib.tryResolveFunction(functions.avcodec_parameters_alloc, "avcodec_parameters_alloc");
     lib.tryResolveFunction(functions.av_packet_alloc, "av_packet_alloc");
     lib.tryResolveFunction(functions.av_packet_free, "av_packet_free");
+    lib.tryResolveFunction(functions.av_packet_unref, "av_packet_unref");
     lib.tryResolveFunction(functions.avcodec_send_packet, "avcodec_send_packet");
     lib.tryResolveFunction(functions.avcodec_receive_frame, "avcodec_receive_frame");
     lib.tryResolveFunction(functions.avcodec_parameters_to_context,
                            "avcodec_parameters_to_context");
+    lib.tryResolveFunction(functions.avcodec_parameters_copy, "avcodec_parameters_copy");
+    lib.tryResolveFunction(functions.av_bsf_get_by_name, "av_bsf_get_by_name");
+    lib.tryResolveFunction(functions.av_bsf_alloc, "av_bsf_alloc");
+    lib.tryResolveFunction(functions.av_bsf_init, "av_bsf_init");
+    lib.tryResolveFunction(functions.av_bsf_send_packet, "av_bsf_send_packet");
+    lib.tryResolveFunction(functions.av_bsf_receive_packet, "av_bsf_receive_packet");
+    lib.tryResolveFunction(functions.av_bsf_flush, "av_bsf_flush");
+    lib.tryResolveFunction(functions.av_bsf_free, "av_bsf_free");
 
     checkForMissingFunctionAndLog(
         functions.avcodec_parameters_alloc, "avcodec_parameters_alloc", missingFunctions, log);
@@ -72,6 +103,8 @@ std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedL
         functions.av_packet_alloc, "av_packet_alloc", missingFunctions, log);
     checkForMissingFunctionAndLog(
         functions.av_packet_free, "av_packet_free", missingFunctions, log);
+    checkForMissingFunctionAndLog(
+        functions.av_packet_unref, "av_packet_unref", missingFunctions, log);
     checkForMissingFunctionAndLog(
         functions.avcodec_send_packet, "avcodec_send_packet", missingFunctions, log);
     checkForMissingFunctionAndLog(
@@ -80,6 +113,18 @@ std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedL
                                   "avcodec_parameters_to_context",
                                   missingFunctions,
                                   log);
+    checkForMissingFunctionAndLog(
+        functions.avcodec_parameters_copy, "avcodec_parameters_copy", missingFunctions, log);
+    checkForMissingFunctionAndLog(
+        functions.av_bsf_get_by_name, "av_bsf_get_by_name", missingFunctions, log);
+    checkForMissingFunctionAndLog(functions.av_bsf_alloc, "av_bsf_alloc", missingFunctions, log);
+    checkForMissingFunctionAndLog(functions.av_bsf_init, "av_bsf_init", missingFunctions, log);
+    checkForMissingFunctionAndLog(
+        functions.av_bsf_send_packet, "av_bsf_send_packet", missingFunctions, log);
+    checkForMissingFunctionAndLog(
+        functions.av_bsf_receive_packet, "av_bsf_receive_packet", missingFunctions, log);
+    checkForMissingFunctionAndLog(functions.av_bsf_flush, "av_bsf_flush", missingFunctions, log);
+    checkForMissingFunctionAndLog(functions.av_bsf_free, "av_bsf_free", missingFunctions, log);
     functions.newParametersAPIAvailable = true;
   }
   else
@@ -27,6 +27,25 @@ struct AvCodecFunctions
   std::function<unsigned()>                                              avcodec_version;
   std::function<const char *(AVCodecID)>                                 avcodec_get_name;
   std::function<const AVCodecDescriptor *(AVCodecID)>                    avcodec_descriptor_get;
+  std::function<void(AVCodecContext *, int *width, int *height, int linesize_align[])>
+                                                                        avcodec_align_dimensions2;
+  std::function<int(AVCodecContext *, AVFrame *, int flags)>            avcodec_default_get_buffer2;
+  std::function<void(AVPacket *, AVRational tb_src, AVRational tb_dst)> av_packet_rescale_ts;
+
+  // Bitstream parsers
+  std::function<AVCodec *(const char *)>             avcodec_find_decoder_by_name;
+  std::function<AVCodecParserContext *(int codecID)> av_parser_init;
+  std::function<int(AVCodecParserContext *,
+                    AVCodecContext *,
+                    uint8_t      **poutbuf,
+                    int           *poutbuf_size,
+                    const uint8_t *buf,
+                    int            buf_size,
+                    int64_t        pts,
+                    int64_t        dts,
+                    int64_t        pos)>
+                                              av_parser_parse2;
+  std::function<void(AVCodecParserContext *)> av_parser_close;
 
   // FFmpeg Version 2.x (avcodec 56)
   std::function<void(AVPacket *pkt)>                                       av_free_packet;
@@ -37,10 +56,21 @@ struct AvCodecFunctions
   std::function<AVCodecParameters *()>                            avcodec_parameters_alloc;
   std::function<AVPacket *()>                                     av_packet_alloc;
   std::function<void(AVPacket **)>                                av_packet_free;
+  std::function<void(AVPacket *)>                                 av_packet_unref;
   bool                                                            newParametersAPIAvailable{};
   std::function<int(AVCodecContext *, const AVPacket *)>          avcodec_send_packet;
   std::function<int(AVCodecContext *, AVFrame *)>                 avcodec_receive_frame;
   std::function<int(AVCodecContext *, const AVCodecParameters *)> avcodec_parameters_to_context;
+
+  // Bitstream filters (FFmpeg >= 3.x, avcodec >= 57)
+  std::function<int(AVCodecParameters *, const AVCodecParameters *)> avcodec_parameters_copy;
+  std::function<const AVBitStreamFilter *(const char *)>             av_bsf_get_by_name;
+  std::function<int(const AVBitStreamFilter *, AVBSFContext **)>     av_bsf_alloc;
+  std::function<int(AVBSFContext *)>                                 av_bsf_init;
+  std::function<int(AVBSFContext *, AVPacket *)>                     av_bsf_send_packet;
+  std::function<int(AVBSFContext *, AVPacket *)>                     av_bsf_receive_packet;
+  std::function<void(AVBSFContext *)>                                av_bsf_flush;
+  std::function<void(AVBSFContext **)>                               av_bsf_free;
 };
 
 std::optional<AvCodecFunctions> tryBindAVCodecFunctionsFromLibrary(const SharedLibraryLoader &lib,
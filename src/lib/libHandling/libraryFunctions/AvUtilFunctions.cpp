@@ -28,18 +28,29 @@ std::optional<AvUtilFunctions> tryBindAVUtilFunctionsFromLibrary(const SharedLib
   lib.tryResolveFunction(functions.avutil_version, "avutil_version");
   lib.tryResolveFunction(functions.av_frame_alloc, "av_frame_alloc");
   lib.tryResolveFunction(functions.av_frame_free, "av_frame_free");
+  lib.tryResolveFunction(functions.av_frame_ref, "av_frame_ref");
   lib.tryResolveFunction(functions.av_mallocz, "av_mallocz");
   lib.tryResolveFunction(functions.av_freep, "av_freep");
   lib.tryResolveFunction(functions.av_dict_set, "av_dict_set");
   lib.tryResolveFunction(functions.av_dict_get, "av_dict_get");
+  lib.tryResolveFunction(functions.av_dict_free, "av_dict_free");
   lib.tryResolveFunction(functions.av_frame_get_side_data, "av_frame_get_side_data");
   lib.tryResolveFunction(functions.av_frame_get_metadata, "av_frame_get_metadata");
+  lib.tryResolveFunction(functions.av_frame_get_sample_rate, "av_frame_get_sample_rate");
+  lib.tryResolveFunction(functions.av_frame_get_channel_layout, "av_frame_get_channel_layout");
+  lib.tryResolveFunction(functions.av_frame_get_channels, "av_frame_get_channels");
+  lib.tryResolveFunction(functions.av_get_default_channel_layout, "av_get_default_channel_layout");
   lib.tryResolveFunction(functions.av_log_set_callback, "av_log_set_callback");
   lib.tryResolveFunction(functions.av_log_default_callback, "av_log_default_callback");
   lib.tryResolveFunction(functions.av_log_set_level, "av_log_set_level");
   lib.tryResolveFunction(functions.av_pix_fmt_desc_get, "av_pix_fmt_desc_get");
   lib.tryResolveFunction(functions.av_pix_fmt_desc_next, "av_pix_fmt_desc_next");
   lib.tryResolveFunction(functions.av_pix_fmt_desc_get_id, "av_pix_fmt_desc_get_id");
+  lib.tryResolveFunction(functions.av_buffer_create, "av_buffer_create");
+  lib.tryResolveFunction(functions.av_image_fill_linesizes, "av_image_fill_linesizes");
+  lib.tryResolveFunction(functions.av_image_fill_pointers, "av_image_fill_pointers");
+  lib.tryResolveFunction(functions.av_opt_find, "av_opt_find");
+  lib.tryResolveFunction(functions.av_opt_set_int, "av_opt_set_int");
 
   std::vector<std::string> missingFunctions;
 
@@ -55,16 +66,34 @@ std::optional<AvUtilFunctions> tryBindAVUtilFunctionsFromLibrary(const SharedLib
   checkForMissingFunctionAndLog(functions.av_frame_alloc, "av_frame_alloc", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_frame_free, "av_frame_free", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_frame_free, "av_frame_free", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.av_frame_ref, "av_frame_ref", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_mallocz, "av_mallocz", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_freep, "av_freep", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_dict_set, "av_dict_set", missingFunctions, log);
   checkForMissingFunctionAndLog(functions.av_dict_get, "av_dict_get", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.av_dict_free, "av_dict_free", missingFunctions, log);
   checkForMissingFunctionAndLog(
       functions.av_frame_get_side_data, "av_frame_get_side_data", missingFunctions, log);
 
   if (version.major < 57)
+  {
     checkForMissingFunctionAndLog(
         functions.av_frame_get_metadata, "av_frame_get_metadata", missingFunctions, log);
+    checkForMissingFunctionAndLog(
+        functions.av_frame_get_sample_rate, "av_frame_get_sample_rate", missingFunctions, log);
+    checkForMissingFunctionAndLog(functions.av_frame_get_channel_layout,
+                                  "av_frame_get_channel_layout",
+                                  missingFunctions,
+                                  log);
+    checkForMissingFunctionAndLog(
+        functions.av_frame_get_channels, "av_frame_get_channels", missingFunctions, log);
+  }
+
+  if (version.major < 59)
+    checkForMissingFunctionAndLog(functions.av_get_default_channel_layout,
+                                  "av_get_default_channel_layout",
+                                  missingFunctions,
+                                  log);
 
   checkForMissingFunctionAndLog(
       functions.av_log_set_callback, "av_log_set_callback", missingFunctions, log);
@@ -78,6 +107,15 @@ std::optional<AvUtilFunctions> tryBindAVUtilFunctionsFromLibrary(const SharedLib
       functions.av_pix_fmt_desc_next, "av_pix_fmt_desc_next", missingFunctions, log);
   checkForMissingFunctionAndLog(
       functions.av_pix_fmt_desc_get_id, "av_pix_fmt_desc_get_id", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_buffer_create, "av_buffer_create", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_image_fill_linesizes, "av_image_fill_linesizes", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_image_fill_pointers, "av_image_fill_pointers", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.av_opt_find, "av_opt_find", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.av_opt_set_int, "av_opt_set_int", missingFunctions, log);
 
   if (!missingFunctions.empty())
   {
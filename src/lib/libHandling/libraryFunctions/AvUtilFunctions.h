@@ -16,15 +16,17 @@ namespace libffmpeg::internal::functions
 
 struct AvUtilFunctions
 {
-  std::function<unsigned()>            avutil_version;
-  std::function<AVFrame *()>           av_frame_alloc;
-  std::function<void(AVFrame **frame)> av_frame_free;
-  std::function<void *(size_t size)>   av_mallocz;
-  std::function<void(void *ptr)>       av_freep;
+  std::function<unsigned()>                            avutil_version;
+  std::function<AVFrame *()>                           av_frame_alloc;
+  std::function<void(AVFrame **frame)>                 av_frame_free;
+  std::function<int(AVFrame *dst, const AVFrame *src)> av_frame_ref;
+  std::function<void *(size_t size)>                   av_mallocz;
+  std::function<void(void *ptr)>                       av_freep;
   std::function<int(AVDictionary **pm, const char *key, const char *value, int flags)> av_dict_set;
   std::function<AVDictionaryEntry *(
       AVDictionary *m, const char *key, const AVDictionaryEntry *prev, int flags)>
       av_dict_get;
+  std::function<void(AVDictionary **pm)> av_dict_free;
   std::function<AVFrameSideData *(const AVFrame *frame, AVFrameSideDataType type)>
                                                                             av_frame_get_side_data;
   std::function<AVDictionary *(const AVFrame *frame)>                       av_frame_get_metadata;
@@ -34,6 +36,26 @@ struct AvUtilFunctions
   std::function<const AVPixFmtDescriptor *(AVPixelFormat pix_fmt)>          av_pix_fmt_desc_get;
   std::function<const AVPixFmtDescriptor *(const AVPixFmtDescriptor *prev)> av_pix_fmt_desc_next;
   std::function<AVPixelFormat(const AVPixFmtDescriptor *desc)>              av_pix_fmt_desc_get_id;
+  std::function<AVBufferRef *(uint8_t *data,
+                              size_t   size,
+                              void (*free)(void *opaque, uint8_t *data),
+                              void    *opaque,
+                              int      flags)>
+      av_buffer_create;
+  std::function<int(int linesizes[4], AVPixelFormat pix_fmt, int width)> av_image_fill_linesizes;
+  std::function<int(
+      uint8_t *data[4], AVPixelFormat pix_fmt, int height, uint8_t *ptr, const int linesizes[4])>
+      av_image_fill_pointers;
+  std::function<const AVOption *(
+      void *obj, const char *name, const char *unit, int opt_flags, int search_flags)>
+      av_opt_find;
+  std::function<int(void *obj, const char *name, int64_t val, int search_flags)> av_opt_set_int;
+
+  // The audio frame getters were removed in avutil 57. The old channel layout API in avutil 59.
+  std::function<int(const AVFrame *frame)>     av_frame_get_sample_rate;
+  std::function<int64_t(const AVFrame *frame)> av_frame_get_channel_layout;
+  std::function<int(const AVFrame *frame)>     av_frame_get_channels;
+  std::function<int64_t(int nb_channels)>      av_get_default_channel_layout;
 };
 
 std::optional<AvUtilFunctions> tryBindAVUtilFunctionsFromLibrary(const SharedLibraryLoader &lib,
@@ -7,6 +7,7 @@
 #include "SwResampleFunctions.h"
 
 #include <common/Formatting.h>
+#include <common/Version.h>
 
 #include "Functions.h"
 
@@ -25,11 +26,39 @@ tryBindSwResampleFunctionsFromLibrary(const SharedLibraryLoader &lib, const Logg
   SwResampleFunctions functions;
 
   lib.tryResolveFunction(functions.swresample_version, "swresample_version");
+  lib.tryResolveFunction(functions.swr_alloc_set_opts, "swr_alloc_set_opts");
+  lib.tryResolveFunction(functions.swr_alloc_set_opts2, "swr_alloc_set_opts2");
+  lib.tryResolveFunction(functions.swr_init, "swr_init");
+  lib.tryResolveFunction(functions.swr_convert, "swr_convert");
+  lib.tryResolveFunction(functions.swr_get_delay, "swr_get_delay");
+  lib.tryResolveFunction(functions.swr_free, "swr_free");
 
   std::vector<std::string> missingFunctions;
 
   checkForMissingFunctionAndLog(
       functions.swresample_version, "swresample_version", missingFunctions, log);
+  if (!functions.swresample_version)
+  {
+    log(LogLevel::Error,
+        "Binding swResample functions failed. Missing function swresample_version");
+    return {};
+  }
+
+  const auto version = Version::fromFFmpegVersion(functions.swresample_version());
+
+  // Only one of the two functions is needed. Older versions of swresample 4 do not have the new
+  // function and in version 5 the old one was removed.
+  if (version.major < 5)
+    checkForMissingFunctionAndLog(
+        functions.swr_alloc_set_opts, "swr_alloc_set_opts", missingFunctions, log);
+  else
+    checkForMissingFunctionAndLog(
+        functions.swr_alloc_set_opts2, "swr_alloc_set_opts2", missingFunctions, log);
+
+  checkForMissingFunctionAndLog(functions.swr_init, "swr_init", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.swr_convert, "swr_convert", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.swr_get_delay, "swr_get_delay", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.swr_free, "swr_free", missingFunctions, log);
 
   if (!missingFunctions.empty())
   {
@@ -6,19 +6,58 @@
 
 #pragma once
 
+#include <common/InternalTypes.h>
 #include <common/Logging.h>
 #include <common/Types.h>
 #include <libHandling/SharedLibraryLoader.h>
 
-namespace libffmpeg::internal::functions
+namespace libffmpeg::internal
+{
+namespace avcodec
+{
+struct AVChannelLayout;
+}
+
+namespace functions
 {
 
 struct SwResampleFunctions
 {
   std::function<unsigned()> swresample_version;
+
+  // Channel layouts as bit masks. Removed in swresample 5 (FFmpeg 7).
+  std::function<SwrContext *(SwrContext    *context,
+                             int64_t        out_ch_layout,
+                             AVSampleFormat out_sample_fmt,
+                             int            out_sample_rate,
+                             int64_t        in_ch_layout,
+                             AVSampleFormat in_sample_fmt,
+                             int            in_sample_rate,
+                             int            log_offset,
+                             void          *log_ctx)>
+      swr_alloc_set_opts;
+  // Channel layouts as AVChannelLayout. Added in FFmpeg 5.1.
+  std::function<int(SwrContext                    **context,
+                    const avcodec::AVChannelLayout *out_ch_layout,
+                    AVSampleFormat                  out_sample_fmt,
+                    int                             out_sample_rate,
+                    const avcodec::AVChannelLayout *in_ch_layout,
+                    AVSampleFormat                  in_sample_fmt,
+                    int                             in_sample_rate,
+                    int                             log_offset,
+                    void                           *log_ctx)>
+      swr_alloc_set_opts2;
+
+  std::function<int(SwrContext *context)> swr_init;
+  std::function<int(
+      SwrContext *context, uint8_t **out, int out_count, const uint8_t **in, int in_count)>
+      swr_convert;
+  std::function<int64_t(SwrContext *context, int64_t base)> swr_get_delay;
+  std::function<void(SwrContext **context)>                 swr_free;
 };
 
 std::optional<SwResampleFunctions>
 tryBindSwResampleFunctionsFromLibrary(const SharedLibraryLoader &lib, const LoggingFunction &log);
 
-} // namespace libffmpeg::internal::functions
+} // namespace functions
+} // namespace libffmpeg::internal
@@ -0,0 +1,65 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include "SwScaleFunctions.h"
+
+#include <common/Formatting.h>
+
+#include "Functions.h"
+
+namespace libffmpeg::internal::functions
+{
+
+std::optional<SwScaleFunctions> tryBindSwScaleFunctionsFromLibrary(const SharedLibraryLoader &lib,
+                                                                   const LoggingFunction     &log)
+{
+  if (!lib)
+  {
+    log(LogLevel::Error, "Binding of swScale functions failed. Library is not loaded.");
+    return {};
+  }
+
+  SwScaleFunctions functions;
+
+  lib.tryResolveFunction(functions.swscale_version, "swscale_version");
+  lib.tryResolveFunction(functions.sws_getContext, "sws_getContext");
+  lib.tryResolveFunction(functions.sws_getCachedContext, "sws_getCachedContext");
+  lib.tryResolveFunction(functions.sws_scale, "sws_scale");
+  lib.tryResolveFunction(functions.sws_freeContext, "sws_freeContext");
+  lib.tryResolveFunction(functions.sws_alloc_context, "sws_alloc_context");
+  lib.tryResolveFunction(functions.sws_init_context, "sws_init_context");
+  lib.tryResolveFunction(functions.sws_scale_frame, "sws_scale_frame");
+
+  std::vector<std::string> missingFunctions;
+
+  checkForMissingFunctionAndLog(
+      functions.swscale_version, "swscale_version", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.sws_getContext, "sws_getContext", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.sws_getCachedContext, "sws_getCachedContext", missingFunctions, log);
+  checkForMissingFunctionAndLog(functions.sws_scale, "sws_scale", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.sws_freeContext, "sws_freeContext", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.sws_alloc_context, "sws_alloc_context", missingFunctions, log);
+  checkForMissingFunctionAndLog(
+      functions.sws_init_context, "sws_init_context", missingFunctions, log);
+
+  if (!missingFunctions.empty())
+  {
+    log(LogLevel::Debug,
+        "Binding swScale functions failed. Missing functions: " + to_string(missingFunctions));
+    return {};
+  }
+
+  if (!functions.sws_scale_frame)
+    log(LogLevel::Debug, "Function sws_scale_frame not found. Slice threading is not available.");
+
+  log(LogLevel::Debug, "Binding of swScale functions successful.");
+  return functions;
+}
+
+} // namespace libffmpeg::internal::functions
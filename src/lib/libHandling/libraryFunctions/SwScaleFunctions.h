@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#pragma once
+
+#include <common/InternalTypes.h>
+#include <common/Logging.h>
+#include <common/Types.h>
+#include <libHandling/SharedLibraryLoader.h>
+
+namespace libffmpeg::internal::functions
+{
+
+struct SwScaleFunctions
+{
+  std::function<unsigned()> swscale_version;
+  std::function<SwsContext *(int           srcW,
+                             int           srcH,
+                             AVPixelFormat srcFormat,
+                             int           dstW,
+                             int           dstH,
+                             AVPixelFormat dstFormat,
+                             int           flags,
+                             SwsFilter    *srcFilter,
+                             SwsFilter    *dstFilter,
+                             const double *param)>
+      sws_getContext;
+  std::function<SwsContext *(SwsContext   *context,
+                             int           srcW,
+                             int           srcH,
+                             AVPixelFormat srcFormat,
+                             int           dstW,
+                             int           dstH,
+                             AVPixelFormat dstFormat,
+                             int           flags,
+                             SwsFilter    *srcFilter,
+                             SwsFilter    *dstFilter,
+                             const double *param)>
+      sws_getCachedContext;
+  std::function<int(SwsContext          *context,
+                    const uint8_t *const srcSlice[],
+                    const int            srcStride[],
+                    int                  srcSliceY,
+                    int                  srcSliceH,
+                    uint8_t *const       dst[],
+                    const int            dstStride[])>
+      sws_scale;
+  std::function<void(SwsContext *context)> sws_freeContext;
+  std::function<SwsContext *()>            sws_alloc_context;
+  std::function<int(SwsContext *context, SwsFilter *srcFilter, SwsFilter *dstFilter)>
+      sws_init_context;
+
+  // Only available since swscale 6 (FFmpeg 5). Together with the "threads" option of the context
+  // the scaling is split into slices which are processed in parallel.
+  std::function<int(SwsContext *context, AVFrame *dst, const AVFrame *src)> sws_scale_frame;
+};
+
+std::optional<SwScaleFunctions> tryBindSwScaleFunctionsFromLibrary(const SharedLibraryLoader &lib,
+                                                                   const LoggingFunction     &log);
+
+} // namespace libffmpeg::internal::functions
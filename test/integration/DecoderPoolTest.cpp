@@ -0,0 +1,168 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <DecoderPool.h>
+#include <common/MemoryBudget.h>
+
+#include "LibrariesWithLogging.h"
+
+#include <gtest/gtest.h>
+
+namespace libffmpeg::test::integration
+{
+
+namespace
+{
+
+int decodeAllFramesOfStream(Demuxer &demuxer, Decoder &decoder, const int streamIndex)
+{
+  int frameCounter = 0;
+
+  const auto pullFramesFromDecoder = [&decoder, &frameCounter]()
+  {
+    while (decoder.decodeNextFrame())
+      ++frameCounter;
+  };
+
+  while (const auto packet = demuxer.getNextPacket())
+  {
+    if (packet->getStreamIndex() != streamIndex)
+      continue;
+
+    auto result = decoder.sendPacket(*packet);
+    EXPECT_NE(result, Decoder::SendPacketResult::Error);
+
+    if (decoder.getDecoderState() == Decoder::State::RetrieveFrames)
+      pullFramesFromDecoder();
+
+    if (result == Decoder::SendPacketResult::NotSentPullFramesFirst)
+    {
+      EXPECT_EQ(decoder.sendPacket(*packet), Decoder::SendPacketResult::Ok);
+    }
+  }
+
+  decoder.setFlushing();
+  pullFramesFromDecoder();
+  EXPECT_EQ(decoder.getDecoderState(), Decoder::State::EndOfBitstream);
+
+  return frameCounter;
+}
+
+} // namespace
+
+TEST(DecoderPool, ResetDecoder_ShouldDecodeAllFramesAgain)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  constexpr auto STREAM_INDEX = 1;
+
+  auto decoder = Decoder(libsAndLogs.libraries);
+  {
+    auto demuxer = libsAndLogs.openTestFileInDemuxer();
+    ASSERT_TRUE(decoder.openForDecoding(demuxer.getFormatContext()->getStream(STREAM_INDEX)));
+    EXPECT_EQ(decodeAllFramesOfStream(demuxer, decoder, STREAM_INDEX), 25);
+  }
+
+  EXPECT_TRUE(decoder.reset());
+  EXPECT_EQ(decoder.getDecoderState(), Decoder::State::NeedsMoreData);
+
+  auto demuxer = libsAndLogs.openTestFileInDemuxer();
+  EXPECT_EQ(decodeAllFramesOfStream(demuxer, decoder, STREAM_INDEX), 25);
+}
+
+TEST(DecoderPool, ReleasedDecoder_ShouldBeReusedForSameCodecParameters)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  constexpr auto STREAM_INDEX = 1;
+
+  DecoderPool pool(libsAndLogs.libraries);
+
+  for (int clip = 0; clip < 3; ++clip)
+  {
+    auto demuxer = libsAndLogs.openTestFileInDemuxer();
+    auto decoder = pool.getDecoder(demuxer.getFormatContext()->getStream(STREAM_INDEX));
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decoder->getDecoderState(), Decoder::State::NeedsMoreData);
+    EXPECT_EQ(decodeAllFramesOfStream(demuxer, *decoder, STREAM_INDEX), 25);
+  }
+
+  const auto statistics = pool.getStatistics();
+  if (libsAndLogs.libraries->getLibrariesVersion().avformat.major > 56)
+  {
+    EXPECT_EQ(statistics.openedDecoders, 1u);
+    EXPECT_EQ(statistics.reusedDecoders, 2u);
+    EXPECT_EQ(statistics.idleDecoders, 1u);
+  }
+
+  pool.clear();
+  EXPECT_EQ(pool.getStatistics().idleDecoders, 0u);
+}
+
+TEST(DecoderPool, ReusedDecoder_ShouldUseMemoryBudgetOfLibraries)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  constexpr auto STREAM_INDEX = 1;
+
+  DecoderPool pool(libsAndLogs.libraries);
+
+  if (libsAndLogs.libraries->getLibrariesVersion().avformat.major <= 56)
+    GTEST_SKIP() << "No codec parameters in avformat 56";
+
+  const auto libraryBudget = libsAndLogs.libraries->getMemoryBudget();
+  const auto callerBudget =
+      std::make_shared<MemoryBudget>(MemoryBudget::Settings(), libraryBudget);
+
+  auto demuxer = libsAndLogs.openTestFileInDemuxer();
+  auto stream  = demuxer.getFormatContext()->getStream(STREAM_INDEX);
+  {
+    auto decoder = pool.getDecoder(stream);
+    ASSERT_TRUE(decoder);
+    EXPECT_EQ(decoder->getMemoryBudget(), libraryBudget);
+    decoder->setMemoryBudget(callerBudget);
+  }
+
+  auto decoder = pool.getDecoder(stream);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(pool.getStatistics().reusedDecoders, 1u);
+  EXPECT_EQ(decoder->getMemoryBudget(), libraryBudget);
+}
+
+TEST(DecoderPool, AudioStreamsWithDifferentSampleRates_ShouldNotShareDecoders)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  constexpr auto AUDIO_STREAM_INDEX = 0;
+
+  DecoderPool pool(libsAndLogs.libraries);
+
+  if (libsAndLogs.libraries->getLibrariesVersion().avformat.major <= 56)
+    GTEST_SKIP() << "No codec parameters in avformat 56";
+
+  auto firstDemuxer = libsAndLogs.openTestFileInDemuxer();
+  auto firstStream  = firstDemuxer.getFormatContext()->getStream(AUDIO_STREAM_INDEX);
+  ASSERT_TRUE(pool.getDecoder(firstStream));
+
+  auto secondDemuxer    = libsAndLogs.openTestFileInDemuxer();
+  auto secondStream     = secondDemuxer.getFormatContext()->getStream(AUDIO_STREAM_INDEX);
+  auto secondParameters = secondStream.getCodecParameters();
+  ASSERT_TRUE(secondParameters);
+  secondParameters->setSampleRate(secondParameters->getSampleRate() / 2);
+  ASSERT_TRUE(pool.getDecoder(secondStream));
+
+  auto statistics = pool.getStatistics();
+  EXPECT_EQ(statistics.openedDecoders, 2u);
+  EXPECT_EQ(statistics.reusedDecoders, 0u);
+  EXPECT_EQ(statistics.idleDecoders, 2u);
+
+  ASSERT_TRUE(pool.getDecoder(firstStream));
+  statistics = pool.getStatistics();
+  EXPECT_EQ(statistics.openedDecoders, 2u);
+  EXPECT_EQ(statistics.reusedDecoders, 1u);
+}
+
+} // namespace libffmpeg::test::integration
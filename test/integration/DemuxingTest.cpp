@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <limits>
 
 namespace libffmpeg::test::integration
 {
@@ -207,6 +208,73 @@ TEST(Demuxing, OpenTestFileAndDemuxPackets_ShouldReturnCorrectPackets)
 
   EXPECT_EQ(packetCountAudio, 45);
   EXPECT_EQ(packetCountVideo, 25);
+  EXPECT_EQ(demuxer.getDemuxerState(), Demuxer::State::EndOfFile);
+}
+
+TEST(Demuxing, ExhaustedMemoryBudget_ShouldNotBeReportedAsEndOfFile)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  auto demuxer = libsAndLogs.openTestFileInDemuxer();
+  EXPECT_EQ(demuxer.getDemuxerState(), Demuxer::State::Reading);
+
+  MemoryBudget::Settings budgetSettings;
+  budgetSettings.limitBytes = 1;
+  budgetSettings.policy     = MemoryBudget::Policy::Fail;
+  demuxer.setMemoryBudget(std::make_shared<MemoryBudget>(budgetSettings));
+
+  int  packetCount = 0;
+  auto firstPacket = demuxer.getNextPacket();
+  ASSERT_TRUE(firstPacket);
+  ++packetCount;
+
+  EXPECT_FALSE(demuxer.getNextPacket());
+  EXPECT_EQ(demuxer.getDemuxerState(), Demuxer::State::MemoryBudgetExhausted);
+
+  // Reading continues once the packet was released
+  firstPacket.reset();
+  while (auto packet = demuxer.getNextPacket())
+    ++packetCount;
+
+  EXPECT_EQ(demuxer.getDemuxerState(), Demuxer::State::EndOfFile);
+  EXPECT_EQ(packetCount, 70);
+}
+
+TEST(Demuxing, DemuxPacketsInBatches_ShouldReturnAllPackets)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  auto demuxer = libsAndLogs.openTestFileInDemuxer();
+
+  std::vector<avcodec::AVPacketWrapper> packets;
+  int                                   packetCountAudio = 0;
+  int                                   packetCountVideo = 0;
+  while (demuxer.getNextPackets(packets, 16) > 0)
+  {
+    EXPECT_LE(packets.size(), 16u);
+    for (const auto &packet : packets)
+    {
+      if (packet.getStreamIndex() == 0)
+        ++packetCountAudio;
+      else if (packet.getStreamIndex() == 1)
+        ++packetCountVideo;
+    }
+  }
+
+  EXPECT_EQ(packetCountAudio, 45);
+  EXPECT_EQ(packetCountVideo, 25);
+}
+
+TEST(Demuxing, DemuxAllPacketsInOneBatch_ShouldReturnAllPackets)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  auto demuxer = libsAndLogs.openTestFileInDemuxer();
+
+  std::vector<avcodec::AVPacketWrapper> packets;
+  EXPECT_EQ(demuxer.getNextPackets(packets, std::numeric_limits<std::size_t>::max()), 70u);
+  EXPECT_EQ(packets.size(), 70u);
+  EXPECT_EQ(demuxer.getDemuxerState(), Demuxer::State::EndOfFile);
 }
 
 TEST(Demuxing, OpenTestFileAndDemuxPackets_ShouldLogDemuxingEventsCorrectly)
@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <ParallelSegmentDecoder.h>
+
+#include "LibrariesWithLogging.h"
+
+#include <gtest/gtest.h>
+
+namespace libffmpeg::test::integration
+{
+
+TEST(ParallelSegmentDecoding, DecodeTestFile_ShouldReturnAllFramesInOrder)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  ParallelSegmentDecoder decoder(libsAndLogs.libraries, {.numberOfThreads = 4});
+
+  std::vector<int64_t> ptsValues;
+  const auto           success = decoder.decodeFile(
+      TEST_FILE_NAME,
+      1,
+      [&ptsValues](avutil::AVFrameWrapper &&frame)
+      {
+        EXPECT_EQ(frame.getSize(), Size({320, 240}));
+        ptsValues.push_back(frame.getPTS().value_or(-1));
+      });
+
+  EXPECT_TRUE(success);
+  ASSERT_EQ(ptsValues.size(), 25u);
+
+  if (libsAndLogs.libraries->getLibrariesVersion().avcodec.major > 56)
+  {
+    for (std::size_t i = 0; i < ptsValues.size(); ++i)
+      EXPECT_EQ(ptsValues.at(i), static_cast<int64_t>(i) * 512);
+  }
+}
+
+TEST(ParallelSegmentDecoding, DecodeTestFileWithOneBufferedFrame_ShouldReturnAllFramesInOrder)
+{
+  auto libsAndLogs = LibrariesWithLogging();
+
+  ParallelSegmentDecoder decoder(libsAndLogs.libraries,
+                                 {.numberOfThreads = 4, .maxBufferedFrames = 1});
+
+  std::vector<int64_t> ptsValues;
+  const auto           success = decoder.decodeFile(
+      TEST_FILE_NAME,
+      1,
+      [&ptsValues](avutil::AVFrameWrapper &&frame)
+      { ptsValues.push_back(frame.getPTS().value_or(-1)); });
+
+  EXPECT_TRUE(success);
+  ASSERT_EQ(ptsValues.size(), 25u);
+
+  if (libsAndLogs.libraries->getLibrariesVersion().avcodec.major > 56)
+  {
+    for (std::size_t i = 0; i < ptsValues.size(); ++i)
+      EXPECT_EQ(ptsValues.at(i), static_cast<int64_t>(i) * 512);
+  }
+}
+
+} // namespace libffmpeg::test::integration
@@ -0,0 +1,290 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVCodec/FrameBufferPool.h>
+#include <AVCodec/wrappers/AVCodecContextWrapper.h>
+#include <AVCodec/wrappers/FrameBufferAllocator.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVCodec/VersionToAVCodecTypes.h>
+#include <wrappers/AVUtil/AVPixFmtDescriptorCreation.h>
+#include <wrappers/AVUtil/VersionToAVUtilTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+namespace libffmpeg::avcodec
+{
+
+namespace
+{
+
+using libffmpeg::internal::AVBufferRef;
+using libffmpeg::internal::AVCodec;
+using libffmpeg::internal::AVCodecContext;
+using libffmpeg::internal::AVCodecID;
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVOption;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr auto AV_CODEC_CAP_DR1  = (1 << 1);
+constexpr auto TEST_PIXEL_FORMAT = static_cast<AVPixelFormat>(123);
+constexpr auto TEST_WIDTH        = 64;
+constexpr auto TEST_HEIGHT       = 32;
+
+// The first members of the AVOption struct that the allocator uses to check the struct layout
+struct AVOptionHeader
+{
+  const char *name{};
+  const char *help{};
+  int         offset{};
+};
+
+// The buffer that av_buffer_create wraps. Releasing it calls the free callback of the allocator
+// just like FFmpeg does when the last reference of a frame is unreferenced.
+struct BufferRefMock
+{
+  uint8_t *data{};
+  void (*free)(void *opaque, uint8_t *data){};
+  void *opaque{};
+
+  void release() { this->free(this->opaque, this->data); }
+};
+
+template <FFmpegVersion V> constexpr bool isAllocatorSupported()
+{
+  return V == FFmpegVersion::FFmpeg_5x || V == FFmpegVersion::FFmpeg_6x ||
+         V == FFmpegVersion::FFmpeg_7x || V == FFmpegVersion::FFmpeg_8x;
+}
+
+template <FFmpegVersion V> void runFramesShouldBeAllocatedFromThePool()
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(getLibraryVerions(V)));
+
+  AVCodecType<V> codec;
+  codec.capabilities                            = AV_CODEC_CAP_DR1;
+  ffmpegLibraries->avcodec.avcodec_find_decoder = [&codec](AVCodecID)
+  { return reinterpret_cast<AVCodec *>(&codec); };
+
+  int numberOfOptionLookups = 0;
+  ffmpegLibraries->avutil.av_opt_find =
+      [&numberOfOptionLookups](void *, const char *name, const char *, int, int)
+  {
+    ++numberOfOptionLookups;
+    EXPECT_EQ(std::string(name), "request_sample_fmt");
+    if constexpr (isAllocatorSupported<V>())
+    {
+      static const AVOptionHeader option{
+          "request_sample_fmt", "", offsetof(AVCodecContextType<V>, request_sample_fmt)};
+      return reinterpret_cast<const AVOption *>(&option);
+    }
+    return static_cast<const AVOption *>(nullptr);
+  };
+
+  avutil::PixelFormatDescriptor yuv420;
+  yuv420.name                          = "yuv420p";
+  yuv420.numberOfComponents            = 3;
+  yuv420.shiftLumaToChroma.widthShift  = 1;
+  yuv420.shiftLumaToChroma.heightShift = 1;
+  yuv420.flags.planar                  = true;
+  yuv420.componentDescriptors.push_back({0, 1, 0, 0, 8});
+  yuv420.componentDescriptors.push_back({1, 1, 0, 0, 8});
+  yuv420.componentDescriptors.push_back({2, 1, 0, 0, 8});
+  const auto rawDescriptor =
+      avutil::createRawFormatDescriptor<avutil::AVPixFmtDescriptorType<V>>(yuv420);
+  ffmpegLibraries->avutil.av_pix_fmt_desc_get = [&rawDescriptor](AVPixelFormat)
+  { return reinterpret_cast<const internal::AVPixFmtDescriptor *>(&rawDescriptor); };
+
+  ffmpegLibraries->avcodec.avcodec_align_dimensions2 =
+      [](AVCodecContext *, int *, int *, int linesizeAlign[])
+  {
+    for (int i = 0; i < internal::AV_NUM_DATA_POINTERS; ++i)
+      linesizeAlign[i] = 16;
+  };
+  ffmpegLibraries->avutil.av_image_fill_linesizes = [](int linesizes[4], AVPixelFormat, int width)
+  {
+    linesizes[0] = width;
+    linesizes[1] = width / 2;
+    linesizes[2] = width / 2;
+    linesizes[3] = 0;
+    return 0;
+  };
+  ffmpegLibraries->avutil.av_image_fill_pointers =
+      [](uint8_t *data[4], AVPixelFormat, int height, uint8_t *ptr, const int linesizes[4])
+  {
+    const auto lumaSize   = linesizes[0] * height;
+    const auto chromaSize = linesizes[1] * height / 2;
+    data[0]               = ptr;
+    data[1]               = ptr + lumaSize;
+    data[2]               = ptr + lumaSize + chromaSize;
+    data[3]               = nullptr;
+    return lumaSize + 2 * chromaSize;
+  };
+
+  std::vector<std::unique_ptr<BufferRefMock>> bufferRefs;
+  ffmpegLibraries->avutil.av_buffer_create =
+      [&bufferRefs](
+          uint8_t *data, size_t, void (*free)(void *opaque, uint8_t *data), void *opaque, int)
+  {
+    bufferRefs.push_back(std::make_unique<BufferRefMock>(BufferRefMock({data, free, opaque})));
+    return reinterpret_cast<AVBufferRef *>(bufferRefs.back().get());
+  };
+
+  int numberOfDefaultAllocations                       = 0;
+  ffmpegLibraries->avcodec.avcodec_default_get_buffer2 = [&numberOfDefaultAllocations](
+                                                             AVCodecContext *, AVFrame *, int)
+  {
+    ++numberOfDefaultAllocations;
+    return 0;
+  };
+
+  AVCodecContextType<V> codecContext{};
+  codecContext.codec_type = internal::AVMEDIA_TYPE_VIDEO;
+  codecContext.codec_id   = internal::AV_CODEC_ID_TESTING;
+
+  auto pool = std::make_shared<FrameBufferPool>();
+
+  AVCodecContextWrapper wrapper(reinterpret_cast<AVCodecContext *>(&codecContext), ffmpegLibraries);
+  wrapper.setFrameBufferPool(pool);
+  EXPECT_TRUE(wrapper.openContextForDecoding());
+
+  if constexpr (!isAllocatorSupported<V>())
+  {
+    // The position of get_buffer2 is not known for these versions. The context is not touched.
+    EXPECT_EQ(numberOfOptionLookups, 0);
+    EXPECT_EQ(pool->getStatistics().poolMisses, 0u);
+    return;
+  }
+  else
+  {
+    EXPECT_EQ(numberOfOptionLookups, 1);
+    ASSERT_NE(codecContext.get_buffer2, nullptr);
+    EXPECT_NE(codecContext.opaque, nullptr);
+
+    const auto getBuffer = [&](avutil::AVFrameType<V> &frame)
+    {
+      frame.width  = TEST_WIDTH;
+      frame.height = TEST_HEIGHT;
+      frame.format = TEST_PIXEL_FORMAT;
+      return codecContext.get_buffer2(reinterpret_cast<AVCodecContext *>(&codecContext),
+                                      reinterpret_cast<AVFrame *>(&frame),
+                                      0);
+    };
+
+    avutil::AVFrameType<V> frame{};
+    ASSERT_EQ(getBuffer(frame), 0);
+    EXPECT_EQ(numberOfDefaultAllocations, 0);
+    ASSERT_EQ(bufferRefs.size(), 1u);
+    EXPECT_EQ(frame.buf[0], reinterpret_cast<AVBufferRef *>(bufferRefs.at(0).get()));
+    EXPECT_EQ(frame.extended_data, frame.data);
+
+    // The width is increased until all lines are aligned to 64 bytes
+    EXPECT_EQ(frame.linesize[0], 128);
+    EXPECT_EQ(frame.linesize[1], 64);
+    EXPECT_EQ(frame.linesize[2], 64);
+    for (int i = 0; i < 3; ++i)
+      EXPECT_EQ(reinterpret_cast<std::uintptr_t>(frame.data[i]) % FrameBufferPool::BUFFER_ALIGNMENT,
+                0u);
+    EXPECT_EQ(frame.data[0], bufferRefs.at(0)->data);
+    EXPECT_EQ(frame.data[1], frame.data[0] + 128 * TEST_HEIGHT);
+    EXPECT_EQ(frame.data[2], frame.data[1] + 64 * TEST_HEIGHT / 2);
+    EXPECT_EQ(frame.data[3], nullptr);
+
+    auto statistics = pool->getStatistics();
+    EXPECT_EQ(statistics.poolMisses, 1u);
+    EXPECT_EQ(statistics.poolHits, 0u);
+    EXPECT_EQ(statistics.buffersInUse, 1u);
+
+    // Freeing the frame gives the buffer back to the pool
+    bufferRefs.at(0)->release();
+    statistics = pool->getStatistics();
+    EXPECT_EQ(statistics.buffersInUse, 0u);
+    EXPECT_EQ(statistics.bytesInUse, 0u);
+
+    avutil::AVFrameType<V> secondFrame{};
+    ASSERT_EQ(getBuffer(secondFrame), 0);
+    EXPECT_EQ(secondFrame.data[0], frame.data[0]);
+    statistics = pool->getStatistics();
+    EXPECT_EQ(statistics.poolMisses, 1u);
+    EXPECT_EQ(statistics.poolHits, 1u);
+    EXPECT_EQ(statistics.buffersInUse, 1u);
+    bufferRefs.at(1)->release();
+
+    // Audio frames are allocated by FFmpeg
+    codecContext.codec_type = internal::AVMEDIA_TYPE_AUDIO;
+    avutil::AVFrameType<V> audioFrame{};
+    EXPECT_EQ(getBuffer(audioFrame), 0);
+    EXPECT_EQ(numberOfDefaultAllocations, 1);
+    EXPECT_EQ(bufferRefs.size(), 2u);
+    EXPECT_EQ(pool->getStatistics().buffersInUse, 0u);
+  }
+}
+
+template <FFmpegVersion V> void runAllocatorShouldNotBeInstalledIfLayoutDoesNotMatch()
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(getLibraryVerions(V)));
+
+  AVCodecType<V> codec;
+  codec.capabilities                            = AV_CODEC_CAP_DR1;
+  ffmpegLibraries->avcodec.avcodec_find_decoder = [&codec](AVCodecID)
+  { return reinterpret_cast<AVCodec *>(&codec); };
+
+  // An offset that does not match the mirrored struct (e.g. an unknown minor version)
+  static const AVOptionHeader option{"request_sample_fmt", "", 3};
+  ffmpegLibraries->avutil.av_opt_find = [](void *, const char *, const char *, int, int)
+  { return reinterpret_cast<const AVOption *>(&option); };
+
+  AVCodecContextType<V> codecContext{};
+  codecContext.codec_type = internal::AVMEDIA_TYPE_VIDEO;
+
+  AVCodecContextWrapper wrapper(reinterpret_cast<AVCodecContext *>(&codecContext), ffmpegLibraries);
+  wrapper.setFrameBufferPool(std::make_shared<FrameBufferPool>());
+  EXPECT_TRUE(wrapper.openContextForDecoding());
+
+  if constexpr (isAllocatorSupported<V>())
+  {
+    EXPECT_EQ(codecContext.get_buffer2, nullptr);
+    EXPECT_EQ(codecContext.opaque, nullptr);
+  }
+}
+
+} // namespace
+
+class FrameBufferAllocatorTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST_F(FrameBufferAllocatorTest, ConstructorWithNullptrShouldThrow)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+  EXPECT_THROW(FrameBufferAllocator allocator({}, ffmpegLibraries), std::runtime_error);
+  EXPECT_THROW(FrameBufferAllocator allocator(std::make_shared<FrameBufferPool>(), {}),
+               std::runtime_error);
+}
+
+TEST_P(FrameBufferAllocatorTest, FramesShouldBeAllocatedFromThePool)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runFramesShouldBeAllocatedFromThePool);
+}
+
+TEST_P(FrameBufferAllocatorTest, AllocatorShouldNotBeInstalledIfLayoutDoesNotMatch)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runAllocatorShouldNotBeInstalledIfLayoutDoesNotMatch);
+}
+
+INSTANTIATE_TEST_SUITE_P(AVCodec,
+                         FrameBufferAllocatorTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg::avcodec
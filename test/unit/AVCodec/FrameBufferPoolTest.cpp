@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVCodec/FrameBufferPool.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace libffmpeg::avcodec
+{
+
+TEST(FrameBufferPoolTest, ReleasedBuffersShouldBeReused)
+{
+  FrameBufferPool pool;
+
+  auto buffer = pool.acquireBuffer(1000);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(FrameBufferPool::getSize(buffer), 1000u);
+  const auto data = FrameBufferPool::getData(buffer);
+  FrameBufferPool::releaseBuffer(buffer);
+
+  auto reusedBuffer = pool.acquireBuffer(1000);
+  EXPECT_EQ(FrameBufferPool::getData(reusedBuffer), data);
+
+  auto otherSizeBuffer = pool.acquireBuffer(2000);
+  EXPECT_NE(FrameBufferPool::getData(otherSizeBuffer), data);
+
+  const auto statistics = pool.getStatistics();
+  EXPECT_EQ(statistics.poolHits, 1u);
+  EXPECT_EQ(statistics.poolMisses, 2u);
+  EXPECT_EQ(statistics.buffersInUse, 2u);
+  EXPECT_EQ(statistics.bytesInUse, 3000u);
+  EXPECT_EQ(statistics.allocatedBytes, 3000u);
+
+  FrameBufferPool::releaseBuffer(reusedBuffer);
+  FrameBufferPool::releaseBuffer(otherSizeBuffer);
+
+  EXPECT_EQ(pool.getStatistics().buffersInUse, 0u);
+  EXPECT_EQ(pool.getStatistics().bytesInUse, 0u);
+}
+
+TEST(FrameBufferPoolTest, BuffersShouldBeAligned)
+{
+  FrameBufferPool pool;
+
+  for (const auto size : {1u, 63u, 100u, 4097u})
+  {
+    auto buffer = pool.acquireBuffer(size);
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(FrameBufferPool::getData(buffer)) %
+                  FrameBufferPool::BUFFER_ALIGNMENT,
+              0u);
+    FrameBufferPool::releaseBuffer(buffer);
+  }
+}
+
+TEST(FrameBufferPoolTest, PeakUsageShouldBeTracked)
+{
+  FrameBufferPool pool;
+
+  auto buffer1 = pool.acquireBuffer(100);
+  auto buffer2 = pool.acquireBuffer(200);
+  FrameBufferPool::releaseBuffer(buffer1);
+  FrameBufferPool::releaseBuffer(buffer2);
+
+  const auto statistics = pool.getStatistics();
+  EXPECT_EQ(statistics.bytesInUse, 0u);
+  EXPECT_EQ(statistics.peakBytesInUse, 300u);
+  EXPECT_EQ(statistics.peakAllocatedBytes, 300u);
+}
+
+TEST(FrameBufferPoolTest, NumberOfFreeBuffersShouldBeLimited)
+{
+  FrameBufferPool pool(FrameBufferPool::Settings({.maxFreeBuffersPerSize = 1}));
+
+  auto buffer1 = pool.acquireBuffer(100);
+  auto buffer2 = pool.acquireBuffer(100);
+  FrameBufferPool::releaseBuffer(buffer1);
+  FrameBufferPool::releaseBuffer(buffer2);
+
+  EXPECT_EQ(pool.getStatistics().allocatedBytes, 100u);
+}
+
+TEST(FrameBufferPoolTest, BufferMayOutliveThePool)
+{
+  FrameBufferPool::Buffer *buffer{};
+  {
+    FrameBufferPool pool;
+    buffer = pool.acquireBuffer(64);
+    ASSERT_NE(buffer, nullptr);
+  }
+
+  std::memset(FrameBufferPool::getData(buffer), 0xab, 64);
+  FrameBufferPool::releaseBuffer(buffer);
+}
+
+TEST(FrameBufferPoolTest, HugePageBuffersShouldBeUsable)
+{
+  FrameBufferPool pool(FrameBufferPool::Settings({.useHugePages = true}));
+
+  auto buffer = pool.acquireBuffer(1920 * 1080 * 3 / 2);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(FrameBufferPool::getData(buffer)) %
+                FrameBufferPool::BUFFER_ALIGNMENT,
+            0u);
+  std::memset(FrameBufferPool::getData(buffer), 0, FrameBufferPool::getSize(buffer));
+  FrameBufferPool::releaseBuffer(buffer);
+}
+
+TEST(FrameBufferPoolTest, AcquireZeroSizeShouldReturnNull)
+{
+  FrameBufferPool pool;
+  EXPECT_EQ(pool.acquireBuffer(0), nullptr);
+}
+
+} // namespace libffmpeg::avcodec
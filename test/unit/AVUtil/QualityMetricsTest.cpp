@@ -0,0 +1,281 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVUtil/QualityMetrics.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <random>
+
+namespace libffmpeg::avutil
+{
+
+namespace
+{
+
+using Implementation = QualityMetricsSettings::Implementation;
+
+PixelFormatDescriptor createYUV420Format(const int depth, const bool interleavedChroma)
+{
+  const auto bytesPerSample = (depth > 8) ? 2 : 1;
+
+  PixelFormatDescriptor format;
+  format.name               = "test";
+  format.numberOfComponents = 3;
+  format.shiftLumaToChroma  = {1, 1};
+  format.flags.planar       = true;
+
+  format.componentDescriptors.push_back({0, bytesPerSample, 0, 0, depth});
+  if (interleavedChroma)
+  {
+    format.componentDescriptors.push_back({1, 2 * bytesPerSample, 0, 0, depth});
+    format.componentDescriptors.push_back({1, 2 * bytesPerSample, bytesPerSample, 0, depth});
+  }
+  else
+  {
+    format.componentDescriptors.push_back({1, bytesPerSample, 0, 0, depth});
+    format.componentDescriptors.push_back({2, bytesPerSample, 0, 0, depth});
+  }
+  return format;
+}
+
+// An image with random sample values. The samples of a second image can be derived from it by
+// adding noise so that the metrics are in a realistic range.
+class TestImage
+{
+public:
+  TestImage(const PixelFormatDescriptor &format, const Size size)
+  {
+    this->image.pixelFormat = format;
+    this->image.size        = size;
+
+    const auto depth          = format.componentDescriptors.at(0).depth;
+    this->bytesPerSample      = (depth > 8) ? 2 : 1;
+    this->maxValue            = (1 << depth) - 1;
+    const auto interleaved    = format.componentDescriptors.at(1).plane ==
+                             format.componentDescriptors.at(2).plane;
+    const auto numberOfPlanes = interleaved ? 2 : 3;
+
+    for (int plane = 0; plane < numberOfPlanes; ++plane)
+    {
+      const auto width = (plane == 0) ? size.width
+                                      : ((size.width + 1) / 2) * (interleaved ? 2 : 1);
+      const auto height = (plane == 0) ? size.height : (size.height + 1) / 2;
+      // Some padding at the end of each line like FFmpeg does
+      const auto linesize = width * this->bytesPerSample + 16;
+
+      this->planes.at(plane).resize(static_cast<std::size_t>(linesize) * height);
+      this->image.data.at(plane)     = this->planes.at(plane).data();
+      this->image.linesize.at(plane) = linesize;
+      this->widths.at(plane)         = width;
+      this->heights.at(plane)        = height;
+    }
+  }
+
+  void fillRandom(const unsigned seed)
+  {
+    std::mt19937                       generator(seed);
+    std::uniform_int_distribution<int> distribution(0, this->maxValue);
+    this->forEachSample([&](const int) { return distribution(generator); });
+  }
+
+  // Copy the other image and add noise in the range [-amplitude, amplitude]
+  void copyWithNoise(const TestImage &other, const int amplitude, const unsigned seed)
+  {
+    std::mt19937                       generator(seed);
+    std::uniform_int_distribution<int> distribution(-amplitude, amplitude);
+
+    this->planes = other.planes;
+    this->forEachSample(
+        [&](const int value)
+        { return std::clamp(value + distribution(generator), 0, this->maxValue); });
+  }
+
+  void forEachSample(const std::function<int(int)> &function)
+  {
+    for (int plane = 0; plane < 3; ++plane)
+    {
+      auto &data = this->planes.at(plane);
+      for (int y = 0; y < this->heights.at(plane); ++y)
+      {
+        for (int x = 0; x < this->widths.at(plane); ++x)
+        {
+          const auto index = static_cast<std::size_t>(y) * this->image.linesize.at(plane) +
+                             x * this->bytesPerSample;
+          auto value = static_cast<int>(data.at(index));
+          if (this->bytesPerSample == 2)
+            value |= static_cast<int>(data.at(index + 1)) << 8;
+
+          value          = function(value);
+          data.at(index) = static_cast<std::byte>(value & 0xff);
+          if (this->bytesPerSample == 2)
+            data.at(index + 1) = static_cast<std::byte>(value >> 8);
+        }
+      }
+    }
+  }
+
+  ImagePlanes image;
+
+private:
+  int                       bytesPerSample{};
+  int                       maxValue{};
+  std::array<ByteVector, 3> planes{};
+  std::array<int, 3>        widths{};
+  std::array<int, 3>        heights{};
+};
+
+void expectEqualMetrics(const FrameMetrics &metrics, const FrameMetrics &reference)
+{
+  ASSERT_EQ(metrics.planes.size(), reference.planes.size());
+  for (std::size_t plane = 0; plane < metrics.planes.size(); ++plane)
+  {
+    EXPECT_EQ(metrics.planes[plane].plane, reference.planes[plane].plane);
+    EXPECT_EQ(metrics.planes[plane].mse, reference.planes[plane].mse);
+    EXPECT_EQ(metrics.planes[plane].psnr, reference.planes[plane].psnr);
+    ASSERT_EQ(metrics.planes[plane].ssim.has_value(), reference.planes[plane].ssim.has_value());
+    if (metrics.planes[plane].ssim)
+    {
+      EXPECT_NEAR(*metrics.planes[plane].ssim, *reference.planes[plane].ssim, 1e-12);
+    }
+  }
+}
+
+} // namespace
+
+TEST(QualityMetrics, IdenticalImagesShouldHaveInfinitePSNRAndSSIMOne)
+{
+  TestImage image(createYUV420Format(8, false), {64, 48});
+  image.fillRandom(1);
+
+  const auto metrics = calculateQualityMetrics(image.image, image.image);
+  ASSERT_TRUE(metrics);
+  ASSERT_EQ(metrics->planes.size(), std::size_t(3));
+  for (const auto &plane : metrics->planes)
+  {
+    EXPECT_EQ(plane.maxValue, 255);
+    EXPECT_EQ(plane.mse, 0.0);
+    EXPECT_TRUE(std::isinf(plane.psnr));
+    ASSERT_TRUE(plane.ssim);
+    EXPECT_DOUBLE_EQ(*plane.ssim, 1.0);
+  }
+}
+
+TEST(QualityMetrics, ConstantDifferenceShouldGiveExpectedMSEAndPSNR)
+{
+  const auto format = createYUV420Format(10, false);
+  TestImage  image1(format, {32, 32});
+  TestImage  image2(format, {32, 32});
+  image1.forEachSample([](const int) { return 500; });
+  image2.forEachSample([](const int) { return 503; });
+
+  const auto metrics =
+      calculateQualityMetrics(image1.image, image2.image, {.calculateSSIM = false});
+  ASSERT_TRUE(metrics);
+  for (const auto &plane : metrics->planes)
+  {
+    EXPECT_EQ(plane.maxValue, 1023);
+    EXPECT_EQ(plane.mse, 9.0);
+    EXPECT_DOUBLE_EQ(plane.psnr, 10.0 * std::log10(1023.0 * 1023.0 / 9.0));
+    EXPECT_FALSE(plane.ssim);
+  }
+}
+
+TEST(QualityMetrics, AllImplementationsAndThreadsShouldMatchScalar)
+{
+  for (const auto depth : {8, 10, 16})
+  {
+    for (const auto interleavedChroma : {false, true})
+    {
+      // Odd sizes so that the vector implementations also run their scalar tails
+      const auto format = createYUV420Format(depth, interleavedChroma);
+      const Size size   = {203, 131};
+
+      TestImage image1(format, size);
+      TestImage image2(format, size);
+      image1.fillRandom(3);
+      image2.copyWithNoise(image1, 1 << (depth - 6), 4);
+
+      const auto reference = calculateQualityMetrics(
+          image1.image, image2.image, {.implementation = Implementation::Scalar});
+      ASSERT_TRUE(reference);
+
+      // The interleaved chroma plane has no SSIM
+      ASSERT_EQ(reference->planes.size(), interleavedChroma ? std::size_t(2) : std::size_t(3));
+      EXPECT_EQ(reference->planes.at(1).ssim.has_value(), !interleavedChroma);
+      for (const auto &plane : reference->planes)
+      {
+        EXPECT_GT(plane.mse, 0.0);
+        if (plane.ssim)
+        {
+          EXPECT_GT(*plane.ssim, 0.0);
+          EXPECT_LT(*plane.ssim, 1.0);
+        }
+      }
+
+      for (const auto implementation : {Implementation::Auto, Implementation::AVX2})
+      {
+        for (const auto numberOfThreads : {1u, 3u})
+        {
+          const auto metrics = calculateQualityMetrics(
+              image1.image,
+              image2.image,
+              {.numberOfThreads = numberOfThreads, .implementation = implementation});
+          ASSERT_TRUE(metrics);
+          expectEqualMetrics(*metrics, *reference);
+        }
+      }
+    }
+  }
+}
+
+TEST(QualityMetrics, UnsupportedOrDifferentImagesShouldFail)
+{
+  const auto format = createYUV420Format(8, false);
+  TestImage  image1(format, {32, 32});
+  TestImage  image2(format, {32, 16});
+  EXPECT_FALSE(calculateQualityMetrics(image1.image, image2.image));
+
+  auto floatFormat              = format;
+  floatFormat.flags.floatValues = true;
+  EXPECT_FALSE(isQualityMetricsSupported(floatFormat));
+  EXPECT_TRUE(isQualityMetricsSupported(format));
+
+  auto missingPlane       = image1.image;
+  missingPlane.data.at(2) = nullptr;
+  EXPECT_FALSE(calculateQualityMetrics(image1.image, missingPlane));
+}
+
+TEST(QualityMetrics, AccumulatorShouldAverageFrames)
+{
+  FrameMetrics frame1;
+  frame1.planes.push_back({0, 255, 4.0, 0.0, 0.9});
+  FrameMetrics frame2;
+  frame2.planes.push_back({0, 255, 2.0, 0.0, 0.8});
+
+  QualityMetricsAccumulator accumulator;
+  EXPECT_TRUE(accumulator.getPlaneMetrics().empty());
+  EXPECT_TRUE(accumulator.add(frame1));
+  EXPECT_TRUE(accumulator.add(frame2));
+
+  FrameMetrics otherPlanes;
+  otherPlanes.planes.push_back({1, 255, 2.0, 0.0, {}});
+  EXPECT_FALSE(accumulator.add(otherPlanes));
+
+  EXPECT_EQ(accumulator.getNumberOfFrames(), std::size_t(2));
+  const auto planes = accumulator.getPlaneMetrics();
+  ASSERT_EQ(planes.size(), std::size_t(1));
+  EXPECT_EQ(planes[0].averageMSE, 3.0);
+  EXPECT_DOUBLE_EQ(planes[0].psnr, 10.0 * std::log10(255.0 * 255.0 / 3.0));
+  EXPECT_DOUBLE_EQ(*planes[0].averageSSIM, 0.85);
+  EXPECT_DOUBLE_EQ(*planes[0].minimumSSIM, 0.8);
+}
+
+} // namespace libffmpeg::avutil
@@ -0,0 +1,234 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVUtil/RGBConversion.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace libffmpeg::avutil
+{
+
+namespace
+{
+
+using Implementation = RGBConversionSettings::Implementation;
+
+PixelFormatDescriptor createYUVFormat(const int  depth,
+                                      const int  widthShift,
+                                      const int  heightShift,
+                                      const bool interleavedChroma,
+                                      const int  sampleShift = 0)
+{
+  const auto bytesPerSample = (depth + sampleShift > 8) ? 2 : 1;
+
+  PixelFormatDescriptor format;
+  format.name               = "test";
+  format.numberOfComponents = 3;
+  format.shiftLumaToChroma  = {widthShift, heightShift};
+  format.flags.planar       = true;
+
+  format.componentDescriptors.push_back({0, bytesPerSample, 0, sampleShift, depth});
+  if (interleavedChroma)
+  {
+    format.componentDescriptors.push_back({1, 2 * bytesPerSample, 0, sampleShift, depth});
+    format.componentDescriptors.push_back(
+        {1, 2 * bytesPerSample, bytesPerSample, sampleShift, depth});
+  }
+  else
+  {
+    format.componentDescriptors.push_back({1, bytesPerSample, 0, sampleShift, depth});
+    format.componentDescriptors.push_back({2, bytesPerSample, 0, sampleShift, depth});
+  }
+  return format;
+}
+
+// An image with random sample values in the valid range of the format
+class TestImage
+{
+public:
+  TestImage(const PixelFormatDescriptor &format, const Size size, const unsigned seed)
+  {
+    this->image.pixelFormat = format;
+    this->image.size        = size;
+
+    const auto &luma           = format.componentDescriptors.at(0);
+    const auto  bytesPerSample = luma.step;
+    const auto  chromaSize     = Size({-((-size.width) >> format.shiftLumaToChroma.widthShift),
+                                       -((-size.height) >> format.shiftLumaToChroma.heightShift)});
+    const auto  chromaStep     = format.componentDescriptors.at(1).step / bytesPerSample;
+    const auto  numberOfPlanes = (chromaStep == 2) ? 2 : 3;
+
+    std::mt19937                       generator(seed);
+    std::uniform_int_distribution<int> distribution(0, (1 << luma.depth) - 1);
+
+    for (int plane = 0; plane < numberOfPlanes; ++plane)
+    {
+      const auto planeSize = (plane == 0) ? size : chromaSize;
+      const auto samples   = (plane == 0) ? planeSize.width : planeSize.width * chromaStep;
+      // Some padding at the end of each line like FFmpeg does
+      const auto linesize = samples * bytesPerSample + 16;
+
+      auto &data = this->planes.at(plane);
+      data.resize(static_cast<std::size_t>(linesize) * planeSize.height);
+      for (int y = 0; y < planeSize.height; ++y)
+      {
+        for (int x = 0; x < samples; ++x)
+        {
+          const auto value  = distribution(generator) << luma.shift;
+          const auto offset = y * linesize + x * bytesPerSample;
+          data.at(offset)   = std::byte(value & 0xff);
+          if (bytesPerSample == 2)
+            data.at(offset + 1) = std::byte(value >> 8);
+        }
+      }
+
+      this->image.data.at(plane)     = data.data();
+      this->image.linesize.at(plane) = linesize;
+    }
+  }
+
+  YUVImage image;
+
+private:
+  std::array<ByteVector, 3> planes;
+};
+
+ByteVector convert(const YUVImage             &image,
+                   const ColorSpace            colorSpace,
+                   const RGBConversionSettings settings)
+{
+  const auto bytesPerPixel = (settings.format == RGBFormat::RGBA) ? 4 : 3;
+  const auto linesize      = image.size.width * bytesPerPixel;
+
+  ByteVector output(static_cast<std::size_t>(linesize) * image.size.height);
+  EXPECT_TRUE(convertToRGB(image, colorSpace, output.data(), linesize, settings));
+  return output;
+}
+
+} // namespace
+
+TEST(RGBConversionTest, KnownColorsShouldBeConvertedCorrectly)
+{
+  const auto format = createYUVFormat(8, 0, 0, false);
+
+  // White, black and red (BT.601 limited range)
+  const std::array<std::byte, 3> lumaPlane   = {std::byte(235), std::byte(16), std::byte(81)};
+  const std::array<std::byte, 3> cbPlane     = {std::byte(128), std::byte(128), std::byte(90)};
+  const std::array<std::byte, 3> crPlane     = {std::byte(128), std::byte(128), std::byte(240)};
+  YUVImage                       image;
+  image.pixelFormat = format;
+  image.size        = {3, 1};
+  image.data        = {lumaPlane.data(), cbPlane.data(), crPlane.data(), nullptr};
+  image.linesize    = {3, 3, 3, 0};
+
+  const auto rgb = convert(image, ColorSpace::BT470BG, {.format = RGBFormat::RGB24});
+
+  const auto expectNear = [&rgb](const int index, const int expected)
+  { EXPECT_NEAR(static_cast<int>(rgb.at(index)), expected, 1) << "Index " << index; };
+
+  expectNear(0, 255);
+  expectNear(1, 255);
+  expectNear(2, 255);
+  expectNear(3, 0);
+  expectNear(4, 0);
+  expectNear(5, 0);
+  expectNear(6, 255);
+  expectNear(7, 0);
+  expectNear(8, 0);
+}
+
+TEST(RGBConversionTest, RGBAShouldHaveOpaqueAlpha)
+{
+  TestImage  testImage(createYUVFormat(8, 1, 1, false), {32, 8}, 1);
+  const auto rgba =
+      convert(testImage.image, ColorSpace::BT709, {.implementation = Implementation::Scalar});
+  const auto rgb = convert(testImage.image,
+                           ColorSpace::BT709,
+                           {.format = RGBFormat::RGB24, .implementation = Implementation::Scalar});
+
+  for (std::size_t pixel = 0; pixel < 32 * 8; ++pixel)
+  {
+    EXPECT_EQ(rgba.at(pixel * 4 + 0), rgb.at(pixel * 3 + 0));
+    EXPECT_EQ(rgba.at(pixel * 4 + 1), rgb.at(pixel * 3 + 1));
+    EXPECT_EQ(rgba.at(pixel * 4 + 2), rgb.at(pixel * 3 + 2));
+    EXPECT_EQ(rgba.at(pixel * 4 + 3), std::byte(255));
+  }
+}
+
+TEST(RGBConversionTest, AllImplementationsShouldMatchScalarReference)
+{
+  struct TestFormat
+  {
+    std::string           name;
+    PixelFormatDescriptor format;
+  };
+  const std::vector<TestFormat> formats = {
+      {"yuv420p", createYUVFormat(8, 1, 1, false)},
+      {"yuv422p", createYUVFormat(8, 1, 0, false)},
+      {"yuv444p", createYUVFormat(8, 0, 0, false)},
+      {"nv12", createYUVFormat(8, 1, 1, true)},
+      {"yuv420p10le", createYUVFormat(10, 1, 1, false)},
+      {"yuv444p10le", createYUVFormat(10, 0, 0, false)},
+      {"p010le", createYUVFormat(10, 1, 1, true, 6)},
+      {"yuv422p12le", createYUVFormat(12, 1, 0, false)}};
+
+  const std::vector<Size> sizes = {{1, 1}, {7, 3}, {16, 2}, {37, 5}, {64, 70}, {99, 33}};
+
+  for (const auto &testFormat : formats)
+  {
+    for (const auto &size : sizes)
+    {
+      TestImage testImage(testFormat.format, size, static_cast<unsigned>(size.width));
+
+      for (const auto rgbFormat : {RGBFormat::RGB24, RGBFormat::RGBA})
+      {
+        for (const auto fullRange : {false, true})
+        {
+          RGBConversionSettings settings;
+          settings.format         = rgbFormat;
+          settings.fullRange      = fullRange;
+          settings.implementation = Implementation::Scalar;
+          const auto reference    = convert(testImage.image, ColorSpace::BT709, settings);
+
+          for (const auto implementation :
+               {Implementation::Auto, Implementation::SSE41, Implementation::AVX2})
+          {
+            for (const auto numberOfThreads : {1u, 3u})
+            {
+              settings.implementation  = implementation;
+              settings.numberOfThreads = numberOfThreads;
+              EXPECT_EQ(convert(testImage.image, ColorSpace::BT709, settings), reference)
+                  << "Format " << testFormat.name << " size " << size.width << "x" << size.height
+                  << " implementation " << static_cast<int>(implementation) << " threads "
+                  << numberOfThreads;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(RGBConversionTest, UnsupportedFormatsShouldBeRejected)
+{
+  auto rgbFormat      = createYUVFormat(8, 0, 0, false);
+  rgbFormat.flags.rgb = true;
+  EXPECT_FALSE(isRGBConversionSupported(rgbFormat));
+
+  EXPECT_FALSE(isRGBConversionSupported(createYUVFormat(16, 1, 1, false)));
+  EXPECT_FALSE(isRGBConversionSupported(createYUVFormat(8, 2, 0, false)));
+  EXPECT_TRUE(isRGBConversionSupported(createYUVFormat(8, 1, 1, true)));
+
+  TestImage  testImage(createYUVFormat(8, 1, 1, false), {16, 16}, 2);
+  ByteVector output(16 * 16 * 4);
+  EXPECT_FALSE(convertToRGB(testImage.image, ColorSpace::ICTCP, output.data(), 16 * 4));
+  EXPECT_FALSE(convertToRGB(testImage.image, ColorSpace::BT709, output.data(), 16 * 3));
+  EXPECT_TRUE(convertToRGB(testImage.image, ColorSpace::BT709, output.data(), 16 * 4));
+}
+
+} // namespace libffmpeg::avutil
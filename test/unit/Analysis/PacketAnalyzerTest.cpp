@@ -0,0 +1,137 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Analysis/PacketAnalyzer.h>
+
+#include <gtest/gtest.h>
+
+namespace libffmpeg::analysis
+{
+
+namespace
+{
+
+// 25 fps in a 1/1000 time base
+constexpr int64_t FRAME_DURATION = 40;
+
+PacketInfo createPacket(const int64_t dts, const int dataSize, const bool keyframe = false)
+{
+  PacketInfo packet;
+  packet.dts      = dts;
+  packet.pts      = dts + 2 * FRAME_DURATION;
+  packet.duration = FRAME_DURATION;
+  packet.dataSize = dataSize;
+  packet.keyframe = keyframe;
+  return packet;
+}
+
+} // namespace
+
+TEST(PacketAnalyzer, ShouldCalculateBitrateWindows)
+{
+  PacketAnalyzer analyzer;
+  analyzer.addStream(0, {1, 1000});
+
+  // 2 seconds with 25 packets of 1000 bytes each
+  for (int i = 0; i < 50; ++i)
+    analyzer.addPacket(createPacket(i * FRAME_DURATION, 1000, i == 0));
+
+  const auto results = analyzer.finish();
+  ASSERT_EQ(results.size(), 1u);
+  const auto &analysis = results.at(0);
+
+  EXPECT_EQ(analysis.numberOfPackets, 50u);
+  EXPECT_EQ(analysis.numberOfBytes, 50000u);
+  EXPECT_DOUBLE_EQ(analysis.averageBitrate, 200000.0);
+
+  ASSERT_EQ(analysis.bitrateWindows.size(), 2u);
+  for (const auto &window : analysis.bitrateWindows)
+  {
+    EXPECT_EQ(window.numberOfPackets, 25u);
+    EXPECT_EQ(window.bytes, 25000u);
+    EXPECT_DOUBLE_EQ(window.bitrate, 200000.0);
+  }
+  EXPECT_DOUBLE_EQ(analysis.bitrateWindows.at(1).startTime, 1.0);
+}
+
+TEST(PacketAnalyzer, ShouldDetectGOPsAndKeyframeIntervals)
+{
+  PacketAnalyzer analyzer;
+  analyzer.addStream(0, {1, 1000});
+
+  // Two leading packets, then GOPs of 10, 10 and 5 packets
+  for (int i = 0; i < 27; ++i)
+    analyzer.addPacket(createPacket(i * FRAME_DURATION, 100, i == 2 || i == 12 || i == 22));
+
+  const auto analysis = analyzer.finish().at(0);
+  EXPECT_EQ(analysis.numberOfKeyframes, 3u);
+  EXPECT_EQ(analysis.numberOfLeadingPackets, 2u);
+  EXPECT_EQ(analysis.gopLengths, std::vector<uint64_t>({10, 10, 5}));
+  ASSERT_EQ(analysis.keyframeIntervals.size(), 2u);
+  EXPECT_DOUBLE_EQ(analysis.keyframeIntervals.at(0), 0.4);
+  EXPECT_DOUBLE_EQ(analysis.keyframeIntervals.at(1), 0.4);
+}
+
+TEST(PacketAnalyzer, ShouldReportTimestampIssues)
+{
+  PacketAnalyzerSettings settings;
+  settings.maxListedGaps = 1;
+  PacketAnalyzer analyzer(settings);
+  analyzer.addStream(0, {1, 1000});
+
+  analyzer.addPacket(createPacket(0, 100, true));
+  analyzer.addPacket(createPacket(40, 100));
+  // A gap of 3 frames
+  analyzer.addPacket(createPacket(200, 100));
+  // Going backwards
+  analyzer.addPacket(createPacket(120, 100));
+
+  auto packetWithoutTimestamps = createPacket(0, 100);
+  packetWithoutTimestamps.dts.reset();
+  packetWithoutTimestamps.pts.reset();
+  packetWithoutTimestamps.corrupt = true;
+  analyzer.addPacket(packetWithoutTimestamps);
+
+  auto packetWithPTSBeforeDTS = createPacket(160, 100);
+  packetWithPTSBeforeDTS.pts  = 100;
+  analyzer.addPacket(packetWithPTSBeforeDTS);
+
+  const auto analysis = analyzer.finish().at(0);
+  EXPECT_EQ(analysis.numberOfPackets, 6u);
+  EXPECT_EQ(analysis.numberOfCorruptPackets, 1u);
+  EXPECT_EQ(analysis.numberOfPacketsWithoutDTS, 1u);
+  EXPECT_EQ(analysis.numberOfPacketsWithoutPTS, 1u);
+  EXPECT_EQ(analysis.numberOfNonMonotonicDTS, 1u);
+  EXPECT_EQ(analysis.numberOfPTSBeforeDTS, 1u);
+  EXPECT_EQ(analysis.maxPTSDelay, 2 * FRAME_DURATION);
+  EXPECT_EQ(analysis.firstDTS, 0);
+  EXPECT_EQ(analysis.lastDTS, 160);
+
+  EXPECT_EQ(analysis.numberOfGaps, 2u);
+  ASSERT_EQ(analysis.gaps.size(), 1u);
+  EXPECT_EQ(analysis.gaps.at(0).packetIndex, 2u);
+  EXPECT_EQ(analysis.gaps.at(0).dts, 200);
+  EXPECT_EQ(analysis.gaps.at(0).gap, 120);
+}
+
+TEST(PacketAnalyzer, ShouldIgnorePacketsOfOtherStreams)
+{
+  PacketAnalyzer analyzer;
+  analyzer.addStream(1, {1, 1000});
+
+  auto packet        = createPacket(0, 100, true);
+  packet.streamIndex = 0;
+  analyzer.addPacket(packet);
+  packet.streamIndex = 1;
+  analyzer.addPacket(packet);
+
+  const auto results = analyzer.finish();
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results.at(0).streamIndex, 1);
+  EXPECT_EQ(results.at(0).numberOfPackets, 1u);
+}
+
+} // namespace libffmpeg::analysis
@@ -0,0 +1,442 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Bitstream/BitReader.h>
+#include <Bitstream/NalParser.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace libffmpeg::bitstream
+{
+
+namespace
+{
+
+class BitWriter
+{
+public:
+  BitWriter(std::initializer_list<int> nalHeader)
+  {
+    for (const auto byte : nalHeader)
+      this->writeBits(static_cast<uint32_t>(byte), 8);
+  }
+
+  BitWriter &writeBits(const uint32_t value, const unsigned numberOfBits)
+  {
+    for (unsigned i = numberOfBits; i > 0; --i)
+      this->bits.push_back(((value >> (i - 1)) & 1) == 1);
+    return *this;
+  }
+
+  BitWriter &writeFlag(const bool flag) { return this->writeBits(flag ? 1 : 0, 1); }
+
+  BitWriter &writeUEV(const uint32_t value)
+  {
+    const auto codeNum = value + 1;
+    unsigned   length{};
+    while ((codeNum >> length) > 1)
+      ++length;
+    this->writeBits(0, length);
+    return this->writeBits(codeNum, length + 1);
+  }
+
+  // Add the RBSP trailing bits and insert the emulation prevention bytes
+  ByteVector finish()
+  {
+    this->writeFlag(true);
+    while (this->bits.size() % 8 != 0)
+      this->writeFlag(false);
+
+    ByteVector nalUnit;
+    int        numberOfZeros{};
+    for (std::size_t i = 0; i < this->bits.size(); i += 8)
+    {
+      int byte{};
+      for (std::size_t bit = 0; bit < 8; ++bit)
+        byte = (byte << 1) | (this->bits.at(i + bit) ? 1 : 0);
+
+      if (numberOfZeros >= 2 && byte <= 3)
+      {
+        nalUnit.push_back(std::byte(3));
+        numberOfZeros = 0;
+      }
+      numberOfZeros = (byte == 0) ? numberOfZeros + 1 : 0;
+      nalUnit.push_back(std::byte(byte));
+    }
+    return nalUnit;
+  }
+
+private:
+  std::vector<bool> bits;
+};
+
+// 1920x1080 (cropped from 1088), POC type 0, log2(MaxFrameNum) 4, log2(MaxPOCLsb) 6
+ByteVector createSPSH264()
+{
+  return BitWriter({0x67})
+      .writeBits(66, 8)
+      .writeBits(0, 8)
+      .writeBits(40, 8)
+      .writeUEV(0)
+      .writeUEV(0)
+      .writeUEV(0)
+      .writeUEV(2)
+      .writeUEV(1)
+      .writeFlag(false)
+      .writeUEV(119)
+      .writeUEV(67)
+      .writeFlag(true)
+      .writeFlag(true)
+      .writeFlag(true)
+      .writeUEV(0)
+      .writeUEV(0)
+      .writeUEV(0)
+      .writeUEV(4)
+      .writeFlag(false)
+      .finish();
+}
+
+ByteVector createPPSH264()
+{
+  return BitWriter({0x68}).writeUEV(0).writeUEV(0).writeFlag(true).writeFlag(false).finish();
+}
+
+ByteVector createSliceH264(const int  nalHeader,
+                           const int  sliceType,
+                           const int  frameNum,
+                           const int  picOrderCntLsb,
+                           const bool idr)
+{
+  BitWriter writer({nalHeader});
+  writer.writeUEV(0).writeUEV(static_cast<uint32_t>(sliceType)).writeUEV(0);
+  writer.writeBits(static_cast<uint32_t>(frameNum), 4);
+  if (idr)
+    writer.writeUEV(3);
+  writer.writeBits(static_cast<uint32_t>(picOrderCntLsb), 6);
+  // Some zero slice data to test the emulation prevention
+  writer.writeBits(0, 32);
+  return writer.finish();
+}
+
+// 1920x1080 (cropped from 1088), 64x64 CTBs, log2(MaxPOCLsb) 8, Main profile, level 4.1
+ByteVector createSPSHEVC()
+{
+  BitWriter writer({0x42, 0x01});
+  writer.writeBits(0, 4).writeBits(0, 3).writeFlag(true);
+  writer.writeBits(0, 2).writeFlag(false).writeBits(1, 5).writeBits(0x60000000, 32);
+  writer.writeBits(0, 16).writeBits(0, 32).writeBits(123, 8);
+  writer.writeUEV(0).writeUEV(1).writeUEV(1920).writeUEV(1088);
+  writer.writeFlag(true).writeUEV(0).writeUEV(0).writeUEV(0).writeUEV(4);
+  writer.writeUEV(0).writeUEV(0).writeUEV(4);
+  writer.writeFlag(true).writeUEV(4).writeUEV(2).writeUEV(0);
+  writer.writeUEV(0).writeUEV(3);
+  return writer.finish();
+}
+
+ByteVector createPPSHEVC()
+{
+  return BitWriter({0x44, 0x01})
+      .writeUEV(0)
+      .writeUEV(0)
+      .writeFlag(true)
+      .writeFlag(false)
+      .writeBits(0, 3)
+      .finish();
+}
+
+ByteVector createSliceHEVC(const int  nalType,
+                           const bool firstSlice,
+                           const int  sliceType,
+                           const int  picOrderCntLsb,
+                           const bool dependent = false)
+{
+  BitWriter writer({nalType << 1, 0x01});
+  writer.writeFlag(firstSlice);
+  if (nalType >= 16 && nalType <= 23)
+    writer.writeFlag(false);
+  writer.writeUEV(0);
+  if (!firstSlice)
+    writer.writeFlag(dependent).writeBits(100, 9);
+  if (!dependent)
+  {
+    writer.writeUEV(static_cast<uint32_t>(sliceType));
+    if (nalType != 19 && nalType != 20)
+      writer.writeBits(static_cast<uint32_t>(picOrderCntLsb), 8);
+  }
+  writer.writeBits(0, 32);
+  return writer.finish();
+}
+
+ByteVector createAnnexB(const std::vector<ByteVector> &nalUnits)
+{
+  ByteVector data;
+  for (const auto &nalUnit : nalUnits)
+  {
+    for (const auto byte : {0, 0, 0, 1})
+      data.push_back(std::byte(byte));
+    data.insert(data.end(), nalUnit.begin(), nalUnit.end());
+  }
+  return data;
+}
+
+ByteVector createLengthPrefixed(const std::vector<ByteVector> &nalUnits)
+{
+  ByteVector data;
+  for (const auto &nalUnit : nalUnits)
+  {
+    const auto size = nalUnit.size();
+    for (const auto shift : {24, 16, 8, 0})
+      data.push_back(std::byte((size >> shift) & 0xff));
+    data.insert(data.end(), nalUnit.begin(), nalUnit.end());
+  }
+  return data;
+}
+
+void appendParameterSet(ByteVector &data, const ByteVector &nalUnit)
+{
+  data.push_back(std::byte((nalUnit.size() >> 8) & 0xff));
+  data.push_back(std::byte(nalUnit.size() & 0xff));
+  data.insert(data.end(), nalUnit.begin(), nalUnit.end());
+}
+
+ByteVector createAVCC()
+{
+  ByteVector avcc;
+  for (const auto byte : {0x01, 66, 0x00, 40, 0xff, 0xe1})
+    avcc.push_back(std::byte(byte));
+  appendParameterSet(avcc, createSPSH264());
+  avcc.push_back(std::byte(1));
+  appendParameterSet(avcc, createPPSH264());
+  return avcc;
+}
+
+ByteVector createHVCC()
+{
+  ByteVector hvcc(23, std::byte(0));
+  hvcc.at(0)  = std::byte(1);
+  hvcc.at(21) = std::byte(0xff);
+  hvcc.at(22) = std::byte(2);
+  for (const auto &[type, nalUnit] :
+       {std::pair{33, createSPSHEVC()}, std::pair{34, createPPSHEVC()}})
+  {
+    for (const auto byte : {0x80 | type, 0x00, 0x01})
+      hvcc.push_back(std::byte(byte));
+    appendParameterSet(hvcc, nalUnit);
+  }
+  return hvcc;
+}
+
+} // namespace
+
+TEST(BitReader, ShouldReadBitsAndExpGolombCodes)
+{
+  // 101 | 1 (ue 0) | 010 (ue 1) | 00111 (ue 6) | 011 (se -1) | 00100 (se 2)
+  const ByteVector data = {std::byte(0b10110100), std::byte(0b01110110), std::byte(0b01000000)};
+
+  BitReader reader(data);
+  EXPECT_EQ(reader.readBits(3), 5u);
+  EXPECT_EQ(reader.readUEV(), 0u);
+  EXPECT_EQ(reader.readUEV(), 1u);
+  EXPECT_EQ(reader.readUEV(), 6u);
+  EXPECT_EQ(reader.readSEV(), -1);
+  EXPECT_EQ(reader.readSEV(), 2);
+  EXPECT_EQ(reader.getBitPosition(), 20u);
+  EXPECT_FALSE(reader.hasError());
+
+  reader.skipBits(5);
+  EXPECT_EQ(reader.readBits(1), 0u);
+  EXPECT_TRUE(reader.hasError());
+}
+
+TEST(BitReader, ShouldRemoveEmulationPreventionBytes)
+{
+  const ByteVector nalUnit = {
+      std::byte(0), std::byte(0), std::byte(3), std::byte(1), std::byte(0), std::byte(0),
+      std::byte(3), std::byte(0), std::byte(3)};
+
+  ByteVector rbsp;
+  convertToRBSP(nalUnit, rbsp, nalUnit.size());
+  EXPECT_EQ(rbsp, ByteVector({std::byte(0), std::byte(0), std::byte(1), std::byte(0),
+                              std::byte(0), std::byte(0), std::byte(3)}));
+
+  convertToRBSP(nalUnit, rbsp, 2);
+  EXPECT_EQ(rbsp.size(), 2u);
+}
+
+TEST(NalParser, ShouldParseH264WithAVCCExtradata)
+{
+  NalParser parser(Codec::H264);
+  ASSERT_TRUE(parser.parseExtradata(createAVCC()));
+  EXPECT_EQ(parser.getNalLengthSize(), 4u);
+
+  ASSERT_EQ(parser.getSPSs().size(), 1u);
+  const auto &sps = parser.getSPSs().at(0);
+  EXPECT_EQ(sps.profile, 66);
+  EXPECT_EQ(sps.level, 40);
+  EXPECT_EQ(sps.size, Size({1920, 1080}));
+  EXPECT_EQ(sps.log2MaxFrameNum, 4);
+  EXPECT_EQ(sps.log2MaxPicOrderCntLsb, 6);
+  EXPECT_EQ(sps.maxNumberOfReferenceFrames, 1);
+  ASSERT_EQ(parser.getPPSs().size(), 1u);
+  EXPECT_TRUE(parser.getPPSs().at(0).entropyCodingMode);
+
+  PacketNalUnits result;
+  ASSERT_TRUE(parser.parsePacket(createLengthPrefixed({createSliceH264(0x65, 7, 0, 0, true)}),
+                                 result));
+  ASSERT_EQ(result.nalUnits.size(), 1u);
+  EXPECT_EQ(result.nalUnits.at(0).type, 5);
+  EXPECT_EQ(result.nalUnits.at(0).offset, 4u);
+  EXPECT_TRUE(result.keyframe);
+  EXPECT_TRUE(result.reference);
+  EXPECT_EQ(result.pictureType, SliceType::I);
+  const auto &idrSlice = result.nalUnits.at(0).slice.value();
+  EXPECT_EQ(idrSlice.idrPicID, 3);
+  EXPECT_EQ(idrSlice.frameNum, 0);
+  EXPECT_EQ(idrSlice.picOrderCntLsb, 0);
+
+  ASSERT_TRUE(parser.parsePacket(createLengthPrefixed({createSliceH264(0x01, 6, 2, 37, false)}),
+                                 result));
+  EXPECT_FALSE(result.keyframe);
+  EXPECT_FALSE(result.reference);
+  EXPECT_EQ(result.pictureType, SliceType::B);
+  const auto &bSlice = result.nalUnits.at(0).slice.value();
+  EXPECT_FALSE(bSlice.idrPicID);
+  EXPECT_EQ(bSlice.frameNum, 2);
+  EXPECT_EQ(bSlice.picOrderCntLsb, 37);
+}
+
+TEST(NalParser, ShouldParseH264AnnexBWithInBandParameterSets)
+{
+  NalParser parser(Codec::H264);
+  ASSERT_TRUE(parser.parseExtradata({}));
+  EXPECT_EQ(parser.getNalLengthSize(), 0u);
+
+  const auto data = createAnnexB({createSPSH264(),
+                                  createPPSH264(),
+                                  createSliceH264(0x41, 5, 1, 4, false),
+                                  createSliceH264(0x41, 7, 1, 4, false)});
+
+  PacketNalUnits result;
+  ASSERT_TRUE(parser.parsePacket(data, result));
+  ASSERT_EQ(result.nalUnits.size(), 4u);
+  EXPECT_EQ(result.nalUnits.at(0).type, 7);
+  EXPECT_EQ(result.nalUnits.at(0).offset, 4u);
+  EXPECT_EQ(result.nalUnits.at(0).size, createSPSH264().size());
+  EXPECT_EQ(result.nalUnits.at(1).type, 8);
+  EXPECT_EQ(result.nalUnits.at(2).slice->sliceType, SliceType::P);
+  EXPECT_EQ(result.nalUnits.at(2).slice->picOrderCntLsb, 4);
+  EXPECT_EQ(result.nalUnits.at(3).slice->sliceType, SliceType::I);
+  EXPECT_EQ(result.pictureType, SliceType::P);
+  EXPECT_TRUE(result.reference);
+  EXPECT_EQ(parser.getSPSs().size(), 1u);
+}
+
+TEST(NalParser, ShouldReportInvalidLengthPrefixes)
+{
+  NalParser parser(Codec::H264);
+  ASSERT_TRUE(parser.parseExtradata(createAVCC()));
+
+  auto data = createLengthPrefixed(
+      {createSliceH264(0x65, 7, 0, 0, true), createSliceH264(0x41, 5, 1, 2, false)});
+  data.resize(data.size() - 1);
+
+  PacketNalUnits result;
+  EXPECT_FALSE(parser.parsePacket(data, result));
+  EXPECT_EQ(result.nalUnits.size(), 1u);
+}
+
+TEST(NalParser, ShouldParseHEVCWithHVCCExtradata)
+{
+  NalParser parser(Codec::HEVC);
+  ASSERT_TRUE(parser.parseExtradata(createHVCC()));
+  EXPECT_EQ(parser.getNalLengthSize(), 4u);
+
+  ASSERT_EQ(parser.getSPSs().size(), 1u);
+  const auto &sps = parser.getSPSs().at(0);
+  EXPECT_EQ(sps.profile, 1);
+  EXPECT_EQ(sps.level, 123);
+  EXPECT_EQ(sps.size, Size({1920, 1080}));
+  EXPECT_EQ(sps.log2MaxPicOrderCntLsb, 8);
+  EXPECT_EQ(sps.picSizeInCtbs, 30 * 17);
+  ASSERT_EQ(parser.getPPSs().size(), 1u);
+  EXPECT_TRUE(parser.getPPSs().at(0).dependentSliceSegmentsEnabled);
+
+  PacketNalUnits result;
+  ASSERT_TRUE(parser.parsePacket(createLengthPrefixed({createSliceHEVC(19, true, 2, 0)}), result));
+  EXPECT_TRUE(result.keyframe);
+  EXPECT_EQ(result.pictureType, SliceType::I);
+  EXPECT_FALSE(result.nalUnits.at(0).slice->picOrderCntLsb);
+
+  const auto data = createLengthPrefixed({createSliceHEVC(1, true, 1, 200),
+                                          createSliceHEVC(1, false, 0, 200),
+                                          createSliceHEVC(1, false, 0, 0, true)});
+  ASSERT_TRUE(parser.parsePacket(data, result));
+  ASSERT_EQ(result.nalUnits.size(), 3u);
+  EXPECT_FALSE(result.keyframe);
+  EXPECT_TRUE(result.reference);
+  EXPECT_EQ(result.pictureType, SliceType::B);
+  EXPECT_EQ(result.nalUnits.at(0).slice->picOrderCntLsb, 200);
+  EXPECT_EQ(result.nalUnits.at(1).slice->sliceType, SliceType::B);
+  EXPECT_TRUE(result.nalUnits.at(2).slice->dependentSliceSegment);
+  EXPECT_FALSE(result.nalUnits.at(2).slice->sliceType);
+
+  ASSERT_TRUE(parser.parsePacket(createLengthPrefixed({createSliceHEVC(0, true, 0, 3)}), result));
+  EXPECT_FALSE(result.reference);
+  EXPECT_EQ(result.nalUnits.at(0).temporalID, 0);
+}
+
+TEST(NalParser, ShouldFindTheSameNalUnitsWithAllImplementations)
+{
+  std::mt19937                       generator(42);
+  std::uniform_int_distribution<int> sizeDistribution(1, 300);
+  std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+  // Random payloads with many zero bytes so that almost start codes occur as well
+  std::vector<ByteVector> nalUnits;
+  for (int i = 0; i < 50; ++i)
+  {
+    ByteVector nalUnit;
+    nalUnit.push_back(std::byte(0x41));
+    const auto size = sizeDistribution(generator);
+    for (int j = 0; j < size; ++j)
+    {
+      const auto value = byteDistribution(generator);
+      nalUnit.push_back(std::byte(value < 128 ? 0 : value));
+    }
+    nalUnit.push_back(std::byte(0x80));
+    nalUnits.push_back(nalUnit);
+  }
+  const auto data = createAnnexB(nalUnits);
+
+  using Implementation = NalParserSettings::Implementation;
+  std::vector<std::vector<std::pair<std::size_t, std::size_t>>> nalUnitPositions;
+  for (const auto implementation :
+       {Implementation::Scalar, Implementation::AVX2, Implementation::Auto})
+  {
+    NalParser      parser(Codec::H264, {implementation});
+    PacketNalUnits result;
+    parser.parsePacket(data, result);
+
+    auto &positions = nalUnitPositions.emplace_back();
+    for (const auto &nalUnit : result.nalUnits)
+      positions.push_back({nalUnit.offset, nalUnit.size});
+  }
+
+  EXPECT_EQ(nalUnitPositions.at(0).size(), nalUnits.size());
+  EXPECT_EQ(nalUnitPositions.at(0), nalUnitPositions.at(1));
+  EXPECT_EQ(nalUnitPositions.at(0), nalUnitPositions.at(2));
+}
+
+TEST(NalParser, ShouldMapCodecNames)
+{
+  EXPECT_EQ(codecFromName("h264"), Codec::H264);
+  EXPECT_EQ(codecFromName("hevc"), Codec::HEVC);
+  EXPECT_FALSE(codecFromName("av1"));
+}
+
+} // namespace libffmpeg::bitstream
@@ -0,0 +1,245 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <BitstreamFilter.h>
+#include <common/Error.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVCodec/VersionToAVCodecTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <deque>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using internal::AVBitStreamFilter;
+using internal::AVBSFContext;
+using internal::AVCodecParameters;
+using internal::AVPacket;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr auto TEST_FILTER_NAME = "h264_mp4toannexb";
+constexpr auto TEST_CODEC_ID    = internal::AVCodecID(27);
+constexpr auto TEST_TIME_BASE   = Rational({1, 90000});
+
+// A filter that passes the packets through and buffers at most 2 packets
+template <FFmpegVersion V> class FFmpegLibrariesMockWithBitstreamFilter : public FFmpegLibrariesMock
+{
+public:
+  using AVBSFContextType      = avcodec::AVBSFContextType<V>;
+  using AVCodecParametersType = avcodec::AVCodecParametersType<V>;
+  using AVPacketType          = avcodec::AVPacketType<V>;
+
+  static constexpr std::size_t MAX_BUFFERED_PACKETS = 2;
+
+  FFmpegLibrariesMockWithBitstreamFilter() : FFmpegLibrariesMock()
+  {
+    this->avcodec.av_packet_alloc = []() { return reinterpret_cast<AVPacket *>(new AVPacketType); };
+    this->avcodec.av_packet_free  = [](AVPacket **packet)
+    {
+      delete reinterpret_cast<AVPacketType *>(*packet);
+      *packet = nullptr;
+    };
+
+    this->avcodec.av_bsf_get_by_name = [this](const char *name) -> const AVBitStreamFilter *
+    {
+      if (std::string(name) == TEST_FILTER_NAME)
+        return reinterpret_cast<const AVBitStreamFilter *>(&this->filterDummy);
+      return nullptr;
+    };
+    this->avcodec.av_bsf_alloc = [](const AVBitStreamFilter *, AVBSFContext **context)
+    {
+      auto newContext     = new AVBSFContextType;
+      newContext->par_in  = reinterpret_cast<AVCodecParameters *>(new AVCodecParametersType);
+      newContext->par_out = reinterpret_cast<AVCodecParameters *>(new AVCodecParametersType);
+      *context            = reinterpret_cast<AVBSFContext *>(newContext);
+      return 0;
+    };
+    this->avcodec.avcodec_parameters_copy =
+        [](AVCodecParameters *destination, const AVCodecParameters *source)
+    {
+      reinterpret_cast<AVCodecParametersType *>(destination)->codec_id =
+          reinterpret_cast<const AVCodecParametersType *>(source)->codec_id;
+      return 0;
+    };
+    this->avcodec.av_bsf_init = [](AVBSFContext *context)
+    {
+      auto castContext = reinterpret_cast<AVBSFContextType *>(context);
+      reinterpret_cast<AVCodecParametersType *>(castContext->par_out)->codec_id =
+          reinterpret_cast<AVCodecParametersType *>(castContext->par_in)->codec_id;
+      castContext->time_base_out = castContext->time_base_in;
+      return 0;
+    };
+    this->avcodec.av_bsf_send_packet = [this](AVBSFContext *, AVPacket *packet)
+    {
+      if (packet == nullptr)
+      {
+        this->endOfStream = true;
+        return 0;
+      }
+      if (this->bufferedPTS.size() >= MAX_BUFFERED_PACKETS)
+        return toAVError(ReturnCode::TryAgain);
+
+      // Move the packet into the filter
+      auto castPacket = reinterpret_cast<AVPacketType *>(packet);
+      this->bufferedPTS.push_back(castPacket->pts);
+      castPacket->pts = internal::AV_NOPTS_VALUE;
+      return 0;
+    };
+    this->avcodec.av_bsf_receive_packet = [this](AVBSFContext *, AVPacket *packet)
+    {
+      if (this->bufferedPTS.empty())
+        return toAVError(this->endOfStream ? ReturnCode::EndOfFile : ReturnCode::TryAgain);
+
+      reinterpret_cast<AVPacketType *>(packet)->pts = this->bufferedPTS.front();
+      this->bufferedPTS.pop_front();
+      return 0;
+    };
+    this->avcodec.av_bsf_flush = [this](AVBSFContext *)
+    {
+      this->bufferedPTS.clear();
+      this->endOfStream = false;
+    };
+    this->avcodec.av_bsf_free = [this](AVBSFContext **context)
+    {
+      auto castContext = reinterpret_cast<AVBSFContextType *>(*context);
+      delete reinterpret_cast<AVCodecParametersType *>(castContext->par_in);
+      delete reinterpret_cast<AVCodecParametersType *>(castContext->par_out);
+      delete castContext;
+      *context = nullptr;
+      ++this->numberOfFreedContexts;
+    };
+  }
+
+  std::deque<int64_t> bufferedPTS;
+  bool                endOfStream{};
+  int                 numberOfFreedContexts{};
+
+private:
+  AVDummy filterDummy;
+};
+
+avcodec::AVPacketWrapper createPacket(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                      const int64_t                     pts)
+{
+  avcodec::AVPacketWrapper packet(ffmpegLibraries);
+  packet.setTimestamps(pts, pts);
+  return packet;
+}
+
+template <FFmpegVersion V> void runFilterPacketsTest()
+{
+  const auto version = getLibraryVerions(V);
+
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMockWithBitstreamFilter<V>>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(version));
+
+  avcodec::AVCodecParametersType<V> inputParameters{};
+  inputParameters.codec_id = TEST_CODEC_ID;
+  const avcodec::AVCodecParametersWrapper inputParametersWrapper(
+      reinterpret_cast<AVCodecParameters *>(&inputParameters), ffmpegLibraries);
+
+  {
+    BitstreamFilter filter(ffmpegLibraries);
+    const auto opened = filter.open(TEST_FILTER_NAME, inputParametersWrapper, TEST_TIME_BASE);
+    if (version.avcodec.major == 56)
+    {
+      EXPECT_FALSE(opened);
+      EXPECT_FALSE(filter);
+      return;
+    }
+
+    ASSERT_TRUE(opened);
+    EXPECT_TRUE(filter);
+    EXPECT_EQ(filter.getOutputTimeBase(), TEST_TIME_BASE);
+    EXPECT_EQ(filter.getOutputCodecParameters()->getCodecID(), TEST_CODEC_ID);
+
+    // Fill the filter so that the next packet can not be sent
+    for (const int64_t pts : {0, 1})
+    {
+      auto packet = createPacket(ffmpegLibraries, pts);
+      EXPECT_EQ(filter.sendPacket(packet), ReturnCode::Ok);
+      EXPECT_FALSE(packet.getPTS());
+    }
+    auto packet = createPacket(ffmpegLibraries, 2);
+    EXPECT_EQ(filter.sendPacket(packet), ReturnCode::TryAgain);
+    EXPECT_EQ(packet.getPTS(), 2);
+
+    std::vector<avcodec::AVPacketWrapper> filteredPackets;
+    EXPECT_TRUE(filter.filterPacket(std::move(packet), filteredPackets));
+    EXPECT_TRUE(filter.filterPacket(createPacket(ffmpegLibraries, 3), filteredPackets));
+    ASSERT_EQ(filteredPackets.size(), 4u);
+    for (int64_t pts = 0; pts < 4; ++pts)
+      EXPECT_EQ(filteredPackets.at(pts).getPTS(), pts);
+
+    EXPECT_FALSE(filter.receivePacket());
+    EXPECT_FALSE(filter.hasReachedEndOfStream());
+    EXPECT_EQ(filter.sendEndOfStream(), ReturnCode::Ok);
+    EXPECT_FALSE(filter.receivePacket());
+    EXPECT_TRUE(filter.hasReachedEndOfStream());
+
+    filter.flush();
+    EXPECT_FALSE(filter.hasReachedEndOfStream());
+  }
+
+  EXPECT_EQ(ffmpegLibraries->numberOfFreedContexts, 1);
+}
+
+template <FFmpegVersion V> void runUnknownFilterTest()
+{
+  const auto version = getLibraryVerions(V);
+
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMockWithBitstreamFilter<V>>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(version));
+
+  avcodec::AVCodecParametersType<V>       inputParameters{};
+  const avcodec::AVCodecParametersWrapper inputParametersWrapper(
+      reinterpret_cast<AVCodecParameters *>(&inputParameters), ffmpegLibraries);
+
+  BitstreamFilter filter(ffmpegLibraries);
+  EXPECT_FALSE(filter.open("unknown_filter", inputParametersWrapper, TEST_TIME_BASE));
+  EXPECT_FALSE(filter);
+  EXPECT_FALSE(filter.receivePacket());
+  EXPECT_EQ(ffmpegLibraries->numberOfFreedContexts, 0);
+}
+
+} // namespace
+
+class BitstreamFilterTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST_F(BitstreamFilterTest, ConstructorWithNullptrForFFmpegLibrariesShouldThrow)
+{
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  EXPECT_THROW(BitstreamFilter filter(ffmpegLibraries), std::runtime_error);
+}
+
+TEST_P(BitstreamFilterTest, FilterPackets)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runFilterPacketsTest);
+}
+
+TEST_P(BitstreamFilterTest, OpenUnknownFilterShouldFail)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runUnknownFilterTest);
+}
+
+INSTANTIATE_TEST_SUITE_P(BitstreamFilter,
+                         BitstreamFilterTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg
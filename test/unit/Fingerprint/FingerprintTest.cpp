@@ -0,0 +1,82 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Fingerprint/Fingerprint.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+namespace libffmpeg::fingerprint
+{
+
+namespace
+{
+
+using Type = FingerprintEntry::Type;
+
+const auto TEST_FILE = std::filesystem::temp_directory_path() / "LibFFmpegTest_Fingerprint.txt";
+
+} // namespace
+
+TEST(Fingerprint, WriteAndReadShouldRoundTrip)
+{
+  const std::vector<FingerprintEntry> entries = {{Type::Packet, 0, 0, 0, 0x01234567},
+                                                 {Type::Packet, 1, 0, {}, 0xffffffff},
+                                                 {Type::Frame, 0, 0, -1024, 0},
+                                                 {Type::Frame, 0, 1, 1ll << 40, 0x89abcdef}};
+
+  {
+    FingerprintWriter writer;
+    EXPECT_FALSE(writer.isOpen());
+    ASSERT_TRUE(writer.open(TEST_FILE));
+    for (const auto &entry : entries)
+      writer.add(entry);
+    EXPECT_TRUE(writer.close());
+  }
+
+  FingerprintReader reader;
+  ASSERT_TRUE(reader.open(TEST_FILE));
+  for (const auto &entry : entries)
+  {
+    const auto readEntry = reader.readNext();
+    ASSERT_TRUE(readEntry);
+    EXPECT_EQ(*readEntry, entry);
+  }
+  EXPECT_FALSE(reader.readNext());
+  EXPECT_FALSE(reader.hasError());
+
+  std::filesystem::remove(TEST_FILE);
+}
+
+TEST(Fingerprint, ReaderShouldReportInvalidLines)
+{
+  {
+    std::ofstream file(TEST_FILE);
+    file << "# LibFFmpeg fingerprint version 1\n";
+    file << "# A comment\n";
+    file << "frame 0 0 - 0000abcd\n";
+    file << "frame 0 1 x 0000abcd\n";
+  }
+
+  FingerprintReader reader;
+  ASSERT_TRUE(reader.open(TEST_FILE));
+  const auto entry = reader.readNext();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(*entry, FingerprintEntry({Type::Frame, 0, 0, {}, 0xabcd}));
+  EXPECT_FALSE(reader.readNext());
+  EXPECT_TRUE(reader.hasError());
+
+  {
+    std::ofstream file(TEST_FILE);
+    file << "Some other file\n";
+  }
+  EXPECT_FALSE(reader.open(TEST_FILE));
+
+  std::filesystem::remove(TEST_FILE);
+}
+
+} // namespace libffmpeg::fingerprint
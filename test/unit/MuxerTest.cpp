@@ -0,0 +1,404 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVFormat/OutputContexts.h>
+#include <Muxer.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVCodec/VersionToAVCodecTypes.h>
+#include <wrappers/AVFormat/VersionToAVFormatTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using internal::AVCodec;
+using internal::AVCodecParameters;
+using internal::AVDictionary;
+using internal::AVFormatContext;
+using internal::AVIOContext;
+using internal::AVOutputFormat;
+using internal::AVPacket;
+using internal::AVRational;
+using internal::AVStream;
+using internal::functions::ReadPacketFunction;
+using internal::functions::SeekFunction;
+using internal::functions::WritePacketFunction;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr auto INPUT_STREAM_INDEX = 3;
+constexpr auto INPUT_TIME_BASE    = AVRational({1, 90000});
+constexpr auto OUTPUT_TIME_BASE   = AVRational({1, 1000});
+
+const auto HEADER  = ByteVector({std::byte('H'), std::byte('D'), std::byte('R')});
+const auto TRAILER = ByteVector({std::byte('E'), std::byte('N'), std::byte('D')});
+
+// A muxer that writes the header, the packet data and the trailer directly to the IO context.
+// Like e.g. the mp4 muxer, the time base of the streams is changed when writing the header.
+template <FFmpegVersion V> class FFmpegLibrariesMockWithMuxer : public FFmpegLibrariesMock
+{
+public:
+  using AVFormatContextType   = avformat::AVFormatContextType<V>;
+  using AVIOContextType       = avformat::AVIOContextType<V>;
+  using AVStreamType          = avformat::AVStreamType<V>;
+  using AVCodecParametersType = avcodec::AVCodecParametersType<V>;
+  using AVPacketType          = avcodec::AVPacketType<V>;
+
+  struct WrittenPacket
+  {
+    int     streamIndex{};
+    int64_t pts{};
+    int64_t dts{};
+    int64_t pos{};
+  };
+
+  FFmpegLibrariesMockWithMuxer() : FFmpegLibrariesMock()
+  {
+    this->avutil.av_mallocz = [](size_t size) { return std::calloc(1, size); };
+    this->avformat.avio_alloc_context = [this](unsigned char *buffer,
+                                               int,
+                                               int                  write_flag,
+                                               void                *opaque,
+                                               ReadPacketFunction  *read_packet,
+                                               WritePacketFunction *write_packet,
+                                               SeekFunction        *seek)
+    {
+      EXPECT_EQ(write_flag, 1);
+      EXPECT_EQ(read_packet, nullptr);
+      EXPECT_NE(write_packet, nullptr);
+
+      this->opaque         = opaque;
+      this->writeCallback  = write_packet;
+      this->outputSeekable = (seek != nullptr);
+
+      auto context    = static_cast<AVIOContextType *>(std::calloc(1, sizeof(AVIOContextType)));
+      context->buffer = buffer;
+      return reinterpret_cast<AVIOContext *>(context);
+    };
+    this->avformat.avio_context_free = [](AVIOContext **context)
+    {
+      std::free(*context);
+      *context = nullptr;
+    };
+    this->avutil.av_freep = [](void *pointer)
+    {
+      auto castPointer = static_cast<void **>(pointer);
+      std::free(*castPointer);
+      *castPointer = nullptr;
+    };
+
+    this->avformat.avformat_alloc_output_context2 = [this](AVFormatContext **context,
+                                                           const AVOutputFormat *,
+                                                           const char *formatName,
+                                                           const char *)
+    {
+      if (formatName == nullptr || std::string(formatName) != "testformat")
+        return -1;
+      *context = reinterpret_cast<AVFormatContext *>(&this->formatContext);
+      ++this->numberOfOpenContexts;
+      return 0;
+    };
+    this->avformat.avformat_free_context = [this](AVFormatContext *)
+    { --this->numberOfOpenContexts; };
+
+    this->avformat.avformat_new_stream = [this](AVFormatContext *, const AVCodec *)
+    {
+      auto stream   = std::make_unique<AVStreamType>();
+      stream->index = static_cast<int>(this->streams.size());
+      if constexpr (V != FFmpegVersion::FFmpeg_2x)
+      {
+        auto parameters  = std::make_unique<AVCodecParametersType>();
+        stream->codecpar = reinterpret_cast<AVCodecParameters *>(parameters.get());
+        this->codecParameters.push_back(std::move(parameters));
+      }
+      this->streams.push_back(std::move(stream));
+      this->streamPointers.push_back(reinterpret_cast<AVStream *>(this->streams.back().get()));
+
+      this->formatContext.streams    = this->streamPointers.data();
+      this->formatContext.nb_streams = static_cast<unsigned>(this->streams.size());
+      return this->streamPointers.back();
+    };
+    this->avcodec.avcodec_parameters_copy = [](AVCodecParameters       *destination,
+                                               const AVCodecParameters *source)
+    {
+      *reinterpret_cast<AVCodecParametersType *>(destination) =
+          *reinterpret_cast<const AVCodecParametersType *>(source);
+      return 0;
+    };
+
+    this->avformat.avformat_write_header = [this](AVFormatContext *, AVDictionary **)
+    {
+      for (auto &stream : this->streams)
+        stream->time_base = OUTPUT_TIME_BASE;
+      this->write(HEADER);
+      return 0;
+    };
+    this->avformat.av_interleaved_write_frame = [this](AVFormatContext *, AVPacket *packet)
+    {
+      const auto castPacket = reinterpret_cast<AVPacketType *>(packet);
+      this->writtenPackets.push_back(
+          {castPacket->stream_index, castPacket->pts, castPacket->dts, castPacket->pos});
+      this->write(ByteVector(reinterpret_cast<std::byte *>(castPacket->data),
+                             reinterpret_cast<std::byte *>(castPacket->data + castPacket->size)));
+      return 0;
+    };
+    this->avformat.av_write_trailer = [this](AVFormatContext *)
+    {
+      this->write(TRAILER);
+      return 0;
+    };
+
+    this->avcodec.av_packet_alloc = []() { return reinterpret_cast<AVPacket *>(new AVPacketType); };
+    this->avcodec.av_packet_free  = [](AVPacket **packet)
+    {
+      auto castPacket = reinterpret_cast<AVPacketType *>(*packet);
+      delete[] castPacket->data;
+      delete castPacket;
+      *packet = nullptr;
+    };
+    this->avcodec.av_free_packet = [](AVPacket *packet)
+    {
+      auto castPacket = reinterpret_cast<AVPacketType *>(packet);
+      delete[] castPacket->data;
+      castPacket->data = nullptr;
+    };
+    this->avcodec.av_new_packet = [](AVPacket *packet, int size)
+    {
+      auto castPacket  = reinterpret_cast<AVPacketType *>(packet);
+      castPacket->data = new uint8_t[size];
+      castPacket->size = size;
+      return 0;
+    };
+    this->avcodec.av_packet_rescale_ts = [](AVPacket *packet, AVRational source, AVRational dest)
+    {
+      auto       castPacket = reinterpret_cast<AVPacketType *>(packet);
+      const auto rescale    = [&](const int64_t value)
+      { return value * source.num * dest.den / (int64_t(source.den) * dest.num); };
+      castPacket->pts = rescale(castPacket->pts);
+      castPacket->dts = rescale(castPacket->dts);
+    };
+  }
+
+  void write(const ByteVector &data)
+  {
+    ASSERT_NE(this->writeCallback, nullptr);
+    const auto size = static_cast<int>(data.size());
+    EXPECT_EQ(
+        this->writeCallback(this->opaque, reinterpret_cast<const uint8_t *>(data.data()), size),
+        size);
+  }
+
+  std::vector<WrittenPacket> writtenPackets;
+  int                        numberOfOpenContexts{};
+  bool                       outputSeekable{};
+
+private:
+  AVFormatContextType                                 formatContext{};
+  std::vector<std::unique_ptr<AVStreamType>>          streams;
+  std::vector<AVStream *>                             streamPointers;
+  std::vector<std::unique_ptr<AVCodecParametersType>> codecParameters;
+
+  void                *opaque{};
+  WritePacketFunction *writeCallback{};
+};
+
+template <FFmpegVersion V> std::shared_ptr<FFmpegLibrariesMockWithMuxer<V>> createLibraries()
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMockWithMuxer<V>>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(getLibraryVerions(V)));
+  return ffmpegLibraries;
+}
+
+template <FFmpegVersion V> struct InputStream
+{
+  InputStream()
+  {
+    this->stream.index     = INPUT_STREAM_INDEX;
+    this->stream.time_base = INPUT_TIME_BASE;
+    if constexpr (V != FFmpegVersion::FFmpeg_2x)
+    {
+      this->codecParameters.codec_id = internal::AV_CODEC_ID_TESTING;
+      this->stream.codecpar = reinterpret_cast<AVCodecParameters *>(&this->codecParameters);
+    }
+  }
+
+  AVStream *get() { return reinterpret_cast<AVStream *>(&this->stream); }
+
+  avformat::AVStreamType<V>         stream{};
+  avcodec::AVCodecParametersType<V> codecParameters{};
+};
+
+avcodec::AVPacketWrapper createPacket(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries,
+                                      const int                         streamIndex,
+                                      const int64_t                     timestamp,
+                                      const std::byte                   value)
+{
+  const auto               data = ByteVector({value, value});
+  avcodec::AVPacketWrapper packet(data, ffmpegLibraries);
+  packet.setStreamIndex(streamIndex);
+  packet.setTimestamps(timestamp, timestamp);
+  packet.setPosition(1000 + timestamp);
+  return packet;
+}
+
+template <FFmpegVersion V> void runStreamCopyToMemoryTest()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  {
+    auto        memoryOutput = std::make_unique<avformat::MemoryOutputContext>(ffmpegLibraries);
+    const auto *outputData   = &memoryOutput->getData();
+
+    InputStream<V> input;
+
+    Muxer muxer(ffmpegLibraries);
+    ASSERT_TRUE(muxer.openOutput(std::move(memoryOutput), "testformat"));
+    EXPECT_TRUE(ffmpegLibraries->outputSeekable);
+    EXPECT_EQ(ffmpegLibraries->numberOfOpenContexts, 1);
+
+    const auto outputStreamIndex =
+        muxer.addStream(avformat::AVStreamWrapper(input.get(), ffmpegLibraries));
+    if constexpr (V == FFmpegVersion::FFmpeg_2x)
+    {
+      // Stream copy requires the codec parameters which do not exist in avformat 56
+      EXPECT_FALSE(outputStreamIndex);
+      return;
+    }
+    ASSERT_EQ(outputStreamIndex, 0);
+    EXPECT_EQ(muxer.getFormatContext()->getNumberStreams(), 1);
+
+    const auto outputStream = muxer.getFormatContext()->getStream(0);
+    EXPECT_EQ(outputStream.getCodecID(), internal::AV_CODEC_ID_TESTING);
+    EXPECT_EQ(outputStream.getTimeBase(), Rational({1, 90000}));
+
+    EXPECT_TRUE(muxer.writeHeader());
+    EXPECT_TRUE(
+        muxer.writePacket(createPacket(ffmpegLibraries, INPUT_STREAM_INDEX, 0, std::byte(1))));
+    // Packets of streams that were not added are dropped
+    EXPECT_TRUE(muxer.writePacket(createPacket(ffmpegLibraries, 0, 0, std::byte(7))));
+    EXPECT_TRUE(
+        muxer.writePacket(createPacket(ffmpegLibraries, INPUT_STREAM_INDEX, 3600, std::byte(2))));
+    EXPECT_TRUE(muxer.finish());
+    EXPECT_FALSE(muxer.finish());
+
+    const auto &written = ffmpegLibraries->writtenPackets;
+    ASSERT_EQ(written.size(), 2u);
+    EXPECT_EQ(written.at(0).streamIndex, 0);
+    EXPECT_EQ(written.at(0).pts, 0);
+    EXPECT_EQ(written.at(1).streamIndex, 0);
+    EXPECT_EQ(written.at(1).pts, 40);
+    EXPECT_EQ(written.at(1).dts, 40);
+    // The position in the input file is not copied to the output
+    EXPECT_EQ(written.at(0).pos, -1);
+    EXPECT_EQ(written.at(1).pos, -1);
+
+    ByteVector expectedData = HEADER;
+    for (const auto value : {std::byte(1), std::byte(1), std::byte(2), std::byte(2)})
+      expectedData.push_back(value);
+    expectedData.insert(expectedData.end(), TRAILER.begin(), TRAILER.end());
+    EXPECT_EQ(*outputData, expectedData);
+  }
+
+  EXPECT_EQ(ffmpegLibraries->numberOfOpenContexts, 0);
+}
+
+template <FFmpegVersion V> void runStreamCopyToCallbackTest()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  ByteVector outputData;
+  auto       callbackOutput = std::make_unique<avformat::CallbackOutputContext>(
+      ffmpegLibraries,
+      [&outputData](std::span<const std::byte> data)
+      {
+        outputData.insert(outputData.end(), data.begin(), data.end());
+        return true;
+      });
+
+  Muxer muxer(ffmpegLibraries);
+  ASSERT_TRUE(muxer.openOutput(std::move(callbackOutput), "testformat"));
+  EXPECT_FALSE(ffmpegLibraries->outputSeekable);
+
+  if constexpr (V != FFmpegVersion::FFmpeg_2x)
+  {
+    InputStream<V> input;
+    ASSERT_TRUE(muxer.addStream(avformat::AVStreamWrapper(input.get(), ffmpegLibraries)));
+  }
+
+  EXPECT_TRUE(muxer.writeHeader());
+  EXPECT_TRUE(muxer.finish());
+
+  ByteVector expectedData = HEADER;
+  expectedData.insert(expectedData.end(), TRAILER.begin(), TRAILER.end());
+  EXPECT_EQ(outputData, expectedData);
+}
+
+template <FFmpegVersion V> void runWritingOutOfOrderShouldFail()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  Muxer muxer(ffmpegLibraries);
+  EXPECT_FALSE(muxer.writeHeader());
+  EXPECT_FALSE(muxer.openOutput(std::make_unique<avformat::MemoryOutputContext>(ffmpegLibraries),
+                                "unknownformat"));
+  EXPECT_FALSE(*muxer.getFormatContext());
+
+  ASSERT_TRUE(muxer.openOutput(std::make_unique<avformat::MemoryOutputContext>(ffmpegLibraries),
+                               "testformat"));
+  EXPECT_FALSE(muxer.openOutput(std::make_unique<avformat::MemoryOutputContext>(ffmpegLibraries),
+                                "testformat"));
+
+  // Packets can only be written after the header
+  auto packet = createPacket(ffmpegLibraries, 0, 0, std::byte(1));
+  EXPECT_FALSE(muxer.getFormatContext()->writePacket(packet));
+  EXPECT_FALSE(muxer.finish());
+  EXPECT_TRUE(ffmpegLibraries->writtenPackets.empty());
+}
+
+} // namespace
+
+class MuxerTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST_F(MuxerTest, ConstructorWithNullptrForFFmpegLibrariesShouldThrow)
+{
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  EXPECT_THROW(Muxer muxer(ffmpegLibraries), std::runtime_error);
+}
+
+TEST_P(MuxerTest, StreamCopyToMemory)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runStreamCopyToMemoryTest);
+}
+
+TEST_P(MuxerTest, StreamCopyToCallback)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runStreamCopyToCallbackTest);
+}
+
+TEST_P(MuxerTest, WritingOutOfOrderShouldFail)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runWritingOutOfOrderShouldFail);
+}
+
+INSTANTIATE_TEST_SUITE_P(Muxer,
+                         MuxerTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg
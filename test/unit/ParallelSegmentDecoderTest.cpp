@@ -0,0 +1,175 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <ParallelSegmentDecoder.h>
+#include <common/Error.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVCodec/VersionToAVCodecTypes.h>
+#include <wrappers/AVFormat/VersionToAVFormatTypes.h>
+#include <wrappers/AVUtil/VersionToAVUtilTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <mutex>
+#include <thread>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using internal::AVCodec;
+using internal::AVCodecContext;
+using internal::AVDictionary;
+using internal::AVFormatContext;
+using internal::AVFrame;
+using internal::AVInputFormat;
+using internal::AVPacket;
+using internal::AVStream;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr auto TEST_CODEC_ID = internal::AV_CODEC_ID_TESTING;
+
+// Two keyframes, so that the packets can be split into two segments
+constexpr std::array TEST_KEYFRAMES = {true, false, false, true, false, false};
+
+// A file with one video stream. Every packet is decoded into one frame with the PTS of the packet.
+// Only the FFmpeg 2.x (avformat 56) path is supported where the stream has no codec parameters.
+class FFmpegLibrariesMockWithFile : public FFmpegLibrariesMock
+{
+public:
+  static constexpr auto V = FFmpegVersion::FFmpeg_2x;
+
+  using AVCodecContextType  = avcodec::AVCodecContextType<V>;
+  using AVCodecType         = avcodec::AVCodecType<V>;
+  using AVFormatContextType = avformat::AVFormatContextType<V>;
+  using AVFrameType         = avutil::AVFrameType<V>;
+  using AVPacketType        = avcodec::AVPacketType<V>;
+  using AVStreamType        = avformat::AVStreamType<V>;
+
+  FFmpegLibrariesMockWithFile() : FFmpegLibrariesMock()
+  {
+    this->avformat.avformat_open_input =
+        [this](AVFormatContext **context, const char *, AVInputFormat *, AVDictionary **)
+    {
+      *context = reinterpret_cast<AVFormatContext *>(&this->formatContext);
+      return 0;
+    };
+    this->avformat.avformat_find_stream_info = [](AVFormatContext *, AVDictionary **)
+    { return 0; };
+    this->avformat.avformat_close_input = [](AVFormatContext **context) { *context = nullptr; };
+
+    this->avformat.av_read_frame = [this](AVFormatContext *, AVPacket *packet)
+    {
+      if (this->numberOfReadPackets == TEST_KEYFRAMES.size())
+        return toAVError(ReturnCode::EndOfFile);
+
+      auto castPacket          = reinterpret_cast<AVPacketType *>(packet);
+      castPacket->pts          = static_cast<int64_t>(this->numberOfReadPackets);
+      castPacket->dts          = castPacket->pts;
+      castPacket->stream_index = 0;
+      castPacket->flags        = TEST_KEYFRAMES.at(this->numberOfReadPackets) ? 1 : 0;
+      castPacket->data         = this->packetData.data();
+      castPacket->size         = static_cast<int>(this->packetData.size());
+      ++this->numberOfReadPackets;
+      return 0;
+    };
+
+    this->avutil.av_frame_alloc = []() { return reinterpret_cast<AVFrame *>(new AVFrameType); };
+    this->avutil.av_frame_free  = [](AVFrame **frame)
+    {
+      delete reinterpret_cast<AVFrameType *>(*frame);
+      *frame = nullptr;
+    };
+
+    this->avcodec.avcodec_find_decoder = [this](internal::AVCodecID codecID) -> AVCodec *
+    {
+      EXPECT_EQ(codecID, TEST_CODEC_ID);
+      return reinterpret_cast<AVCodec *>(&this->codec);
+    };
+    this->avcodec.avcodec_decode_video2 =
+        [this](AVCodecContext *context, AVFrame *frame, int *gotFrame, const AVPacket *packet)
+    {
+      EXPECT_EQ(context, reinterpret_cast<AVCodecContext *>(&this->codecContext));
+      {
+        std::scoped_lock lock(this->mutex);
+        this->decodingThreads.push_back(std::this_thread::get_id());
+      }
+
+      const auto castPacket = reinterpret_cast<const AVPacketType *>(packet);
+      if (castPacket->size == 0)
+      {
+        *gotFrame = 0;
+        return 0;
+      }
+
+      reinterpret_cast<AVFrameType *>(frame)->pts = castPacket->pts;
+      *gotFrame                                   = 1;
+      return castPacket->size;
+    };
+
+    this->codecContext.codec_type  = internal::AVMEDIA_TYPE_VIDEO;
+    this->codecContext.codec_id    = TEST_CODEC_ID;
+    this->codec.id                 = TEST_CODEC_ID;
+    this->stream.codec             = reinterpret_cast<AVCodecContext *>(&this->codecContext);
+    this->streamPointers[0]        = reinterpret_cast<AVStream *>(&this->stream);
+    this->formatContext.nb_streams = 1;
+    this->formatContext.streams    = this->streamPointers.data();
+  }
+
+  std::vector<std::thread::id> decodingThreads;
+
+private:
+  AVFormatContextType       formatContext{};
+  AVStreamType              stream{};
+  std::array<AVStream *, 1> streamPointers{};
+  AVCodecContextType        codecContext{};
+  AVCodecType               codec{};
+  std::array<uint8_t, 4>    packetData{};
+  std::size_t               numberOfReadPackets{};
+  std::mutex                mutex;
+};
+
+} // namespace
+
+TEST(ParallelSegmentDecoderTest, CreationWithInvalidFFmpegLibraries_shouldThrow)
+{
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  EXPECT_THROW(ParallelSegmentDecoder decoder(ffmpegLibraries), std::runtime_error);
+}
+
+TEST(ParallelSegmentDecoderTest, DecodeStreamWithoutCodecParameters_shouldUseOneDecoder)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMockWithFile>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion())
+      .WillByDefault(Return(getLibraryVerions(FFmpegVersion::FFmpeg_2x)));
+
+  ParallelSegmentDecoder::Settings settings;
+  settings.numberOfThreads = 4;
+  ParallelSegmentDecoder decoder(ffmpegLibraries, settings);
+
+  std::vector<int64_t> framePTS;
+  EXPECT_TRUE(decoder.decodeFile("dummyFile",
+                                 0,
+                                 [&framePTS](avutil::AVFrameWrapper &&frame)
+                                 { framePTS.push_back(frame.getPTS().value_or(-1)); }));
+
+  EXPECT_EQ(framePTS, std::vector<int64_t>({0, 1, 2, 3, 4, 5}));
+
+  // All segments must be decoded by one decoder on the codec context of the stream. Sharing the
+  // context between worker threads is not possible.
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecOpen2, 1);
+  ASSERT_FALSE(ffmpegLibraries->decodingThreads.empty());
+  for (const auto &threadID : ffmpegLibraries->decodingThreads)
+    EXPECT_EQ(threadID, std::this_thread::get_id());
+}
+
+} // namespace libffmpeg
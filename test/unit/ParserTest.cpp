@@ -0,0 +1,342 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Parser.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVCodec/VersionToAVCodecTypes.h>
+#include <wrappers/AVFormat/VersionToAVFormatTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+using internal::AVCodec;
+using internal::AVCodecContext;
+using internal::AVCodecParserContext;
+using internal::AVIOContext;
+using internal::AVPacket;
+using internal::functions::ReadPacketFunction;
+using internal::functions::SeekFunction;
+using internal::functions::WritePacketFunction;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr auto TEST_CODEC_NAME = "h264";
+constexpr auto TEST_CODEC_ID   = internal::AV_CODEC_ID_TESTING;
+
+constexpr auto START_CODE = std::array{std::byte(0), std::byte(0), std::byte(1)};
+
+// Three NAL units of which the first one is a keyframe (IDR slice)
+const std::vector<ByteVector> TEST_PACKETS = {
+    {std::byte(0), std::byte(0), std::byte(1), std::byte(0x65), std::byte(1), std::byte(2)},
+    {std::byte(0), std::byte(0), std::byte(1), std::byte(0x41), std::byte(3)},
+    {std::byte(0), std::byte(0), std::byte(1), std::byte(0x41), std::byte(4), std::byte(5)}};
+
+ByteVector getTestStream()
+{
+  ByteVector stream;
+  for (const auto &packet : TEST_PACKETS)
+    stream.insert(stream.end(), packet.begin(), packet.end());
+  return stream;
+}
+
+// A parser that splits the stream at start codes
+template <FFmpegVersion V> class FFmpegLibrariesMockWithParser : public FFmpegLibrariesMock
+{
+public:
+  using AVCodecParserContextType = avcodec::AVCodecParserContextType<V>;
+  using AVCodecType              = avcodec::AVCodecType<V>;
+  using AVPacketType             = avcodec::AVPacketType<V>;
+
+  FFmpegLibrariesMockWithParser() : FFmpegLibrariesMock()
+  {
+    this->avcodec.av_packet_alloc = []() { return reinterpret_cast<AVPacket *>(new AVPacketType); };
+    this->avcodec.av_packet_free  = [](AVPacket **packet)
+    {
+      auto castPacket = reinterpret_cast<AVPacketType *>(*packet);
+      delete[] castPacket->data;
+      delete castPacket;
+      *packet = nullptr;
+    };
+    this->avcodec.av_free_packet = [](AVPacket *packet)
+    {
+      auto castPacket = reinterpret_cast<AVPacketType *>(packet);
+      delete[] castPacket->data;
+      castPacket->data = nullptr;
+    };
+    this->avcodec.av_new_packet = [](AVPacket *packet, int size)
+    {
+      auto castPacket  = reinterpret_cast<AVPacketType *>(packet);
+      castPacket->data = new uint8_t[size];
+      castPacket->size = size;
+      return 0;
+    };
+
+    this->avcodec.avcodec_get_name = [](internal::AVCodecID) { return TEST_CODEC_NAME; };
+    this->avcodec.avcodec_find_decoder_by_name = [this](const char *name) -> AVCodec *
+    {
+      if (std::string(name) == TEST_CODEC_NAME)
+        return reinterpret_cast<AVCodec *>(&this->codec);
+      return nullptr;
+    };
+
+    this->avcodec.av_parser_init = [this](int codecID) -> AVCodecParserContext *
+    {
+      if (codecID != TEST_CODEC_ID)
+        return nullptr;
+      ++this->numberOfOpenParsers;
+      return reinterpret_cast<AVCodecParserContext *>(new AVCodecParserContextType);
+    };
+    this->avcodec.av_parser_close = [this](AVCodecParserContext *context)
+    {
+      delete reinterpret_cast<AVCodecParserContextType *>(context);
+      --this->numberOfOpenParsers;
+    };
+    this->avcodec.av_parser_parse2 = [this](AVCodecParserContext *context,
+                                            AVCodecContext *,
+                                            uint8_t      **outputData,
+                                            int           *outputSize,
+                                            const uint8_t *data,
+                                            int            size,
+                                            int64_t        pts,
+                                            int64_t        dts,
+                                            int64_t)
+    { return this->parse(context, outputData, outputSize, data, size, pts, dts); };
+
+    this->codec.id = TEST_CODEC_ID;
+  }
+
+  int parse(AVCodecParserContext *context,
+            uint8_t             **outputData,
+            int                  *outputSize,
+            const uint8_t        *data,
+            const int             size,
+            const int64_t         pts,
+            const int64_t         dts)
+  {
+    auto castContext = reinterpret_cast<AVCodecParserContextType *>(context);
+    castContext->pts = pts;
+    castContext->dts = dts;
+    *outputSize      = 0;
+
+    // Flushing outputs the remaining data
+    if (size == 0)
+    {
+      if (!this->buffer.empty())
+        this->outputPacket(castContext, outputData, outputSize, this->buffer.size());
+      return 0;
+    }
+
+    for (int i = 0; i < size; ++i)
+    {
+      this->buffer.push_back(std::byte(data[i]));
+      if (this->buffer.size() > START_CODE.size() &&
+          std::equal(START_CODE.begin(), START_CODE.end(), this->buffer.end() - START_CODE.size()))
+      {
+        this->outputPacket(
+            castContext, outputData, outputSize, this->buffer.size() - START_CODE.size());
+        return i + 1;
+      }
+    }
+    return size;
+  }
+
+  void outputPacket(AVCodecParserContextType *context,
+                    uint8_t                 **outputData,
+                    int                      *outputSize,
+                    const std::size_t         packetSize)
+  {
+    this->output.assign(this->buffer.begin(), this->buffer.begin() + packetSize);
+    this->buffer.erase(this->buffer.begin(), this->buffer.begin() + packetSize);
+
+    *outputData        = reinterpret_cast<uint8_t *>(this->output.data());
+    *outputSize        = static_cast<int>(this->output.size());
+    context->key_frame = (this->output.at(START_CODE.size()) == std::byte(0x65)) ? 1 : 0;
+  }
+
+  int numberOfOpenParsers{};
+
+private:
+  AVCodecType codec{};
+  ByteVector  buffer;
+  ByteVector  output;
+};
+
+class MemoryInput : public avformat::AVIOInputContext
+{
+public:
+  MemoryInput(std::shared_ptr<IFFmpegLibraries> ffmpegLibraries, const ByteVector &data)
+      : AVIOInputContext(ffmpegLibraries), data(data)
+  {
+  }
+
+  // Read in small chunks so that packets are split over multiple reads
+  std::optional<int> readData(uint8_t *buf, int buf_size) override
+  {
+    const auto remaining = this->data.size() - this->position;
+    const auto size      = std::min({std::size_t(4), std::size_t(buf_size), remaining});
+    std::memcpy(buf, this->data.data() + this->position, size);
+    this->position += size;
+    return static_cast<int>(size);
+  }
+  std::optional<int> getFileSize() const override { return static_cast<int>(this->data.size()); }
+  bool               seek(int64_t) override { return false; }
+
+private:
+  ByteVector  data;
+  std::size_t position{};
+};
+
+template <FFmpegVersion V> std::shared_ptr<FFmpegLibrariesMockWithParser<V>> createLibraries()
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMockWithParser<V>>>();
+  ON_CALL(*ffmpegLibraries, getLibrariesVersion()).WillByDefault(Return(getLibraryVerions(V)));
+  return ffmpegLibraries;
+}
+
+void checkPackets(const std::vector<avcodec::AVPacketWrapper> &packets)
+{
+  ASSERT_EQ(packets.size(), TEST_PACKETS.size());
+  for (std::size_t i = 0; i < packets.size(); ++i)
+  {
+    EXPECT_EQ(packets.at(i).getData(), TEST_PACKETS.at(i));
+    EXPECT_EQ(packets.at(i).getFlags().keyframe, i == 0);
+    EXPECT_FALSE(packets.at(i).getPTS());
+  }
+}
+
+template <FFmpegVersion V> void runParseMemoryTest()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  {
+    Parser parser(ffmpegLibraries);
+    ASSERT_TRUE(parser.open(TEST_CODEC_NAME));
+    EXPECT_TRUE(parser);
+    EXPECT_EQ(parser.getCodecID(), TEST_CODEC_ID);
+    EXPECT_EQ(ffmpegLibraries->numberOfOpenParsers, 1);
+
+    // Feed the stream in chunks that do not match the packet boundaries
+    const auto stream = getTestStream();
+    const auto data   = std::span<const std::byte>(stream);
+
+    std::vector<avcodec::AVPacketWrapper> packets;
+    EXPECT_TRUE(parser.parse(data.subspan(0, 7), packets));
+    EXPECT_EQ(packets.size(), 0u);
+    EXPECT_TRUE(parser.parse(data.subspan(7), packets));
+    EXPECT_EQ(packets.size(), 2u);
+    EXPECT_TRUE(parser.flush(packets));
+    checkPackets(packets);
+  }
+
+  EXPECT_EQ(ffmpegLibraries->numberOfOpenParsers, 0);
+}
+
+template <FFmpegVersion V> void runReadPacketsFromInputTest()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  using AVIOContextType = avformat::AVIOContextType<V>;
+
+  ffmpegLibraries->avutil.av_mallocz = [](size_t size) { return std::calloc(1, size); };
+  ffmpegLibraries->avformat.avio_alloc_context = [](unsigned char *buffer,
+                                                    int,
+                                                    int,
+                                                    void *,
+                                                    ReadPacketFunction *,
+                                                    WritePacketFunction *,
+                                                    SeekFunction *)
+  {
+    auto context    = static_cast<AVIOContextType *>(std::calloc(1, sizeof(AVIOContextType)));
+    context->buffer = buffer;
+    return reinterpret_cast<AVIOContext *>(context);
+  };
+  ffmpegLibraries->avformat.avio_context_free = [](AVIOContext **context)
+  {
+    std::free(*context);
+    *context = nullptr;
+  };
+  ffmpegLibraries->avutil.av_freep = [](void *pointer)
+  {
+    auto castPointer = static_cast<void **>(pointer);
+    std::free(*castPointer);
+    *castPointer = nullptr;
+  };
+
+  MemoryInput input(ffmpegLibraries, getTestStream());
+
+  Parser parser(ffmpegLibraries);
+  ASSERT_TRUE(parser.open(TEST_CODEC_ID));
+
+  std::vector<avcodec::AVPacketWrapper> packets;
+  while (auto packet = parser.readPacket(input))
+    packets.push_back(std::move(*packet));
+  checkPackets(packets);
+
+  EXPECT_FALSE(parser.readPacket(input));
+}
+
+template <FFmpegVersion V> void runOpenUnknownCodecTest()
+{
+  auto ffmpegLibraries = createLibraries<V>();
+
+  Parser parser(ffmpegLibraries);
+  EXPECT_FALSE(parser.open("unknown_codec"));
+  EXPECT_FALSE(parser.open(internal::AV_CODEC_ID_NONE));
+  EXPECT_FALSE(parser);
+
+  std::vector<avcodec::AVPacketWrapper> packets;
+  EXPECT_FALSE(parser.parse(getTestStream(), packets));
+  EXPECT_TRUE(packets.empty());
+  EXPECT_EQ(ffmpegLibraries->numberOfOpenParsers, 0);
+}
+
+} // namespace
+
+class ParserTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST_F(ParserTest, ConstructorWithNullptrForFFmpegLibrariesShouldThrow)
+{
+  std::shared_ptr<IFFmpegLibraries> ffmpegLibraries;
+  EXPECT_THROW(Parser parser(ffmpegLibraries), std::runtime_error);
+}
+
+TEST_P(ParserTest, ParseDataFromMemory)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runParseMemoryTest);
+}
+
+TEST_P(ParserTest, ReadPacketsFromInput)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runReadPacketsFromInputTest);
+}
+
+TEST_P(ParserTest, OpenUnknownCodecShouldFail)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runOpenUnknownCodecTest);
+}
+
+INSTANTIATE_TEST_SUITE_P(Parser,
+                         ParserTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg
@@ -0,0 +1,117 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Probing/BatchProber.h>
+#include <Probing/ProbeCache.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace libffmpeg::probing
+{
+
+namespace
+{
+
+const auto TEST_FILE = std::filesystem::temp_directory_path() / "LibFFmpegTest_ProbeCache.txt";
+const auto TEST_DIRECTORY = std::filesystem::temp_directory_path() / "LibFFmpegTest_Probing";
+
+} // namespace
+
+TEST(ProbeCache, FindShouldOnlyReturnResultsWithSameSizeAndModificationTime)
+{
+  ProbeCache cache;
+  cache.insert("/media/file.mp4", 1000, 42, "{\"a\":1}");
+
+  EXPECT_EQ(cache.find("/media/file.mp4", 1000, 42), "{\"a\":1}");
+  EXPECT_FALSE(cache.find("/media/file.mp4", 1001, 42));
+  EXPECT_FALSE(cache.find("/media/file.mp4", 1000, 43));
+  EXPECT_FALSE(cache.find("/media/other.mp4", 1000, 42));
+}
+
+TEST(ProbeCache, SaveAndLoadShouldRoundTrip)
+{
+  {
+    ProbeCache cache;
+    cache.insert("/media/file.mp4", 1000, 42, "{\"a\":1}");
+    cache.insert("/media/with space and \"quotes\".mkv", 0, -5, "{\"b\":\"x y\"}");
+    ASSERT_TRUE(cache.save(TEST_FILE));
+  }
+
+  ProbeCache cache;
+  ASSERT_TRUE(cache.load(TEST_FILE));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.find("/media/file.mp4", 1000, 42), "{\"a\":1}");
+  EXPECT_EQ(cache.find("/media/with space and \"quotes\".mkv", 0, -5), "{\"b\":\"x y\"}");
+
+  std::filesystem::remove(TEST_FILE);
+}
+
+TEST(ProbeCache, LoadShouldRejectFilesWithoutHeader)
+{
+  {
+    std::ofstream file(TEST_FILE);
+    file << "1000 42 15 /media/file.mp4 {}\n";
+  }
+
+  ProbeCache cache;
+  EXPECT_FALSE(cache.load(TEST_FILE));
+  EXPECT_EQ(cache.size(), 0u);
+
+  std::filesystem::remove(TEST_FILE);
+}
+
+TEST(ProbeCache, RemoveUnusedEntriesShouldKeepFoundAndInsertedEntries)
+{
+  {
+    ProbeCache cache;
+    cache.insert("/media/found.mp4", 1, 1, "{}");
+    cache.insert("/media/deleted.mp4", 1, 1, "{}");
+    ASSERT_TRUE(cache.save(TEST_FILE));
+  }
+
+  ProbeCache cache;
+  ASSERT_TRUE(cache.load(TEST_FILE));
+  EXPECT_TRUE(cache.find("/media/found.mp4", 1, 1));
+  cache.insert("/media/new.mp4", 1, 1, "{}");
+  cache.removeUnusedEntries();
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_FALSE(cache.find("/media/deleted.mp4", 1, 1));
+
+  std::filesystem::remove(TEST_FILE);
+}
+
+TEST(BatchProber, EscapeJSONStringShouldEscapeSpecialCharacters)
+{
+  EXPECT_EQ(escapeJSONString("plain/path.mp4"), "plain/path.mp4");
+  EXPECT_EQ(escapeJSONString("a\"b\\c"), "a\\\"b\\\\c");
+  EXPECT_EQ(escapeJSONString("line\nbreak\ttab"), "line\\nbreak\\ttab");
+  EXPECT_EQ(escapeJSONString(std::string("\x01", 1)), "\\u0001");
+}
+
+TEST(BatchProber, CollectFilesShouldFindFilesRecursivelyOrReadFileList)
+{
+  std::filesystem::create_directories(TEST_DIRECTORY / "sub");
+  std::ofstream(TEST_DIRECTORY / "b.mp4") << "b";
+  std::ofstream(TEST_DIRECTORY / "sub" / "a.mkv") << "a";
+
+  const auto files = collectFiles(TEST_DIRECTORY);
+  ASSERT_EQ(files.size(), 2u);
+  EXPECT_EQ(files.at(0), TEST_DIRECTORY / "b.mp4");
+  EXPECT_EQ(files.at(1), TEST_DIRECTORY / "sub" / "a.mkv");
+
+  std::ofstream(TEST_FILE) << "/media/z.mp4\r\n\n/media/y.mp4\n";
+  const auto listedFiles = collectFiles(TEST_FILE);
+  EXPECT_EQ(listedFiles, std::vector<Path>({"/media/y.mp4", "/media/z.mp4"}));
+
+  std::filesystem::remove_all(TEST_DIRECTORY);
+  std::filesystem::remove(TEST_FILE);
+}
+
+} // namespace libffmpeg::probing
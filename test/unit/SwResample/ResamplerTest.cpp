@@ -0,0 +1,280 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVCodec/wrappers/AVChannelInternal.h>
+#include <SwResample/Resampler.h>
+#include <common/InternalTypes.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVUtil/VersionToAVUtilTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace libffmpeg::swresample
+{
+
+namespace
+{
+
+using libffmpeg::avutil::AVFrameType;
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVSampleFormat;
+using libffmpeg::internal::SwrContext;
+using libffmpeg::internal::avcodec::AVChannelLayout;
+using libffmpeg::internal::avcodec::AVChannelOrder;
+
+using ::testing::Return;
+
+constexpr uint64_t STEREO_MASK            = 0x3;
+constexpr uint64_t MONO_MASK              = 0x4;
+constexpr int      TEST_INPUT_RATE        = 44100;
+constexpr int      TEST_NUMBER_OF_SAMPLES = 1024;
+
+struct SwResampleCalls
+{
+  int            contextsAllocated{};
+  int            contextsFreed{};
+  int            init{};
+  int            convert{};
+  int64_t        delay{};
+  int            lastOutputCapacity{};
+  int            lastInputSamples{};
+  const uint8_t *lastInput{};
+  uint8_t       *lastOutput{};
+  uint64_t       lastInputMask{};
+  uint64_t       lastOutputMask{};
+  int            lastOutputRate{};
+  AVSampleFormat lastOutputFormat{};
+};
+
+template <FFmpegVersion V>
+void setupMockFunctions(FFmpegLibrariesMock &ffmpegLibraries, SwResampleCalls &calls)
+{
+  ffmpegLibraries.avutil.av_frame_alloc = []()
+  { return reinterpret_cast<AVFrame *>(new AVFrameType<V>()); };
+  ffmpegLibraries.avutil.av_frame_free = [](AVFrame **frame)
+  {
+    delete reinterpret_cast<AVFrameType<V> *>(*frame);
+    *frame = nullptr;
+  };
+
+  // Before FFmpeg 5, the audio parameters of the frame are accessed using functions
+  ffmpegLibraries.avutil.av_frame_get_sample_rate = [](const AVFrame *)
+  { return TEST_INPUT_RATE; };
+  ffmpegLibraries.avutil.av_frame_get_channels = [](const AVFrame *) { return 2; };
+  ffmpegLibraries.avutil.av_frame_get_channel_layout = [](const AVFrame *)
+  { return static_cast<int64_t>(STEREO_MASK); };
+
+  const auto allocateContext = [&calls]()
+  {
+    ++calls.contextsAllocated;
+    return reinterpret_cast<SwrContext *>(new AVDummy);
+  };
+
+  if constexpr (V >= FFmpegVersion::FFmpeg_7x)
+    ffmpegLibraries.swresample.swr_alloc_set_opts2 = [&calls, allocateContext](
+                                                         SwrContext            **context,
+                                                         const AVChannelLayout  *outLayout,
+                                                         AVSampleFormat          outFormat,
+                                                         int                     outRate,
+                                                         const AVChannelLayout  *inLayout,
+                                                         AVSampleFormat,
+                                                         int inRate,
+                                                         int,
+                                                         void *)
+    {
+      EXPECT_EQ(inLayout->order, AVChannelOrder::AV_CHANNEL_ORDER_NATIVE);
+      EXPECT_EQ(outLayout->order, AVChannelOrder::AV_CHANNEL_ORDER_NATIVE);
+      EXPECT_EQ(inRate, TEST_INPUT_RATE);
+      calls.lastInputMask    = inLayout->u.mask;
+      calls.lastOutputMask   = outLayout->u.mask;
+      calls.lastOutputRate   = outRate;
+      calls.lastOutputFormat = outFormat;
+      *context               = allocateContext();
+      return 0;
+    };
+  else
+    ffmpegLibraries.swresample.swr_alloc_set_opts = [&calls, allocateContext](
+                                                        SwrContext    *context,
+                                                        int64_t        outLayout,
+                                                        AVSampleFormat outFormat,
+                                                        int            outRate,
+                                                        int64_t        inLayout,
+                                                        AVSampleFormat,
+                                                        int inRate,
+                                                        int,
+                                                        void *)
+    {
+      EXPECT_EQ(context, nullptr);
+      EXPECT_EQ(inRate, TEST_INPUT_RATE);
+      calls.lastInputMask    = static_cast<uint64_t>(inLayout);
+      calls.lastOutputMask   = static_cast<uint64_t>(outLayout);
+      calls.lastOutputRate   = outRate;
+      calls.lastOutputFormat = outFormat;
+      return allocateContext();
+    };
+
+  ffmpegLibraries.swresample.swr_init = [&calls](SwrContext *)
+  {
+    ++calls.init;
+    return 0;
+  };
+  ffmpegLibraries.swresample.swr_get_delay = [&calls](SwrContext *, int64_t)
+  { return calls.delay; };
+  ffmpegLibraries.swresample.swr_convert =
+      [&calls](SwrContext *, uint8_t **out, int outCount, const uint8_t **in, int inCount)
+  {
+    ++calls.convert;
+    calls.lastOutputCapacity = outCount;
+    calls.lastInputSamples   = inCount;
+    calls.lastInput          = (in == nullptr) ? nullptr : in[0];
+    calls.lastOutput         = out[0];
+    return (in == nullptr) ? static_cast<int>(calls.delay) : outCount - 10;
+  };
+  ffmpegLibraries.swresample.swr_free = [&calls](SwrContext **context)
+  {
+    ++calls.contextsFreed;
+    delete reinterpret_cast<AVDummy *>(*context);
+    *context = nullptr;
+  };
+}
+
+template <FFmpegVersion V>
+void setFrameParameters(AVFrame *frame, std::array<uint8_t *, 2> &planes)
+{
+  auto castFrame           = reinterpret_cast<AVFrameType<V> *>(frame);
+  castFrame->format        = AVSampleFormat::AV_SAMPLE_FMT_FLTP;
+  castFrame->nb_samples    = TEST_NUMBER_OF_SAMPLES;
+  castFrame->extended_data = planes.data();
+
+  if constexpr (V >= FFmpegVersion::FFmpeg_7x)
+  {
+    castFrame->sample_rate           = TEST_INPUT_RATE;
+    castFrame->ch_layout.order       = AVChannelOrder::AV_CHANNEL_ORDER_NATIVE;
+    castFrame->ch_layout.nb_channels = 2;
+    castFrame->ch_layout.u.mask      = STEREO_MASK;
+  }
+  else if constexpr (V >= FFmpegVersion::FFmpeg_5x)
+  {
+    castFrame->sample_rate    = TEST_INPUT_RATE;
+    castFrame->channels       = 2;
+    castFrame->channel_layout = STEREO_MASK;
+  }
+}
+
+template <FFmpegVersion V> void runResamplerShouldConvertAndCacheContextTest()
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  SwResampleCalls calls;
+  setupMockFunctions<V>(*ffmpegLibraries, calls);
+
+  std::array<float, TEST_NUMBER_OF_SAMPLES> left{};
+  std::array<float, TEST_NUMBER_OF_SAMPLES> right{};
+  std::array<uint8_t *, 2> planes = {reinterpret_cast<uint8_t *>(left.data()),
+                                     reinterpret_cast<uint8_t *>(right.data())};
+
+  {
+    Resampler resampler(ffmpegLibraries,
+                        {.sampleRate = 48000, .sampleFormat = AVSampleFormat::AV_SAMPLE_FMT_S16});
+
+    avutil::AVFrameWrapper frame(ffmpegLibraries);
+    setFrameParameters<V>(frame.getFrame(), planes);
+
+    // ceil(1024 * 48000 / 44100)
+    constexpr auto expectedCapacity = 1115;
+
+    AudioBuffer output;
+    EXPECT_TRUE(resampler.convert(frame, output));
+    EXPECT_EQ(calls.contextsAllocated, 1);
+    EXPECT_EQ(calls.init, 1);
+    EXPECT_EQ(calls.lastInputMask, STEREO_MASK);
+    EXPECT_EQ(calls.lastOutputMask, STEREO_MASK);
+    EXPECT_EQ(calls.lastOutputRate, 48000);
+    EXPECT_EQ(calls.lastOutputFormat, AVSampleFormat::AV_SAMPLE_FMT_S16);
+    EXPECT_EQ(calls.lastInputSamples, TEST_NUMBER_OF_SAMPLES);
+    EXPECT_EQ(calls.lastInput, planes[0]);
+    EXPECT_EQ(calls.lastOutputCapacity, expectedCapacity);
+
+    EXPECT_EQ(output.sampleFormat, AVSampleFormat::AV_SAMPLE_FMT_S16);
+    EXPECT_EQ(output.numberOfChannels, 2);
+    EXPECT_EQ(output.numberOfSamples, expectedCapacity - 10);
+    ASSERT_EQ(output.planes.size(), std::size_t(1));
+    EXPECT_EQ(output.planes[0].size(), std::size_t(expectedCapacity * 2 * 2));
+    EXPECT_EQ(calls.lastOutput, reinterpret_cast<uint8_t *>(output.planes[0].data()));
+
+    // The context and the output buffer are reused
+    const auto outputData = output.planes[0].data();
+    EXPECT_TRUE(resampler.convert(frame, output));
+    EXPECT_EQ(calls.contextsAllocated, 1);
+    EXPECT_EQ(calls.convert, 2);
+    EXPECT_EQ(output.planes[0].data(), outputData);
+
+    // Buffered samples increase the required output capacity
+    calls.delay = 100;
+    EXPECT_TRUE(resampler.convert(frame, output));
+    EXPECT_EQ(calls.lastOutputCapacity, (1124 * 48000 + TEST_INPUT_RATE - 1) / TEST_INPUT_RATE);
+
+    EXPECT_TRUE(resampler.flush(output));
+    EXPECT_EQ(calls.lastInput, nullptr);
+    EXPECT_EQ(calls.lastInputSamples, 0);
+    EXPECT_EQ(output.numberOfSamples, 100);
+
+    resampler.setSettings({.sampleRate    = 16000,
+                           .sampleFormat  = AVSampleFormat::AV_SAMPLE_FMT_FLTP,
+                           .channelLayout = internal::avcodec::bitMaskToChannelLayout(MONO_MASK)});
+    calls.delay = 0;
+    EXPECT_TRUE(resampler.convert(frame, output));
+    EXPECT_EQ(calls.contextsAllocated, 2);
+    EXPECT_EQ(calls.lastOutputMask, MONO_MASK);
+    EXPECT_EQ(calls.lastOutputRate, 16000);
+    EXPECT_EQ(output.numberOfChannels, 1);
+    ASSERT_EQ(output.planes.size(), std::size_t(1));
+    EXPECT_EQ(output.sampleFormat, AVSampleFormat::AV_SAMPLE_FMT_FLTP);
+  }
+
+  EXPECT_EQ(calls.contextsAllocated, 2);
+  EXPECT_EQ(calls.contextsFreed, 2);
+}
+
+} // namespace
+
+class ResamplerTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST(ResamplerTest, shouldThrowIfLibrariesAreNull)
+{
+  EXPECT_THROW(Resampler resampler(nullptr), std::runtime_error);
+}
+
+TEST(ResamplerTest, flushWithoutConversionShouldReturnNoSamples)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+
+  Resampler   resampler(ffmpegLibraries);
+  AudioBuffer output;
+  output.numberOfSamples = 5;
+  EXPECT_TRUE(resampler.flush(output));
+  EXPECT_EQ(output.numberOfSamples, 0);
+}
+
+TEST_P(ResamplerTest, ResamplerShouldConvertAndCacheContext)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runResamplerShouldConvertAndCacheContextTest);
+}
+
+INSTANTIATE_TEST_SUITE_P(SwResample,
+                         ResamplerTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg::swresample
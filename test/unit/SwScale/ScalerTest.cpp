@@ -0,0 +1,380 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <SwScale/Scaler.h>
+#include <common/InternalTypes.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVUtil/VersionToAVUtilTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace libffmpeg::swscale
+{
+
+namespace
+{
+
+using libffmpeg::avutil::AVFrameType;
+using libffmpeg::internal::AVBufferRef;
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVPixelFormat;
+using libffmpeg::internal::AVPixFmtDescriptor;
+using libffmpeg::internal::SwsContext;
+
+using ::testing::Return;
+
+constexpr auto TEST_INPUT_FORMAT  = AVPixelFormat(12);
+constexpr auto TEST_OUTPUT_FORMAT = internal::AV_PIX_FMT_TESTING;
+
+// The name is the first member of the AVPixFmtDescriptor in all versions
+struct TestPixFmtDescriptor
+{
+  const char *name{};
+};
+
+struct SwScaleCalls
+{
+  int                            contextsAllocated{};
+  int                            contextsFreed{};
+  int                            getCachedContext{};
+  int                            scale{};
+  int                            scaleFrame{};
+  std::map<std::string, int64_t> options{};
+  Size                           lastInputSize{};
+  Size                           lastOutputSize{};
+  std::array<uint8_t *, 4>       lastOutputData{};
+  std::vector<std::size_t>       bufferSizes{};
+};
+
+template <FFmpegVersion V>
+void setupMockFunctions(FFmpegLibrariesMock &ffmpegLibraries, SwScaleCalls &calls)
+{
+  static const TestPixFmtDescriptor rgbaDescriptor{"rgba"};
+
+  ffmpegLibraries.avutil.av_frame_alloc = []()
+  { return reinterpret_cast<AVFrame *>(new AVFrameType<V>()); };
+  ffmpegLibraries.avutil.av_frame_free = [](AVFrame **frame)
+  {
+    delete reinterpret_cast<AVFrameType<V> *>(*frame);
+    *frame = nullptr;
+  };
+  ffmpegLibraries.avutil.av_pix_fmt_desc_next = [](const AVPixFmtDescriptor *previous)
+  {
+    if (previous != nullptr)
+      return static_cast<const AVPixFmtDescriptor *>(nullptr);
+    return reinterpret_cast<const AVPixFmtDescriptor *>(&rgbaDescriptor);
+  };
+  ffmpegLibraries.avutil.av_pix_fmt_desc_get_id = [](const AVPixFmtDescriptor *)
+  { return TEST_OUTPUT_FORMAT; };
+  ffmpegLibraries.avutil.av_image_fill_linesizes =
+      [](int linesizes[4], AVPixelFormat, int width)
+  {
+    linesizes[0] = width * 4;
+    return 0;
+  };
+  ffmpegLibraries.avutil.av_image_fill_pointers =
+      [](uint8_t *data[4], AVPixelFormat, int height, uint8_t *pointer, const int linesizes[4])
+  {
+    data[0] = pointer;
+    return linesizes[0] * height;
+  };
+  ffmpegLibraries.avutil.av_buffer_create =
+      [&calls](uint8_t *data, size_t size, void (*)(void *, uint8_t *), void *, int)
+  {
+    calls.bufferSizes.push_back(size);
+    return reinterpret_cast<AVBufferRef *>(data);
+  };
+  ffmpegLibraries.avutil.av_opt_set_int =
+      [&calls](void *, const char *name, int64_t value, int)
+  {
+    calls.options[name] = value;
+    return 0;
+  };
+
+  const auto allocateContext = [&calls]()
+  {
+    ++calls.contextsAllocated;
+    return reinterpret_cast<SwsContext *>(new AVDummy);
+  };
+  const auto freeContext = [&calls](SwsContext *context)
+  {
+    if (context == nullptr)
+      return;
+    ++calls.contextsFreed;
+    delete reinterpret_cast<AVDummy *>(context);
+  };
+
+  ffmpegLibraries.swscale.sws_freeContext   = freeContext;
+  ffmpegLibraries.swscale.sws_alloc_context = allocateContext;
+  ffmpegLibraries.swscale.sws_init_context  = [](SwsContext *, internal::SwsFilter *,
+                                                internal::SwsFilter *) { return 0; };
+  ffmpegLibraries.swscale.sws_getCachedContext = [&calls, allocateContext, freeContext](
+                                                     SwsContext   *context,
+                                                     int           srcW,
+                                                     int           srcH,
+                                                     AVPixelFormat srcFormat,
+                                                     int           dstW,
+                                                     int           dstH,
+                                                     AVPixelFormat dstFormat,
+                                                     int,
+                                                     internal::SwsFilter *,
+                                                     internal::SwsFilter *,
+                                                     const double *)
+  {
+    ++calls.getCachedContext;
+    EXPECT_EQ(srcFormat, TEST_INPUT_FORMAT);
+    EXPECT_EQ(dstFormat, TEST_OUTPUT_FORMAT);
+    calls.lastInputSize  = {srcW, srcH};
+    calls.lastOutputSize = {dstW, dstH};
+    freeContext(context);
+    return allocateContext();
+  };
+  ffmpegLibraries.swscale.sws_scale = [&calls](SwsContext *,
+                                               const uint8_t *const[],
+                                               const int[],
+                                               int,
+                                               int,
+                                               uint8_t *const dst[],
+                                               const int[])
+  {
+    ++calls.scale;
+    for (int i = 0; i < 4; ++i)
+      calls.lastOutputData[i] = dst[i];
+    return calls.lastOutputSize.height;
+  };
+}
+
+template <FFmpegVersion V> void setFrameParameters(AVFrame *frame, const Size size)
+{
+  auto castFrame    = reinterpret_cast<AVFrameType<V> *>(frame);
+  castFrame->width  = size.width;
+  castFrame->height = size.height;
+  castFrame->format = TEST_INPUT_FORMAT;
+}
+
+template <FFmpegVersion V> void runScalerShouldCacheContextTest()
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  SwScaleCalls calls;
+  setupMockFunctions<V>(*ffmpegLibraries, calls);
+
+  {
+    Scaler scaler(ffmpegLibraries, {.outputSize = {8, 4}, .outputPixelFormat = "rgba"});
+
+    avutil::AVFrameWrapper frame(ffmpegLibraries);
+    setFrameParameters<V>(frame.getFrame(), {16, 8});
+
+    const auto layout = scaler.getOutputLayout(frame);
+    ASSERT_TRUE(layout);
+    EXPECT_EQ(layout->linesize[0], 8 * 4);
+    EXPECT_EQ(layout->bufferSize, static_cast<std::size_t>(8 * 4 * 4));
+
+    ByteVector output(layout->bufferSize);
+    EXPECT_TRUE(scaler.scale(frame, output));
+    EXPECT_TRUE(scaler.scale(frame, output));
+    EXPECT_EQ(calls.getCachedContext, 1);
+    EXPECT_EQ(calls.scale, 2);
+    EXPECT_EQ(calls.lastInputSize, Size({16, 8}));
+    EXPECT_EQ(calls.lastOutputSize, Size({8, 4}));
+    EXPECT_EQ(calls.lastOutputData[0], reinterpret_cast<uint8_t *>(output.data()));
+    EXPECT_FALSE(scaler.isSliceThreadingActive());
+
+    ByteVector tooSmallOutput(layout->bufferSize - 1);
+    EXPECT_FALSE(scaler.scale(frame, tooSmallOutput));
+
+    setFrameParameters<V>(frame.getFrame(), {32, 16});
+    EXPECT_TRUE(scaler.scale(frame, output));
+    EXPECT_EQ(calls.getCachedContext, 2);
+    EXPECT_EQ(calls.lastInputSize, Size({32, 16}));
+
+    scaler.setSettings({.outputSize = {}, .outputPixelFormat = "rgba"});
+    ByteVector fullSizeOutput(32 * 16 * 4);
+    EXPECT_TRUE(scaler.scale(frame, fullSizeOutput));
+    EXPECT_EQ(calls.getCachedContext, 3);
+    EXPECT_EQ(calls.lastOutputSize, Size({32, 16}));
+  }
+
+  EXPECT_EQ(calls.contextsAllocated, 3);
+  EXPECT_EQ(calls.contextsFreed, 3);
+}
+
+template <FFmpegVersion V> void runScalerSliceThreadingTest()
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  SwScaleCalls calls;
+  setupMockFunctions<V>(*ffmpegLibraries, calls);
+
+  const auto sliceThreadingSupported = (V >= FFmpegVersion::FFmpeg_5x);
+  if (sliceThreadingSupported)
+    ffmpegLibraries->swscale.sws_scale_frame =
+        [&calls](SwsContext *, AVFrame *dst, const AVFrame *)
+    {
+      ++calls.scaleFrame;
+      const auto castFrame = reinterpret_cast<AVFrameType<V> *>(dst);
+      EXPECT_EQ(castFrame->width, 16);
+      EXPECT_EQ(castFrame->height, 8);
+      EXPECT_EQ(castFrame->format, TEST_OUTPUT_FORMAT);
+      EXPECT_EQ(castFrame->linesize[0], 16 * 4);
+      calls.lastOutputData[0] = castFrame->data[0];
+      return 0;
+    };
+
+  {
+    Scaler scaler(ffmpegLibraries, {.numberOfSliceThreads = 4});
+
+    avutil::AVFrameWrapper frame(ffmpegLibraries);
+    setFrameParameters<V>(frame.getFrame(), {16, 8});
+
+    calls.lastOutputSize = {16, 8};
+    ByteVector output(16 * 8 * 4);
+    EXPECT_TRUE(scaler.scale(frame, output));
+    EXPECT_EQ(calls.lastOutputData[0], reinterpret_cast<uint8_t *>(output.data()));
+    EXPECT_EQ(scaler.isSliceThreadingActive(), sliceThreadingSupported);
+
+    if (sliceThreadingSupported)
+    {
+      EXPECT_EQ(calls.scaleFrame, 1);
+      EXPECT_EQ(calls.scale, 0);
+      EXPECT_EQ(calls.getCachedContext, 0);
+      EXPECT_EQ(calls.options.at("threads"), 4);
+      EXPECT_EQ(calls.options.at("srcw"), 16);
+      EXPECT_EQ(calls.options.at("dst_format"), TEST_OUTPUT_FORMAT);
+    }
+    else
+    {
+      EXPECT_EQ(calls.scale, 1);
+      EXPECT_EQ(calls.getCachedContext, 1);
+      EXPECT_TRUE(calls.options.empty());
+    }
+  }
+
+  EXPECT_EQ(calls.contextsAllocated, 1);
+  EXPECT_EQ(calls.contextsFreed, 1);
+}
+
+template <FFmpegVersion V> void runScalerSliceThreadingPlanarOutputTest()
+{
+  // Slice threading (sws_scale_frame) is only used with FFmpeg 5 and newer
+  if constexpr (V >= FFmpegVersion::FFmpeg_5x)
+  {
+    auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+    EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion())
+        .WillRepeatedly(Return(getLibraryVerions(V)));
+
+    SwScaleCalls calls;
+    setupMockFunctions<V>(*ffmpegLibraries, calls);
+
+    // A planar 4:2:0 output with three planes
+    ffmpegLibraries->avutil.av_image_fill_linesizes = [](int linesizes[4], AVPixelFormat, int width)
+    {
+      linesizes[0] = width;
+      linesizes[1] = width / 2;
+      linesizes[2] = width / 2;
+      return 0;
+    };
+    ffmpegLibraries->avutil.av_image_fill_pointers =
+        [](uint8_t *data[4], AVPixelFormat, int height, uint8_t *pointer, const int linesizes[4])
+    {
+      data[0] = pointer;
+      data[1] = data[0] + linesizes[0] * height;
+      data[2] = data[1] + linesizes[1] * height / 2;
+      return linesizes[0] * height + linesizes[1] * height / 2 + linesizes[2] * height / 2;
+    };
+
+    std::array<AVBufferRef *, 4> frameBuffers{};
+    std::array<uint8_t *, 4>     frameData{};
+    ffmpegLibraries->swscale.sws_scale_frame = [&](SwsContext *, AVFrame *dst, const AVFrame *)
+    {
+      ++calls.scaleFrame;
+      const auto castFrame = reinterpret_cast<AVFrameType<V> *>(dst);
+      for (int i = 0; i < 4; ++i)
+      {
+        frameBuffers[i] = castFrame->buf[i];
+        frameData[i]    = castFrame->data[i];
+      }
+      return 0;
+    };
+
+    Scaler scaler(ffmpegLibraries, {.numberOfSliceThreads = 4});
+
+    avutil::AVFrameWrapper frame(ffmpegLibraries);
+    setFrameParameters<V>(frame.getFrame(), {16, 8});
+
+    const auto layout = scaler.getOutputLayout(frame);
+    ASSERT_TRUE(layout);
+    ByteVector output(layout->bufferSize);
+    EXPECT_TRUE(scaler.scale(frame, output));
+    EXPECT_EQ(calls.scaleFrame, 1);
+
+    // Every plane must be covered by a buffer reference of the frame
+    EXPECT_EQ(calls.bufferSizes, std::vector<std::size_t>({16 * 8, 8 * 4, 8 * 4}));
+    for (int i = 0; i < 3; ++i)
+    {
+      const auto planeData = output.data() + layout->planeOffset[i];
+      EXPECT_EQ(frameData[i], reinterpret_cast<uint8_t *>(planeData));
+      EXPECT_EQ(reinterpret_cast<uint8_t *>(frameBuffers[i]), frameData[i]);
+    }
+    EXPECT_EQ(frameBuffers[3], nullptr);
+  }
+}
+
+} // namespace
+
+class ScalerTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST(ScalerTest, shouldThrowIfLibrariesAreNull)
+{
+  EXPECT_THROW(Scaler scaler(nullptr), std::runtime_error);
+}
+
+TEST(ScalerTest, scalingShouldFailIfSwScaleIsNotLoaded)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_FALSE(ffmpegLibraries->isSwScaleAvailable());
+
+  Scaler                 scaler(ffmpegLibraries);
+  avutil::AVFrameWrapper frame(ffmpegLibraries);
+  ByteVector             output(64);
+  EXPECT_FALSE(scaler.getOutputLayout(frame));
+  EXPECT_FALSE(scaler.scale(frame, output));
+}
+
+TEST_P(ScalerTest, ScalerShouldCacheContext)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runScalerShouldCacheContextTest);
+}
+
+TEST_P(ScalerTest, ScalerShouldUseSliceThreadsIfAvailable)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runScalerSliceThreadingTest);
+}
+
+TEST_P(ScalerTest, ScalerWithSliceThreadsShouldReferenceAllOutputPlanes)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runScalerSliceThreadingPlanarOutputTest);
+}
+
+INSTANTIATE_TEST_SUITE_P(SwScale,
+                         ScalerTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg::swscale
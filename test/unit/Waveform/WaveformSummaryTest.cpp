@@ -0,0 +1,173 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <Waveform/WaveformGenerator.h>
+#include <Waveform/WaveformSummary.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <filesystem>
+#include <limits>
+#include <random>
+
+namespace libffmpeg::waveform
+{
+
+namespace
+{
+
+using Implementation = WaveformSettings::Implementation;
+
+std::vector<float> createRandomSamples(const std::size_t numberOfSamples, const unsigned seed)
+{
+  std::mt19937                          generator(seed);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+  std::vector<float> samples(numberOfSamples);
+  for (auto &sample : samples)
+    sample = distribution(generator);
+  return samples;
+}
+
+class TemporaryFile
+{
+public:
+  TemporaryFile(const std::string &name)
+      : path(std::filesystem::temp_directory_path() / ("LibFFmpegTest_" + name))
+  {
+  }
+  ~TemporaryFile() { std::filesystem::remove(this->path); }
+
+  const Path path;
+};
+
+} // namespace
+
+TEST(WaveformKernels, AllImplementationsShouldMatchScalar)
+{
+  // An odd number of samples so that the vector implementations also run their scalar tail
+  const auto samples = createRandomSamples(1001, 7);
+
+  kernels::SampleStatistics scalar{std::numeric_limits<float>::infinity(),
+                                   -std::numeric_limits<float>::infinity(),
+                                   0.0};
+  kernels::accumulateScalar(samples.data(), samples.size(), scalar);
+
+  EXPECT_EQ(scalar.min, *std::min_element(samples.begin(), samples.end()));
+  EXPECT_EQ(scalar.max, *std::max_element(samples.begin(), samples.end()));
+
+#ifdef LIBFFMPEG_HAS_X86_KERNELS
+  if (!getCpuFeatures().avx2)
+    GTEST_SKIP() << "AVX2 is not supported by this CPU";
+
+  kernels::SampleStatistics avx2{std::numeric_limits<float>::infinity(),
+                                 -std::numeric_limits<float>::infinity(),
+                                 0.0};
+  kernels::accumulateAVX2(samples.data(), samples.size(), avx2);
+
+  EXPECT_EQ(avx2.min, scalar.min);
+  EXPECT_EQ(avx2.max, scalar.max);
+  EXPECT_NEAR(avx2.sumOfSquares, scalar.sumOfSquares, 1e-9 * scalar.sumOfSquares);
+#endif
+}
+
+TEST(WaveformSummary, WriteAndReadShouldRoundTrip)
+{
+  TemporaryFile summaryFile("WaveformSummaryRoundTrip.wav.summary");
+
+  constexpr std::size_t SAMPLES_PER_BUCKET = 16;
+  constexpr std::size_t NUMBER_OF_SAMPLES  = 1000;
+
+  // A ramp in the left channel and a constant value in the right channel
+  std::vector<float> left(NUMBER_OF_SAMPLES);
+  for (std::size_t i = 0; i < NUMBER_OF_SAMPLES; ++i)
+    left[i] = static_cast<float>(i) / NUMBER_OF_SAMPLES * 2.0f - 1.0f;
+  const std::vector<float> right(NUMBER_OF_SAMPLES, 0.5f);
+
+  {
+    WaveformSummaryWriter writer(
+        {.samplesPerBucket = SAMPLES_PER_BUCKET, .levelFactor = 4, .implementation = {}});
+    ASSERT_TRUE(writer.open(summaryFile.path, 2, 48000));
+
+    // Add the samples in chunks that do not line up with the buckets
+    constexpr std::size_t CHUNK_SIZE = 100;
+    for (std::size_t offset = 0; offset < NUMBER_OF_SAMPLES; offset += CHUNK_SIZE)
+    {
+      const std::array<const float *, 2> channels = {left.data() + offset,
+                                                     right.data() + offset};
+      EXPECT_TRUE(writer.addSamples(channels, CHUNK_SIZE));
+    }
+
+    const std::array<const float *, 1> wrongNumberOfChannels = {left.data()};
+    EXPECT_FALSE(writer.addSamples(wrongNumberOfChannels, 1));
+
+    EXPECT_TRUE(writer.finish());
+  }
+
+  WaveformSummaryReader reader;
+  ASSERT_TRUE(reader.open(summaryFile.path));
+  EXPECT_EQ(reader.getNumberOfChannels(), 2);
+  EXPECT_EQ(reader.getSampleRate(), 48000);
+  EXPECT_EQ(reader.getNumberOfSamples(), NUMBER_OF_SAMPLES);
+
+  // 1000 samples: 63 buckets of 16, 16 of 64, 4 of 256 and 1 of 1024 samples
+  const auto &levels = reader.getLevels();
+  ASSERT_EQ(levels.size(), std::size_t(4));
+  const std::array<uint64_t, 4> expectedBuckets = {63, 16, 4, 1};
+  for (std::size_t level = 0; level < levels.size(); ++level)
+  {
+    EXPECT_EQ(levels[level].samplesPerBucket, SAMPLES_PER_BUCKET << (2 * level));
+    EXPECT_EQ(levels[level].numberOfBuckets, expectedBuckets[level]);
+    EXPECT_EQ(levels[level].fileOffset % 8, uint64_t(0));
+  }
+  EXPECT_EQ(levels[0].fileOffset, WAVEFORM_HEADER_SIZE);
+
+  std::vector<WaveformBucket> buckets;
+  ASSERT_TRUE(reader.readBuckets(0, 1, 2, buckets));
+  ASSERT_EQ(buckets.size(), std::size_t(4));
+  EXPECT_EQ(buckets[0].min, static_cast<int16_t>(std::round(left[16] * 32767.0f)));
+  EXPECT_EQ(buckets[0].max, static_cast<int16_t>(std::round(left[31] * 32767.0f)));
+  EXPECT_EQ(buckets[1], WaveformBucket({16384, 16384, 32768}));
+  EXPECT_EQ(buckets[3], WaveformBucket({16384, 16384, 32768}));
+
+  // The whole stream in one bucket
+  ASSERT_TRUE(reader.readBuckets(3, 0, 10, buckets));
+  ASSERT_EQ(buckets.size(), std::size_t(2));
+  EXPECT_EQ(buckets[0].min, -32767);
+  EXPECT_EQ(buckets[0].max, static_cast<int16_t>(std::round(left.back() * 32767.0f)));
+  EXPECT_EQ(buckets[1], WaveformBucket({16384, 16384, 32768}));
+
+  // The last incomplete bucket of level 0
+  ASSERT_TRUE(reader.readBuckets(0, 62, 10, buckets));
+  EXPECT_EQ(buckets.size(), std::size_t(2));
+  EXPECT_FALSE(reader.readBuckets(4, 0, 1, buckets));
+
+  EXPECT_EQ(reader.selectLevel(1000, 1000), std::size_t(0));
+  EXPECT_EQ(reader.selectLevel(1000, 20), std::size_t(1));
+  EXPECT_EQ(reader.selectLevel(1000, 4), std::size_t(2));
+  EXPECT_EQ(reader.selectLevel(1000000, 1), std::size_t(3));
+}
+
+TEST(WaveformSummary, ReaderShouldRejectInvalidFiles)
+{
+  TemporaryFile invalidFile("WaveformSummaryInvalid.summary");
+  {
+    std::ofstream file(invalidFile.path, std::ios::binary);
+    file << "This is not a waveform summary";
+  }
+
+  WaveformSummaryReader reader;
+  EXPECT_FALSE(reader.open(invalidFile.path));
+  EXPECT_FALSE(reader.open(invalidFile.path.string() + ".missing"));
+}
+
+TEST(WaveformGenerator, ShouldThrowIfLibrariesAreNull)
+{
+  EXPECT_THROW(WaveformGenerator generator(nullptr), std::runtime_error);
+}
+
+} // namespace libffmpeg::waveform
@@ -0,0 +1,110 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <DataComparer.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace
+{
+
+std::vector<std::byte> createData(const std::size_t size, const std::size_t offset = 0)
+{
+  std::vector<std::byte> data(size);
+  for (std::size_t i = 0; i < size; ++i)
+    data[i] = static_cast<std::byte>((offset + i) & 0xff);
+  return data;
+}
+
+// Feed the chunks of both inputs like FilePacketComparer does with the packet queues
+void compareChunks(DataComparer                                             &comparer,
+                   const std::array<std::vector<std::vector<std::byte>>, 2> &chunks)
+{
+  std::array<std::size_t, 2> nextChunk{};
+  while (!comparer.isFinished())
+  {
+    const auto input = comparer.getInputToReadNext();
+    if (nextChunk[input] < chunks[input].size())
+      comparer.addData(input, chunks[input][nextChunk[input]++]);
+    else
+      comparer.setFinished(input);
+  }
+}
+
+} // namespace
+
+TEST(DataComparer, EqualDataInDifferentChunkSizes_ShouldMatch)
+{
+  const auto data = createData(1000);
+
+  std::array<std::vector<std::vector<std::byte>>, 2> chunks;
+  for (std::size_t start = 0; start < data.size(); start += 100)
+    chunks[0].emplace_back(data.begin() + start, data.begin() + start + 100);
+  for (std::size_t start = 0; start < data.size(); start += 250)
+    chunks[1].emplace_back(data.begin() + start, data.begin() + start + 250);
+
+  DataComparer comparer;
+  compareChunks(comparer, chunks);
+
+  EXPECT_EQ(comparer.getBytesCompared(), 1000u);
+  EXPECT_EQ(comparer.getBytesDiffering(), 0u);
+  EXPECT_EQ(comparer.getUnmatchedBytes(0), 0u);
+  EXPECT_EQ(comparer.getUnmatchedBytes(1), 0u);
+}
+
+TEST(DataComparer, DifferingBytes_ShouldBeCounted)
+{
+  auto data1 = createData(300);
+  auto data2 = data1;
+  data2[10]  = std::byte(0xaa);
+  data2[250] = std::byte(0xbb);
+
+  DataComparer comparer;
+  compareChunks(comparer, {{{data1}, {data2}}});
+
+  EXPECT_EQ(comparer.getBytesCompared(), 300u);
+  EXPECT_EQ(comparer.getBytesDiffering(), 2u);
+}
+
+TEST(DataComparer, InputsOfUnequalLength_ShouldCountTheRemainingBytesAsUnmatched)
+{
+  for (const int longerInput : {0, 1})
+  {
+    std::array<std::vector<std::vector<std::byte>>, 2> chunks;
+    chunks[1 - longerInput].push_back(createData(150));
+    for (std::size_t start = 0; start < 1000; start += 100)
+      chunks[longerInput].push_back(createData(100, start));
+
+    DataComparer comparer;
+    compareChunks(comparer, chunks);
+
+    EXPECT_EQ(comparer.getBytesCompared(), 150u);
+    EXPECT_EQ(comparer.getBytesDiffering(), 0u);
+    EXPECT_EQ(comparer.getUnmatchedBytes(longerInput), 850u);
+    EXPECT_EQ(comparer.getUnmatchedBytes(1 - longerInput), 0u);
+  }
+}
+
+TEST(DataComparer, DataAfterTheOtherInputFinished_ShouldNotBeBuffered)
+{
+  DataComparer comparer;
+  comparer.addData(0, createData(10));
+  comparer.setFinished(1);
+
+  EXPECT_EQ(comparer.getUnmatchedBytes(0), 10u);
+  EXPECT_EQ(comparer.getInputToReadNext(), 0);
+
+  comparer.addData(0, createData(1000));
+  EXPECT_EQ(comparer.getUnmatchedBytes(0), 1010u);
+  EXPECT_FALSE(comparer.isFinished());
+
+  comparer.setFinished(0);
+  EXPECT_TRUE(comparer.isFinished());
+  EXPECT_EQ(comparer.getUnmatchedBytes(0), 1010u);
+  EXPECT_EQ(comparer.getBytesCompared(), 0u);
+}
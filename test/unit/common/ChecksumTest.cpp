@@ -0,0 +1,71 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <common/Checksum.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace libffmpeg
+{
+
+namespace
+{
+
+std::span<const std::byte> toBytes(const std::string_view text)
+{
+  return {reinterpret_cast<const std::byte *>(text.data()), text.size()};
+}
+
+} // namespace
+
+TEST(CRC32C, ShouldMatchKnownValues)
+{
+  for (const auto implementation : {CRC32C::Implementation::Scalar, CRC32C::Implementation::SSE42})
+  {
+    CRC32C empty(implementation);
+    EXPECT_EQ(empty.getValue(), 0u);
+
+    // The check value of CRC-32C
+    CRC32C crc(implementation);
+    crc.update(toBytes("123456789"));
+    EXPECT_EQ(crc.getValue(), 0xe3069283u);
+
+    // 32 bytes of zeros (RFC 3720, B.4)
+    const std::vector<std::byte> zeros(32);
+    CRC32C                       zerosCRC(implementation);
+    zerosCRC.update(zeros);
+    EXPECT_EQ(zerosCRC.getValue(), 0x8a9136aau);
+  }
+}
+
+TEST(CRC32C, AllImplementationsAndSplitsShouldMatch)
+{
+  std::mt19937                       generator(5);
+  std::uniform_int_distribution<int> distribution(0, 255);
+
+  std::vector<std::byte> data(1000);
+  for (auto &byte : data)
+    byte = std::byte(distribution(generator));
+
+  const auto expected = calculateCRC32C(data);
+
+  for (const auto implementation : {CRC32C::Implementation::Scalar, CRC32C::Implementation::SSE42})
+  {
+    for (const std::size_t split : {0, 1, 7, 8, 13, 500, 999})
+    {
+      CRC32C crc(implementation);
+      crc.update(std::span(data).first(split));
+      crc.update(std::span(data).subspan(split));
+      EXPECT_EQ(crc.getValue(), expected);
+    }
+  }
+}
+
+} // namespace libffmpeg
@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <common/MemoryBudget.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace libffmpeg
+{
+
+using namespace std::chrono_literals;
+
+TEST(MemoryBudgetTest, ReservationsShouldBeAccounted)
+{
+  auto budget = std::make_shared<MemoryBudget>();
+
+  {
+    const auto reservation1 = budget->reserve(100);
+    auto       reservation2 = budget->reserve(50);
+    EXPECT_EQ(budget->getUsage().currentBytes, 150u);
+
+    const auto movedReservation = std::move(reservation2);
+    EXPECT_EQ(budget->getUsage().currentBytes, 150u);
+    EXPECT_EQ(movedReservation.getBytes(), 50u);
+  }
+
+  const auto usage = budget->getUsage();
+  EXPECT_EQ(usage.currentBytes, 0u);
+  EXPECT_EQ(usage.peakBytes, 150u);
+  EXPECT_EQ(usage.limitBytes, 0u);
+}
+
+TEST(MemoryBudgetTest, ReservationsShouldBeAccountedInParent)
+{
+  auto libraryBudget   = std::make_shared<MemoryBudget>();
+  auto pipelineBudget1 = std::make_shared<MemoryBudget>(MemoryBudget::Settings(), libraryBudget);
+  auto pipelineBudget2 = std::make_shared<MemoryBudget>(MemoryBudget::Settings(), libraryBudget);
+
+  auto reservation1 = pipelineBudget1->reserve(100);
+  auto reservation2 = pipelineBudget2->reserve(200);
+
+  EXPECT_EQ(pipelineBudget1->getUsage().currentBytes, 100u);
+  EXPECT_EQ(pipelineBudget2->getUsage().currentBytes, 200u);
+  EXPECT_EQ(libraryBudget->getUsage().currentBytes, 300u);
+
+  reservation2 = {};
+  EXPECT_EQ(pipelineBudget2->getUsage().currentBytes, 0u);
+  EXPECT_EQ(libraryBudget->getUsage().currentBytes, 100u);
+  EXPECT_EQ(libraryBudget->getUsage().peakBytes, 300u);
+}
+
+TEST(MemoryBudgetTest, UnlimitedBudgetShouldAlwaysHaveCapacity)
+{
+  auto budget      = std::make_shared<MemoryBudget>();
+  auto reservation = budget->reserve(1000000);
+  EXPECT_FALSE(budget->isLimitReached());
+  EXPECT_TRUE(budget->waitForCapacity());
+}
+
+TEST(MemoryBudgetTest, FailPolicyShouldFailIfLimitIsReached)
+{
+  auto budget = std::make_shared<MemoryBudget>(
+      MemoryBudget::Settings({.limitBytes = 100, .policy = MemoryBudget::Policy::Fail}));
+
+  auto reservation = budget->reserve(60);
+  EXPECT_TRUE(budget->waitForCapacity());
+
+  auto reservation2 = budget->reserve(60);
+  EXPECT_TRUE(budget->isLimitReached());
+  EXPECT_FALSE(budget->waitForCapacity());
+
+  reservation2 = {};
+  EXPECT_TRUE(budget->waitForCapacity());
+}
+
+TEST(MemoryBudgetTest, LimitOfParentShouldApply)
+{
+  auto libraryBudget = std::make_shared<MemoryBudget>(
+      MemoryBudget::Settings({.limitBytes = 100, .policy = MemoryBudget::Policy::Fail}));
+  auto pipelineBudget = std::make_shared<MemoryBudget>(MemoryBudget::Settings(), libraryBudget);
+
+  auto otherReservation = libraryBudget->reserve(100);
+  EXPECT_FALSE(pipelineBudget->isLimitReached());
+  EXPECT_FALSE(pipelineBudget->waitForCapacity());
+}
+
+TEST(MemoryBudgetTest, BlockPolicyShouldTimeOut)
+{
+  auto budget = std::make_shared<MemoryBudget>(MemoryBudget::Settings(
+      {.limitBytes = 100, .policy = MemoryBudget::Policy::Block, .blockTimeout = 10ms}));
+
+  auto reservation = budget->reserve(100);
+  EXPECT_FALSE(budget->waitForCapacity());
+}
+
+TEST(MemoryBudgetTest, BlockPolicyShouldContinueWhenMemoryIsReleased)
+{
+  auto budget = std::make_shared<MemoryBudget>(
+      MemoryBudget::Settings({.limitBytes = 100, .policy = MemoryBudget::Policy::Block}));
+
+  auto reservation = budget->reserve(100);
+
+  std::thread releaseThread(
+      [&reservation]()
+      {
+        std::this_thread::sleep_for(10ms);
+        reservation = {};
+      });
+
+  EXPECT_TRUE(budget->waitForCapacity());
+  releaseThread.join();
+  EXPECT_EQ(budget->getUsage().currentBytes, 0u);
+}
+
+} // namespace libffmpeg
@@ -6,6 +6,10 @@
 
 #include "FFmpegLibrariesMoc.h"
 
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
 namespace libffmpeg
 {
 
@@ -30,10 +34,16 @@ FFmpegLibrariesMock::FFmpegLibrariesMock()
   this->avutil.av_dict_get =
       [this](AVDictionary *dictionray, const char *key, const AVDictionaryEntry *prev, int flags)
   { return this->av_dict_get_moc(dictionray, key, prev, flags); };
+  this->avutil.av_dict_set =
+      [this](AVDictionary **dictionary, const char *key, const char *value, int)
+  { return this->av_dict_set_mock(dictionary, key, value); };
+  this->avutil.av_dict_free = [this](AVDictionary **dictionary)
+  { this->av_dict_free_mock(dictionary); };
 
   this->avcodec.av_packet_alloc = [this]() { return this->av_packet_alloc_mock(); };
   this->avcodec.av_packet_free  = [this](AVPacket **packet) { this->av_packet_free_mock(packet); };
   this->avcodec.av_free_packet  = [this](AVPacket *packet) { this->av_free_packet_mock(packet); };
+  this->avcodec.av_packet_unref = [this](AVPacket *packet) { this->av_packet_unref_mock(packet); };
   this->avcodec.av_init_packet  = [this](AVPacket *packet) { this->av_init_packet_mock(packet); };
   this->avcodec.avcodec_receive_frame = [this](AVCodecContext *context, AVFrame *frame)
   { return this->avcodec_receive_frame_mock(context, frame); };
@@ -64,8 +74,22 @@ FFmpegLibrariesMock::~FFmpegLibrariesMock()
       << "Not all allocated packets were freed again";
   EXPECT_EQ(this->functionCounters.avcodecAllocContext3, this->functionCounters.avcodecFreeContext)
       << "Not all allocated codec contexts were freed again";
+  EXPECT_EQ(this->avDictionariesAllocated, this->functionCounters.avDictFree)
+      << "Not all allocated dictionaries were freed again";
 }
 
+namespace
+{
+
+// The dictionaries that are created with av_dict_set. These are not compatible with the
+// dictionaries that the av_dict_get mock expects.
+struct MockDictionary
+{
+  std::map<std::string, std::string> entries;
+};
+
+} // namespace
+
 AVFrame *FFmpegLibrariesMock::av_frame_alloc_mock()
 {
   auto frame = new AVDummy;
@@ -102,10 +126,29 @@ AVDictionaryEntry *FFmpegLibrariesMock::av_dict_get_moc(AVDictionary
 
   ++this->functionCounters.avDictGet;
 
-  if (dictionray == nullptr || key == nullptr || flags != AV_DICT_IGNORE_SUFFIX)
+  if (dictionray == nullptr || key == nullptr)
     return {};
 
   auto castBack = reinterpret_cast<AVDictionaryEntry *>(dictionray);
+
+  if (flags == 0)
+  {
+    // Exact (case insensitive) match of the key
+    for (; castBack->key != nullptr; ++castBack)
+    {
+      const auto keyMatches = std::ranges::equal(std::string_view(castBack->key),
+                                                 std::string_view(key),
+                                                 [](const char a, const char b)
+                                                 { return std::tolower(a) == std::tolower(b); });
+      if (keyMatches)
+        return castBack;
+    }
+    return nullptr;
+  }
+
+  if (flags != AV_DICT_IGNORE_SUFFIX)
+    return {};
+
   if (prev == nullptr)
     return castBack;
 
@@ -120,6 +163,31 @@ AVDictionaryEntry *FFmpegLibrariesMock::av_dict_get_moc(AVDictionary
   return nullptr;
 }
 
+int FFmpegLibrariesMock::av_dict_set_mock(AVDictionary **dictionary,
+                                          const char    *key,
+                                          const char    *value)
+{
+  ++this->functionCounters.avDictSet;
+
+  if (*dictionary == nullptr)
+  {
+    *dictionary = reinterpret_cast<AVDictionary *>(new MockDictionary);
+    ++this->avDictionariesAllocated;
+  }
+  reinterpret_cast<MockDictionary *>(*dictionary)->entries[key] = value;
+  return 0;
+}
+
+void FFmpegLibrariesMock::av_dict_free_mock(AVDictionary **dictionary)
+{
+  if (dictionary != nullptr && *dictionary != nullptr)
+  {
+    delete reinterpret_cast<MockDictionary *>(*dictionary);
+    *dictionary = nullptr;
+    ++this->functionCounters.avDictFree;
+  }
+}
+
 AVPacket *FFmpegLibrariesMock::av_packet_alloc_mock()
 {
   auto packet = new AVDummy;
@@ -138,6 +206,14 @@ void FFmpegLibrariesMock::av_packet_free_mock(AVPacket **packet)
   }
 }
 
+void FFmpegLibrariesMock::av_packet_unref_mock(internal::AVPacket *packet)
+{
+  if (packet != nullptr)
+  {
+    ++this->functionCounters.avPacketUnref;
+  }
+}
+
 void FFmpegLibrariesMock::av_free_packet_mock(internal::AVPacket *packet)
 {
   if (packet != nullptr)
@@ -230,6 +306,14 @@ int FFmpegLibrariesMock::avcodec_open2_mock(internal::AVCodecContext *codecConte
   EXPECT_NE(codecContext, nullptr);
   EXPECT_NE(codec, nullptr);
   ++this->functionCounters.avcodecOpen2;
+
+  // Like FFmpeg, consume all options
+  if (dictionary != nullptr && *dictionary != nullptr)
+  {
+    this->functionCallValues.avcodecOpen2Options =
+        reinterpret_cast<MockDictionary *>(*dictionary)->entries;
+    this->av_dict_free_mock(dictionary);
+  }
   return 0;
 }
 
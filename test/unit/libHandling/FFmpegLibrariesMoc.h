@@ -11,6 +11,8 @@
 
 #include <gmock/gmock.h>
 
+#include <map>
+
 namespace libffmpeg
 {
 
@@ -39,9 +41,12 @@ public:
     int avFrameFree{};
     int avPixFmtDescGet{};
     int avDictGet{};
+    int avDictSet{};
+    int avDictFree{};
     int avPacketAlloc{};
     int avPacketFree{};
     int avFreePacket{};
+    int avPacketUnref{};
     int avInitPacket{};
     int avcodecReceiveFrame{};
     int avcodecSendPacketNonNull{};
@@ -58,6 +63,7 @@ public:
   struct FunctionCallValues
   {
     std::vector<internal::AVPixelFormat> avPixFmtDescGet;
+    std::map<std::string, std::string>   avcodecOpen2Options;
   };
   FunctionCallValues functionCallValues;
 
@@ -71,6 +77,7 @@ public:
 
 private:
   AVDummy avDummy;
+  int     avDictionariesAllocated{};
 
   // AVUtil
   internal::AVFrame                  *av_frame_alloc_mock();
@@ -80,11 +87,14 @@ private:
                                                       const char                        *key,
                                                       const internal::AVDictionaryEntry *prev,
                                                       int                                flags);
+  int  av_dict_set_mock(internal::AVDictionary **dictionary, const char *key, const char *value);
+  void av_dict_free_mock(internal::AVDictionary **dictionary);
 
   // AVCodec
   internal::AVPacket *av_packet_alloc_mock();
   void                av_packet_free_mock(internal::AVPacket **packet);
   void                av_free_packet_mock(internal::AVPacket *packet);
+  void                av_packet_unref_mock(internal::AVPacket *packet);
   void                av_init_packet_mock(internal::AVPacket *packet);
   int avcodec_receive_frame_mock(internal::AVCodecContext *context, internal::AVFrame *frame);
   int avcodec_send_packet_mock(internal::AVCodecContext *context, const internal::AVPacket *packet);
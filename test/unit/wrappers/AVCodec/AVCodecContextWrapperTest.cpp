@@ -70,6 +70,30 @@ template <FFmpegVersion V> void runAVCodecContextTest()
   EXPECT_EQ(wrapper.getExtradata(), dataArrayToByteVector(TEST_EXTRADATA));
 }
 
+template <FFmpegVersion V> void runLowresShouldBeLimitedToCodecMaximum()
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  AVCodecType<V> codec;
+  codec.max_lowres                              = 2;
+  ffmpegLibraries->avcodec.avcodec_find_decoder = [&codec](AVCodecID)
+  { return reinterpret_cast<AVCodec *>(&codec); };
+
+  {
+    AVDummy                           codecParametersDummy;
+    avcodec::AVCodecParametersWrapper codecParameters(
+        reinterpret_cast<AVCodecParameters *>(&codecParametersDummy), ffmpegLibraries);
+
+    auto context = AVCodecContextWrapper(ffmpegLibraries);
+    context.setLowres(3);
+    EXPECT_TRUE(context.openContextForDecoding(codecParameters));
+  }
+
+  const auto expectedOptions = std::map<std::string, std::string>({{"lowres", "2"}});
+  EXPECT_EQ(ffmpegLibraries->functionCallValues.avcodecOpen2Options, expectedOptions);
+}
+
 class AVCodecContextWrapperTest : public testing::TestWithParam<LibraryVersions>
 {
 };
@@ -108,6 +132,62 @@ TEST_F(AVCodecContextWrapperTest, TestOpeningOfFile)
   EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecOpen2, 1);
 }
 
+TEST_F(AVCodecContextWrapperTest, TestOpeningWithCodecID)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+  ffmpegLibraries->functionChecks.avcodecFindDecoderExpectedCodecID =
+      libffmpeg::internal::AV_CODEC_ID_TESTING;
+
+  {
+    auto context = AVCodecContextWrapper(ffmpegLibraries);
+    EXPECT_TRUE(context.openContextForDecoding(libffmpeg::internal::AV_CODEC_ID_TESTING));
+  }
+
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecFindDecoder, 1);
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecAllocContext3, 1);
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecParametersToContext, 0);
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avcodecOpen2, 1);
+}
+
+TEST_F(AVCodecContextWrapperTest, SkipSettingsShouldBePassedAsOptions)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+
+  {
+    AVDummy                           codecParametersDummy;
+    avcodec::AVCodecParametersWrapper codecParameters(
+        reinterpret_cast<AVCodecParameters *>(&codecParametersDummy), ffmpegLibraries);
+
+    auto context = AVCodecContextWrapper(ffmpegLibraries);
+    context.setSkipSettings({.skipFrame      = Discard::NonKey,
+                             .skipLoopFilter = Discard::All,
+                             .skipIDCT       = Discard::Default});
+    EXPECT_TRUE(context.openContextForDecoding(codecParameters));
+  }
+
+  const auto expectedOptions =
+      std::map<std::string, std::string>({{"skip_frame", "nokey"}, {"skip_loop_filter", "all"}});
+  EXPECT_EQ(ffmpegLibraries->functionCallValues.avcodecOpen2Options, expectedOptions);
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avDictSet, 2);
+}
+
+TEST_F(AVCodecContextWrapperTest, DefaultSkipSettingsShouldNotSetOptions)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+
+  {
+    AVDummy                           codecParametersDummy;
+    avcodec::AVCodecParametersWrapper codecParameters(
+        reinterpret_cast<AVCodecParameters *>(&codecParametersDummy), ffmpegLibraries);
+
+    auto context = AVCodecContextWrapper(ffmpegLibraries);
+    EXPECT_TRUE(context.openContextForDecoding(codecParameters));
+  }
+
+  EXPECT_TRUE(ffmpegLibraries->functionCallValues.avcodecOpen2Options.empty());
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avDictSet, 0);
+}
+
 TEST_F(AVCodecContextWrapperTest, TestSendingPackets)
 {
   auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
@@ -151,6 +231,12 @@ TEST_P(AVCodecContextWrapperTest, TestAVCodecContextWrapper)
   RUN_TEST_FOR_VERSION(version, runAVCodecContextTest);
 }
 
+TEST_P(AVCodecContextWrapperTest, LowresShouldBeLimitedToCodecMaximum)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runLowresShouldBeLimitedToCodecMaximum);
+}
+
 INSTANTIATE_TEST_SUITE_P(AVCodecContextWrapper,
                          AVCodecContextWrapperTest,
                          testing::ValuesIn(SupportedFFmpegVersions),
@@ -51,6 +51,9 @@ void runAVCodecParametersWrapperTestAVFormat56(const LibraryVersions &version)
   EXPECT_EQ(parameters.getColorspace(), avutil::ColorSpace::UNSPECIFIED);
   EXPECT_EQ(parameters.getPixelFormat().name, "Unknown");
   EXPECT_EQ(parameters.getSampleAspectRatio(), Rational());
+  EXPECT_EQ(parameters.getSampleRate(), 0);
+  EXPECT_EQ(parameters.getProfile(), 0);
+  EXPECT_EQ(parameters.getCodecTag(), 0u);
 }
 
 template <FFmpegVersion V> void runAVCodecParametersWrapperTest()
@@ -70,15 +73,20 @@ template <FFmpegVersion V> void runAVCodecParametersWrapperTest()
   std::array<uint8_t, 4> TEST_EXTRADATA = {22, 56, 19, 22};
 
   AVCodecParametersType<V> codecParameters;
-  codecParameters.codec_type          = AVMEDIA_TYPE_AUDIO;
-  codecParameters.codec_id            = static_cast<AVCodecID>(123);
-  codecParameters.extradata           = TEST_EXTRADATA.data();
-  codecParameters.extradata_size      = static_cast<int>(TEST_EXTRADATA.size());
-  codecParameters.width               = 64;
-  codecParameters.height              = 198;
-  codecParameters.color_space         = AVCOL_SPC_SMPTE240M;
-  codecParameters.format              = TEST_PIXEL_FORMAT;
-  codecParameters.sample_aspect_ratio = AVRational({23, 88});
+  codecParameters.codec_type            = AVMEDIA_TYPE_AUDIO;
+  codecParameters.codec_id              = static_cast<AVCodecID>(123);
+  codecParameters.extradata             = TEST_EXTRADATA.data();
+  codecParameters.extradata_size        = static_cast<int>(TEST_EXTRADATA.size());
+  codecParameters.width                 = 64;
+  codecParameters.height                = 198;
+  codecParameters.color_space           = AVCOL_SPC_SMPTE240M;
+  codecParameters.format                = TEST_PIXEL_FORMAT;
+  codecParameters.sample_aspect_ratio   = AVRational({23, 88});
+  codecParameters.sample_rate           = 48000;
+  codecParameters.block_align           = 6;
+  codecParameters.bits_per_coded_sample = 16;
+  codecParameters.profile               = 2;
+  codecParameters.codec_tag             = 0x31637661;
   if constexpr (V == FFmpegVersion::FFmpeg_3x || V == FFmpegVersion::FFmpeg_4x)
     codecParameters.channel_layout = TEST_CHANNEL_LAYOUT_5POINT1;
   if constexpr (V >= FFmpegVersion::FFmpeg_5x)
@@ -95,6 +103,11 @@ template <FFmpegVersion V> void runAVCodecParametersWrapperTest()
   EXPECT_EQ(parameters.getPixelFormat().name, "None");
   EXPECT_EQ(parameters.getSampleAspectRatio(), Rational({23, 88}));
   EXPECT_THAT(parameters.getChannelLayout(), ElementsAreArray(TEST_CHANNELINFO_5POINT1));
+  EXPECT_EQ(parameters.getSampleRate(), 48000);
+  EXPECT_EQ(parameters.getBlockAlign(), 6);
+  EXPECT_EQ(parameters.getBitsPerCodedSample(), 16);
+  EXPECT_EQ(parameters.getProfile(), 2);
+  EXPECT_EQ(parameters.getCodecTag(), 0x31637661u);
 
   EXPECT_EQ(ffmpegLibraries->functionCounters.avPixFmtDescGet, 1);
 }
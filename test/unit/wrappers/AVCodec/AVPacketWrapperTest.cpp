@@ -51,6 +51,7 @@ public:
   {
     this->avcodec.av_packet_alloc = [this]() { return this->allocatePacket(); };
     this->avcodec.av_packet_free  = [this](AVPacket **packet) { this->freePacket(packet); };
+    this->avcodec.av_packet_unref = [this](AVPacket *packet) { this->unrefPacket(packet); };
     this->avcodec.av_new_packet   = [this](AVPacket *packet, int dataSize)
     { return this->newPacket(packet, dataSize); };
     if constexpr (std::is_same_v<AVPacketType, libffmpeg::internal::avcodec::AVPacket_56>)
@@ -99,6 +100,19 @@ public:
     ++this->packetCounters.packetFreeCounter;
   }
 
+  void unrefPacket(AVPacket *packet)
+  {
+    auto actualPacket = reinterpret_cast<AVPacketType *>(packet);
+    if (actualPacket->data != nullptr && actualPacket->size > 0)
+    {
+      delete[] actualPacket->data;
+      ++this->packetCounters.dataDeletionCounter;
+    }
+    actualPacket->data = nullptr;
+    actualPacket->size = 0;
+    ++this->packetCounters.packetUnrefCounter;
+  }
+
   int newPacket(AVPacket *packet, int dataSize)
   {
     auto actualPacket  = reinterpret_cast<AVPacketType *>(packet);
@@ -140,6 +154,7 @@ public:
     int dataDeletionCounter{0};
     int packetFreeCounter{0};
     int packetNewCounter{0};
+    int packetUnrefCounter{0};
     // These are AVCodec major version 56 only
     int packetInitCounter{0};
     int freePacketCounter{0};
@@ -200,6 +215,31 @@ template <FFmpegVersion V> void runConstructorFromDataTest()
   EXPECT_EQ(ffmpegLibraries->packetCounters.dataDeletionCounter, 1);
 }
 
+template <FFmpegVersion V> void runUnrefTest()
+{
+  const auto version = getLibraryVerions(V);
+
+  auto ffmpegLibraries =
+      std::make_shared<FFmpegLibrariesMockWithPacketAllocation<AVPacketType<V>>>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(version));
+
+  {
+    AVPacketWrapper packet(dataArrayToByteVector(TEST_DATA), ffmpegLibraries);
+    packet.unref();
+
+    EXPECT_TRUE(packet);
+    EXPECT_EQ(packet.getDataSize(), 0);
+    EXPECT_EQ(ffmpegLibraries->packetCounters.dataDeletionCounter, 1);
+    if (version.avcodec.major > 56)
+      EXPECT_EQ(ffmpegLibraries->packetCounters.packetUnrefCounter, 1);
+    else
+      EXPECT_EQ(ffmpegLibraries->packetCounters.freePacketCounter, 1);
+    EXPECT_EQ(ffmpegLibraries->packetCounters.packetFreeCounter, 0);
+  }
+
+  EXPECT_EQ(ffmpegLibraries->packetCounters.dataDeletionCounter, 1);
+}
+
 template <FFmpegVersion V> void runTimestampTest()
 {
   const auto version = getLibraryVerions(V);
@@ -246,6 +286,17 @@ TEST_F(AVPacketWrapperTest, IfPacketAllocationFailsShouldThrow)
   EXPECT_THROW(AVPacketWrapper packet(data, ffmpegLibraries), std::runtime_error);
 }
 
+TEST_F(AVPacketWrapperTest, IfPacketDataAllocationFailsShouldThrow)
+{
+  auto ffmpegLibraries = std::make_shared<NiceMock<FFmpegLibrariesMock>>();
+
+  constexpr auto AVERROR_ENOMEM = -12;
+  ffmpegLibraries->avcodec.av_new_packet = [](AVPacket *, int) { return AVERROR_ENOMEM; };
+
+  const ByteVector data = {std::byte(0x00), std::byte(0xff)};
+  EXPECT_THROW(AVPacketWrapper packet(data, ffmpegLibraries), std::runtime_error);
+}
+
 TEST_P(AVPacketWrapperTest, TestDefaultConstructor)
 {
   const auto version = GetParam();
@@ -258,6 +309,12 @@ TEST_P(AVPacketWrapperTest, TestConstructorFromData)
   RUN_TEST_FOR_VERSION(version, runConstructorFromDataTest);
 }
 
+TEST_P(AVPacketWrapperTest, TestUnref)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runUnrefTest);
+}
+
 TEST_P(AVPacketWrapperTest, TestSettingOfTimestamp)
 {
   const auto version = GetParam();
@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include <AVCodec/wrappers/AVBSFContextInternal.h>
 #include <AVCodec/wrappers/AVCodecContextWrapperInternal.h>
 #include <AVCodec/wrappers/AVCodecDescriptorConversionInternal.h>
 #include <AVCodec/wrappers/AVCodecParametersWrapperInternal.h>
+#include <AVCodec/wrappers/AVCodecParserContextInternal.h>
 #include <AVCodec/wrappers/AVCodecWrapperInternal.h>
 #include <AVCodec/wrappers/AVPacketWrapperInternal.h>
 #include <wrappers/RunTestForAllVersions.h>
@@ -79,4 +81,20 @@ template <FFmpegVersion V> constexpr auto avCodecDescriptorTypeFunction()
 template <FFmpegVersion V>
 using AVCodecDescriptorType = typename decltype(avCodecDescriptorTypeFunction<V>())::type;
 
+template <FFmpegVersion V> constexpr auto avBSFContextTypeFunction()
+{
+  RETURN_AVCODEC_TYPE_WRAPPER_FOR_VERSION_V(AVBSFContext);
+}
+
+template <FFmpegVersion V>
+using AVBSFContextType = typename decltype(avBSFContextTypeFunction<V>())::type;
+
+template <FFmpegVersion V> constexpr auto avCodecParserContextTypeFunction()
+{
+  RETURN_AVCODEC_TYPE_WRAPPER_FOR_VERSION_V(AVCodecParserContext);
+}
+
+template <FFmpegVersion V>
+using AVCodecParserContextType = typename decltype(avCodecParserContextTypeFunction<V>())::type;
+
 } // namespace libffmpeg::avcodec
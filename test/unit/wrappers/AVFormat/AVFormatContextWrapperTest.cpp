@@ -197,10 +197,11 @@ template <FFmpegVersion V> void runAVFormatContextWrapperTest()
       EXPECT_EQ(packet.getPTS(), (i + 1) * 100);
     }
     EXPECT_FALSE(format.getNextPacket(packet));
+    EXPECT_EQ(format.readNextPacket(packet), ReturnCode::EndOfFile);
 
     EXPECT_EQ(formatOpenInputCount, 1);
     EXPECT_EQ(findStreamInfoCount, 1);
-    EXPECT_EQ(readFrameCount, 6);
+    EXPECT_EQ(readFrameCount, 7);
   }
 
   EXPECT_EQ(formatCloseInputCount, 1);
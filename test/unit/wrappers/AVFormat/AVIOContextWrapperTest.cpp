@@ -6,11 +6,14 @@
 
 #include <AVFormat/wrappers/AVIOContextWrapper.h>
 #include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVFormat/VersionToAVFormatTypes.h>
 #include <wrappers/RunTestForAllVersions.h>
 #include <wrappers/TestHelper.h>
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+
 namespace libffmpeg::avformat
 {
 
@@ -45,8 +48,7 @@ template <FFmpegVersion V> void runAVIOInputContextCreationTest()
   ffmpegLibraries->avutil.av_mallocz = [&bufferAllocationCount](size_t size)
   {
     ++bufferAllocationCount;
-    auto buffer = new unsigned char[size];
-    return reinterpret_cast<void *>(buffer);
+    return std::calloc(1, size);
   };
 
   int avioContextAllocateCounter = 0;
@@ -68,10 +70,9 @@ template <FFmpegVersion V> void runAVIOInputContextCreationTest()
     EXPECT_EQ(write_packet, nullptr);
     EXPECT_NE(seek, nullptr);
 
-    // Clean up buffer
-    delete[] buffer;
-
-    auto avioContext = new AVDummy;
+    using ContextType   = AVIOContextType<V>;
+    auto avioContext    = static_cast<ContextType *>(std::calloc(1, sizeof(ContextType)));
+    avioContext->buffer = buffer;
     return reinterpret_cast<AVIOContext *>(avioContext);
   };
 
@@ -80,12 +81,18 @@ template <FFmpegVersion V> void runAVIOInputContextCreationTest()
       [&avioContextFreeCounter](internal::AVIOContext **context)
   {
     ++avioContextFreeCounter;
-    auto dummyCast = reinterpret_cast<AVDummy *>(*context);
-    delete dummyCast;
+    std::free(*context);
+    *context = nullptr;
   };
 
   int avFreePCounter               = 0;
-  ffmpegLibraries->avutil.av_freep = [&avFreePCounter](void *buffer) { ++avFreePCounter; };
+  ffmpegLibraries->avutil.av_freep = [&avFreePCounter](void *pointer)
+  {
+    ++avFreePCounter;
+    auto castPointer = static_cast<void **>(pointer);
+    std::free(*castPointer);
+    *castPointer = nullptr;
+  };
 
   {
     MockAVIOInputContext context(ffmpegLibraries);
@@ -93,21 +100,22 @@ template <FFmpegVersion V> void runAVIOInputContextCreationTest()
     EXPECT_EQ(bufferAllocationCount, 1);
     EXPECT_EQ(avioContextAllocateCounter, 1);
     EXPECT_EQ(avioContextFreeCounter, 0);
-    EXPECT_EQ(avioContextFreeCounter, 0);
+    EXPECT_EQ(avFreePCounter, 0);
   }
 
   EXPECT_EQ(bufferAllocationCount, 1);
   EXPECT_EQ(avioContextAllocateCounter, 1);
 
+  // The buffer is always freed with av_freep. The context only in avformat 56.
   if constexpr (V == FFmpegVersion::FFmpeg_2x)
   {
     EXPECT_EQ(avioContextFreeCounter, 0);
-    EXPECT_EQ(avFreePCounter, 1);
+    EXPECT_EQ(avFreePCounter, 2);
   }
   else
   {
     EXPECT_EQ(avioContextFreeCounter, 1);
-    EXPECT_EQ(avFreePCounter, 0);
+    EXPECT_EQ(avFreePCounter, 1);
   }
 }
 
@@ -137,8 +145,7 @@ template <FFmpegVersion V> void runAVIOInputAllocContextFails_ShouldNotThrow()
   ffmpegLibraries->avutil.av_mallocz = [&bufferAllocationCount](size_t size)
   {
     ++bufferAllocationCount;
-    auto buffer = new unsigned char[size];
-    return reinterpret_cast<void *>(buffer);
+    return std::calloc(1, size);
   };
 
   int avioContextAllocateCounter = 0;
@@ -152,16 +159,22 @@ template <FFmpegVersion V> void runAVIOInputAllocContextFails_ShouldNotThrow()
                                     SeekFunction        *seek)
   {
     ++avioContextAllocateCounter;
-
-    // Clean up buffer
-    delete[] buffer;
-
     return nullptr;
   };
 
+  int avFreePCounter               = 0;
+  ffmpegLibraries->avutil.av_freep = [&avFreePCounter](void *pointer)
+  {
+    ++avFreePCounter;
+    auto castPointer = static_cast<void **>(pointer);
+    std::free(*castPointer);
+    *castPointer = nullptr;
+  };
+
   MockAVIOInputContext context(ffmpegLibraries);
   EXPECT_EQ(bufferAllocationCount, 1);
   EXPECT_EQ(avioContextAllocateCounter, 1);
+  EXPECT_EQ(avFreePCounter, 1);
   EXPECT_FALSE(context);
 }
 
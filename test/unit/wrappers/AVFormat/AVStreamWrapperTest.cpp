@@ -27,6 +27,7 @@ using libffmpeg::internal::AVCodecDescriptor;
 using libffmpeg::internal::AVCodecID;
 using libffmpeg::internal::AVCodecParameters;
 using libffmpeg::internal::AVCOL_SPC_FCC;
+using libffmpeg::internal::AVIndexEntry;
 using libffmpeg::internal::AVMEDIA_TYPE_AUDIO;
 using libffmpeg::internal::AVPixelFormat;
 using libffmpeg::internal::AVRational;
@@ -171,6 +172,81 @@ template <FFmpegVersion V> void runAVStreamWrapperTestCodecParametersSet()
   EXPECT_TRUE(streamWrapper.getCodecParameters());
 }
 
+template <FFmpegVersion V> void runAVStreamWrapperTestDiscard()
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  AVStreamType<V> stream;
+  AVStreamWrapper streamWrapper(reinterpret_cast<AVStream *>(&stream), ffmpegLibraries);
+
+  EXPECT_EQ(streamWrapper.getDiscard(), avcodec::Discard::Default);
+
+  streamWrapper.setDiscard(avcodec::Discard::All);
+  EXPECT_EQ(stream.discard, libffmpeg::internal::AVDISCARD_ALL);
+  EXPECT_EQ(streamWrapper.getDiscard(), avcodec::Discard::All);
+
+  streamWrapper.setDiscard(avcodec::Discard::NonKey);
+  EXPECT_EQ(stream.discard, libffmpeg::internal::AVDISCARD_NONKEY);
+  EXPECT_EQ(streamWrapper.getDiscard(), avcodec::Discard::NonKey);
+}
+
+template <FFmpegVersion V> void runAVStreamWrapperTestIndexEntries()
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  std::array<AVIndexEntry, 2> avIndexEntries{};
+  avIndexEntries[0].pos          = 48;
+  avIndexEntries[0].timestamp    = 0;
+  avIndexEntries[0].flags        = libffmpeg::internal::AVINDEX_KEYFRAME;
+  avIndexEntries[0].size         = 12345;
+  avIndexEntries[1].pos          = 12393;
+  avIndexEntries[1].timestamp    = 512;
+  avIndexEntries[1].size         = 678;
+  avIndexEntries[1].min_distance = 512;
+
+  const std::vector<IndexEntry> expectedEntries = {{48, 0, 12345, 0, true, false},
+                                                   {12393, 512, 678, 512, false, false}};
+
+  AVStreamType<V> stream;
+  AVStreamWrapper streamWrapper(reinterpret_cast<AVStream *>(&stream), ffmpegLibraries);
+
+  if constexpr (V == FFmpegVersion::FFmpeg_3x)
+  {
+    stream.index_entries    = avIndexEntries.data();
+    stream.nb_index_entries = static_cast<int>(avIndexEntries.size());
+
+    EXPECT_EQ(streamWrapper.getNumberOfIndexEntries(), 2);
+    EXPECT_EQ(streamWrapper.getIndexEntries(), expectedEntries);
+  }
+  else if constexpr (V == FFmpegVersion::FFmpeg_2x || V == FFmpegVersion::FFmpeg_4x)
+  {
+    // Not accessible without the API functions
+    EXPECT_EQ(streamWrapper.getNumberOfIndexEntries(), 0);
+    EXPECT_TRUE(streamWrapper.getIndexEntries().empty());
+  }
+  else
+  {
+    const auto streamPointer = reinterpret_cast<AVStream *>(&stream);
+    ffmpegLibraries->avformat.avformat_index_get_entries_count =
+        [&](const AVStream *st) -> int
+    {
+      EXPECT_EQ(st, streamPointer);
+      return static_cast<int>(avIndexEntries.size());
+    };
+    ffmpegLibraries->avformat.avformat_index_get_entry =
+        [&](AVStream *st, int idx) -> const AVIndexEntry *
+    {
+      EXPECT_EQ(st, streamPointer);
+      return &avIndexEntries.at(idx);
+    };
+
+    EXPECT_EQ(streamWrapper.getNumberOfIndexEntries(), 2);
+    EXPECT_EQ(streamWrapper.getIndexEntries(), expectedEntries);
+  }
+}
+
 } // namespace
 
 class AVStreamWrapperTest : public testing::TestWithParam<LibraryVersions>
@@ -216,6 +292,18 @@ TEST_P(AVStreamWrapperTest, TestAVInputFormatWrapperWithCodecParametersSet)
   RUN_TEST_FOR_VERSION(version, runAVStreamWrapperTestCodecParametersSet);
 }
 
+TEST_P(AVStreamWrapperTest, TestAVStreamWrapperDiscard)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runAVStreamWrapperTestDiscard);
+}
+
+TEST_P(AVStreamWrapperTest, TestAVStreamWrapperIndexEntries)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runAVStreamWrapperTestIndexEntries);
+}
+
 INSTANTIATE_TEST_SUITE_P(AVFormatWrappers,
                          AVStreamWrapperTest,
                          testing::ValuesIn(SupportedFFmpegVersions),
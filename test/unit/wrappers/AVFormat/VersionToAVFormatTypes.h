@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AVFormat/wrappers/AVFormatContextWrapperInternal.h>
+#include <AVFormat/wrappers/AVIOContextWrapperInternal.h>
 #include <AVFormat/wrappers/AVInputFormatWrapperInternal.h>
 #include <AVFormat/wrappers/AVStreamWrapperInternal.h>
 #include <wrappers/RunTestForAllVersions.h>
@@ -62,4 +63,12 @@ template <FFmpegVersion V> constexpr auto avFormatContextTypeFunction()
 template <FFmpegVersion V>
 using AVFormatContextType = typename decltype(avFormatContextTypeFunction<V>())::type;
 
+template <FFmpegVersion V> constexpr auto avIOContextTypeFunction()
+{
+  RETURN_AVFORMAT_TYPE_WRAPPER_FOR_VERSION_V(AVIOContext);
+}
+
+template <FFmpegVersion V>
+using AVIOContextType = typename decltype(avIOContextTypeFunction<V>())::type;
+
 } // namespace libffmpeg::avformat
@@ -63,4 +63,66 @@ TEST(AVDictionaryWrapperTest, GetDictEntriesTest)
   EXPECT_EQ(ffmpegLibraries->functionCounters.avDictGet, 5);
 }
 
+TEST(AVDictionaryWrapperTest, IterateEntriesWithoutCopy)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+
+  std::array<AVDictionaryEntry, 4> dummyEntries = {
+      AVDictionaryEntry({(char *)"key1", (char *)"value1"}),
+      AVDictionaryEntry({(char *)"key2", (char *)"value2"}),
+      AVDictionaryEntry({(char *)"key3", (char *)"value3"}),
+      AVDictionaryEntry({nullptr, nullptr})};
+
+  const auto dictPtr = reinterpret_cast<AVDictionary *>(dummyEntries.data());
+
+  AVDictionaryWrapper wrapper(dictPtr, ffmpegLibraries);
+
+  std::vector<StringPair> entries;
+  for (const auto &entry : wrapper)
+  {
+    // The views must point directly into the dictionary entries
+    EXPECT_EQ(entry.key.data(), dummyEntries.at(entries.size()).key);
+    EXPECT_EQ(entry.value.data(), dummyEntries.at(entries.size()).value);
+    entries.push_back({std::string(entry.key), std::string(entry.value)});
+  }
+
+  EXPECT_EQ(entries,
+            std::vector<StringPair>(
+                {{"key1", "value1"}, {"key2", "value2"}, {"key3", "value3"}}));
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avDictGet, 4);
+}
+
+TEST(AVDictionaryWrapperTest, IterateNullptrShouldNotCallFFmpeg)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+
+  AVDictionaryWrapper wrapper(nullptr, ffmpegLibraries);
+  EXPECT_EQ(wrapper.begin(), wrapper.end());
+  EXPECT_FALSE(wrapper.get("key1"));
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avDictGet, 0);
+}
+
+TEST(AVDictionaryWrapperTest, GetValueForKey)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+
+  std::array<AVDictionaryEntry, 3> dummyEntries = {
+      AVDictionaryEntry({(char *)"rotate", (char *)"90"}),
+      AVDictionaryEntry({(char *)"lavfi.scene_score", (char *)"0.5"}),
+      AVDictionaryEntry({nullptr, nullptr})};
+
+  const auto dictPtr = reinterpret_cast<AVDictionary *>(dummyEntries.data());
+
+  AVDictionaryWrapper wrapper(dictPtr, ffmpegLibraries);
+
+  const auto value = wrapper.get("lavfi.scene_score");
+  ASSERT_TRUE(value);
+  EXPECT_EQ(*value, "0.5");
+  EXPECT_EQ(value->data(), dummyEntries.at(1).value);
+
+  EXPECT_EQ(wrapper.get(std::string("ROTATE")), "90");
+  EXPECT_FALSE(wrapper.get("notInDictionary"));
+  EXPECT_EQ(ffmpegLibraries->functionCounters.avDictGet, 3);
+}
+
 } // namespace libffmpeg::avutil
\ No newline at end of file
@@ -4,6 +4,7 @@
  * For a copy, see <https://opensource.org/licenses/MIT>.
  */
 
+#include <AVCodec/wrappers/AVChannelInternal.h>
 #include <AVUtil/wrappers/AVFrameWrapper.h>
 #include <common/InternalTypes.h>
 #include <libHandling/FFmpegLibrariesMoc.h>
@@ -13,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+
 namespace libffmpeg::avutil
 {
 
@@ -21,6 +24,8 @@ namespace
 
 using libffmpeg::internal::AVFrame;
 using libffmpeg::internal::AVPixelFormat;
+using libffmpeg::internal::AVSampleFormat;
+using libffmpeg::internal::avcodec::AVChannelOrder;
 
 using ::testing::Return;
 
@@ -104,6 +109,76 @@ template <FFmpegVersion V> void runAVFrameWrapperTestDataAccess()
   // Todo ... there must be more here
 }
 
+template <FFmpegVersion V> void runAVFrameWrapperTestAudioAccess()
+{
+  constexpr uint64_t STEREO_MASK       = 0x3;
+  constexpr int      NUMBER_OF_SAMPLES = 4;
+
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+
+  ffmpegLibraries->avutil.av_frame_alloc = []()
+  { return reinterpret_cast<AVFrame *>(new AVFrameType<V>()); };
+  ffmpegLibraries->avutil.av_frame_free = [](AVFrame **frame)
+  {
+    delete reinterpret_cast<AVFrameType<V> *>(*frame);
+    *frame = nullptr;
+  };
+  ffmpegLibraries->avutil.av_frame_get_sample_rate = [](const AVFrame *) { return 48000; };
+  ffmpegLibraries->avutil.av_frame_get_channels    = [](const AVFrame *) { return 2; };
+  ffmpegLibraries->avutil.av_frame_get_channel_layout = [](const AVFrame *)
+  { return static_cast<int64_t>(STEREO_MASK); };
+
+  std::array<float, NUMBER_OF_SAMPLES> left  = {0.0f, 0.25f, 0.5f, 0.75f};
+  std::array<float, NUMBER_OF_SAMPLES> right = {-0.0f, -0.25f, -0.5f, -0.75f};
+  std::array<uint8_t *, 2>             planes{reinterpret_cast<uint8_t *>(left.data()),
+                                  reinterpret_cast<uint8_t *>(right.data())};
+
+  std::array<int16_t, NUMBER_OF_SAMPLES * 2> interleaved{};
+  auto interleavedPlane = reinterpret_cast<uint8_t *>(interleaved.data());
+
+  AVFrameWrapper frame(ffmpegLibraries);
+  auto           castFrame = reinterpret_cast<AVFrameType<V> *>(frame.getFrame());
+  castFrame->format        = AVSampleFormat::AV_SAMPLE_FMT_FLTP;
+  castFrame->nb_samples    = NUMBER_OF_SAMPLES;
+  castFrame->extended_data = planes.data();
+  if constexpr (V >= FFmpegVersion::FFmpeg_7x)
+  {
+    castFrame->sample_rate           = 48000;
+    castFrame->ch_layout.order       = AVChannelOrder::AV_CHANNEL_ORDER_NATIVE;
+    castFrame->ch_layout.nb_channels = 2;
+    castFrame->ch_layout.u.mask      = STEREO_MASK;
+  }
+  else if constexpr (V >= FFmpegVersion::FFmpeg_5x)
+  {
+    castFrame->sample_rate    = 48000;
+    castFrame->channels       = 2;
+    castFrame->channel_layout = STEREO_MASK;
+  }
+
+  EXPECT_EQ(frame.getSampleFormat(), AVSampleFormat::AV_SAMPLE_FMT_FLTP);
+  EXPECT_EQ(frame.getSampleRate(), 48000);
+  EXPECT_EQ(frame.getNumberOfSamples(), NUMBER_OF_SAMPLES);
+  EXPECT_EQ(frame.getNumberOfChannels(), 2);
+  EXPECT_EQ(frame.getChannelLayout(), internal::avcodec::bitMaskToChannelLayout(STEREO_MASK));
+  EXPECT_EQ(frame.getNumberOfAudioPlanes(), 2);
+
+  const auto leftSamples = frame.getAudioSamples<float>(0);
+  ASSERT_EQ(leftSamples.size(), std::size_t(NUMBER_OF_SAMPLES));
+  EXPECT_EQ(leftSamples.data(), left.data());
+  EXPECT_EQ(leftSamples[3], 0.75f);
+  EXPECT_EQ(frame.getAudioSamples<float>(1).data(), right.data());
+  EXPECT_TRUE(frame.getAudioSamples<float>(2).empty());
+  EXPECT_TRUE(frame.getAudioSamples<int16_t>(0).empty());
+
+  castFrame->format        = AVSampleFormat::AV_SAMPLE_FMT_S16;
+  castFrame->extended_data = &interleavedPlane;
+  EXPECT_EQ(frame.getNumberOfAudioPlanes(), 1);
+  EXPECT_EQ(frame.getAudioPlane(0).size(), sizeof(interleaved));
+  EXPECT_EQ(frame.getAudioSamples<int16_t>(0).size(), interleaved.size());
+  EXPECT_TRUE(frame.getAudioSamples<int16_t>(1).empty());
+}
+
 } // namespace
 
 class AVFrameWrapperTest : public testing::TestWithParam<LibraryVersions>
@@ -128,6 +203,12 @@ TEST_P(AVFrameWrapperTest, TestAVFrameWrapperDataAccess)
   RUN_TEST_FOR_VERSION(version, runAVFrameWrapperTestDataAccess);
 }
 
+TEST_P(AVFrameWrapperTest, TestAVFrameWrapperAudioAccess)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runAVFrameWrapperTestAudioAccess);
+}
+
 INSTANTIATE_TEST_SUITE_P(AVUtilWrappers,
                          AVFrameWrapperTest,
                          testing::ValuesIn(SupportedFFmpegVersions),
@@ -114,6 +114,41 @@ TEST(AVPixFmtDescriptorConversionTest, TestDefaultConstructor)
   EXPECT_EQ(format.componentDescriptors.size(), 0);
 }
 
+TEST(AVPixFmtDescriptorConversionTest, GetVisiblePlaneSize)
+{
+  // yuv420p10le with an odd size. The partially covered chroma samples are visible.
+  PixelFormatDescriptor yuv420p10;
+  yuv420p10.numberOfComponents   = 3;
+  yuv420p10.shiftLumaToChroma    = {1, 1};
+  yuv420p10.componentDescriptors = {{0, 2, 0, 0, 10}, {1, 2, 0, 0, 10}, {2, 2, 0, 0, 10}};
+
+  EXPECT_EQ(getVisiblePlaneSize(0, {33, 17}, yuv420p10), Size({66, 17}));
+  EXPECT_EQ(getVisiblePlaneSize(1, {33, 17}, yuv420p10), Size({34, 9}));
+  EXPECT_EQ(getVisiblePlaneSize(2, {33, 17}, yuv420p10), Size({34, 9}));
+  EXPECT_EQ(getVisiblePlaneSize(3, {33, 17}, yuv420p10), Size({0, 0}));
+
+  // nv12 with interleaved chroma
+  PixelFormatDescriptor nv12;
+  nv12.numberOfComponents   = 3;
+  nv12.shiftLumaToChroma    = {1, 1};
+  nv12.componentDescriptors = {{0, 1, 0, 0, 8}, {1, 2, 0, 0, 8}, {1, 2, 1, 0, 8}};
+  EXPECT_EQ(getVisiblePlaneSize(1, {32, 16}, nv12), Size({32, 8}));
+
+  // Packed rgb24 is not subsampled
+  PixelFormatDescriptor rgb24;
+  rgb24.numberOfComponents   = 3;
+  rgb24.flags.rgb            = true;
+  rgb24.componentDescriptors = {{0, 3, 0, 0, 8}, {0, 3, 1, 0, 8}, {0, 3, 2, 0, 8}};
+  EXPECT_EQ(getVisiblePlaneSize(0, {10, 4}, rgb24), Size({30, 4}));
+
+  // monow is bitwise packed. The step is given in bits.
+  PixelFormatDescriptor monow;
+  monow.numberOfComponents   = 1;
+  monow.flags.bitwisePacked  = true;
+  monow.componentDescriptors = {{0, 1, 0, 0, 1}};
+  EXPECT_EQ(getVisiblePlaneSize(0, {13, 4}, monow), Size({2, 4}));
+}
+
 TEST_P(AVPixFmtDescriptorConversionTest, TestAVPixFmtDescriptorConversion)
 {
   const auto version = GetParam();
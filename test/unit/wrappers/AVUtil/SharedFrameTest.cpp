@@ -0,0 +1,143 @@
+/* Copyright (c) 2023 Christian Feldmann [christian.feldmann@gmx.de].
+ * All rights reserved.
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#include <AVUtil/wrappers/SharedFrame.h>
+#include <common/InternalTypes.h>
+#include <libHandling/FFmpegLibrariesMoc.h>
+#include <wrappers/AVUtil/VersionToAVUtilTypes.h>
+#include <wrappers/RunTestForAllVersions.h>
+#include <wrappers/TestHelper.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+namespace libffmpeg::avutil
+{
+
+namespace
+{
+
+using libffmpeg::internal::AVFrame;
+using libffmpeg::internal::AVPixelFormat;
+
+using ::testing::Return;
+
+template <FFmpegVersion V> void runSharedFrameTest()
+{
+  constexpr auto TEST_PIXEL_FORMAT = AVPixelFormat(289);
+  constexpr auto TEST_LINESIZE     = 32;
+  constexpr auto TEST_SIZE         = Size({20, 4});
+
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+  EXPECT_CALL(*ffmpegLibraries, getLibrariesVersion()).WillRepeatedly(Return(getLibraryVerions(V)));
+  ffmpegLibraries->functionChecks.avutilPixFmtDescGetExpectedFormat = TEST_PIXEL_FORMAT;
+
+  int frameAllocCounter                  = 0;
+  ffmpegLibraries->avutil.av_frame_alloc = [&frameAllocCounter]()
+  {
+    auto frame = new AVFrameType<V>;
+    frameAllocCounter++;
+    return reinterpret_cast<AVFrame *>(frame);
+  };
+
+  int frameFreeCounter                  = 0;
+  ffmpegLibraries->avutil.av_frame_free = [&frameFreeCounter](AVFrame **frame)
+  {
+    if (frame != nullptr && *frame != nullptr)
+    {
+      auto castFrame = reinterpret_cast<AVFrameType<V> *>(*frame);
+      delete (castFrame);
+      *frame = nullptr;
+      frameFreeCounter++;
+    }
+  };
+
+  int frameRefCounter                  = 0;
+  ffmpegLibraries->avutil.av_frame_ref = [&frameRefCounter](AVFrame *dst, const AVFrame *src)
+  {
+    *reinterpret_cast<AVFrameType<V> *>(dst) = *reinterpret_cast<const AVFrameType<V> *>(src);
+    frameRefCounter++;
+    return 0;
+  };
+
+  std::array<std::byte, TEST_LINESIZE * 4> lumaData{};
+
+  {
+    AVFrameWrapper frame(ffmpegLibraries);
+    {
+      auto castFrame         = reinterpret_cast<AVFrameType<V> *>(frame.getFrame());
+      castFrame->width       = TEST_SIZE.width;
+      castFrame->height      = TEST_SIZE.height;
+      castFrame->data[0]     = reinterpret_cast<uint8_t *>(lumaData.data());
+      castFrame->linesize[0] = TEST_LINESIZE;
+      castFrame->format      = TEST_PIXEL_FORMAT;
+    }
+
+    const SharedFrame sharedFrame(std::move(frame));
+    EXPECT_TRUE(sharedFrame);
+    EXPECT_EQ(sharedFrame.getUseCount(), 1);
+
+    {
+      const auto copiedFrame = sharedFrame;
+      EXPECT_EQ(sharedFrame.getUseCount(), 2);
+      EXPECT_EQ(frameAllocCounter, 1);
+
+      const auto plane = copiedFrame->getPlane(0);
+      EXPECT_EQ(plane.data, lumaData.data());
+      EXPECT_EQ(plane.linesize, TEST_LINESIZE);
+      EXPECT_EQ(plane.size, TEST_SIZE);
+
+      const auto line = plane.getLine(1);
+      EXPECT_EQ(line.data(), lumaData.data() + TEST_LINESIZE);
+      EXPECT_EQ(line.size(), static_cast<std::size_t>(TEST_LINESIZE));
+      EXPECT_TRUE(plane.getLine(TEST_SIZE.height).empty());
+
+      EXPECT_EQ(copiedFrame->getPlane(1).data, nullptr);
+    }
+    EXPECT_EQ(sharedFrame.getUseCount(), 1);
+
+    const auto reference = sharedFrame.createReference();
+    EXPECT_EQ(frameRefCounter, 1);
+    EXPECT_EQ(frameAllocCounter, 2);
+    EXPECT_EQ(reference.getPlane(0).data, lumaData.data());
+  }
+
+  EXPECT_EQ(frameAllocCounter, 2);
+  EXPECT_EQ(frameFreeCounter, 2);
+}
+
+} // namespace
+
+class SharedFrameTest : public testing::TestWithParam<LibraryVersions>
+{
+};
+
+TEST(SharedFrameTest, shouldThrowIfFrameIsEmpty)
+{
+  auto ffmpegLibraries = std::make_shared<FFmpegLibrariesMock>();
+
+  AVFrameWrapper frame(ffmpegLibraries);
+  auto           movedFrame = std::move(frame);
+  EXPECT_THROW(SharedFrame sharedFrame(std::move(frame)), std::runtime_error);
+
+  const SharedFrame emptySharedFrame;
+  EXPECT_FALSE(emptySharedFrame);
+  EXPECT_THROW(const auto reference = emptySharedFrame.createReference(), std::runtime_error);
+}
+
+TEST_P(SharedFrameTest, TestSharedFrame)
+{
+  const auto version = GetParam();
+  RUN_TEST_FOR_VERSION(version, runSharedFrameTest);
+}
+
+INSTANTIATE_TEST_SUITE_P(AVUtilWrappers,
+                         SharedFrameTest,
+                         testing::ValuesIn(SupportedFFmpegVersions),
+                         getNameWithFFmpegVersion);
+
+} // namespace libffmpeg::avutil